@@ -0,0 +1,300 @@
+/*
+ *  Copyright (C) 2023 Swansea University
+ *
+ *  This file is part of the SELKIELogger suite of tools.
+ *
+ *  SELKIELogger is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation, either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  SELKIELogger is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this SELKIELogger product.
+ *  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "DWStats.h"
+
+/*!
+ * @param[out] ring Ring buffer to initialise
+ * @param[in] size Number of samples to allocate
+ * @return True on success, false on error
+ */
+bool dw_ring_init(dw_disp_ring *ring, const size_t size) {
+	if (ring == NULL || size == 0) { return false; }
+	*ring = (dw_disp_ring){0};
+	ring->north = calloc(size, sizeof(float));
+	ring->west = calloc(size, sizeof(float));
+	ring->vert = calloc(size, sizeof(float));
+	if (!ring->north || !ring->west || !ring->vert) {
+		dw_ring_destroy(ring);
+		return false;
+	}
+	ring->size = size;
+	return true;
+}
+
+/*!
+ * @param[in,out] ring Ring buffer to release
+ */
+void dw_ring_destroy(dw_disp_ring *ring) {
+	if (ring == NULL) { return; }
+	free(ring->north);
+	free(ring->west);
+	free(ring->vert);
+	*ring = (dw_disp_ring){0};
+}
+
+/*!
+ * Once full, the oldest sample is overwritten.
+ *
+ * @param[in,out] ring Ring buffer
+ * @param[in] north North displacement [m]
+ * @param[in] west West displacement [m]
+ * @param[in] vert Vertical displacement [m]
+ */
+void dw_ring_add(dw_disp_ring *ring, const float north, const float west, const float vert) {
+	if (ring == NULL || ring->size == 0) { return; }
+	ring->north[ring->head] = north;
+	ring->west[ring->head] = west;
+	ring->vert[ring->head] = vert;
+	ring->head = (ring->head + 1) % ring->size;
+	if (ring->count < ring->size) { ring->count++; }
+}
+
+/*!
+ * Iterative decimation in time FFT, using the e^(-i...) sign convention.
+ *
+ * @param[in,out] re Real components
+ * @param[in,out] im Imaginary components
+ * @param[in] n Number of points (must be a power of two)
+ * @return True on success, false if n is not a power of two
+ */
+bool dw_fft(double *re, double *im, const size_t n) {
+	if (re == NULL || im == NULL || n < 2 || (n & (n - 1))) { return false; }
+
+	// Bit reversal permutation
+	for (size_t i = 1, j = 0; i < n; i++) {
+		size_t bit = n >> 1;
+		for (; j & bit; bit >>= 1) {
+			j ^= bit;
+		}
+		j ^= bit;
+		if (i < j) {
+			double t = re[i];
+			re[i] = re[j];
+			re[j] = t;
+			t = im[i];
+			im[i] = im[j];
+			im[j] = t;
+		}
+	}
+
+	for (size_t len = 2; len <= n; len <<= 1) {
+		const double ang = -2 * M_PI / len;
+		const double wr = cos(ang);
+		const double wi = sin(ang);
+		for (size_t i = 0; i < n; i += len) {
+			double cr = 1;
+			double ci = 0;
+			for (size_t k = 0; k < len / 2; k++) {
+				const size_t a = i + k;
+				const size_t b = a + len / 2;
+				const double tr = re[b] * cr - im[b] * ci;
+				const double ti = re[b] * ci + im[b] * cr;
+				re[b] = re[a] - tr;
+				im[b] = im[a] - ti;
+				re[a] += tr;
+				im[a] += ti;
+				const double nr = cr * wr - ci * wi;
+				ci = cr * wi + ci * wr;
+				cr = nr;
+			}
+		}
+	}
+	return true;
+}
+
+/*!
+ * Horizontal displacements lag the vertical displacement by 90 degrees in the
+ * direction of travel, so the quadrature spectra between vertical and
+ * horizontal displacements point in the opposite direction to wave travel.
+ *
+ * @param[in] qn Quadrature spectrum, vertical and north displacements
+ * @param[in] qe Quadrature spectrum, vertical and east displacements
+ * @return Direction waves are coming from, in degrees clockwise from north
+ */
+float dw_wave_direction(const double qn, const double qe) {
+	if (qn == 0 && qe == 0) { return NAN; }
+	double d = atan2(qe, qn) * 180.0 / M_PI;
+	if (d < 0) { d += 360.0; }
+	return d;
+}
+
+/*!
+ * Spectra are estimated using Welch's method: the displacements held in the
+ * ring are split into segments of `window` samples with 50% overlap, each
+ * segment has its mean removed and a Hann window applied, and the resulting
+ * periodograms are averaged. Segments with more than 10% invalid (NAN)
+ * samples are skipped, and remaining invalid samples are treated as zero
+ * displacement.
+ *
+ * Statistics are calculated from spectral moments between DW_STATS_FMIN and
+ * DW_STATS_FMAX, and directions from the quadrature spectra between vertical
+ * and horizontal displacements.
+ *
+ * @param[in] ring Displacements
+ * @param[in] window Segment length (must be a power of two)
+ * @param[in] fs Sample rate [Hz]
+ * @param[in] bands Number of bands in compact spectra (1 to DW_STATS_MAX_BANDS)
+ * @param[out] out Wave statistics
+ * @return True on success, false if statistics could not be calculated
+ */
+bool dw_wave_statistics(const dw_disp_ring *ring, const size_t window, const double fs,
+                        const uint8_t bands, dw_wave_stats *out) {
+	if (ring == NULL || out == NULL || fs <= 0) { return false; }
+	if (bands == 0 || bands > DW_STATS_MAX_BANDS) { return false; }
+	if (window < 8 || (window & (window - 1)) || ring->count < window) { return false; }
+
+	const size_t nf = window / 2 + 1;
+	double *work = calloc((7 * window) + (5 * nf), sizeof(double));
+	if (work == NULL) { return false; }
+	double *hann = work;
+	double *zr = &(hann[window]);
+	double *zi = &(zr[window]);
+	double *nr = &(zi[window]);
+	double *ni = &(nr[window]);
+	double *er = &(ni[window]);
+	double *ei = &(er[window]);
+	double *szz = &(ei[window]);
+	double *snn = &(szz[nf]);
+	double *see = &(snn[nf]);
+	double *qzn = &(see[nf]);
+	double *qze = &(qzn[nf]);
+
+	double wss = 0;
+	for (size_t i = 0; i < window; i++) {
+		hann[i] = 0.5 * (1 - cos(2 * M_PI * i / window));
+		wss += hann[i] * hann[i];
+	}
+
+	const size_t start = (ring->head + ring->size - ring->count) % ring->size;
+	uint16_t segments = 0;
+	for (size_t s = 0; (s + window) <= ring->count; s += window / 2) {
+		double mz = 0;
+		double mn = 0;
+		double mw = 0;
+		size_t valid = 0;
+		for (size_t i = 0; i < window; i++) {
+			const size_t ix = (start + s + i) % ring->size;
+			if (isnan(ring->vert[ix]) || isnan(ring->north[ix]) || isnan(ring->west[ix])) {
+				continue;
+			}
+			mz += ring->vert[ix];
+			mn += ring->north[ix];
+			mw += ring->west[ix];
+			valid++;
+		}
+		if (valid < (window - window / 10)) { continue; }
+		mz /= valid;
+		mn /= valid;
+		mw /= valid;
+
+		for (size_t i = 0; i < window; i++) {
+			const size_t ix = (start + s + i) % ring->size;
+			zi[i] = 0;
+			ni[i] = 0;
+			ei[i] = 0;
+			if (isnan(ring->vert[ix]) || isnan(ring->north[ix]) || isnan(ring->west[ix])) {
+				zr[i] = 0;
+				nr[i] = 0;
+				er[i] = 0;
+				continue;
+			}
+			zr[i] = (ring->vert[ix] - mz) * hann[i];
+			nr[i] = (ring->north[ix] - mn) * hann[i];
+			// East is positive here
+			er[i] = (mw - ring->west[ix]) * hann[i];
+		}
+		dw_fft(zr, zi, window);
+		dw_fft(nr, ni, window);
+		dw_fft(er, ei, window);
+
+		for (size_t k = 0; k < nf; k++) {
+			szz[k] += zr[k] * zr[k] + zi[k] * zi[k];
+			snn[k] += nr[k] * nr[k] + ni[k] * ni[k];
+			see[k] += er[k] * er[k] + ei[k] * ei[k];
+			// Imaginary part of conj(Z) * N and conj(Z) * E
+			qzn[k] += zr[k] * ni[k] - zi[k] * nr[k];
+			qze[k] += zr[k] * ei[k] - zi[k] * er[k];
+		}
+		segments++;
+	}
+
+	if (segments == 0) {
+		free(work);
+		return false;
+	}
+
+	// One sided PSD, averaged over all segments
+	const double df = fs / window;
+	const double scale = 2.0 / (fs * wss * segments);
+	const double bw = (DW_STATS_FMAX - DW_STATS_FMIN) / bands;
+
+	*out = (dw_wave_stats){.segments = segments, .bands = bands};
+	double bqn[DW_STATS_MAX_BANDS] = {0};
+	double bqe[DW_STATS_MAX_BANDS] = {0};
+	int bcount[DW_STATS_MAX_BANDS] = {0};
+	double m0 = 0;
+	double m2 = 0;
+	double sqn = 0;
+	double sqe = 0;
+	double peak = 0;
+	size_t kp = 0;
+	for (size_t k = 1; k < nf; k++) {
+		const double f = k * df;
+		if (f < DW_STATS_FMIN || f > DW_STATS_FMAX) { continue; }
+		const double s = szz[k] * scale;
+		m0 += s * df;
+		m2 += f * f * s * df;
+		sqn += qzn[k];
+		sqe += qze[k];
+		if (s > peak) {
+			peak = s;
+			kp = k;
+		}
+
+		int b = (f - DW_STATS_FMIN) / bw;
+		if (b >= bands) { b = bands - 1; }
+		out->psd[b] += s;
+		bqn[b] += qzn[k];
+		bqe[b] += qze[k];
+		bcount[b]++;
+	}
+
+	out->Hs = 4 * sqrt(m0);
+	out->Tz = (m2 > 0) ? sqrt(m0 / m2) : NAN;
+	out->Tp = (kp > 0) ? 1.0 / (kp * df) : NAN;
+	out->Dm = dw_wave_direction(sqn, sqe);
+	out->Dp = (kp > 0) ? dw_wave_direction(qzn[kp], qze[kp]) : NAN;
+	for (int b = 0; b < bands; b++) {
+		if (bcount[b] > 0) {
+			out->psd[b] /= bcount[b];
+			out->dir[b] = dw_wave_direction(bqn[b], bqe[b]);
+		} else {
+			out->psd[b] = NAN;
+			out->dir[b] = NAN;
+		}
+	}
+	free(work);
+	return true;
+}
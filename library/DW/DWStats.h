@@ -0,0 +1,103 @@
+/*
+ *  Copyright (C) 2023 Swansea University
+ *
+ *  This file is part of the SELKIELogger suite of tools.
+ *
+ *  SELKIELogger is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation, either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  SELKIELogger is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this SELKIELogger product.
+ *  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SELKIELoggerDW_Stats
+#define SELKIELoggerDW_Stats
+
+/*!
+ * @file DWStats.h Wave statistics from Datawell buoy displacements
+ * @ingroup SELKIELoggerDW
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*!
+ * @addtogroup SELKIELoggerDW
+ * @{
+ */
+
+//! Displacement sample rate for HXV data [Hz]
+#define DW_HXV_RATE 1.28
+
+//! Lower frequency limit for wave statistics [Hz]
+#define DW_STATS_FMIN 0.025
+
+//! Upper frequency limit for wave statistics [Hz]
+#define DW_STATS_FMAX 0.58
+
+//! Maximum number of bands in compact spectra
+#define DW_STATS_MAX_BANDS 64
+
+/*!
+ * @brief Ring buffer of buoy displacements
+ *
+ * Displacements are stored in metres. Samples with invalid data are stored as
+ * NAN and excluded from statistics.
+ */
+typedef struct {
+	float *north; //!< North displacements [m]
+	float *west;  //!< West displacements [m]
+	float *vert;  //!< Vertical displacements [m]
+	size_t size;  //!< Number of samples allocated
+	size_t count; //!< Number of samples held
+	size_t head;  //!< Position of next sample to be written
+} dw_disp_ring;
+
+/*!
+ * @brief Wave statistics estimated from displacements
+ *
+ * Directions are those the waves are coming from, in degrees clockwise from
+ * north. Compact spectra are averaged into equal width bands between
+ * DW_STATS_FMIN and DW_STATS_FMAX.
+ */
+typedef struct {
+	float Hs;                         //!< Significant wave height (Hm0) [m]
+	float Tp;                         //!< Peak period [s]
+	float Tz;                         //!< Mean zero crossing period (Tm02) [s]
+	float Dm;                         //!< Mean direction [degrees]
+	float Dp;                         //!< Direction at spectral peak [degrees]
+	uint16_t segments;                //!< Number of segments averaged
+	uint8_t bands;                    //!< Number of compact spectral bands
+	float psd[DW_STATS_MAX_BANDS];    //!< Vertical displacement PSD for each band [m^2/Hz]
+	float dir[DW_STATS_MAX_BANDS];    //!< Mean direction for each band [degrees]
+} dw_wave_stats;
+
+//! Allocate displacement ring buffer
+bool dw_ring_init(dw_disp_ring *ring, const size_t size);
+
+//! Release displacement ring buffer
+void dw_ring_destroy(dw_disp_ring *ring);
+
+//! Add displacement sample to ring buffer
+void dw_ring_add(dw_disp_ring *ring, const float north, const float west, const float vert);
+
+//! In place radix-2 complex FFT
+bool dw_fft(double *re, double *im, const size_t n);
+
+//! Convert quadrature spectra to direction waves are coming from
+float dw_wave_direction(const double qn, const double qe);
+
+//! Estimate wave statistics from displacements held in ring buffer
+bool dw_wave_statistics(const dw_disp_ring *ring, const size_t window, const double fs,
+                        const uint8_t bands, dw_wave_stats *out);
+//! @}
+#endif
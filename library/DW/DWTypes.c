@@ -99,7 +99,8 @@ bool dw_string_hxv(const char *in, size_t *end, dw_hxv *out) {
 			break;
 		}
 	}
-	if (le < 0) { return false; }
+	// No line end, or too short to contain a full line
+	if (le < 24) { return false; }
 
 	// Work backwards from the carriage return
 	bool ret = true;
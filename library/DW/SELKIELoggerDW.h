@@ -34,5 +34,6 @@
  */
 
 #include "DW/DWMessages.h"
+#include "DW/DWStats.h"
 #include "DW/DWTypes.h"
 #endif
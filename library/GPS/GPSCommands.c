@@ -38,19 +38,12 @@
  * extra data is set to zero
  */
 /*!
- * Sends a UBX protocol CFG-PRT message, configuring UART 1 for the specified
- * baud rate with all protocols permitted as input and only UBX messages
- * permitted as output.
+ * Generates the message sent by ubx_setBaudRate()
  *
- * No configuration for UBX message types is performed here, so the GPS may
- * just sit silently until we configure the messages we want as output
- * (depending on default configuration).
- *
- * @param[in] handle File descriptor to write command to
  * @param[in] baud Desired baud rate - will be converted with baud_to_flag()
- * @return Status of ubx_writeMessage()
+ * @return UBX message, with checksum set
  */
-bool ubx_setBaudRate(const int handle, const uint32_t baud) {
+ubx_message ubx_buildSetBaudRate(const uint32_t baud) {
 	ubx_message setBaud = {0xB5,
 	                       0x62, // Header bytes
 	                       0x06,
@@ -77,22 +70,36 @@ bool ubx_setBaudRate(const int handle, const uint32_t baud) {
 	setBaud.data[11] = (uint8_t)((baud >> 24) & 0xFF);
 
 	ubx_set_checksum(&setBaud);
-	return ubx_writeMessage(handle, &setBaud);
+	return setBaud;
 }
 
 /*!
- * Sends a UBX protcol CFG-MSG message with the provided message class, type and rate.
+ * Sends a UBX protocol CFG-PRT message, configuring UART 1 for the specified
+ * baud rate with all protocols permitted as input and only UBX messages
+ * permitted as output.
  *
- * The message is output very "rate" updates/calculations on UART1 and disabled
- * on all other outputs.
+ * No configuration for UBX message types is performed here, so the GPS may
+ * just sit silently until we configure the messages we want as output
+ * (depending on default configuration).
  *
  * @param[in] handle File descriptor to write command to
+ * @param[in] baud Desired baud rate - will be converted with baud_to_flag()
+ * @return Status of ubx_writeMessage()
+ */
+bool ubx_setBaudRate(const int handle, const uint32_t baud) {
+	ubx_message setBaud = ubx_buildSetBaudRate(baud);
+	return ubx_writeMessage(handle, &setBaud);
+}
+
+/*!
+ * Generates the message sent by ubx_setMessageRate()
+ *
  * @param[in] msgClass UBX Message Class
  * @param[in] msgID UBX Message ID/Type
  * @param[in] rate Requested message rate (0 to disable)
- * @return Status of ubx_writeMessage()
+ * @return UBX message, with checksum set
  */
-bool ubx_setMessageRate(const int handle, const uint8_t msgClass, const uint8_t msgID, const uint8_t rate) {
+ubx_message ubx_buildSetMessageRate(const uint8_t msgClass, const uint8_t msgID, const uint8_t rate) {
 	ubx_message setRate = {0xB5,
 	                       0x62,
 	                       0x06,
@@ -111,9 +118,39 @@ bool ubx_setMessageRate(const int handle, const uint8_t msgClass, const uint8_t
 	                       0xFF,
 	                       0x00};
 	ubx_set_checksum(&setRate);
+	return setRate;
+}
+
+/*!
+ * Sends a UBX protcol CFG-MSG message with the provided message class, type and rate.
+ *
+ * The message is output very "rate" updates/calculations on UART1 and disabled
+ * on all other outputs.
+ *
+ * @param[in] handle File descriptor to write command to
+ * @param[in] msgClass UBX Message Class
+ * @param[in] msgID UBX Message ID/Type
+ * @param[in] rate Requested message rate (0 to disable)
+ * @return Status of ubx_writeMessage()
+ */
+bool ubx_setMessageRate(const int handle, const uint8_t msgClass, const uint8_t msgID, const uint8_t rate) {
+	ubx_message setRate = ubx_buildSetMessageRate(msgClass, msgID, rate);
 	return ubx_writeMessage(handle, &setRate);
 }
 
+/*!
+ * Generates the message sent by ubx_pollMessage()
+ *
+ * @param[in] msgClass UBX Message Class
+ * @param[in] msgID UBX Message ID/Type
+ * @return UBX message, with checksum set
+ */
+ubx_message ubx_buildPollMessage(const uint8_t msgClass, const uint8_t msgID) {
+	ubx_message poll = {0xB5, 0x62, msgClass, msgID, 0x0000, {0x00}, 0xFF, 0xFF, 0x00};
+	ubx_set_checksum(&poll);
+	return poll;
+}
+
 /*!
  * Some UBX message types can be polled by sending a message with the message
  * class and ID but zero length.
@@ -126,18 +163,16 @@ bool ubx_setMessageRate(const int handle, const uint8_t msgClass, const uint8_t
  * @return Status of ubx_writeMessage()
  */
 bool ubx_pollMessage(const int handle, const uint8_t msgClass, const uint8_t msgID) {
-	ubx_message poll = {0xB5, 0x62, msgClass, msgID, 0x0000, {0x00}, 0xFF, 0xFF, 0x00};
-	ubx_set_checksum(&poll);
+	ubx_message poll = ubx_buildPollMessage(msgClass, msgID);
 	return ubx_writeMessage(handle, &poll);
 }
 
 /*!
- * Not making this configurable for now, as the "proper" method would need a bit more faff
+ * Generates the message sent by ubx_enableGalileo()
  *
- * @param[in] handle File descriptor to write command to
- * @return Status of ubx_writeMessage()
+ * @return UBX message, with checksum set
  */
-bool ubx_enableGalileo(const int handle) {
+ubx_message ubx_buildEnableGalileo(void) {
 	ubx_message enableGalileo = {0xB5,
 	                             0x62, // Header
 	                             0x06, // CFG
@@ -152,23 +187,43 @@ bool ubx_enableGalileo(const int handle) {
 	                             0xFF,
 	                             0x00};
 	ubx_set_checksum(&enableGalileo);
-	return ubx_writeMessage(handle, &enableGalileo);
+	return enableGalileo;
 }
 
 /*!
- * Configures the GPS navigation calculation and reporting rate.
+ * Requests the current output rate configuration for a single message type.
+ * The module responds with a CFG-MSG message in the same format as that sent
+ * by ubx_setMessageRate().
  *
- * - Interval is measured in milliseconds and sets navigation results calculation rate
- * - Output rate sets how many measurements are made before an update message is sent.
- *
- * Can be overridden by power saving settings
+ * @param[in] msgClass UBX Message Class
+ * @param[in] msgID UBX Message ID/Type
+ * @return UBX message, with checksum set
+ */
+ubx_message ubx_buildPollMessageRate(const uint8_t msgClass, const uint8_t msgID) {
+	ubx_message pollRate = {0xB5, 0x62, 0x06, 0x01, 0x0002, {msgClass, msgID}, 0xFF, 0xFF, 0x00};
+	ubx_set_checksum(&pollRate);
+	return pollRate;
+}
+
+/*!
+ * Not making this configurable for now, as the "proper" method would need a bit more faff
  *
  * @param[in] handle File descriptor to write command to
+ * @return Status of ubx_writeMessage()
+ */
+bool ubx_enableGalileo(const int handle) {
+	ubx_message enableGalileo = ubx_buildEnableGalileo();
+	return ubx_writeMessage(handle, &enableGalileo);
+}
+
+/*!
+ * Generates the message sent by ubx_setNavigationRate()
+ *
  * @param[in] interval Calculation interval in milliseconds
  * @param[in] outputRate Output solution every 'outputRate' calculations
- * @return Status of ubx_writeMessage()
+ * @return UBX message, with checksum set
  */
-bool ubx_setNavigationRate(const int handle, const uint16_t interval, const uint16_t outputRate) {
+ubx_message ubx_buildSetNavigationRate(const uint16_t interval, const uint16_t outputRate) {
 	ubx_message navRate = {0xB5,
 	                       0x62, // Header
 	                       0x06, // CFG
@@ -183,20 +238,33 @@ bool ubx_setNavigationRate(const int handle, const uint16_t interval, const uint
 	                       0xFF,
 	                       0x00};
 	ubx_set_checksum(&navRate);
-	return ubx_writeMessage(handle, &navRate);
+	return navRate;
 }
 
 /*!
- * Allows us to log warnings and information from the GPS module, largely
- * during the startup and configuration process.
+ * Configures the GPS navigation calculation and reporting rate.
  *
- * Enables error, warning and information messages on UART1 only and disables
- * message output on all other ports.
+ * - Interval is measured in milliseconds and sets navigation results calculation rate
+ * - Output rate sets how many measurements are made before an update message is sent.
+ *
+ * Can be overridden by power saving settings
  *
  * @param[in] handle File descriptor to write command to
+ * @param[in] interval Calculation interval in milliseconds
+ * @param[in] outputRate Output solution every 'outputRate' calculations
  * @return Status of ubx_writeMessage()
  */
-bool ubx_enableLogMessages(const int handle) {
+bool ubx_setNavigationRate(const int handle, const uint16_t interval, const uint16_t outputRate) {
+	ubx_message navRate = ubx_buildSetNavigationRate(interval, outputRate);
+	return ubx_writeMessage(handle, &navRate);
+}
+
+/*!
+ * Generates the message sent by ubx_enableLogMessages()
+ *
+ * @return UBX message, with checksum set
+ */
+ubx_message ubx_buildEnableLogMessages(void) {
 	ubx_message enableInf = {0xB5,
 	                         0x62,   // Header
 	                         0x06,   // CFG
@@ -212,16 +280,30 @@ bool ubx_enableLogMessages(const int handle) {
 	                         0xFF,
 	                         0x00};
 	ubx_set_checksum(&enableInf);
-	return ubx_writeMessage(handle, &enableInf);
+	return enableInf;
 }
 
 /*!
- * Disables options set by ubx_enableLogMessages()
+ * Allows us to log warnings and information from the GPS module, largely
+ * during the startup and configuration process.
+ *
+ * Enables error, warning and information messages on UART1 only and disables
+ * message output on all other ports.
  *
  * @param[in] handle File descriptor to write command to
  * @return Status of ubx_writeMessage()
  */
-bool ubx_disableLogMessages(const int handle) {
+bool ubx_enableLogMessages(const int handle) {
+	ubx_message enableInf = ubx_buildEnableLogMessages();
+	return ubx_writeMessage(handle, &enableInf);
+}
+
+/*!
+ * Generates the message sent by ubx_disableLogMessages()
+ *
+ * @return UBX message, with checksum set
+ */
+ubx_message ubx_buildDisableLogMessages(void) {
 	ubx_message disableInf = {0xB5,
 	                          0x62,
 	                          0x06,
@@ -237,17 +319,27 @@ bool ubx_disableLogMessages(const int handle) {
 	                          0xFF,
 	                          0x00};
 	ubx_set_checksum(&disableInf);
-	return ubx_writeMessage(handle, &disableInf);
+	return disableInf;
 }
 
 /*!
- * Set I2C address for this GPS module
+ * Disables options set by ubx_enableLogMessages()
  *
  * @param[in] handle File descriptor to write command to
- * @param[in] addr New I2C address
  * @return Status of ubx_writeMessage()
  */
-bool ubx_setI2CAddress(const int handle, const uint8_t addr) {
+bool ubx_disableLogMessages(const int handle) {
+	ubx_message disableInf = ubx_buildDisableLogMessages();
+	return ubx_writeMessage(handle, &disableInf);
+}
+
+/*!
+ * Generates the message sent by ubx_setI2CAddress()
+ *
+ * @param[in] addr New I2C address
+ * @return UBX message, with checksum set
+ */
+ubx_message ubx_buildSetI2CAddress(const uint8_t addr) {
 	ubx_message setI2C = {0xB5,
 	                      0x62,
 	                      0x06,
@@ -267,5 +359,17 @@ bool ubx_setI2CAddress(const int handle, const uint8_t addr) {
 	                      0xFF,
 	                      0x00};
 	ubx_set_checksum(&setI2C);
+	return setI2C;
+}
+
+/*!
+ * Set I2C address for this GPS module
+ *
+ * @param[in] handle File descriptor to write command to
+ * @param[in] addr New I2C address
+ * @return Status of ubx_writeMessage()
+ */
+bool ubx_setI2CAddress(const int handle, const uint8_t addr) {
+	ubx_message setI2C = ubx_buildSetI2CAddress(addr);
 	return ubx_writeMessage(handle, &setI2C);
 }
@@ -62,5 +62,41 @@ bool ubx_disableLogMessages(const int handle);
 //! Set I2C address
 bool ubx_setI2CAddress(const int handle, const uint8_t addr);
 
+/*!
+ * @}
+ * @defgroup ubxCommandMessages UBX Command messages
+ * @ingroup SELKIELoggerGPS
+ *
+ * Generate the messages sent by the UBX command functions, so that they can be
+ * sent and acknowledged asynchronously (see GPSConfig.h)
+ * @{
+ */
+//! Generate message for ubx_setBaudRate()
+ubx_message ubx_buildSetBaudRate(const uint32_t baud);
+
+//! Generate message for ubx_setMessageRate()
+ubx_message ubx_buildSetMessageRate(const uint8_t msgClass, const uint8_t msgID, const uint8_t rate);
+
+//! Generate message for ubx_pollMessage()
+ubx_message ubx_buildPollMessage(const uint8_t msgClass, const uint8_t msgID);
+
+//! Generate CFG-MSG poll request for a single message type
+ubx_message ubx_buildPollMessageRate(const uint8_t msgClass, const uint8_t msgID);
+
+//! Generate message for ubx_enableGalileo()
+ubx_message ubx_buildEnableGalileo(void);
+
+//! Generate message for ubx_setNavigationRate()
+ubx_message ubx_buildSetNavigationRate(const uint16_t interval, const uint16_t outputRate);
+
+//! Generate message for ubx_enableLogMessages()
+ubx_message ubx_buildEnableLogMessages(void);
+
+//! Generate message for ubx_disableLogMessages()
+ubx_message ubx_buildDisableLogMessages(void);
+
+//! Generate message for ubx_setI2CAddress()
+ubx_message ubx_buildSetI2CAddress(const uint8_t addr);
+
 //! @}
 #endif
@@ -0,0 +1,181 @@
+/*
+ *  Copyright (C) 2023 Swansea University
+ *
+ *  This file is part of the SELKIELogger suite of tools.
+ *
+ *  SELKIELogger is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation, either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  SELKIELogger is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this SELKIELogger product.
+ *  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include "GPSConfig.h"
+#include "GPSSerial.h"
+
+/*!
+ * @param[out] c Configuration sequence to initialise
+ * @param[in] retries Number of times each step will be re-sent before failing
+ */
+void ubx_config_init(ubx_config *c, const int retries) {
+	memset(c, 0, sizeof(ubx_config));
+	c->retries = retries > 0 ? retries : 0;
+	c->state = UBXCFG_DONE;
+}
+
+/*!
+ * The command is considered complete once the module acknowledges it, and
+ * the next step is sent after a further `delay` milliseconds.
+ *
+ * @param[in,out] c Configuration sequence
+ * @param[in] msg Command to send. Messages with more than 256 bytes of data are not supported.
+ * @param[in] timeout Time to wait for acknowledgement [ms]
+ * @param[in] delay Time to wait after acknowledgement before sending next step [ms]
+ * @return True on success, false if the message isn't supported or the sequence is full
+ */
+bool ubx_config_add_command(ubx_config *c, const ubx_message *msg, const int timeout, const int delay) {
+	if (c->count >= UBX_CONFIG_MAX_STEPS || msg->length > 256) { return false; }
+	ubx_config_step *s = &(c->steps[c->count]);
+	memset(s, 0, sizeof(ubx_config_step));
+	s->msg = *msg;
+	s->msg.extdata = NULL;
+	s->respClass = UBXACK;
+	s->respID = 0x01;
+	s->expect[0] = msg->msgClass;
+	s->expect[1] = msg->msgID;
+	s->expectLen = 2;
+	s->timeout = timeout;
+	s->delay = delay;
+	c->count++;
+	if (c->state == UBXCFG_DONE) { c->state = UBXCFG_PENDING; }
+	return true;
+}
+
+/*!
+ * The poll is considered complete once a message with the same class and ID
+ * is received. If `expectLen` is non-zero, the first `expectLen` bytes of the
+ * message payload must also match `expect`, which can be used to verify that
+ * configuration has been applied.
+ *
+ * @param[in,out] c Configuration sequence
+ * @param[in] msg Poll request to send
+ * @param[in] expect Expected start of response payload (may be NULL if expectLen is zero)
+ * @param[in] expectLen Number of bytes to check (maximum UBX_CONFIG_EXPECT)
+ * @param[in] timeout Time to wait for response [ms]
+ * @return True on success, false if the sequence is full or parameters are invalid
+ */
+bool ubx_config_add_poll(ubx_config *c, const ubx_message *msg, const uint8_t *expect, const uint8_t expectLen,
+                         const int timeout) {
+	if (c->count >= UBX_CONFIG_MAX_STEPS || msg->length > 256) { return false; }
+	if (expectLen > UBX_CONFIG_EXPECT || (expectLen > 0 && expect == NULL)) { return false; }
+	ubx_config_step *s = &(c->steps[c->count]);
+	memset(s, 0, sizeof(ubx_config_step));
+	s->msg = *msg;
+	s->msg.extdata = NULL;
+	s->respClass = msg->msgClass;
+	s->respID = msg->msgID;
+	if (expectLen > 0) { memcpy(s->expect, expect, expectLen); }
+	s->expectLen = expectLen;
+	s->timeout = timeout;
+	c->count++;
+	if (c->state == UBXCFG_DONE) { c->state = UBXCFG_PENDING; }
+	return true;
+}
+
+/*!
+ * Sends the current step once any delay requested by the previous step has
+ * passed, and re-sends it if no response has been received before its
+ * timeout expires. If the step has already been sent `retries` times, the
+ * sequence is marked as failed.
+ *
+ * A failed write is treated in the same way as a missing response.
+ *
+ * @param[in,out] c Configuration sequence
+ * @param[in] handle File descriptor connected to GPS module
+ * @param[in] now Current time [ms]
+ * @return Sequence state
+ */
+ubx_config_state ubx_config_run(ubx_config *c, const int handle, const uint64_t now) {
+	if (c->state == UBXCFG_WAITING && now >= c->deadline) {
+		c->timeouts++;
+		if (c->attempts > c->retries) {
+			c->state = UBXCFG_FAILED;
+		} else {
+			c->state = UBXCFG_PENDING;
+		}
+	}
+
+	if (c->state == UBXCFG_PENDING && now >= c->deadline) {
+		const ubx_config_step *s = &(c->steps[c->current]);
+		c->attempts++;
+		ubx_writeMessage(handle, &(s->msg));
+		c->deadline = now + s->timeout;
+		c->state = UBXCFG_WAITING;
+	}
+	return c->state;
+}
+
+/*!
+ * Messages unrelated to the current step are ignored.
+ *
+ * If the message confirms the current step, the sequence moves on to the
+ * next step (or completes). If the module rejected the current command, or a
+ * polled message did not match the expected values, the step is re-sent on
+ * the next call to ubx_config_run() (unless all retries have been used, in
+ * which case the sequence fails).
+ *
+ * @param[in,out] c Configuration sequence
+ * @param[in] f Message received from GPS module
+ * @param[in] now Current time [ms]
+ * @return True if message was a response to the current step
+ */
+bool ubx_config_frame(ubx_config *c, const ubx_frame *f, const uint64_t now) {
+	if (c->state != UBXCFG_WAITING) { return false; }
+	const ubx_config_step *s = &(c->steps[c->current]);
+
+	bool match = false;
+	if (f->msgClass == s->respClass && f->msgID == s->respID) {
+		match = (f->length >= s->expectLen) &&
+		        (s->expectLen == 0 || memcmp(f->data, s->expect, s->expectLen) == 0);
+		if (!match && s->respClass == UBXACK) {
+			// Acknowledgement for a different command
+			return false;
+		}
+	} else if (s->respClass == UBXACK && f->msgClass == UBXACK && f->msgID == 0x00) {
+		// ACK-NAK for current command?
+		if (f->length < 2 || f->data[0] != s->expect[0] || f->data[1] != s->expect[1]) {
+			return false;
+		}
+	} else {
+		return false;
+	}
+
+	if (!match) {
+		c->naks++;
+		if (c->attempts > c->retries) {
+			c->state = UBXCFG_FAILED;
+		} else {
+			c->state = UBXCFG_PENDING;
+			c->deadline = now;
+		}
+		return true;
+	}
+
+	c->acks++;
+	c->current++;
+	c->attempts = 0;
+	c->deadline = now + s->delay;
+	c->state = (c->current < c->count) ? UBXCFG_PENDING : UBXCFG_DONE;
+	return true;
+}
@@ -0,0 +1,112 @@
+/*
+ *  Copyright (C) 2023 Swansea University
+ *
+ *  This file is part of the SELKIELogger suite of tools.
+ *
+ *  SELKIELogger is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation, either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  SELKIELogger is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this SELKIELogger product.
+ *  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SELKIELoggerGPS_Config
+#define SELKIELoggerGPS_Config
+
+/*!
+ * @file GPSConfig.h Asynchronous configuration of u-blox GPS modules
+ * @ingroup SELKIELoggerGPS
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "GPSTypes.h"
+
+/*!
+ * @defgroup ubxConfig UBX Configuration sequences
+ * @ingroup SELKIELoggerGPS
+ *
+ * Send a sequence of configuration messages to a GPS module, confirming each
+ * one before moving on to the next.
+ *
+ * Configuration commands are confirmed by the module with a UBX-ACK-ACK
+ * message, or rejected with UBX-ACK-NAK. Polled messages are confirmed by
+ * receipt of the requested message, optionally checking the start of the
+ * payload to verify the module configuration.
+ *
+ * Commands are re-sent if no response is received within the timeout
+ * specified for each step, and the sequence fails if any step has not
+ * been confirmed after the configured number of retries.
+ *
+ * These functions never block: the caller is expected to pass every message
+ * received from the module to ubx_config_frame() and call ubx_config_run()
+ * periodically until the sequence is complete.
+ * @{
+ */
+
+//! Maximum number of steps in a configuration sequence
+#define UBX_CONFIG_MAX_STEPS 20
+
+//! Maximum number of payload bytes checked in a polled response
+#define UBX_CONFIG_EXPECT 8
+
+//! Configuration sequence states
+typedef enum {
+	UBXCFG_PENDING = 0, //!< Current step waiting to be sent
+	UBXCFG_WAITING,     //!< Current step sent, waiting for response
+	UBXCFG_DONE,        //!< All steps completed
+	UBXCFG_FAILED,      //!< Current step failed after all retries
+} ubx_config_state;
+
+//! A single step in a configuration sequence
+typedef struct {
+	ubx_message msg;                   //!< Message to send (data array only)
+	uint8_t respClass;                 //!< Message class of expected response
+	uint8_t respID;                    //!< Message ID of expected response
+	uint8_t expect[UBX_CONFIG_EXPECT]; //!< Expected start of response payload
+	uint8_t expectLen;                 //!< Number of payload bytes to check
+	int timeout;                       //!< Time to wait for response [ms]
+	int delay;                         //!< Time to wait before next step [ms]
+} ubx_config_step;
+
+//! Configuration sequence and current progress
+typedef struct {
+	ubx_config_step steps[UBX_CONFIG_MAX_STEPS]; //!< Steps to be carried out in order
+	int count;              //!< Number of steps
+	int current;            //!< Current step
+	int attempts;           //!< Number of times current step has been sent
+	int retries;            //!< Number of times each step will be re-sent
+	uint64_t deadline;      //!< Time to send current step, or to stop waiting for response [ms]
+	ubx_config_state state; //!< Current state
+	unsigned int acks;      //!< Number of steps confirmed
+	unsigned int naks;      //!< Number of commands rejected or failing verification
+	unsigned int timeouts;  //!< Number of responses not received within timeout
+} ubx_config;
+
+//! Initialise an empty configuration sequence
+void ubx_config_init(ubx_config *c, const int retries);
+
+//! Add configuration command, to be confirmed by UBX-ACK-ACK
+bool ubx_config_add_command(ubx_config *c, const ubx_message *msg, const int timeout, const int delay);
+
+//! Add poll request, to be confirmed by receipt of polled message
+bool ubx_config_add_poll(ubx_config *c, const ubx_message *msg, const uint8_t *expect, const uint8_t expectLen,
+                         const int timeout);
+
+//! Send pending messages and check for timeouts
+ubx_config_state ubx_config_run(ubx_config *c, const int handle, const uint64_t now);
+
+//! Check received message against current configuration step
+bool ubx_config_frame(ubx_config *c, const ubx_frame *f, const uint64_t now);
+
+//! @}
+#endif
@@ -46,16 +46,10 @@ void ubx_calc_checksum(const ubx_message *msg, uint8_t *csA, uint8_t *csB) {
 	b += a;
 	a += (msg->length >> 8);
 	b += a;
-	if (msg->length <= 256) {
-		for (uint8_t dx = 0; dx < msg->length; dx++) {
-			a += msg->data[dx];
-			b += a;
-		}
-	} else {
-		for (uint16_t dx = 0; dx < msg->length; dx++) {
-			a += msg->extdata[dx];
-			b += a;
-		}
+	const uint8_t *d = (msg->length <= 256) ? msg->data : msg->extdata;
+	for (uint16_t dx = 0; dx < msg->length; dx++) {
+		a += d[dx];
+		b += a;
 	}
 	*csA = a;
 	*csB = b;
@@ -87,6 +81,30 @@ bool ubx_check_checksum(const ubx_message *msg) {
 	return false;
 }
 
+/*!
+ * Checks that `frame` holds a complete UBX message of exactly `len` bytes,
+ * including sync bytes, and that the checksum is valid.
+ *
+ * @param[in] frame Message data, in transmission order
+ * @param[in] len Number of bytes in frame
+ * @return Checksum validity (true/false)
+ */
+bool ubx_check_frame(const uint8_t *frame, const size_t len) {
+	if (frame == NULL || len < 8) { return false; }
+	if (frame[0] != 0xB5 || frame[1] != 0x62) { return false; }
+	const uint16_t length = frame[4] + (frame[5] << 8);
+	if (UBX_FRAME_SIZE(length) != len) { return false; }
+
+	uint8_t a = 0;
+	uint8_t b = 0;
+	// Checksum covers class, ID, length and payload
+	for (size_t dx = 2; dx < (len - 2); dx++) {
+		a += frame[dx];
+		b += a;
+	}
+	return (frame[len - 2] == a) && (frame[len - 1] == b);
+}
+
 /*!
  * Allocates a new array of bytes and copies message into array in transmission order
  * (e.g. out[0] to be sent first).
@@ -177,7 +195,37 @@ bool ubx_decode_nav_pvt(const ubx_message *msg, ubx_nav_pvt *out) {
 
 	if (msg->msgClass != UBXNAV || msg->msgID != 0x07) { return false; }
 
-	const uint8_t *d = msg->data;
+	return ubx_decode_nav_pvt_data(msg->data, msg->length, out);
+}
+
+/*!
+ * Decodes a NAV-PVT message referenced in place by a ubx_frame, without
+ * copying the payload.
+ *
+ * @param[in] frame UBX Message to decode (must be NAV-PVT)
+ * @param[out] out Pointer to output message (allocated by caller)
+ * @return True on success, false on error
+ */
+bool ubx_decode_nav_pvt_frame(const ubx_frame *frame, ubx_nav_pvt *out) {
+	if (out == NULL || frame == NULL || frame->data == NULL) { return false; }
+
+	if (frame->msgClass != UBXNAV || frame->msgID != 0x07) { return false; }
+
+	return ubx_decode_nav_pvt_data(frame->data, frame->length, out);
+}
+
+/*!
+ * Messages generated by older firmware are 84 bytes long, and do not include
+ * the vehicle heading and magnetic declination fields.
+ *
+ * @param[in] d NAV-PVT message payload
+ * @param[in] length Payload length
+ * @param[out] out Pointer to output message (allocated by caller)
+ * @return True on success, false on error
+ */
+bool ubx_decode_nav_pvt_data(const uint8_t *d, const uint16_t length, ubx_nav_pvt *out) {
+	if (out == NULL || d == NULL || length < 84) { return false; }
+
 	out->tow = d[0] + (d[1] << 8) + (d[2] << 16) + (d[3] << 24);
 	out->year = d[4] + (d[5] << 8);
 	out->month = d[6];
@@ -209,10 +257,10 @@ bool ubx_decode_nav_pvt(const ubx_message *msg, ubx_nav_pvt *out) {
 	out->headingAcc = ((int32_t)(d[72] + (d[73] << 8) + (d[74] << 16) + (d[75] << 24))) * 1E-5;
 	out->pDOP = d[76] + (d[77] << 8);
 	out->pvtFlags = d[78];
-	if (msg->length == 92) {
+	if (length >= 92) {
 		out->vehicleHeading = ((int32_t)(d[84] + (d[85] << 8) + (d[86] << 16) + (d[87] << 24))) * 1E-5;
-		out->magneticDeclination = ((int32_t)(d[88] + (d[89] << 8))) * 1E-2;
-		out->magDecAcc = ((int32_t)(d[90] + (d[91] << 8) + (d[92] << 16) + (d[93] << 24))) * 1E-2;
+		out->magneticDeclination = ((int16_t)(d[88] + (d[89] << 8))) * 1E-2;
+		out->magDecAcc = (d[90] + (d[91] << 8)) * 1E-2;
 	} else {
 		out->vehicleHeading = NAN;
 		out->magneticDeclination = NAN;
@@ -49,6 +49,9 @@ void ubx_set_checksum(ubx_message *msg);
 //! Verify checksum bytes of UBX message
 bool ubx_check_checksum(const ubx_message *msg);
 
+//! Verify checksum bytes of UBX message held in a buffer
+bool ubx_check_frame(const uint8_t *frame, const size_t len);
+
 //! Convert UBX message to flat array of bytes
 size_t ubx_flat_array(const ubx_message *msg, uint8_t **out);
 
@@ -61,5 +64,11 @@ void ubx_print_hex(const ubx_message *msg);
 //! Decode UBX NAV-PVT message
 bool ubx_decode_nav_pvt(const ubx_message *msg, ubx_nav_pvt *out);
 
+//! Decode UBX NAV-PVT message held in a buffer
+bool ubx_decode_nav_pvt_frame(const ubx_frame *frame, ubx_nav_pvt *out);
+
+//! Decode UBX NAV-PVT message payload
+bool ubx_decode_nav_pvt_data(const uint8_t *d, const uint16_t length, ubx_nav_pvt *out);
+
 //! @}
 #endif
@@ -101,6 +101,47 @@ int ubx_openConnection(const char *port, const int initialBaud) {
 	return handle;
 }
 
+/*!
+ * Opens a connection at the initial baud rate, commands the module to switch
+ * to 115200 baud UBX output and then switches the local port to match.
+ *
+ * Unlike ubx_openConnection(), this function does not wait for the module to
+ * apply the new settings or re-send the command. If the module was already
+ * operating at 115200 baud it may ignore commands for up to 1 second, so the
+ * CFG-PRT command should be repeated at the new rate until it is acknowledged
+ * (e.g. as the first step in a ubx_config sequence).
+ *
+ * @param[in] port Path to character device connected to UBlox module
+ * @param[in] initialBaud Initial baud rate for connection. Usually 9600, but may vary.
+ * @return File descriptor for use with other commands
+ */
+int ubx_openConnectionAsync(const char *port, const int initialBaud) {
+	int handle = openSerialConnection(port, initialBaud);
+	if (handle < 0) { return -1; }
+
+	if (!ubx_setBaudRate(handle, 115200)) {
+		fprintf(stderr, "Unable to command baud rate change");
+		perror("openConnectionAsync");
+		close(handle);
+		return -1;
+	}
+
+	// Make sure the command has been sent before changing rate
+	tcdrain(handle);
+
+	struct termios options;
+	tcgetattr(handle, &options);
+	cfsetispeed(&options, B115200);
+	cfsetospeed(&options, B115200);
+	if (tcsetattr(handle, TCSANOW, &options)) {
+		fprintf(stderr, "tcsetattr() failed!\n");
+		close(handle);
+		return -1;
+	}
+	tcflush(handle, TCIFLUSH);
+	return handle;
+}
+
 /*!
  * Currently just closes the handle, but could deconfigure and reset the module
  * or put it into a power saving mode in future.
@@ -136,8 +177,10 @@ bool ubx_readMessage(int handle, ubx_message *out) {
  * The source handle can be anything supported by read(), but would usually be
  * a file or a serial port.
  *
- * If a valid message is found then it is written to the structure provided as
- * a parameter and the function returns true.
+ * If a valid message is found then it is copied to the structure provided as
+ * a parameter and the function returns true. Messages longer than 256 bytes
+ * are copied to a newly allocated array (see ubx_message.extdata), which must
+ * be freed by the caller.
  *
  * If a message cannot be read, the function returns false and the `sync1`
  * field is set to an error value:
@@ -148,6 +191,9 @@ bool ubx_readMessage(int handle, ubx_message *out) {
  * - 0xAA means that an error occurred reading in data
  * - 0XEE means a valid message header was found, but no valid message
  *
+ * See ubx_readFrame_buf() for a version of this function that does not copy
+ * the message data.
+ *
  * @param[in] handle File descriptor from ubx_openConnection()
  * @param[out] out Pointer to message structure to fill with data
  * @param[in,out] buf Serial data buffer
@@ -156,105 +202,134 @@ bool ubx_readMessage(int handle, ubx_message *out) {
  * @return True if out now contains a valid message, false otherwise.
  */
 bool ubx_readMessage_buf(int handle, ubx_message *out, uint8_t buf[UBX_SERIAL_BUFF], int *index, int *hw) {
-	int ti = 0;
-	if ((*hw) < UBX_SERIAL_BUFF - 1) {
-		errno = 0;
-		ti = read(handle, &(buf[(*hw)]), UBX_SERIAL_BUFF - (*hw));
-		if (ti >= 0) {
-			(*hw) += ti;
-		} else {
-			if (errno != EAGAIN) {
-				fprintf(stderr, "Unexpected error while reading from serial port (handle ID: 0x%02x)\n",
-				        handle);
-				fprintf(stderr, "read returned \"%s\" in readMessage\n", strerror(errno));
-				out->sync1 = 0xAA;
-				return false;
-			}
-		}
+	ubx_frame f = {0};
+	out->extdata = NULL;
+	if (!ubx_readFrame_buf(handle, &f, buf, index, hw)) {
+		out->sync1 = f.sync1;
+		return false;
 	}
 
-	// Check buf[index] is valid ID
-	while (!(buf[(*index)] == 0xB5) && (*index) < (*hw)) {
-		(*index)++; // Current byte cannot be start of a message, so advance
-	}
-	if ((*index) == (*hw)) {
-		if ((*hw) > 0 && (*index) > 0) {
-			// Move data from index back to zero position
-			memmove(buf, &(buf[(*index)]), UBX_SERIAL_BUFF - (*index));
-			(*hw) -= (*index);
-			(*index) = 0;
+	out->sync1 = f.frame[0];
+	out->sync2 = f.frame[1];
+	out->msgClass = f.msgClass;
+	out->msgID = f.msgID;
+	out->length = f.length;
+	if (f.length <= 256) {
+		memcpy(out->data, f.data, f.length);
+	} else {
+		out->extdata = malloc(f.length);
+		if (out->extdata == NULL) {
+			out->sync1 = 0xAA;
+			return false;
 		}
-		// fprintf(stderr, "Buffer empty - returning\n");
-		out->sync1 = 0xFF;
-		if (ti == 0) { out->sync1 = 0xFD; }
-		return false;
+		memcpy(out->extdata, f.data, f.length);
 	}
+	out->csumA = f.data[f.length];
+	out->csumB = f.data[f.length + 1];
+	return true;
+}
 
-	if (((*hw) - (*index)) < 8) {
-		// Not enough data for any valid message, come back later
-		out->sync1 = 0xFF;
-		return false;
-	}
+/*!
+ * Pulls data from `handle` and stores it in `buf`, tracking the current search
+ * position in `index` and the current fill level/buffer high water mark in `hw`
+ *
+ * If a valid message is found, `out` is set to reference it in place within
+ * `buf` and the function returns true. The message data is not copied, and
+ * remains valid until the next call to this function with the same buffer.
+ * Data is only read from `handle` if no complete message is already held in
+ * `buf`.
+ *
+ * If a message cannot be read, the function returns false and the `sync1`
+ * field is set to an error value, as for ubx_readMessage_buf().
+ *
+ * @param[in] handle File descriptor from ubx_openConnection()
+ * @param[out] out Pointer to frame structure to fill
+ * @param[in,out] buf Serial data buffer
+ * @param[in,out] index Current search position within `buf`
+ * @param[in,out] hw End of current valid data in `buf`
+ * @return True if out now references a valid message, false otherwise.
+ */
+bool ubx_readFrame_buf(int handle, ubx_frame *out, uint8_t buf[UBX_SERIAL_BUFF], int *index, int *hw) {
+	*out = (ubx_frame){.sync1 = 0xFF};
+	int ti = -1;
+	for (int pass = 0; pass < 2; pass++) {
+		while ((*index) < (*hw)) {
+			// Skip to next possible start of message
+			uint8_t *sync = memchr(&(buf[(*index)]), 0xB5, (*hw) - (*index));
+			if (sync == NULL) {
+				(*index) = (*hw);
+				break;
+			}
+			(*index) = sync - buf;
 
-	// Set length of data required for message
+			if (((*hw) - (*index)) < 8) {
+				// Not enough data for any valid message
+				break;
+			}
 
-	out->sync1 = buf[(*index)];
-	out->sync2 = buf[(*index) + 1];
-	out->msgClass = buf[(*index) + 2];
-	out->msgID = buf[(*index) + 3];
-	out->length = buf[(*index) + 4] + (buf[(*index) + 5] << 8);
+			if (sync[1] != 0x62) {
+				// Found first sync byte, but second not valid
+				(*index)++;
+				continue;
+			}
 
-	if (out->sync2 != 0x62) {
-		// Found first sync byte, but second not valid
-		// Advance the index so we skip this message and go back around
-		(*index)++;
-		out->sync1 = 0xFF;
-		return false;
-	}
+			const uint16_t length = sync[4] + (sync[5] << 8);
+			const size_t size = UBX_FRAME_SIZE(length);
+			if (size > UBX_SERIAL_BUFF) {
+				// Can't be buffered, so can't be a valid message
+				(*index)++;
+				out->sync1 = 0xEE;
+				return false;
+			}
 
-	if (((*hw) - (*index)) < (out->length + 8)) {
-		// Not enough data for this message yet, so mark output invalid
-		out->sync1 = 0xFF;
-		if (ti == 0) { out->sync1 = 0xFD; }
-		// Go back around, but leave index where it is so we will pick up
-		// from the same point in the buffer
-		return false;
-	}
+			if ((size_t)((*hw) - (*index)) < size) {
+				// Not enough data for this message yet, so leave index
+				// where it is and pick up from the same point later
+				break;
+			}
 
-	out->extdata = NULL;
-	if (out->length <= 256) {
-		for (uint8_t i = 0; i < out->length; i++) {
-			out->data[i] = buf[(*index) + 6 + i];
-		}
-	} else {
-		out->extdata = calloc(out->length, 1);
-		for (uint16_t i = 0; i < out->length; i++) {
-			out->extdata[i] = buf[(*index) + 6 + i];
+			if (!ubx_check_frame(sync, size)) {
+				// Use 0xEE as "Found, but invalid", leaving 0xFF as "No message"
+				(*index)++;
+				out->sync1 = 0xEE;
+				return false;
+			}
+
+			out->sync1 = 0xB5;
+			out->msgClass = sync[2];
+			out->msgID = sync[3];
+			out->length = length;
+			out->frame = sync;
+			out->data = &(sync[6]);
+			(*index) += size;
+			return true;
 		}
-	}
 
-	out->csumA = buf[(*index) + 6 + out->length];
-	out->csumB = buf[(*index) + 7 + out->length];
+		if (pass > 0) { break; }
 
-	bool valid = ubx_check_checksum(out);
-	if (valid) {
-		(*index) += 8 + out->length;
-	} else {
-		out->sync1 = 0xEE; // Use 0xEE as "Found, but invalid", leaving 0xFF as
-		                   // "No message"
-		if (out->extdata) {
-			free(out->extdata);
-			out->extdata = NULL;
+		// Move unprocessed data back to zero position, then read more
+		if ((*index) > 0) {
+			memmove(buf, &(buf[(*index)]), (*hw) - (*index));
+			(*hw) -= (*index);
+			(*index) = 0;
+		}
+		if ((*hw) >= UBX_SERIAL_BUFF) { break; }
+
+		errno = 0;
+		ti = read(handle, &(buf[(*hw)]), UBX_SERIAL_BUFF - (*hw));
+		if (ti > 0) {
+			(*hw) += ti;
+		} else if (ti < 0 && errno != EAGAIN) {
+			fprintf(stderr, "Unexpected error while reading from serial port (handle ID: 0x%02x)\n",
+			        handle);
+			fprintf(stderr, "read returned \"%s\" in readFrame\n", strerror(errno));
+			out->sync1 = 0xAA;
+			return false;
 		}
-		(*index)++;
-	}
-	if ((*hw) > 0) {
-		// Move data from index back to zero position
-		memmove(buf, &(buf[(*index)]), UBX_SERIAL_BUFF - (*index));
-		(*hw) -= (*index);
-		(*index) = 0;
 	}
-	return valid;
+
+	if (ti == 0) { out->sync1 = 0xFD; }
+	return false;
 }
 
 /*!
@@ -41,6 +41,9 @@
 //! Set up a connection to a UBlox module on a given port
 int ubx_openConnection(const char *port, const int initialBaud);
 
+//! Set up a connection to a UBlox module without waiting for configuration to be applied
+int ubx_openConnectionAsync(const char *port, const int initialBaud);
+
 //! Close a connection opened with ubx_openConnection()
 void ubx_closeConnection(int handle);
 
@@ -50,6 +53,9 @@ bool ubx_readMessage(int handle, ubx_message *out);
 //! Read data from handle, and parse message if able
 bool ubx_readMessage_buf(int handle, ubx_message *out, uint8_t buf[UBX_SERIAL_BUFF], int *index, int *hw);
 
+//! Read data from handle, and reference message in place if able
+bool ubx_readFrame_buf(int handle, ubx_frame *out, uint8_t buf[UBX_SERIAL_BUFF], int *index, int *hw);
+
 //! Read (and discard) messages until required message seen or timeout reached
 bool ubx_waitForMessage(const int handle, const uint8_t msgClass, const uint8_t msgID, const int maxDelay,
                         ubx_message *out);
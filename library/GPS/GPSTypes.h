@@ -90,6 +90,25 @@ typedef struct ubx_message {
 	                   //!< correct length
 } ubx_message;
 
+/*!
+ * @brief Reference to a validated UBX message held in a receive buffer
+ *
+ * Allows messages to be decoded and copied directly from the buffer they were
+ * received into. The pointers are only valid until the buffer is next
+ * modified (see ubx_readFrame_buf()).
+ */
+typedef struct ubx_frame {
+	uint8_t sync1;        //!< 0xB5 if frame valid, otherwise error code
+	uint8_t msgClass;     //!< A value from ubx_class
+	uint8_t msgID;        //!< Message ID byte
+	uint16_t length;      //!< Payload length
+	const uint8_t *frame; //!< Complete message, including sync bytes and checksum
+	const uint8_t *data;  //!< Message payload
+} ubx_frame;
+
+//! Total size of a UBX message, including sync bytes, header and checksum
+#define UBX_FRAME_SIZE(length) ((size_t)(length) + 8)
+
 //! UBX Message descriptions
 typedef struct ubx_message_name {
 	uint8_t msgClass; //!< ubx_class value
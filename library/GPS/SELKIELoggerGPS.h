@@ -33,6 +33,7 @@
  */
 
 #include "GPS/GPSCommands.h"
+#include "GPS/GPSConfig.h"
 #include "GPS/GPSMessages.h"
 #include "GPS/GPSSerial.h"
 #include "GPS/GPSTypes.h"
@@ -93,18 +93,7 @@ float i2c_ads1015_read_mux(const int busHandle, const int devAddr, const uint16_
 	if (ioctl(busHandle, I2C_SLAVE, devAddr) < 0) { return NAN; }
 
 	uint16_t pga = ADS1015_CONFIG_PGA_DEFAULT;
-	float min = -INFINITY;
-	float max = INFINITY;
-	float scale = 1.0;
-	float offset = 0;
-
-	if (opts) {
-		min = opts->min;
-		max = opts->max;
-		scale = opts->scale;
-		offset = opts->offset;
-		pga = opts->pga;
-	}
+	if (opts) { pga = opts->pga; }
 
 	while (!(i2c_ads1015_read_configuration(busHandle, devAddr) & ADS1015_CONFIG_STATE_CONVERT)) {
 		usleep(100);
@@ -133,8 +122,36 @@ float i2c_ads1015_read_mux(const int busHandle, const int devAddr, const uint16_
 	int32_t res = i2c_smbus_read_word_data(busHandle, ADS1015_REG_RESULT);
 	if (res < 0) { return NAN; }
 
-	uint16_t sres = i2c_swapbytes(res);
-	sres = (sres & 0xFFF0) >> 4;
+	return i2c_ads1015_convert(i2c_swapbytes(res), opts);
+}
+
+/*!
+ * Convert the contents of the conversion register (in host byte order) to a
+ * voltage, then apply scale, offset and limits from the options structure.
+ *
+ * The PGA setting must match the one used for the conversion.
+ *
+ * @param[in] raw Conversion register contents
+ * @param[in] opts Pointer to i2c_ads1015_options structure, or NULL for defaults
+ * @returns Scaled voltage value, or NAN if outside configured limits
+ */
+float i2c_ads1015_convert(const uint16_t raw, const void *opts) {
+	const i2c_ads1015_options *o = (const i2c_ads1015_options *)opts;
+	uint16_t pga = ADS1015_CONFIG_PGA_DEFAULT;
+	float min = -INFINITY;
+	float max = INFINITY;
+	float scale = 1.0;
+	float offset = 0;
+
+	if (o) {
+		min = o->min;
+		max = o->max;
+		scale = o->scale;
+		offset = o->offset;
+		pga = o->pga;
+	}
+
+	uint16_t sres = (raw & 0xFFF0) >> 4;
 
 	float sv = i2c_ads1015_pga_to_scale_factor(pga);
 
@@ -152,6 +169,97 @@ float i2c_ads1015_read_mux(const int busHandle, const int devAddr, const uint16_
 	return adcV;
 }
 
+/*!
+ * @param[in] config Configuration word or ADS1015_CONFIG_DRATE_ constant
+ * @return Samples per second
+ */
+int i2c_ads1015_rate_to_sps(const uint16_t config) {
+	const int sps[] = {128, 250, 490, 920, 1600, 2400, 3300, 3300};
+	return sps[(config & ADS1015_CONFIG_DRATE_SELECT) >> 5];
+}
+
+/*!
+ * Reconfigure an ADS1015 device for continuous conversions using the provided
+ * mux setting, with PGA and data rate taken from the options structure.
+ *
+ * Conversions continue in the background, and the latest result can be read
+ * from the conversion register (ADS1015_REG_RESULT) at any time. The first
+ * result for the new mux setting is available after one conversion period,
+ * which is returned (with a margin for oscillator tolerance) so that callers
+ * can start conversions on multiple devices before waiting.
+ *
+ * @param[in] busHandle Handle from i2c_openConnection()
+ * @param[in] devAddr I2C Address for an ADS1015 sensor
+ * @param[in] mux ADS1015_CONFIG_MUX_ constant to select measurement to be performed
+ * @param[in] opts Pointer to i2c_ads1015_options structure
+ * @returns Delay until result is available [us], or -1 on error
+ */
+int i2c_ads1015_start_mux(const int busHandle, const int devAddr, const uint16_t mux,
+                          const i2c_ads1015_options *opts) {
+	uint16_t pga = ADS1015_CONFIG_PGA_DEFAULT;
+	uint16_t rate = ADS1015_CONFIG_DRATE_1600;
+	if (opts) {
+		pga = opts->pga;
+		rate = opts->rate;
+	}
+
+	uint16_t config = (ADS1015_CONFIG_DEFAULT & ADS1015_CONFIG_MUX_CLEAR & ADS1015_CONFIG_PGA_CLEAR &
+	                   ADS1015_CONFIG_MODE_CLEAR & ADS1015_CONFIG_DRATE_CLEAR);
+	config |= (mux & ADS1015_CONFIG_MUX_SELECT) | (pga & ADS1015_CONFIG_PGA_SELECT) |
+	          (rate & ADS1015_CONFIG_DRATE_SELECT) | ADS1015_CONFIG_MODE_CONTIN;
+
+	if (!i2c_write_register(busHandle, devAddr, ADS1015_REG_CONFIG, config)) { return -1; }
+	return (1100000 / i2c_ads1015_rate_to_sps(rate)) + 50;
+}
+
+/*!
+ * Wrapper around i2c_ads1015_start_mux()
+ *
+ * @param[in] busHandle Handle from i2c_openConnection()
+ * @param[in] devAddr I2C Address for an ADS1015 ADC
+ * @param[in] opts Pointer to i2c_ads1015_options structure
+ * @return Delay until result is available [us], or -1 on error
+ */
+int i2c_ads1015_start_ch0(const int busHandle, const int devAddr, const void *opts) {
+	return i2c_ads1015_start_mux(busHandle, devAddr, ADS1015_CONFIG_MUX_SINGLE_0, opts);
+}
+
+/*!
+ * Wrapper around i2c_ads1015_start_mux()
+ *
+ * @param[in] busHandle Handle from i2c_openConnection()
+ * @param[in] devAddr I2C Address for an ADS1015 ADC
+ * @param[in] opts Pointer to i2c_ads1015_options structure
+ * @return Delay until result is available [us], or -1 on error
+ */
+int i2c_ads1015_start_ch1(const int busHandle, const int devAddr, const void *opts) {
+	return i2c_ads1015_start_mux(busHandle, devAddr, ADS1015_CONFIG_MUX_SINGLE_1, opts);
+}
+
+/*!
+ * Wrapper around i2c_ads1015_start_mux()
+ *
+ * @param[in] busHandle Handle from i2c_openConnection()
+ * @param[in] devAddr I2C Address for an ADS1015 ADC
+ * @param[in] opts Pointer to i2c_ads1015_options structure
+ * @return Delay until result is available [us], or -1 on error
+ */
+int i2c_ads1015_start_ch2(const int busHandle, const int devAddr, const void *opts) {
+	return i2c_ads1015_start_mux(busHandle, devAddr, ADS1015_CONFIG_MUX_SINGLE_2, opts);
+}
+
+/*!
+ * Wrapper around i2c_ads1015_start_mux()
+ *
+ * @param[in] busHandle Handle from i2c_openConnection()
+ * @param[in] devAddr I2C Address for an ADS1015 ADC
+ * @param[in] opts Pointer to i2c_ads1015_options structure
+ * @return Delay until result is available [us], or -1 on error
+ */
+int i2c_ads1015_start_ch3(const int busHandle, const int devAddr, const void *opts) {
+	return i2c_ads1015_start_mux(busHandle, devAddr, ADS1015_CONFIG_MUX_SINGLE_3, opts);
+}
+
 /*!
  * Wrapper around i2c_ads1015_read_mux()
  *
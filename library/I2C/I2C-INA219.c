@@ -68,10 +68,9 @@ uint16_t i2c_ina219_read_configuration(const int busHandle, const int devAddr) {
  * Connects to specified device address, reads the contents of the shunt
  * voltage register and converts the value to a floating point number.
  *
- * Out of range values are pinned to zero.
- *
  * @param[in] busHandle Handle from i2c_openConnection()
  * @param[in] devAddr I2C Address for an INA219 sensor
+ * @param[in] opts Pointer to i2c_ina219_options structure, or NULL
  * @return Shunt voltage in millivolts, or NAN on error
  */
 float i2c_ina219_read_shuntVoltage(const int busHandle, const int devAddr, const void *opts) {
@@ -80,24 +79,7 @@ float i2c_ina219_read_shuntVoltage(const int busHandle, const int devAddr, const
 
 	int32_t res = i2c_smbus_read_word_data(busHandle, INA219_REG_SHUNT);
 	if (res < 0) { return NAN; }
-
-	uint16_t sres = i2c_swapbytes(res);
-	float shuntV = 0;
-	if ((sres & 0x8000)) {
-		uint16_t t = (sres & 0x7FFF) + 1;
-		shuntV = ~t * 1E-2;
-	} else {
-		shuntV = (sres & 0x7FFF) * 1E-2;
-	}
-
-	if (shuntV > 320.0 || shuntV < -320.0) { return NAN; }
-	if (opts) {
-		i2c_ina219_options *o = (i2c_ina219_options *)opts;
-		float t = shuntV * o->scale + o->offset;
-		if ((t < o->min) || (t > o->max)) { return NAN; }
-		return t;
-	}
-	return shuntV; // If no options supplied, return unscaled value
+	return i2c_ina219_convert_shuntVoltage(i2c_swapbytes(res), opts);
 }
 
 /*!
@@ -106,10 +88,9 @@ float i2c_ina219_read_shuntVoltage(const int busHandle, const int devAddr, const
  *
  * Bus voltage is measured at the V- terminal.
  *
- * If the overflow or invalid data flags are set, will return NAN
- *
  * @param[in] busHandle Handle from i2c_openConnection()
  * @param[in] devAddr I2C Address for an INA219 sensor
+ * @param[in] opts Pointer to i2c_ina219_options structure, or NULL
  * @return Bus voltage in volts, or NAN in case of error
  */
 float i2c_ina219_read_busVoltage(const int busHandle, const int devAddr, const void *opts) {
@@ -118,19 +99,7 @@ float i2c_ina219_read_busVoltage(const int busHandle, const int devAddr, const v
 
 	int32_t res = i2c_smbus_read_word_data(busHandle, INA219_REG_BUS);
 	if (res < 0) { return NAN; }
-
-	uint16_t sres = i2c_swapbytes(res);
-	uint8_t flags = (sres & 0x03);
-	if ((flags & 0x01) || !(flags & 0x02)) { return NAN; }
-
-	float busV = (sres >> 3) * 4E-3;
-	if (opts) {
-		i2c_ina219_options *o = (i2c_ina219_options *)opts;
-		float t = busV * o->scale + o->offset;
-		if ((t < o->min) || (t > o->max)) { return NAN; }
-		return t;
-	}
-	return busV;
+	return i2c_ina219_convert_busVoltage(i2c_swapbytes(res), opts);
 }
 
 /*!
@@ -143,6 +112,7 @@ float i2c_ina219_read_busVoltage(const int busHandle, const int devAddr, const v
  *
  * @param[in] busHandle Handle from i2c_openConnection()
  * @param[in] devAddr I2C Address for an INA219 sensor
+ * @param[in] opts Pointer to i2c_ina219_options structure, or NULL
  * @return Power consumption in watts, or NAN in case of error
  */
 float i2c_ina219_read_power(const int busHandle, const int devAddr, const void *opts) {
@@ -151,15 +121,7 @@ float i2c_ina219_read_power(const int busHandle, const int devAddr, const void *
 
 	int32_t res = i2c_smbus_read_word_data(busHandle, INA219_REG_POWER);
 	if (res < 0) { return NAN; }
-	uint16_t sres = i2c_swapbytes(res);
-	float power = sres * 2E-3;
-	if (opts) {
-		i2c_ina219_options *o = (i2c_ina219_options *)opts;
-		float t = power * o->scale + o->offset;
-		if ((t < o->min) || (t > o->max)) { return NAN; }
-		return t;
-	}
-	return power;
+	return i2c_ina219_convert_power(i2c_swapbytes(res), opts);
 }
 
 /*!
@@ -168,6 +130,7 @@ float i2c_ina219_read_power(const int busHandle, const int devAddr, const void *
  *
  * @param[in] busHandle Handle from i2c_openConnection()
  * @param[in] devAddr I2C Address for an INA219 sensor
+ * @param[in] opts Pointer to i2c_ina219_options structure, or NULL
  * @return Measured current in amperes, or NAN in case of error
  */
 float i2c_ina219_read_current(const int busHandle, const int devAddr, const void *opts) {
@@ -176,19 +139,83 @@ float i2c_ina219_read_current(const int busHandle, const int devAddr, const void
 
 	int32_t res = i2c_smbus_read_word_data(busHandle, INA219_REG_CURRENT);
 	if (res < 0) { return NAN; }
-	uint16_t sres = i2c_swapbytes(res);
+	return i2c_ina219_convert_current(i2c_swapbytes(res), opts);
+}
+
+/*!
+ * Apply scale, offset and limits from an options structure (if provided)
+ *
+ * @param[in] value Unscaled value
+ * @param[in] opts Pointer to i2c_ina219_options structure, or NULL
+ * @return Scaled value, or NAN if outside configured limits
+ */
+static float i2c_ina219_apply_options(const float value, const void *opts) {
+	if (!opts) { return value; }
+	const i2c_ina219_options *o = (const i2c_ina219_options *)opts;
+	float t = value * o->scale + o->offset;
+	if ((t < o->min) || (t > o->max)) { return NAN; }
+	return t;
+}
+
+/*!
+ * The INA219 samples continuously, so the shunt voltage register can be read
+ * at any time once the device has been configured with i2c_ina219_configure().
+ *
+ * Out of range values are replaced with NAN.
+ *
+ * @param[in] raw Shunt voltage register contents (host byte order)
+ * @param[in] opts Pointer to i2c_ina219_options structure, or NULL
+ * @return Shunt voltage in millivolts, or NAN on error
+ */
+float i2c_ina219_convert_shuntVoltage(const uint16_t raw, const void *opts) {
+	float shuntV = 0;
+	if ((raw & 0x8000)) {
+		uint16_t t = (raw & 0x7FFF) + 1;
+		shuntV = ~t * 1E-2;
+	} else {
+		shuntV = (raw & 0x7FFF) * 1E-2;
+	}
+
+	if (shuntV > 320.0 || shuntV < -320.0) { return NAN; }
+	return i2c_ina219_apply_options(shuntV, opts);
+}
+
+/*!
+ * If the overflow or invalid data flags are set, will return NAN
+ *
+ * @param[in] raw Bus voltage register contents (host byte order)
+ * @param[in] opts Pointer to i2c_ina219_options structure, or NULL
+ * @return Bus voltage in volts, or NAN in case of error
+ */
+float i2c_ina219_convert_busVoltage(const uint16_t raw, const void *opts) {
+	uint8_t flags = (raw & 0x03);
+	if ((flags & 0x01) || !(flags & 0x02)) { return NAN; }
+
+	float busV = (raw >> 3) * 4E-3;
+	return i2c_ina219_apply_options(busV, opts);
+}
+
+/*!
+ * @param[in] raw Power register contents (host byte order)
+ * @param[in] opts Pointer to i2c_ina219_options structure, or NULL
+ * @return Power consumption in watts, or NAN in case of error
+ */
+float i2c_ina219_convert_power(const uint16_t raw, const void *opts) {
+	return i2c_ina219_apply_options(raw * 2E-3, opts);
+}
+
+/*!
+ * @param[in] raw Current register contents (host byte order)
+ * @param[in] opts Pointer to i2c_ina219_options structure, or NULL
+ * @return Measured current in amperes, or NAN in case of error
+ */
+float i2c_ina219_convert_current(const uint16_t raw, const void *opts) {
 	float current = 0;
-	if ((sres & 0x8000)) {
-		uint16_t t = ~(sres & 0x7FFF) + 1;
+	if ((raw & 0x8000)) {
+		uint16_t t = ~(raw & 0x7FFF) + 1;
 		current = t * 1E-4;
 	} else {
-		current = (sres & 0x7FFF) * 1E-4;
-	}
-	if (opts) {
-		i2c_ina219_options *o = (i2c_ina219_options *)opts;
-		float t = current * o->scale + o->offset;
-		if ((t < o->min) || (t > o->max)) { return NAN; }
-		return t;
+		current = (raw & 0x7FFF) * 1E-4;
 	}
-	return current;
+	return i2c_ina219_apply_options(current, opts);
 }
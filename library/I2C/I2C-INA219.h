@@ -22,6 +22,7 @@
 #define SELKIELoggerI2C_INA219
 
 #include <stdbool.h>
+#include <stdint.h>
 
 /*!
  * @file I2C-INA219.h
@@ -116,5 +117,17 @@ float i2c_ina219_read_power(const int busHandle, const int devAddr, const void *
 //! Get current flow through shunt resistor in amps
 float i2c_ina219_read_current(const int busHandle, const int devAddr, const void *opts);
 
+//! Convert shunt voltage register contents to millivolts
+float i2c_ina219_convert_shuntVoltage(const uint16_t raw, const void *opts);
+
+//! Convert bus voltage register contents to volts
+float i2c_ina219_convert_busVoltage(const uint16_t raw, const void *opts);
+
+//! Convert power register contents to watts
+float i2c_ina219_convert_power(const uint16_t raw, const void *opts);
+
+//! Convert current register contents to amps
+float i2c_ina219_convert_current(const uint16_t raw, const void *opts);
+
 //! @}
 #endif
@@ -25,6 +25,10 @@
 #include <string.h>
 #include <unistd.h>
 
+#include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+#include <sys/ioctl.h>
+
 /*!
  * Opens the specified bus in read/write mode
  *
@@ -59,3 +63,65 @@ int16_t i2c_swapbytes(const int16_t in) {
 	uint16_t tmp = in;
 	return (int16_t)((tmp >> 8) + ((tmp & 0xFF) << 8));
 }
+
+/*!
+ * Each register is read by writing the register address and then reading two
+ * bytes (most significant byte first) from the device, using a repeated start
+ * condition between the two.
+ *
+ * Requests are grouped into as few I2C_RDWR ioctl calls as possible, and may
+ * address multiple devices. This avoids selecting each device in turn with
+ * I2C_SLAVE, and reduces the number of system calls required to read a set of
+ * registers.
+ *
+ * Register values are returned in host byte order, so do not need to be
+ * passed through i2c_swapbytes().
+ *
+ * @param[in] busHandle Handle from i2c_openConnection()
+ * @param[in,out] reads Array of requests, updated with register values
+ * @param[in] count Number of entries in reads
+ * @return True if all registers read successfully, false otherwise
+ */
+bool i2c_read_registers(const int busHandle, i2c_reg_read *reads, const int count) {
+	const int perCall = I2C_RDWR_IOCTL_MAX_MSGS / 2;
+	struct i2c_msg msgs[I2C_RDWR_IOCTL_MAX_MSGS] = {0};
+	uint8_t regs[I2C_RDWR_IOCTL_MAX_MSGS / 2] = {0};
+	uint8_t data[I2C_RDWR_IOCTL_MAX_MSGS / 2][2] = {0};
+
+	for (int base = 0; base < count; base += perCall) {
+		const int n = (count - base) < perCall ? (count - base) : perCall;
+		for (int i = 0; i < n; i++) {
+			regs[i] = reads[base + i].reg;
+			msgs[2 * i] = (struct i2c_msg){
+				.addr = reads[base + i].devAddr, .flags = 0, .len = 1, .buf = &(regs[i])};
+			msgs[2 * i + 1] = (struct i2c_msg){
+				.addr = reads[base + i].devAddr, .flags = I2C_M_RD, .len = 2, .buf = data[i]};
+		}
+
+		struct i2c_rdwr_ioctl_data xfer = {.msgs = msgs, .nmsgs = 2 * n};
+		if (ioctl(busHandle, I2C_RDWR, &xfer) < 0) { return false; }
+
+		for (int i = 0; i < n; i++) {
+			reads[base + i].value = (uint16_t)((data[i][0] << 8) | data[i][1]);
+		}
+	}
+	return true;
+}
+
+/*!
+ * Writes the register address followed by the value (most significant byte
+ * first) in a single I2C_RDWR transaction.
+ *
+ * @param[in] busHandle Handle from i2c_openConnection()
+ * @param[in] devAddr I2C Device address
+ * @param[in] reg Register to write
+ * @param[in] value Value to write, in host byte order
+ * @return True on success, false otherwise
+ */
+bool i2c_write_register(const int busHandle, const int devAddr, const uint8_t reg,
+                        const uint16_t value) {
+	uint8_t buf[3] = {reg, (value >> 8) & 0xFF, value & 0xFF};
+	struct i2c_msg msg = {.addr = devAddr, .flags = 0, .len = 3, .buf = buf};
+	struct i2c_rdwr_ioctl_data xfer = {.msgs = &msg, .nmsgs = 1};
+	return (ioctl(busHandle, I2C_RDWR, &xfer) >= 0);
+}
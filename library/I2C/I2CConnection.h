@@ -21,6 +21,7 @@
 #ifndef SELKIELoggerI2C_Connection
 #define SELKIELoggerI2C_Connection
 
+#include <stdbool.h>
 #include <stdint.h>
 
 /*!
@@ -36,6 +37,22 @@
 //! Device specific callback functions
 typedef float (*i2c_dev_read_fn)(const int, const int, const void *);
 
+//! Device initialisation function (bus handle, device address)
+typedef bool (*i2c_dev_init_fn)(const int, const int);
+
+//! Start a measurement, returning delay until result available [us] or -1 on error
+typedef int (*i2c_dev_start_fn)(const int, const int, const void *);
+
+//! Convert raw register contents to measurement value
+typedef float (*i2c_dev_convert_fn)(const uint16_t, const void *);
+
+//! Register read request, for use with i2c_read_registers()
+typedef struct {
+	uint8_t devAddr; //!< I2C Device address
+	uint8_t reg;     //!< Register to read
+	uint16_t value;  //!< Register contents (output)
+} i2c_reg_read;
+
 //! Set up a connection to the specified bus
 int i2c_openConnection(const char *bus);
 
@@ -44,5 +61,12 @@ void i2c_closeConnection(int handle);
 
 //! Swap word byte order
 int16_t i2c_swapbytes(const int16_t in);
+
+//! Read 16 bit registers from one or more devices using combined transactions
+bool i2c_read_registers(const int busHandle, i2c_reg_read *reads, const int count);
+
+//! Write a 16 bit register using a single transaction
+bool i2c_write_register(const int busHandle, const int devAddr, const uint8_t reg,
+                        const uint16_t value);
 //! @}
 #endif
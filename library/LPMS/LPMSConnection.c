@@ -72,7 +72,8 @@ bool lpms_readMessage(int handle, lpms_message *out) {
  * position in `index` and the current fill level/buffer high water mark in `hw`
  *
  * If a valid message is found then it is written to the structure provided as
- * a parameter and the function returns true.
+ * a parameter and the function returns true. If out->capacity is non-zero, the
+ * existing out->data array is reused for the message data.
  *
  * If a message cannot be read, the function returns false
  *
@@ -113,7 +114,8 @@ bool lpms_readMessage_buf(int handle, lpms_message *out, uint8_t buf[LPMS_BUFF],
 		return false;
 	}
 
-	lpms_message t = {0};
+	// Reuse caller supplied data array, if provided
+	lpms_message t = {.data = out->capacity ? out->data : NULL, .capacity = out->capacity};
 	bool r = lpms_from_bytes(buf, *hw, &t, index);
 	if (r) {
 		(*out) = t;
@@ -124,7 +126,7 @@ bool lpms_readMessage_buf(int handle, lpms_message *out, uint8_t buf[LPMS_BUFF],
 		} else {
 			if ((*index) < (*hw)) { (*index)++; }
 		}
-		if (t.data) { free(t.data); } // Not passing message back
+		if (t.data && !t.capacity) { free(t.data); } // Not passing message back
 	}
 
 	if ((*hw) > 0 && ((*hw) >= (*index))) {
@@ -19,6 +19,7 @@
 */
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -28,11 +29,30 @@
 
 #include <assert.h>
 
+//! Size of each IMU data field in message data, indexed by LPMS_IMU bit [bytes]
+static const uint8_t lpms_imu_sizes[LPMS_IMU_FIELDS] = {12, 12, 0,  12, 0,  12, 0, 12, 12,
+                                                        12, 12, 16, 12, 12, 4,  4, 4};
+
+//! Location of each IMU data field within lpms_data, indexed by LPMS_IMU bit
+static const size_t lpms_imu_targets[LPMS_IMU_FIELDS] = {
+	offsetof(lpms_data, accel_raw),    offsetof(lpms_data, accel_cal),
+	0,                                 offsetof(lpms_data, gyro_raw),
+	0,                                 offsetof(lpms_data, gyro_cal),
+	0,                                 offsetof(lpms_data, gyro_aligned),
+	offsetof(lpms_data, mag_raw),      offsetof(lpms_data, mag_cal),
+	offsetof(lpms_data, omega),        offsetof(lpms_data, quaternion),
+	offsetof(lpms_data, euler_angles), offsetof(lpms_data, accel_linear),
+	offsetof(lpms_data, pressure),     offsetof(lpms_data, altitude),
+	offsetof(lpms_data, temperature)};
+
 /*!
  *
  * Populate lpms_message from array of bytes, searching for valid start byte if
  * required.
  *
+ * If msg->capacity is non-zero, message data is copied into the existing
+ * msg->data array rather than a newly allocated array.
+ *
  * @param[in] in Array of bytes
  * @param[in] len Number of bytes available in array
  * @param[out] msg Pointer to lpms_message
@@ -62,7 +82,7 @@ bool lpms_from_bytes(const uint8_t *in, const size_t len, lpms_message *msg, siz
 	msg->length = in[start + 5] + ((uint16_t)in[start + 6] << 8);
 
 	if (msg->length == 0) {
-		msg->data = NULL;
+		if (msg->capacity == 0) { msg->data = NULL; }
 	} else {
 		// Check there's enough bytes in buffer to cover message header
 		// (6 bytes), footer (4 bytes), and embedded data
@@ -70,7 +90,12 @@ bool lpms_from_bytes(const uint8_t *in, const size_t len, lpms_message *msg, siz
 			msg->id = 0xFF;
 			return false;
 		}
-		msg->data = calloc(msg->length, sizeof(uint8_t));
+		if (msg->capacity == 0) {
+			msg->data = calloc(msg->length, sizeof(uint8_t));
+		} else if (msg->capacity < msg->length) {
+			msg->id = 0xAA;
+			return false;
+		}
 		if (msg->data == NULL) {
 			msg->id = 0xAA;
 			return false;
@@ -151,6 +176,66 @@ bool lpms_checksum(const lpms_message *msg, uint16_t *csum) {
 	return true;
 }
 
+/*!
+ * Fields are stored in IMU data packets in order of their bit number in the
+ * output configuration, following a 4 byte timestamp.
+ *
+ * @param[out] l Layout to populate
+ * @param[in] present Output configuration, as reported by LPMS_MSG_GET_OUTPUTS
+ * @returns True on success, false on error
+ */
+bool lpms_imu_layout_init(lpms_imu_layout *l, const uint32_t present) {
+	if (!l) { return false; }
+	l->present = 0;
+	l->count = 0;
+	uint16_t ix = 4;
+	for (int f = 0; f < LPMS_IMU_FIELDS; f++) {
+		if (lpms_imu_sizes[f] == 0 || !(present & (1U << f))) {
+			l->offset[f] = -1;
+			continue;
+		}
+		l->offset[f] = ix;
+		l->fields[l->count++] = f;
+		ix += lpms_imu_sizes[f];
+		l->present |= (1U << f);
+	}
+	l->length = ix;
+	return true;
+}
+
+/*!
+ * Extract timestamp and all fields listed in the layout from input message
+ * into data struct. On return, d->present indicates the fields extracted.
+ *
+ * If the message is shorter than expected, all complete fields are still
+ * extracted.
+ *
+ * @param[in] msg Pointer to message structure containing IMU data
+ * @param[in] l Layout calculated by lpms_imu_layout_init()
+ * @param[in,out] d Pointer to lpms_data structure to populate
+ * @returns True if timestamp and all expected fields were extracted
+ */
+bool lpms_imu_decode(const lpms_message *msg, const lpms_imu_layout *l, lpms_data *d) {
+	if (!msg || !l || !d || msg->command != LPMS_MSG_GET_IMUDATA) { return false; }
+	if (msg->length < 4) { return false; }
+
+	d->timestamp = msg->data[0] + ((uint32_t)msg->data[1] << 8) + ((uint32_t)msg->data[2] << 16) +
+	               ((uint32_t)msg->data[3] << 24);
+	d->present = 0;
+	for (int i = 0; i < l->count; i++) {
+		const uint8_t f = l->fields[i];
+		if (msg->length < (l->offset[f] + lpms_imu_sizes[f])) { break; }
+		uint8_t *target = (uint8_t *)d + lpms_imu_targets[f];
+		const uint8_t *source = &(msg->data[l->offset[f]]);
+		// Fixed size copies, which the compiler can inline
+		for (int w = 0; w < lpms_imu_sizes[f]; w += 4) {
+			memcpy(&(target[w]), &(source[w]), 4);
+		}
+		d->present |= (1U << f);
+	}
+	return (d->present == l->present);
+}
+
 /*!
  * Extract timestamp from input message into data struct.
  *
@@ -94,6 +94,12 @@ bool lpms_to_bytes(const lpms_message *msg, uint8_t **out, size_t *len);
 //! Calculate checksum for LPMS message packet
 bool lpms_checksum(const lpms_message *msg, uint16_t *csum);
 
+//! Calculate IMU data field offsets for a given output configuration
+bool lpms_imu_layout_init(lpms_imu_layout *l, const uint32_t present);
+
+//! Extract all available IMU data from lpms_message into lpms_data in a single pass
+bool lpms_imu_decode(const lpms_message *msg, const lpms_imu_layout *l, lpms_data *d);
+
 //! Extract timestamp from lpms_message into lpms_data, if available
 bool lpms_imu_set_timestamp(const lpms_message *msg, lpms_data *d);
 //! Extract accel_raw from lpms_message into lpms_data, if available
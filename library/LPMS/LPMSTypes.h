@@ -44,6 +44,10 @@
  *
  * When transmitted, an initial LPMS_START byte precedes the message and
  * LPMS_END1 and LPMS_END2 are appended.
+ *
+ * If `capacity` is zero, `data` is allocated for each message received and
+ * must be freed by the caller. Otherwise, `data` is assumed to point to a
+ * caller owned array of `capacity` bytes that is reused for each message.
  */
 typedef struct {
 	uint16_t id;       //!< Source/Destination Sensor ID
@@ -51,6 +55,7 @@ typedef struct {
 	uint16_t length;   //!< Length of data, in bytes
 	uint16_t checksum; //!< Sum of all preceding message bytes
 	uint8_t *data;     //!< Pointer to data array
+	uint16_t capacity; //!< Size of caller supplied data array, or 0 to allocate per message
 } lpms_message;
 
 // While it is unlikely that this wouldn't be true on any supported system, the
@@ -113,7 +118,25 @@ typedef struct {
 #define LPMS_IMU_TEMPERATURE  16 //!< temperature will contain data
 
 #define LPMS_HAS(x, y)        (((x) & (1 << y)) == (1 << y)) //!< Check if masked bit is/bits are set
+
+#define LPMS_IMU_FIELDS       17 //!< Number of possible field bits in IMU data packets
 //! @}
 
+/*!
+ * @brief Location of fields in LPMS IMU data packets
+ *
+ * The fields present in each IMU data packet are fixed by the output
+ * configuration, so their offsets can be calculated once when the
+ * configuration is received (see lpms_imu_layout_init()) and then used to
+ * decode each packet in a single pass (see lpms_imu_decode()).
+ */
+typedef struct {
+	uint32_t present;                //!< Output configuration used to calculate offsets
+	int16_t offset[LPMS_IMU_FIELDS]; //!< Offset of each field in message data (-1 if absent)
+	uint8_t fields[LPMS_IMU_FIELDS]; //!< Bit numbers of fields present, in packet order
+	uint8_t count;                   //!< Number of entries in fields[]
+	uint16_t length;                 //!< Expected message data length
+} lpms_imu_layout;
+
 //! @}
 #endif
@@ -91,6 +91,10 @@ bool mp_readMessage(int handle, msg_t *out) {
  * - 0xAA means that an error occurred reading in data
  * - 0XEE means a valid message header was found, but no valid message
  *
+ * Messages are parsed from the buffer by mp_decodeMessage_buf(). Invalid data
+ * skipped by that function is reported as 0xFF here, as callers can simply
+ * try again.
+ *
  * @param[in] handle File descriptor from mp_openConnection()
  * @param[out] out Pointer to message structure to fill with data
  * @param[in,out] buf Serial data buffer
@@ -101,6 +105,13 @@ bool mp_readMessage(int handle, msg_t *out) {
 bool mp_readMessage_buf(int handle, msg_t *out, uint8_t buf[MP_SERIAL_BUFF], int *index, int *hw) {
 	int ti = 0;
 	if (out == NULL || (*index) < 0 || (*hw) < 0 || buf == NULL) { return false; }
+	if ((*index) > 0) {
+		// Move remaining data back to zero position
+		memmove(buf, &(buf[(*index)]), (*hw) - (*index));
+		(*hw) -= (*index);
+		(*index) = 0;
+	}
+
 	if ((*hw) < MP_SERIAL_BUFF - 1) {
 		errno = 0;
 		ti = read(handle, &(buf[(*hw)]), MP_SERIAL_BUFF - (*hw));
@@ -118,29 +129,50 @@ bool mp_readMessage_buf(int handle, msg_t *out, uint8_t buf[MP_SERIAL_BUFF], int
 		}
 	}
 
+	if (mp_decodeMessage_buf(out, buf, index, (*hw))) { return true; }
+
+	if (out->data.value == 0xEE) {
+		out->data.value = 0xFF;
+	} else if (ti == 0) {
+		out->data.value = 0xFD;
+	}
+	return false;
+}
+
+/*!
+ * Parses the next message from data already held in a buffer, without
+ * reading any more data or moving the data within the buffer. This allows
+ * callers that read data by other means (e.g. from a network connection) to
+ * extract all complete messages from each read.
+ *
+ * The message is unpacked directly from the buffer. Any data before the start
+ * of the message is skipped, and `index` is advanced past the message if one
+ * is found. Once `index` reaches `hw`, all data in the buffer has been used.
+ *
+ * If a message cannot be decoded, the function returns false and the float
+ * value field is set to an error value:
+ * - 0xFF means no complete message is available, and more data is required
+ * - 0xEE means invalid data was found and skipped, so the caller should try again
+ *
+ * @param[out] out Pointer to message structure to fill with data
+ * @param[in] buf Data buffer
+ * @param[in,out] index Current search position within `buf`
+ * @param[in] hw End of current valid data in `buf`
+ * @return True if out now contains a valid message, false otherwise.
+ */
+bool mp_decodeMessage_buf(msg_t *out, const uint8_t *buf, int *index, const int hw) {
+	if (out == NULL || buf == NULL || (*index) < 0 || hw < 0) { return false; }
+
 	// Check buf[index] is valid ID
-	while (!(buf[(*index)] == MP_SYNC_BYTE1) && (*index) < (*hw)) {
+	while ((*index) < hw && buf[(*index)] != MP_SYNC_BYTE1) {
 		(*index)++; // Current byte cannot be start of a message, so advance
 	}
-	if ((*index) == (*hw)) {
-		if ((*hw) > 0 && (*index) > 0) {
-			// Move data from index back to zero position
-			memmove(buf, &(buf[(*index)]), MP_SERIAL_BUFF - (*index));
-			(*hw) -= (*index);
-			(*index) = 0;
-		}
-		// fprintf(stderr, "Buffer empty - returning\n");
-		out->dtype = MSG_ERROR;
-		out->data.value = 0xFF;
-		if (ti == 0) { out->data.value = 0xFD; }
-		return false;
-	}
 
-	if (((*hw) - (*index)) < 8) {
-		// Not enough data for any valid message, come back later
+	if ((hw - (*index)) < 5) {
+		// Not enough data for any valid message (array marker and four
+		// single byte values), come back later
 		out->dtype = MSG_ERROR;
 		out->data.value = 0xFF;
-		if (ti == 0) { out->data.value = 0xFD; }
 		return false;
 	}
 
@@ -149,34 +181,27 @@ bool mp_readMessage_buf(int handle, msg_t *out, uint8_t buf[MP_SERIAL_BUFF], int
 		// Advance the index so we skip this message and go back around
 		(*index)++;
 		out->dtype = MSG_ERROR;
-		out->data.value = 0xFF;
+		out->data.value = 0xEE;
 		return false;
 	}
 
 	// We now know we have a good candidate for a valid MessagePacked message
-	msgpack_unpacker unpack;
-	if (!msgpack_unpacker_init(&unpack, 64 + (*hw) - (*index))) {
-		out->dtype = MSG_ERROR;
-		out->data.value = 0xAA;
-		fprintf(stderr, "Unable to initialise msgpack unpacker\n");
-		return false;
-	}
-	const size_t upInitialOffset = unpack.off;
-	memcpy(msgpack_unpacker_buffer(&unpack), &(buf[(*index)]), (*hw) - (*index));
-	msgpack_unpacker_buffer_consumed(&unpack, (*hw) - (*index));
-
-	msgpack_unpacked mpupd = {0};
+	msgpack_unpacked mpupd;
+	msgpack_unpacked_init(&mpupd);
+	size_t used = 0;
 	{
-		msgpack_unpack_return rs = msgpack_unpacker_next(&unpack, &mpupd);
+		msgpack_unpack_return rs = msgpack_unpack_next(&mpupd, (const char *)&(buf[(*index)]),
+		                                               hw - (*index), &used);
 		switch (rs) {
 			case MSGPACK_UNPACK_SUCCESS:
+			case MSGPACK_UNPACK_EXTRA_BYTES:
 				// Will continue after the switch
 				break;
 			case MSGPACK_UNPACK_CONTINUE:
 				// Need more data
 				out->dtype = MSG_ERROR;
 				out->data.value = 0xFF;
-				msgpack_unpacker_destroy(&unpack);
+				msgpack_unpacked_destroy(&mpupd);
 				// Could still be a good message, so do not advance index
 				return false;
 
@@ -184,8 +209,8 @@ bool mp_readMessage_buf(int handle, msg_t *out, uint8_t buf[MP_SERIAL_BUFF], int
 			default:
 				// Treat any unknown status as an error
 				out->dtype = MSG_ERROR;
-				out->data.value = 0xFF;
-				msgpack_unpacker_destroy(&unpack);
+				out->data.value = 0xEE;
+				msgpack_unpacked_destroy(&mpupd);
 				(*index)++; // Assume bad message, so advance 1 byte
 				            // further into buffer
 				return false;
@@ -194,8 +219,7 @@ bool mp_readMessage_buf(int handle, msg_t *out, uint8_t buf[MP_SERIAL_BUFF], int
 		if (mpupd.data.type != MSGPACK_OBJECT_ARRAY || mpupd.data.via.array.size != 4) {
 			msgpack_unpacked_destroy(&mpupd);
 			out->dtype = MSG_ERROR;
-			out->data.value = 0xFF;
-			msgpack_unpacker_destroy(&unpack);
+			out->data.value = 0xEE;
 			(*index)++;
 			return false;
 		}
@@ -212,8 +236,7 @@ bool mp_readMessage_buf(int handle, msg_t *out, uint8_t buf[MP_SERIAL_BUFF], int
 	if (inArr[0].type != MSGPACK_OBJECT_POSITIVE_INTEGER || inArr[0].via.u64 != MP_SYNC_BYTE2) {
 		msgpack_unpacked_destroy(&mpupd);
 		out->dtype = MSG_ERROR;
-		out->data.value = 0xFF;
-		msgpack_unpacker_destroy(&unpack);
+		out->data.value = 0xEE;
 		(*index)++;
 		return false;
 	}
@@ -222,8 +245,7 @@ bool mp_readMessage_buf(int handle, msg_t *out, uint8_t buf[MP_SERIAL_BUFF], int
 	if (inArr[1].type != MSGPACK_OBJECT_POSITIVE_INTEGER || inArr[1].via.u64 >= 128) {
 		msgpack_unpacked_destroy(&mpupd);
 		out->dtype = MSG_ERROR;
-		out->data.value = 0xFF;
-		msgpack_unpacker_destroy(&unpack);
+		out->data.value = 0xEE;
 		(*index)++;
 		return false;
 	}
@@ -233,8 +255,7 @@ bool mp_readMessage_buf(int handle, msg_t *out, uint8_t buf[MP_SERIAL_BUFF], int
 	if (inArr[2].type != MSGPACK_OBJECT_POSITIVE_INTEGER || inArr[2].via.u64 >= 128) {
 		msgpack_unpacked_destroy(&mpupd);
 		out->dtype = MSG_ERROR;
-		out->data.value = 0xFF;
-		msgpack_unpacker_destroy(&unpack);
+		out->data.value = 0xEE;
 		(*index)++;
 		return false;
 	}
@@ -266,6 +287,8 @@ bool mp_readMessage_buf(int handle, msg_t *out, uint8_t buf[MP_SERIAL_BUFF], int
 			valid = str_update(&(out->data.string), inArr[3].via.str.size, inArr[3].via.str.ptr);
 			break;
 		case MSGPACK_OBJECT_ARRAY:
+			// Empty arrays can't be identified
+			if (inArr[3].via.array.size == 0) { break; }
 			// Switch based on first item type
 			switch (inArr[3].via.array.ptr[0].type) {
 				case MSGPACK_OBJECT_STR:
@@ -299,20 +322,13 @@ bool mp_readMessage_buf(int handle, msg_t *out, uint8_t buf[MP_SERIAL_BUFF], int
 			break;
 	}
 
-	(*index) += (unpack.off - upInitialOffset);
+	(*index) += used;
 	msgpack_unpacked_destroy(&mpupd);
-	msgpack_unpacker_destroy(&unpack);
 
-	if ((*hw) > 0) {
-		// Move data from index back to zero position
-		memmove(buf, &(buf[(*index)]), MP_SERIAL_BUFF - (*index));
-		(*hw) -= (*index);
-		(*index) = 0;
-	}
 	if (valid == false) {
 		out->dtype = MSG_ERROR;
-		out->data.value = 0xFF; // Invalid message
-		                        // Index already incremented and reset above
+		out->data.value = 0xEE; // Invalid message
+		                        // Index already advanced past message above
 	}
 	return valid;
 }
@@ -21,6 +21,7 @@
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include "MQTTConnection.h"
 
@@ -123,12 +124,19 @@ bool mqtt_subscribe_batch(mqtt_conn *conn, mqtt_queue_map *qm) {
  * called by the mosquitto event loop for every message matching our
  * subscriptions.
  *
+ * Topics are matched to the configuration using mqtt_find_topic(), which
+ * also assigns channels to topics matching wildcard subscriptions.
+ *
  * If mqtt_queue_map.dumpall is true, messages not matching a configured topic
  * will be queued under SLCHAN_RAW as strings with the format "topic: payload".
  * Otherwise they will be ignored.
  *
  * Zero length messages are never queued.
  *
+ * Messages are passed to mqtt_queue_map.deliver if set, or queued to
+ * mqtt_queue_map.q otherwise. In either case, they are tagged with the
+ * CLOCK_MONOTONIC time at which they were received (msg_t.captured).
+ *
  * @param[in] conn Pointer to MQTT Connection structure
  * @param[in] userdat_qm mqtt_queue_map - passed as void pointer by mosquitto library
  * @param[in] inmsg Incoming message
@@ -138,15 +146,13 @@ void mqtt_enqueue_messages(mqtt_conn *conn, void *userdat_qm, const struct mosqu
 
 	mqtt_queue_map *qm = (mqtt_queue_map *)(userdat_qm);
 
-	int ix = -1;
-	for (int m = 0; m < qm->numtopics; m++) {
-		if (strcasecmp(inmsg->topic, qm->tc[m].topic) == 0) {
-			// Found it!
-			ix = m;
-			break;
-		}
-	}
+	struct timespec now = {0};
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
 	if (inmsg->payloadlen == 0) { return; } // Don't queue zero sized messages
+
+	uint8_t type = 0;
+	const int ix = mqtt_find_topic(qm, inmsg->topic, &type);
 	msg_t *out = NULL;
 	if (ix < 0) {
 		// Not a message we want
@@ -166,14 +172,30 @@ void mqtt_enqueue_messages(mqtt_conn *conn, void *userdat_qm, const struct mosqu
 	} else {
 		// This message is needed and has an allocated channel number
 		if (qm->tc[ix].text) {
-			out = msg_new_string(qm->sourceNum, qm->tc[ix].type, inmsg->payloadlen, inmsg->payload);
+			out = msg_new_string(qm->sourceNum, type, inmsg->payloadlen, inmsg->payload);
 		} else {
 			float val = strtof(inmsg->payload, NULL);
-			out = msg_new_float(qm->sourceNum, qm->tc[ix].type, val);
+			out = msg_new_float(qm->sourceNum, type, val);
 		}
 	}
+	if (out == NULL) {
+		perror("mqtt_enqueue_messages:msg_new");
+		return;
+	}
+	out->captured = (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+
+	if (qm->deliver) {
+		if (!qm->deliver(qm->deliverData, out)) {
+			perror("mqtt_enqueue_messages:deliver");
+			msg_destroy(out);
+			free(out);
+		}
+		return;
+	}
 	if (!queue_push(&qm->q, out)) {
 		perror("mqtt_enqueue_messages:queue_push");
+		msg_destroy(out);
+		free(out);
 		return;
 	}
 	return;
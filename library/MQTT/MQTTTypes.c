@@ -18,9 +18,13 @@
  *  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <ctype.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <strings.h>
 
 #include "MQTTTypes.h"
 
@@ -28,16 +32,19 @@
  * mqtt_queue_map structure must be allocated by caller.
  *
  * @param[in] qm mqtt_queue_map to initialise
- * @return True on success (currently unconditionally)
+ * @return True on success, false if lock could not be initialised
  */
 bool mqtt_init_queue_map(mqtt_queue_map *qm) {
 	queue_init(&qm->q);
 	qm->numtopics = 0;
-	for (int i = 0; i < 120; i++) {
-		qm->tc[i].topic = NULL;
-		qm->tc[i].name = NULL;
-	}
-	return true;
+	qm->tc = NULL;
+	qm->table = NULL;
+	qm->tableSize = 0;
+	qm->tableEntries = 0;
+	qm->deliver = NULL;
+	qm->deliverData = NULL;
+	atomic_init(&qm->remapped, false);
+	return (pthread_mutex_init(&qm->lock, NULL) == 0);
 }
 
 /*!
@@ -47,7 +54,7 @@ bool mqtt_init_queue_map(mqtt_queue_map *qm) {
  */
 void mqtt_destroy_queue_map(mqtt_queue_map *qm) {
 	queue_destroy(&qm->q);
-	for (int i = 0; i < 120; i++) {
+	for (int i = 0; i < qm->numtopics; i++) {
 		if (qm->tc[i].topic) {
 			free(qm->tc[i].topic);
 			qm->tc[i].topic = NULL;
@@ -56,5 +63,283 @@ void mqtt_destroy_queue_map(mqtt_queue_map *qm) {
 			free(qm->tc[i].name);
 			qm->tc[i].name = NULL;
 		}
+		if (qm->tc[i].assigned) {
+			// Topic strings are owned by the lookup table
+			free(qm->tc[i].assigned);
+			qm->tc[i].assigned = NULL;
+		}
+	}
+	free(qm->tc);
+	qm->tc = NULL;
+	qm->numtopics = 0;
+
+	for (size_t b = 0; b < qm->tableSize; b++) {
+		mqtt_topic_entry *e = qm->table[b];
+		while (e) {
+			mqtt_topic_entry *n = e->next;
+			free(e->topic);
+			free(e);
+			e = n;
+		}
+	}
+	free(qm->table);
+	qm->table = NULL;
+	qm->tableSize = 0;
+	qm->tableEntries = 0;
+	pthread_mutex_destroy(&qm->lock);
+}
+
+/*!
+ * Case insensitive FNV-1a hash, to match the case insensitive topic
+ * comparisons used elsewhere.
+ *
+ * @param[in] topic Topic string
+ * @returns Hash value
+ */
+uint32_t mqtt_topic_hash(const char *topic) {
+	uint32_t h = 2166136261U;
+	for (const unsigned char *c = (const unsigned char *)topic; *c; c++) {
+		h ^= tolower(*c);
+		h *= 16777619U;
+	}
+	return h;
+}
+
+/*!
+ * @param[in] qm mqtt_queue_map containing lookup table
+ * @param[in] topic Topic to find
+ * @returns Pointer to table entry, or NULL if not found
+ */
+mqtt_topic_entry *mqtt_table_find(mqtt_queue_map *qm, const char *topic) {
+	if (qm->tableSize == 0) { return NULL; }
+	mqtt_topic_entry *e = qm->table[mqtt_topic_hash(topic) & (qm->tableSize - 1)];
+	while (e) {
+		if (strcasecmp(e->topic, topic) == 0) { return e; }
+		e = e->next;
+	}
+	return NULL;
+}
+
+/*!
+ * The table is doubled in size whenever the number of entries exceeds the
+ * number of buckets.
+ *
+ * @param[in] qm mqtt_queue_map containing lookup table
+ * @param[in] topic Topic to add (copied)
+ * @param[in] config Matching index into mqtt_queue_map.tc, or -1
+ * @param[in] type Channel number
+ * @returns Pointer to new entry, or NULL on error
+ */
+mqtt_topic_entry *mqtt_table_add(mqtt_queue_map *qm, const char *topic, const int config,
+                                 const uint8_t type) {
+	if (qm->tableEntries >= qm->tableSize) {
+		const size_t ns = qm->tableSize ? qm->tableSize * 2 : MQTT_TOPIC_BUCKETS;
+		mqtt_topic_entry **nt = calloc(ns, sizeof(mqtt_topic_entry *));
+		if (nt == NULL) { return NULL; }
+		for (size_t b = 0; b < qm->tableSize; b++) {
+			mqtt_topic_entry *e = qm->table[b];
+			while (e) {
+				mqtt_topic_entry *n = e->next;
+				const size_t nb = mqtt_topic_hash(e->topic) & (ns - 1);
+				e->next = nt[nb];
+				nt[nb] = e;
+				e = n;
+			}
+		}
+		free(qm->table);
+		qm->table = nt;
+		qm->tableSize = ns;
+	}
+
+	mqtt_topic_entry *e = calloc(1, sizeof(mqtt_topic_entry));
+	if (e == NULL) { return NULL; }
+	e->topic = strdup(topic);
+	if (e->topic == NULL) {
+		free(e);
+		return NULL;
+	}
+	e->config = config;
+	e->type = type;
+	const size_t b = mqtt_topic_hash(topic) & (qm->tableSize - 1);
+	e->next = qm->table[b];
+	qm->table[b] = e;
+	qm->tableEntries++;
+	return e;
+}
+
+/*!
+ * Topics without wildcards are added to the lookup table immediately, and
+ * must not duplicate an existing topic.
+ *
+ * Topics containing wildcards reserve `count` channels, which are assigned
+ * to matching topics by mqtt_find_topic() as they are received. Topics
+ * without wildcards must have a count of 1.
+ *
+ * @param[in] qm mqtt_queue_map to update
+ * @param[in] topic Topic to subscribe to
+ * @param[in] name Channel name
+ * @param[in] first Channel number for first (or only) channel
+ * @param[in] count Number of channels to reserve
+ * @param[in] text Treat received data as text
+ * @return True on success, false on error
+ */
+bool mqtt_add_topic(mqtt_queue_map *qm, const char *topic, const char *name, const uint8_t first,
+                    const uint8_t count, const bool text) {
+	if (qm == NULL || topic == NULL || name == NULL || count == 0) { return false; }
+	const bool wildcard = (strpbrk(topic, "+#") != NULL);
+	if (!wildcard && (count != 1 || mqtt_table_find(qm, topic))) { return false; }
+
+	mqtt_topic_config *tc = realloc(qm->tc, (qm->numtopics + 1) * sizeof(mqtt_topic_config));
+	if (tc == NULL) { return false; }
+	qm->tc = tc;
+
+	mqtt_topic_config *t = &(qm->tc[qm->numtopics]);
+	(*t) = (mqtt_topic_config){
+		.type = first, .count = count, .text = text, .wildcard = wildcard};
+	t->topic = strdup(topic);
+	t->name = strdup(name);
+	if (wildcard) { t->assigned = calloc(count, sizeof(char *)); }
+	if (!t->topic || !t->name || (wildcard && !t->assigned) ||
+	    (!wildcard && !mqtt_table_add(qm, topic, qm->numtopics, first))) {
+		free(t->topic);
+		free(t->name);
+		free(t->assigned);
+		return false;
+	}
+	qm->numtopics++;
+	return true;
+}
+
+/*!
+ * Implements MQTT topic filter matching: '+' matches exactly one topic level,
+ * and '#' (as the final level) matches any number of remaining levels,
+ * including none. Wildcards at the start of a filter do not match topics
+ * beginning with '$', as required by the MQTT specification.
+ *
+ * Comparisons are case insensitive, for consistency with the handling of
+ * topics without wildcards.
+ *
+ * @param[in] filter Subscription topic, which may contain wildcards
+ * @param[in] topic Received topic
+ * @return True if topic matches filter
+ */
+bool mqtt_topic_match(const char *filter, const char *topic) {
+	if (filter == NULL || topic == NULL) { return false; }
+	if (topic[0] == '$' && (filter[0] == '+' || filter[0] == '#')) { return false; }
+
+	const char *f = filter;
+	const char *t = topic;
+	while (*f) {
+		if (*f == '#') {
+			// Must be final level
+			return (f[1] == 0);
+		}
+		if (*f == '+') {
+			while (*t && *t != '/') {
+				t++;
+			}
+			f++;
+		} else {
+			if (tolower((unsigned char)*f) != tolower((unsigned char)*t)) {
+				// Allow "a/#" to match "a"
+				return (*t == 0 && f[0] == '/' && f[1] == '#' && f[2] == 0);
+			}
+			f++;
+			t++;
+		}
+	}
+	return (*t == 0);
+}
+
+/*!
+ * Looks up a received topic in the hash table, falling back to checking
+ * each wildcard topic in turn if the topic has not been seen before. The
+ * result is added to the table (up to MQTT_TOPIC_CACHE_MAX entries for
+ * topics that don't match any configuration), so subsequent messages on the
+ * same topic require only the table lookup.
+ *
+ * The first time a topic matches a wildcard configuration it is assigned
+ * the next free channel reserved for that configuration, and
+ * mqtt_queue_map.remapped is set. Topics matching a wildcard configuration
+ * with no free channels are treated as unmatched.
+ *
+ * @param[in] qm mqtt_queue_map containing topic configuration
+ * @param[in] topic Received topic
+ * @param[out] type Channel number (if matched)
+ * @returns Index into mqtt_queue_map.tc, or -1 if topic does not match
+ */
+int mqtt_find_topic(mqtt_queue_map *qm, const char *topic, uint8_t *type) {
+	if (qm == NULL || topic == NULL) { return -1; }
+	pthread_mutex_lock(&qm->lock);
+	mqtt_topic_entry *e = mqtt_table_find(qm, topic);
+	if (e) {
+		const int ix = e->config;
+		if (type) { *type = e->type; }
+		pthread_mutex_unlock(&qm->lock);
+		return ix;
+	}
+
+	int ix = -1;
+	uint8_t ct = 0;
+	for (int m = 0; m < qm->numtopics; m++) {
+		mqtt_topic_config *t = &(qm->tc[m]);
+		if (!t->wildcard || t->used >= t->count) { continue; }
+		if (mqtt_topic_match(t->topic, topic)) {
+			ix = m;
+			ct = t->type + t->used;
+			break;
+		}
+	}
+
+	if (ix >= 0) {
+		e = mqtt_table_add(qm, topic, ix, ct);
+		if (e == NULL) {
+			// Can't record assignment, so can't safely use the channel
+			pthread_mutex_unlock(&qm->lock);
+			return -1;
+		}
+		mqtt_topic_config *t = &(qm->tc[ix]);
+		t->assigned[t->used++] = e->topic;
+		atomic_store(&qm->remapped, true);
+		if (type) { *type = ct; }
+	} else if (qm->tableEntries < MQTT_TOPIC_CACHE_MAX) {
+		// Failure to cache the result isn't fatal
+		mqtt_table_add(qm, topic, -1, 0);
+	}
+	pthread_mutex_unlock(&qm->lock);
+	return ix;
+}
+
+/*!
+ * Channels reserved by wildcard topics are named with the configured name
+ * and the assigned topic, or the configured name and the channel offset if
+ * no topic has been assigned yet.
+ *
+ * Returned string must be freed by caller.
+ *
+ * @param[in] qm mqtt_queue_map containing topic configuration
+ * @param[in] type Channel number
+ * @returns Channel name, or NULL if channel not configured (or on error)
+ */
+char *mqtt_channel_name(mqtt_queue_map *qm, const uint8_t type) {
+	if (qm == NULL) { return NULL; }
+	char *out = NULL;
+	pthread_mutex_lock(&qm->lock);
+	for (int m = 0; m < qm->numtopics; m++) {
+		const mqtt_topic_config *t = &(qm->tc[m]);
+		if (type < t->type || type >= (t->type + t->count)) { continue; }
+		if (!t->wildcard) {
+			out = strdup(t->name);
+			break;
+		}
+		const int off = type - t->type;
+		if (t->assigned[off]) {
+			if (asprintf(&out, "%s:%s", t->name, t->assigned[off]) < 0) { out = NULL; }
+		} else {
+			if (asprintf(&out, "%s:%d", t->name, off) < 0) { out = NULL; }
+		}
+		break;
 	}
+	pthread_mutex_unlock(&qm->lock);
+	return out;
 }
@@ -28,6 +28,8 @@
 
 #include "SELKIELoggerBase.h"
 #include <mosquitto.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 
 /*!
@@ -35,30 +37,70 @@
  * @{
  */
 
+//! Initial number of buckets in topic lookup table
+#define MQTT_TOPIC_BUCKETS 64
+
+//! Maximum number of unmatched topics to remember
+#define MQTT_TOPIC_CACHE_MAX 4096
+
 //! Convenient alias for library structure
 typedef struct mosquitto mqtt_conn;
 
 //! MQTT Topic mapping
+
+/*!
+ * Topics containing MQTT wildcards ('+' or '#') reserve a range of `count`
+ * channels, starting at `type`. Each distinct topic matching the wildcard is
+ * assigned the next free channel in this range as it is first seen.
+ */
 typedef struct {
-	uint8_t type; //!< Channel number to use
-	char *topic;  //!< MQTT topic to subscribe/match against
-	char *name;   //!< Channel name
-	bool text;    //!< Treat received data as text
+	uint8_t type;          //!< Channel number to use (first channel for wildcard topics)
+	uint8_t count;         //!< Number of channels reserved
+	uint8_t used;          //!< Number of channels assigned so far
+	char *topic;           //!< MQTT topic to subscribe/match against
+	char *name;            //!< Channel name
+	bool text;             //!< Treat received data as text
+	bool wildcard;         //!< Topic contains wildcards
+	const char **assigned; //!< Topic assigned to each channel (wildcard topics only)
 } mqtt_topic_config;
 
+//! Topic lookup table entry
+typedef struct mqtt_topic_entry {
+	char *topic;                   //!< Received topic
+	int config;                    //!< Matching entry in mqtt_queue_map.tc, or -1 if no match
+	uint8_t type;                  //!< Channel number for this topic
+	struct mqtt_topic_entry *next; //!< Next entry in same bucket
+} mqtt_topic_entry;
+
+//! Message delivery function (see mqtt_queue_map.deliver)
+typedef bool (*mqtt_deliver_fn)(void *data, msg_t *msg);
+
 /*!
  * Configuration and supporting data for mapping MQTT data to internal message format.
  *
- * Messages matching the topics subscribed to in mqtt_queue_map.tc are wrapped as msg_t instances and queued to
- * mqtt_queue_map.q by the callback function.
+ * Messages matching the topics subscribed to in mqtt_queue_map.tc are
+ * wrapped as msg_t instances by the callback function. If a delivery function
+ * is set, messages are passed directly to it, otherwise they are queued to
+ * mqtt_queue_map.q.
+ *
+ * Received topics are looked up in a hash table, so that the topic
+ * configuration is only searched the first time a topic is seen.
+ *
  * @sa mqtt_enqueue_messages
  */
 typedef struct {
-	msgqueue q;                //!< Internal message queue
-	uint8_t sourceNum;         //!< Source number
-	int numtopics;             //!< Number of topics registered
-	mqtt_topic_config tc[120]; //!< Individual topic configuration
-	bool dumpall;              //!< Dump any message, not just matches in .tc
+	msgqueue q;                 //!< Internal message queue
+	uint8_t sourceNum;          //!< Source number
+	int numtopics;              //!< Number of topics registered
+	mqtt_topic_config *tc;      //!< Individual topic configuration
+	bool dumpall;               //!< Dump any message, not just matches in .tc
+	mqtt_topic_entry **table;   //!< Topic lookup table
+	size_t tableSize;           //!< Number of buckets in table
+	size_t tableEntries;        //!< Number of entries in table
+	pthread_mutex_t lock;       //!< Protects lookup table and channel assignments
+	atomic_bool remapped;       //!< Set when a wildcard channel is assigned
+	mqtt_deliver_fn deliver;    //!< Deliver messages directly (optional)
+	void *deliverData;          //!< Passed to deliver function
 } mqtt_queue_map;
 
 //! Initialise mqtt_queue_map to sensible defaults
@@ -66,5 +108,28 @@ bool mqtt_init_queue_map(mqtt_queue_map *qm);
 
 //! Release resources used by mqtt_queue_map instance
 void mqtt_destroy_queue_map(mqtt_queue_map *qm);
+
+//! Hash function for topic lookup table
+uint32_t mqtt_topic_hash(const char *topic);
+
+//! Find topic in lookup table
+mqtt_topic_entry *mqtt_table_find(mqtt_queue_map *qm, const char *topic);
+
+//! Add topic to lookup table
+mqtt_topic_entry *mqtt_table_add(mqtt_queue_map *qm, const char *topic, const int config,
+                                 const uint8_t type);
+
+//! Add topic to mqtt_queue_map, reserving channels from first
+bool mqtt_add_topic(mqtt_queue_map *qm, const char *topic, const char *name, const uint8_t first,
+                    const uint8_t count, const bool text);
+
+//! Check whether topic matches a subscription filter, including wildcards
+bool mqtt_topic_match(const char *filter, const char *topic);
+
+//! Find topic configuration and channel number for a received topic
+int mqtt_find_topic(mqtt_queue_map *qm, const char *topic, uint8_t *type);
+
+//! Return name for a channel, or NULL if not configured
+char *mqtt_channel_name(mqtt_queue_map *qm, const uint8_t type);
 //! @}
 #endif
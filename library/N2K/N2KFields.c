@@ -0,0 +1,253 @@
+/*
+ *  Copyright (C) 2023 Swansea University
+ *
+ *  This file is part of the SELKIELogger suite of tools.
+ *
+ *  SELKIELogger is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation, either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  SELKIELogger is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this SELKIELogger product.
+ *  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "N2KFields.h"
+#include "N2KMessages.h"
+
+//! Shorthand for a byte aligned numerical field
+#define N2K_FIELD(name, byte, bits, sgn, sc, off) {name, (byte)*8, bits, sgn, true, sc, off}
+
+//! Shorthand for a flag/enumeration field without a reserved "not available" value
+#define N2K_ENUM(name, bit, bits) {name, bit, bits, false, false, 1.0, 0.0}
+
+//! Fill out n2k_pgn_desc entry, counting the fields automatically
+#define N2K_PGN(num, desc, len, f) {num, desc, len, sizeof(f) / sizeof(f[0]), f}
+
+//! PGN 127250: Vessel Heading
+static const n2k_field_desc n2k_127250_fields[] = {
+	N2K_FIELD("Heading", 1, 16, false, N2K_TO_DEGREES, 0),
+	N2K_FIELD("Deviation", 3, 16, true, N2K_TO_DEGREES, 0),
+	N2K_FIELD("Variation", 5, 16, true, N2K_TO_DEGREES, 0),
+	N2K_ENUM("Reference", 56, 2),
+};
+
+//! PGN 127251: Rate of Turn
+static const n2k_field_desc n2k_127251_fields[] = {
+	N2K_FIELD("RateOfTurn", 1, 32, true, N2K_TO_DEGREES / 3200, 0),
+};
+
+//! PGN 127257: Attitude
+static const n2k_field_desc n2k_127257_fields[] = {
+	N2K_FIELD("Yaw", 1, 16, true, N2K_TO_DEGREES, 0),
+	N2K_FIELD("Pitch", 3, 16, true, N2K_TO_DEGREES, 0),
+	N2K_FIELD("Roll", 5, 16, true, N2K_TO_DEGREES, 0),
+};
+
+//! PGN 128267: Water Depth
+static const n2k_field_desc n2k_128267_fields[] = {
+	N2K_FIELD("Depth", 1, 32, false, 0.01, 0),
+	N2K_FIELD("DepthOffset", 5, 16, true, 0.01, 0),
+	N2K_FIELD("DepthRange", 7, 8, true, 10.0, 0),
+};
+
+//! PGN 129025: Position, Rapid Update
+static const n2k_field_desc n2k_129025_fields[] = {
+	N2K_FIELD("Fast-Latitude", 0, 32, true, 1E-7, 0),
+	N2K_FIELD("Fast-Longitude", 4, 32, true, 1E-7, 0),
+};
+
+//! PGN 129026: COG & SOG, Rapid Update
+static const n2k_field_desc n2k_129026_fields[] = {
+	N2K_ENUM("Fast-COGSOGReference", 8, 2),
+	N2K_FIELD("Fast-CourseOverGround", 2, 16, false, N2K_TO_DEGREES, 0),
+	N2K_FIELD("Fast-SpeedOverGround", 4, 16, true, 0.01, 0),
+};
+
+//! PGN 129029: GNSS Position Data
+static const n2k_field_desc n2k_129029_fields[] = {
+	N2K_FIELD("Days", 1, 16, false, 1.0, 0),
+	N2K_FIELD("Seconds", 3, 32, false, 0.0001, 0),
+	N2K_FIELD("Latitude", 7, 64, true, 1E-16, 0),
+	N2K_FIELD("Longitude", 15, 64, true, 1E-16, 0),
+	N2K_FIELD("Altitude", 23, 64, true, 1E-6, 0),
+	N2K_ENUM("GNSSType", 248, 4),
+	N2K_ENUM("GNSSMethod", 252, 4),
+	N2K_FIELD("NumSV", 33, 8, false, 1.0, 0),
+	N2K_FIELD("HDOP", 34, 16, true, 0.01, 0),
+	N2K_FIELD("PDOP", 36, 16, true, 0.01, 0),
+	N2K_FIELD("GeoidSeparation", 38, 16, true, 0.01, 0),
+};
+
+//! PGN 129033: Date and Time
+static const n2k_field_desc n2k_129033_fields[] = {
+	N2K_FIELD("Days", 0, 16, false, 1.0, 0),
+	N2K_FIELD("Seconds", 2, 32, false, 0.0001, 0),
+	N2K_FIELD("UTCOffset", 6, 16, true, 1.0, 0),
+};
+
+//! PGN 130306: Wind Data
+static const n2k_field_desc n2k_130306_fields[] = {
+	N2K_FIELD("WindSpeed", 1, 16, true, 0.01, 0),
+	N2K_FIELD("WindAngle", 3, 16, false, N2K_TO_DEGREES, 0),
+	N2K_ENUM("WindReference", 40, 3),
+};
+
+//! PGN 130311: Environmental Parameters
+static const n2k_field_desc n2k_130311_fields[] = {
+	N2K_ENUM("TemperatureSource", 8, 6),
+	N2K_ENUM("HumiditySource", 14, 2),
+	N2K_FIELD("Temperature", 2, 16, false, 0.01, -273.15),
+	N2K_FIELD("Humidity", 4, 16, true, 0.004, 0),
+	N2K_FIELD("Pressure", 6, 16, false, 1.0, 0),
+};
+
+/*!
+ * Table of PGNs that can be decoded by n2k_decode_message() and n2k_decode_batch().
+ *
+ * Scaling and offsets match the equivalent n2k_XXXXXX_values() functions.
+ * The final entry in this list **must** have the PGN set to zero.
+ */
+const n2k_pgn_desc n2k_pgn_table[] = {
+	N2K_PGN(127250, "Vessel Heading", 8, n2k_127250_fields),
+	N2K_PGN(127251, "Rate of Turn", 8, n2k_127251_fields),
+	N2K_PGN(127257, "Attitude", 7, n2k_127257_fields),
+	N2K_PGN(128267, "Water Depth", 8, n2k_128267_fields),
+	N2K_PGN(129025, "Position", 8, n2k_129025_fields),
+	N2K_PGN(129026, "Course and Speed", 8, n2k_129026_fields),
+	N2K_PGN(129029, "GNSS Position", 43, n2k_129029_fields),
+	N2K_PGN(129033, "Date and Time", 8, n2k_129033_fields),
+	N2K_PGN(130306, "Wind Data", 8, n2k_130306_fields),
+	N2K_PGN(130311, "Environmental Data", 8, n2k_130311_fields),
+	{0, NULL, 0, 0, NULL} // End of list sentinel value
+};
+
+/*!
+ * @param[in] pgn PGN number to search for
+ * @returns Pointer to entry in n2k_pgn_table, or NULL if not found
+ */
+const n2k_pgn_desc *n2k_pgn_find(const uint32_t pgn) {
+	for (const n2k_pgn_desc *pd = n2k_pgn_table; pd->PGN; pd++) {
+		if (pd->PGN == pgn) { return pd; }
+	}
+	return NULL;
+}
+
+/*!
+ * Values are assembled in little endian order, as used throughout N2K
+ * messages. No bounds checking is performed here, so the caller must ensure
+ * that data contains at least (bitOffset + bitWidth) bits.
+ *
+ * @param[in] data Message payload
+ * @param[in] bitOffset Position of first bit
+ * @param[in] bitWidth Number of bits to extract (1-64)
+ * @returns Unsigned value, right aligned
+ */
+uint64_t n2k_get_bits(const uint8_t *data, const uint16_t bitOffset, const uint8_t bitWidth) {
+	const uint8_t *p = &(data[bitOffset / 8]);
+	const uint8_t shift = bitOffset % 8;
+	const uint8_t nbytes = (shift + bitWidth + 7) / 8;
+
+	uint64_t v = 0;
+	for (uint8_t i = 0; i < nbytes && i < 8; i++) {
+		v |= ((uint64_t)p[i]) << (8 * i);
+	}
+	v >>= shift;
+	if (nbytes > 8) { v |= ((uint64_t)p[8]) << (64 - shift); }
+	if (bitWidth < 64) { v &= ((1ULL << bitWidth) - 1); }
+	return v;
+}
+
+/*!
+ * The field is extracted with n2k_get_bits(), sign extended if required and
+ * then scaled.
+ *
+ * If the field is flagged as having a reserved "not available" value, the
+ * maximum value (and minimum value for signed fields) will be returned as
+ * NAN, matching n2k_get_double() and n2k_get_udouble().
+ *
+ * @param[in] n N2K message containing target data
+ * @param[in] f Field description
+ * @returns Scaled value, or NAN if not available or outside message data
+ */
+double n2k_decode_field(const n2k_act_message *n, const n2k_field_desc *f) {
+	if ((f->bitOffset + f->bitWidth) > (n->datalen * 8)) { return NAN; }
+
+	const uint64_t raw = n2k_get_bits(n->data, f->bitOffset, f->bitWidth);
+	const uint64_t umax = (f->bitWidth < 64) ? ((1ULL << f->bitWidth) - 1) : UINT64_MAX;
+	double v = 0;
+	if (f->isSigned) {
+		const uint64_t smax = umax >> 1;
+		if (f->hasNA && (raw == smax || raw == (smax + 1))) { return NAN; }
+		if (raw > smax) {
+			// Negative: value is raw - 2^width
+			v = -(double)(umax - raw) - 1.0;
+		} else {
+			v = (double)raw;
+		}
+	} else {
+		if (f->hasNA && raw == umax) { return NAN; }
+		v = (double)raw;
+	}
+	return v * f->scale + f->offset;
+}
+
+/*!
+ * Decodes every field described in pd into the values array, which must have
+ * space for at least pd->nFields entries.
+ *
+ * @param[in] pd PGN description
+ * @param[in] n Input message
+ * @param[out] values Array of decoded values (NAN if field not available)
+ * @returns Number of finite values decoded, or -1 if message does not match description
+ */
+int n2k_decode_message(const n2k_pgn_desc *pd, const n2k_act_message *n, double *values) {
+	if (!pd || !n || !values || !n->data) { return -1; }
+	if (n->PGN != pd->PGN || n->datalen < pd->minLength) { return -1; }
+
+	int valid = 0;
+	for (uint8_t f = 0; f < pd->nFields; f++) {
+		values[f] = n2k_decode_field(n, &(pd->fields[f]));
+		valid += isfinite(values[f]);
+	}
+	return valid;
+}
+
+/*!
+ * Decodes each message in msgs into columnar output arrays, such that
+ * columns[f][m] holds field f from message m.
+ *
+ * The columns array must contain pd->nFields pointers, each to an array of at
+ * least count doubles. Rows corresponding to messages that do not match the
+ * PGN description are filled with NAN.
+ *
+ * @param[in] pd PGN description
+ * @param[in] msgs Array of input messages
+ * @param[in] count Number of messages in msgs
+ * @param[out] columns Output arrays, one per field
+ * @returns Number of messages successfully decoded
+ */
+size_t n2k_decode_batch(const n2k_pgn_desc *pd, const n2k_act_message *msgs, const size_t count,
+                        double **columns) {
+	if (!pd || !msgs || !columns) { return 0; }
+
+	size_t decoded = 0;
+	for (size_t m = 0; m < count; m++) {
+		const n2k_act_message *n = &(msgs[m]);
+		const bool match = (n->data && n->PGN == pd->PGN && n->datalen >= pd->minLength);
+		for (uint8_t f = 0; f < pd->nFields; f++) {
+			columns[f][m] = match ? n2k_decode_field(n, &(pd->fields[f])) : NAN;
+		}
+		decoded += match;
+	}
+	return decoded;
+}
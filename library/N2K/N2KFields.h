@@ -0,0 +1,93 @@
+/*
+ *  Copyright (C) 2023 Swansea University
+ *
+ *  This file is part of the SELKIELogger suite of tools.
+ *
+ *  SELKIELogger is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation, either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  SELKIELogger is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this SELKIELogger product.
+ *  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SELKIELoggerN2K_Fields
+#define SELKIELoggerN2K_Fields
+
+/*!
+ * @file N2KFields.h Table driven PGN field descriptions and decoders
+ * @ingroup SELKIELoggerN2K
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "N2KTypes.h"
+
+/*!
+ * @addtogroup SELKIELoggerN2Kfields Table driven PGN decoding
+ * @ingroup SELKIELoggerN2K
+ *
+ * Each supported PGN is described by an array of n2k_field_desc entries,
+ * giving the position, size and scaling for each numerical field in the
+ * message payload. These descriptions are collected in n2k_pgn_table, and
+ * a single generic decoder converts any described message into an array of
+ * values.
+ *
+ * To support an additional PGN, add a field array and a matching entry in
+ * n2k_pgn_table (N2KFields.c).
+ *
+ * @{
+ */
+
+//! Largest number of fields that can be described for a single PGN
+#define N2K_MAX_FIELDS 16
+
+//! Describe a single numerical field within a PGN
+typedef struct {
+	const char *name;   //!< Field name, used for channel names
+	uint16_t bitOffset; //!< Field position from start of message data, in bits
+	uint8_t bitWidth;   //!< Field width, in bits (1-64)
+	bool isSigned;      //!< Field is stored as two's complement signed value
+	bool hasNA;         //!< Reserved maximum (and signed minimum) values indicate missing data
+	double scale;       //!< Raw value is multiplied by this factor...
+	double offset;      //!< ... and then this value is added
+} n2k_field_desc;
+
+//! Describe the numerical fields within a PGN
+typedef struct {
+	uint32_t PGN;                 //!< PGN number
+	const char *name;             //!< Short description
+	uint8_t minLength;            //!< Minimum valid n2k_act_message.datalen
+	uint8_t nFields;              //!< Number of entries in fields
+	const n2k_field_desc *fields; //!< Field descriptions
+} n2k_pgn_desc;
+
+//! Table of known PGNs, terminated by an entry with PGN set to zero
+extern const n2k_pgn_desc n2k_pgn_table[];
+
+//! Find PGN description in n2k_pgn_table
+const n2k_pgn_desc *n2k_pgn_find(const uint32_t pgn);
+
+//! Extract arbitrary bit field from message data
+uint64_t n2k_get_bits(const uint8_t *data, const uint16_t bitOffset, const uint8_t bitWidth);
+
+//! Decode a single described field, returning NAN if not available
+double n2k_decode_field(const n2k_act_message *n, const n2k_field_desc *f);
+
+//! Decode all described fields from a single message
+int n2k_decode_message(const n2k_pgn_desc *pd, const n2k_act_message *n, double *values);
+
+//! Decode an array of messages into per-field columns
+size_t n2k_decode_batch(const n2k_pgn_desc *pd, const n2k_act_message *msgs, const size_t count,
+                        double **columns);
+//! @}
+#endif
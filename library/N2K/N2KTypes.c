@@ -21,6 +21,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "N2KTypes.h"
 
@@ -85,18 +86,26 @@ bool n2k_act_to_bytes(const n2k_act_message *act, uint8_t **out, size_t *len) {
 }
 
 /*!
+ * Parses a single message without allocating any memory. The message payload
+ * is written to the caller supplied data array, which must be large enough to
+ * hold the largest possible payload (255 bytes).
  *
- * Will allocate an n2k_act_message for output, which must be freed by caller.
+ * On return, msg->data will be set to point at the data array if a complete
+ * message was read (even if the checksum was invalid), or NULL otherwise. A
+ * false return value with msg->data set therefore indicates a checksum
+ * failure, with the header fields still available for reporting.
  *
  * @param[in] in Array of bytes
  * @param[in] len Number of bytes available in array
- * @param[out] msg Pointer to n2k_act_message pointer for output
+ * @param[out] msg Message structure to populate
+ * @param[out] data Array to hold message payload
  * @param[out] pos Number of bytes consumed
  * @param[in] debug Set true for more verbose output
  * @returns True on success, false on error
  */
-bool n2k_act_from_bytes(const uint8_t *in, const size_t len, n2k_act_message **msg, size_t *pos, bool debug) {
-	if (in == NULL || msg == NULL || len < 18 || pos == NULL) { return NULL; }
+bool n2k_act_parse(const uint8_t *in, const size_t len, n2k_act_message *msg, uint8_t *data, size_t *pos, bool debug) {
+	if (in == NULL || msg == NULL || data == NULL || len < 18 || pos == NULL) { return false; }
+	msg->data = NULL;
 
 	ssize_t start = -1;
 	while (((*pos) + 18) < len) {
@@ -123,97 +132,75 @@ bool n2k_act_from_bytes(const uint8_t *in, const size_t len, n2k_act_message **m
 		return false;
 	}
 
-	(*msg) = calloc(1, sizeof(n2k_act_message));
-	if ((*msg) == NULL) {
-		perror("n2k_act_from_bytes");
-		return false;
-	}
-
-	(*msg)->length = in[start + 3];
-	(*msg)->priority = in[start + 4];
-	(*msg)->PGN = in[start + 5] + ((uint32_t)in[start + 6] << 8) + ((uint32_t)in[start + 7] << 16);
+	msg->length = in[start + 3];
+	msg->priority = in[start + 4];
+	msg->PGN = in[start + 5] + ((uint32_t)in[start + 6] << 8) + ((uint32_t)in[start + 7] << 16);
 
 	// PGN validation?
 
-	(*msg)->dst = in[start + 8];
-	(*msg)->src = in[start + 9];
+	msg->dst = in[start + 8];
+	msg->src = in[start + 9];
 
 	// Validate src + dst
 
-	(*msg)->timestamp = in[start + 10] + ((uint32_t)in[start + 11] << 8) + ((uint32_t)in[start + 12] << 16) +
+	msg->timestamp = in[start + 10] + ((uint32_t)in[start + 11] << 8) + ((uint32_t)in[start + 12] << 16) +
 	                    ((uint32_t)in[start + 13] << 24);
-	(*msg)->datalen = in[start + 14];
+	msg->datalen = in[start + 14];
 
 	volatile ssize_t remaining = len - start - 15;
-	if (remaining <= ((*msg)->datalen + 3)) { // Available data - unusable data before start - message so far
+	if (remaining <= (msg->datalen + 3)) { // Available data - unusable data before start - message so far
 		// Not enough data present to read the rest of the message
-		free(*msg);
-		(*msg) = NULL;
 		// Don't update *pos
 		if (debug) { fprintf(stderr, "N2K: Insufficient data to read in message content\n"); }
 		return false;
 	}
 
-	(*msg)->data = calloc((*msg)->datalen, sizeof(uint8_t));
-	if ((*msg)->data == NULL) {
-		perror("n2k_act_from_bytes:data-calloc");
-		free(*msg);
-		(*msg) = NULL;
-		// Don't update *pos, just in case the memory issue is recoverable
-		return false;
-	}
+	// Payload is written directly to the caller's buffer
+	msg->data = data;
 
 	size_t off = 15;
-	for (int i = 0; i < (*msg)->datalen; i++) {
+	for (int i = 0; i < msg->datalen; i++) {
 		uint8_t c = in[(start + off++)];
 		remaining--;
 		if (c == ACT_ESC) {
 			uint8_t next = in[(start + off++)];
 			if (next == ACT_ESC) {
-				(*msg)->data[i] = ACT_ESC;
+				msg->data[i] = ACT_ESC;
 				remaining--;
 			} else if (next == ACT_EOT) {
 				// Message terminated early
 				(*pos) = (start + off);
-				free((*msg)->data);
-				free(*msg);
-				(*msg) = NULL;
+				msg->data = NULL;
 				if (debug) { fprintf(stderr, "N2K: Premature Termination\n"); }
 				return false;
 			} else if (next == ACT_SOT) {
 				// This....probably shouldn't happen.
 				// Exit as above, but reposition to before the message start
 				(*pos) = (start + off - 2);
-				free((*msg)->data);
-				free(*msg);
-				(*msg) = NULL;
+				msg->data = NULL;
 				if (debug) { fprintf(stderr, "N2K: Unexpected start of message marker\n"); }
 				return false;
 			} else {
 				// Any other ESC + character sequence here is invalid
 				(*pos) = (start + off);
-				free((*msg)->data);
-				free(*msg);
-				(*msg) = NULL;
+				msg->data = NULL;
 				if (debug) {
 					fprintf(stderr, "N2K: Bad character escape sequence (ESC + 0x%02x\n", next);
 				}
 				return false;
 			}
 		} else {
-			(*msg)->data[i] = c;
+			msg->data[i] = c;
 		}
 
-		if (remaining < ((*msg)->datalen - i + 3)) {
-			free((*msg)->data);
-			free(*msg);
-			(*msg) = NULL;
+		if (remaining < (msg->datalen - i + 3)) {
+			msg->data = NULL;
 			if (debug) { fprintf(stderr, "N2K: Out of data while parsing\n"); }
 			return false;
 		}
 	}
 
-	(*msg)->csum = in[(start + off++)];
+	msg->csum = in[(start + off++)];
 
 	uint8_t ee = in[(start + off++)];
 	uint8_t et = in[(start + off++)];
@@ -230,17 +217,56 @@ bool n2k_act_from_bytes(const uint8_t *in, const size_t len, n2k_act_message **m
 	}
 
 	(*pos) = start + off;
-	uint8_t cs = n2k_act_checksum(*msg);
+	uint8_t cs = n2k_act_checksum(msg);
 
-	if ((*msg)->csum != cs) {
+	if (msg->csum != cs) {
 		if (debug) {
-			fprintf(stderr, "Bad checksum (%d => %d\tPGN %d)\n", (*msg)->src, (*msg)->dst, (*msg)->PGN);
+			fprintf(stderr, "Bad checksum (%d => %d\tPGN %d)\n", msg->src, msg->dst, msg->PGN);
 		}
 		return false; // Signal error, but send the message out
 	}
 	return true;
 }
 
+/*!
+ *
+ * Will allocate an n2k_act_message for output, which must be freed by caller.
+ *
+ * If a complete message was read but had an invalid checksum, the message is
+ * still allocated and returned, but this function will return false.
+ *
+ * @param[in] in Array of bytes
+ * @param[in] len Number of bytes available in array
+ * @param[out] msg Pointer to n2k_act_message pointer for output
+ * @param[out] pos Number of bytes consumed
+ * @param[in] debug Set true for more verbose output
+ * @returns True on success, false on error
+ */
+bool n2k_act_from_bytes(const uint8_t *in, const size_t len, n2k_act_message **msg, size_t *pos, bool debug) {
+	if (in == NULL || msg == NULL || len < 18 || pos == NULL) { return false; }
+
+	uint8_t data[256] = {0};
+	n2k_act_message tmp = {0};
+	bool r = n2k_act_parse(in, len, &tmp, data, pos, debug);
+	if (tmp.data == NULL) { return false; }
+
+	(*msg) = calloc(1, sizeof(n2k_act_message));
+	if ((*msg) == NULL) {
+		perror("n2k_act_from_bytes");
+		return false;
+	}
+	(**msg) = tmp;
+	(*msg)->data = calloc(tmp.datalen, sizeof(uint8_t));
+	if ((*msg)->data == NULL) {
+		perror("n2k_act_from_bytes:data-calloc");
+		free(*msg);
+		(*msg) = NULL;
+		return false;
+	}
+	memcpy((*msg)->data, data, tmp.datalen);
+	return r;
+}
+
 /*!
  * @param[in] msg ntk_act_message input
  * @returns Unsigned byte containing checksum value
@@ -99,6 +99,9 @@ typedef struct {
 //! Convert N2K message to a series of bytes compatible with ACT gateway devices
 bool n2k_act_to_bytes(const n2k_act_message *act, uint8_t **out, size_t *len);
 
+//! Parse a series of received bytes from ACT gateway devices into a caller supplied message and buffer
+bool n2k_act_parse(const uint8_t *in, const size_t len, n2k_act_message *msg, uint8_t *data, size_t *pos, bool debug);
+
 //! Convert a series of recieved bytes from ACT gateway devices into a message representation
 bool n2k_act_from_bytes(const uint8_t *in, const size_t len, n2k_act_message **msg, size_t *pos, bool debug);
 
@@ -32,6 +32,7 @@
  * @{
  */
 #include "N2K/N2KConnection.h"
+#include "N2K/N2KFields.h"
 #include "N2K/N2KMessages.h"
 #include "N2K/N2KTypes.h"
 //! @}
@@ -0,0 +1,350 @@
+/*
+ *  Copyright (C) 2023 Swansea University
+ *
+ *  This file is part of the SELKIELogger suite of tools.
+ *
+ *  SELKIELogger is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation, either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  SELKIELogger is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this SELKIELogger product.
+ *  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <math.h>
+#include <string.h>
+
+#include "NMEAFields.h"
+
+//! Shorthand for a plain numerical field
+#define NMEA_FIELD(name, ix) {name, ix, NMEA_FT_NUMBER, 0}
+
+//! Shorthand for a field with a non-default conversion
+#define NMEA_CONV(name, ix, type, match) {name, ix, type, match}
+
+//! Fill out nmea_sentence_desc entry, counting the fields automatically
+#define NMEA_SENTENCE(id, desc, minf, f) {id, desc, minf, sizeof(f) / sizeof(f[0]), f}
+
+//! Knots to m/s
+#define NMEA_KNOTS 0.514444444
+
+//! GGA: GNSS Fix Data
+static const nmea_field_desc nmea_gga_fields[] = {
+	NMEA_CONV("Time", 0, NMEA_FT_TIME, 0),
+	NMEA_CONV("Latitude", 1, NMEA_FT_LATLON, 0),
+	NMEA_CONV("Longitude", 3, NMEA_FT_LATLON, 0),
+	NMEA_FIELD("Quality", 5),
+	NMEA_FIELD("Satellites", 6),
+	NMEA_FIELD("HDOP", 7),
+	NMEA_FIELD("Altitude", 8),
+	NMEA_FIELD("GeoidSeparation", 10),
+};
+
+//! RMC: Recommended Minimum Navigation Information
+static const nmea_field_desc nmea_rmc_fields[] = {
+	NMEA_CONV("Time", 0, NMEA_FT_TIME, 0),
+	NMEA_CONV("Valid", 1, NMEA_FT_FLAG, 'A'),
+	NMEA_CONV("Latitude", 2, NMEA_FT_LATLON, 0),
+	NMEA_CONV("Longitude", 4, NMEA_FT_LATLON, 0),
+	NMEA_CONV("SpeedOverGround", 6, NMEA_FT_SPEED, 'N'),
+	NMEA_FIELD("CourseOverGround", 7),
+	NMEA_CONV("Date", 8, NMEA_FT_DATE, 0),
+	NMEA_CONV("MagneticVariation", 9, NMEA_FT_SIGNED, 0),
+};
+
+//! VTG: Track Made Good and Ground Speed
+static const nmea_field_desc nmea_vtg_fields[] = {
+	NMEA_FIELD("CourseTrue", 0),
+	NMEA_FIELD("CourseMagnetic", 2),
+	NMEA_CONV("SpeedOverGround", 4, NMEA_FT_SPEED, 0),
+};
+
+//! HDT: Heading, True
+static const nmea_field_desc nmea_hdt_fields[] = {
+	NMEA_FIELD("Heading", 0),
+};
+
+//! MWV: Wind Speed and Angle
+static const nmea_field_desc nmea_mwv_fields[] = {
+	NMEA_FIELD("WindAngle", 0),
+	NMEA_CONV("TrueWind", 1, NMEA_FT_FLAG, 'T'),
+	NMEA_CONV("WindSpeed", 2, NMEA_FT_SPEED, 0),
+	NMEA_CONV("Valid", 4, NMEA_FT_FLAG, 'A'),
+};
+
+//! MTW: Water Temperature
+static const nmea_field_desc nmea_mtw_fields[] = {
+	NMEA_FIELD("WaterTemperature", 0),
+};
+
+//! XDR: Transducer Measurements (first four measurements only)
+static const nmea_field_desc nmea_xdr_fields[] = {
+	NMEA_FIELD("Value1", 1),
+	NMEA_FIELD("Value2", 5),
+	NMEA_FIELD("Value3", 9),
+	NMEA_FIELD("Value4", 13),
+};
+
+//! ZDA: Time and Date
+static const nmea_field_desc nmea_zda_fields[] = {
+	NMEA_CONV("Time", 0, NMEA_FT_TIME, 0),
+	NMEA_FIELD("Day", 1),
+	NMEA_FIELD("Month", 2),
+	NMEA_FIELD("Year", 3),
+};
+
+//! DPT: Depth
+static const nmea_field_desc nmea_dpt_fields[] = {
+	NMEA_FIELD("Depth", 0),
+	NMEA_FIELD("DepthOffset", 1),
+	NMEA_FIELD("DepthRange", 2),
+};
+
+/*!
+ * Minimum field counts are set so that the fields required to identify the
+ * message contents are present. Optional fields beyond this point are
+ * decoded as NAN if not present in a message.
+ */
+const nmea_sentence_desc nmea_sentence_table[] = {
+	NMEA_SENTENCE("GGA", "GNSS Fix Data", 9, nmea_gga_fields),
+	NMEA_SENTENCE("RMC", "Recommended Minimum Navigation Information", 9, nmea_rmc_fields),
+	NMEA_SENTENCE("VTG", "Track Made Good and Ground Speed", 6, nmea_vtg_fields),
+	NMEA_SENTENCE("HDT", "Heading, True", 1, nmea_hdt_fields),
+	NMEA_SENTENCE("MWV", "Wind Speed and Angle", 5, nmea_mwv_fields),
+	NMEA_SENTENCE("MTW", "Water Temperature", 1, nmea_mtw_fields),
+	NMEA_SENTENCE("XDR", "Transducer Measurements", 4, nmea_xdr_fields),
+	NMEA_SENTENCE("ZDA", "Time and Date", 4, nmea_zda_fields),
+	NMEA_SENTENCE("DPT", "Depth", 2, nmea_dpt_fields),
+	{"", NULL, 0, 0, NULL},
+};
+
+//! Powers of ten, used to scale decimal fractions
+static const double nmea_pow10[] = {1E0,  1E1,  1E2,  1E3,  1E4,  1E5,  1E6,
+                                    1E7,  1E8,  1E9,  1E10, 1E11, 1E12, 1E13,
+                                    1E14, 1E15, 1E16, 1E17, 1E18};
+
+/*!
+ * @param[in] message Three character message ID (need not be null terminated)
+ * @returns Pointer to sentence description, or NULL if not found
+ */
+const nmea_sentence_desc *nmea_sentence_find(const char *message) {
+	if (!message) { return NULL; }
+	for (const nmea_sentence_desc *sd = nmea_sentence_table; sd->message[0]; sd++) {
+		if (strncmp(sd->message, message, 3) == 0) { return sd; }
+	}
+	return NULL;
+}
+
+/*!
+ * Fields are delimited in the same way as in nmea_parse_fields(), but rather
+ * than copying each field into a new string array, only the position and
+ * length of each field within the raw message data are recorded.
+ *
+ * @param[in] msg Input message
+ * @param[out] tok Field positions
+ * @returns Number of fields found
+ */
+int nmea_tokenise(const nmea_msg_t *msg, nmea_tokens *tok) {
+	tok->count = 0;
+	uint8_t start = 0;
+	for (uint8_t fp = 0; fp < msg->rawlen && tok->count < NMEA_MAX_FIELDS - 1; fp++) {
+		if ((msg->raw[fp] == ',') || (msg->raw[fp] == 0)) {
+			tok->start[tok->count] = start;
+			tok->length[tok->count] = fp - start;
+			tok->count++;
+			start = fp + 1;
+		}
+	}
+	tok->start[tok->count] = start;
+	tok->length[tok->count] = (msg->rawlen > start) ? (msg->rawlen - start) : 0;
+	tok->count++;
+	return tok->count;
+}
+
+/*!
+ * Accepts an optional sign, followed by digits and an optional decimal point.
+ * Digits beyond the precision of a double are ignored, as are fractional
+ * digits beyond the 18th decimal place.
+ *
+ * @param[in] msg Input message
+ * @param[in] tok Field positions, from nmea_tokenise()
+ * @param[in] field Field number
+ * @returns Field value, or NAN if field is empty or not a valid number
+ */
+double nmea_field_number(const nmea_msg_t *msg, const nmea_tokens *tok, const int field) {
+	if (field < 0 || field >= tok->count || tok->length[field] == 0) { return NAN; }
+
+	const uint8_t *p = &(msg->raw[tok->start[field]]);
+	const uint8_t *end = p + tok->length[field];
+	bool negative = false;
+	if (*p == '-' || *p == '+') { negative = (*p++ == '-'); }
+
+	uint64_t mantissa = 0;
+	int digits = 0;   // Significant digits accumulated
+	int scale = 0;    // Digits after the decimal point (accumulated)
+	int dropped = 0;  // Integer digits ignored due to precision limit
+	bool point = false;
+	bool any = false;
+	for (; p < end; p++) {
+		if (*p == '.') {
+			if (point) { return NAN; }
+			point = true;
+			continue;
+		}
+		const uint8_t d = *p - '0';
+		if (d > 9) { return NAN; }
+		any = true;
+		if (point) {
+			// Fractional digits beyond the scale table are insignificant
+			if (digits >= 18 || scale >= 18) { continue; }
+			scale++;
+		} else if (digits >= 18) {
+			dropped++;
+			continue;
+		}
+		mantissa = mantissa * 10 + d;
+		if (mantissa > 0) { digits++; }
+	}
+	if (!any) { return NAN; }
+
+	double v = (double)mantissa;
+	if (scale > 0) { v /= nmea_pow10[scale]; }
+	if (dropped > 0) { v *= pow(10, dropped); }
+	return negative ? -v : v;
+}
+
+/*!
+ * @param[in] msg Input message
+ * @param[in] tok Field positions, from nmea_tokenise()
+ * @param[in] field Field number
+ * @returns First character of field, or 0 if field is empty or not present
+ */
+char nmea_field_char(const nmea_msg_t *msg, const nmea_tokens *tok, const int field) {
+	if (field < 0 || field >= tok->count || tok->length[field] == 0) { return 0; }
+	return msg->raw[tok->start[field]];
+}
+
+/*!
+ * Converts a civil date to a day count, without using the C library time
+ * functions (which depend on the local time zone)
+ *
+ * @param[in] y Year
+ * @param[in] m Month (1-12)
+ * @param[in] d Day of month (1-31)
+ * @returns Days since 1970-01-01
+ */
+long nmea_days_from_civil(int y, const int m, const int d) {
+	y -= (m <= 2);
+	const long era = (y >= 0 ? y : y - 399) / 400;
+	const long yoe = y - era * 400;
+	const long doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+	const long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+	return era * 146097 + doe - 719468;
+}
+
+/*!
+ * The field is converted according to f->type. Fields that are empty, not
+ * present in the message, or fail validation are returned as NAN.
+ *
+ * Hemisphere, direction and units are read from the field following the
+ * described field, where required by the conversion type.
+ *
+ * @param[in] msg Input message
+ * @param[in] tok Field positions, from nmea_tokenise()
+ * @param[in] f Field description
+ * @returns Converted value, or NAN if not available
+ */
+double nmea_decode_field(const nmea_msg_t *msg, const nmea_tokens *tok,
+                         const nmea_field_desc *f) {
+	if (f->type == NMEA_FT_FLAG) {
+		if (f->index >= tok->count || tok->length[f->index] == 0) { return NAN; }
+		return (nmea_field_char(msg, tok, f->index) == f->match) ? 1.0 : 0.0;
+	}
+
+	const double v = nmea_field_number(msg, tok, f->index);
+	if (!isfinite(v)) { return NAN; }
+
+	const char next = nmea_field_char(msg, tok, f->index + 1);
+	switch (f->type) {
+		case NMEA_FT_NUMBER:
+			return v;
+		case NMEA_FT_LATLON: {
+			if (v < 0) { return NAN; }
+			const double deg = floor(v / 100);
+			const double dd = deg + (v - deg * 100) / 60.0;
+			if (next == 'N' || next == 'E') { return dd; }
+			if (next == 'S' || next == 'W') { return -dd; }
+			return NAN;
+		}
+		case NMEA_FT_TIME: {
+			if (v < 0) { return NAN; }
+			const double h = floor(v / 10000);
+			const double m = floor(fmod(v, 10000) / 100);
+			const double s = fmod(v, 100);
+			if (h > 23 || m > 59 || s >= 61) { return NAN; }
+			return h * 3600 + m * 60 + s;
+		}
+		case NMEA_FT_DATE: {
+			if (v < 0 || tok->length[f->index] != 6) { return NAN; }
+			const int dmy = (int)v;
+			const int d = dmy / 10000;
+			const int m = (dmy / 100) % 100;
+			const int y = dmy % 100;
+			if (d < 1 || d > 31 || m < 1 || m > 12) { return NAN; }
+			// Two digit years: assume 1980-2079
+			return nmea_days_from_civil(y < 80 ? 2000 + y : 1900 + y, m, d);
+		}
+		case NMEA_FT_SIGNED:
+			return (next == 'S' || next == 'W') ? -v : v;
+		case NMEA_FT_SPEED:
+			switch (f->match ? f->match : next) {
+				case 'N':
+					return v * NMEA_KNOTS;
+				case 'K':
+					return v / 3.6;
+				case 'M':
+					return v;
+				case 'S':
+					return v * 0.44704;
+				default:
+					return NAN;
+			}
+		default:
+			return NAN;
+	}
+}
+
+/*!
+ * Decodes every field described in sd into the values array, which must have
+ * space for at least sd->nFields entries.
+ *
+ * Proprietary and encapsulated messages are never matched, as their content
+ * is not defined by the standard sentence formats.
+ *
+ * @param[in] sd Sentence description
+ * @param[in] msg Input message
+ * @param[in] tok Field positions, from nmea_tokenise()
+ * @param[out] values Array of decoded values (NAN if field not available)
+ * @returns Number of finite values decoded, or -1 if message does not match description
+ */
+int nmea_decode_message(const nmea_sentence_desc *sd, const nmea_msg_t *msg,
+                        const nmea_tokens *tok, double *values) {
+	if (!sd || !msg || !tok || !values) { return -1; }
+	if (msg->encapsulated || msg->talker[0] == 'P') { return -1; }
+	if (strncmp(sd->message, msg->message, 3) != 0) { return -1; }
+	if (tok->count < sd->minFields) { return -1; }
+
+	int valid = 0;
+	for (uint8_t f = 0; f < sd->nFields; f++) {
+		values[f] = nmea_decode_field(msg, tok, &(sd->fields[f]));
+		valid += isfinite(values[f]);
+	}
+	return valid;
+}
@@ -0,0 +1,122 @@
+/*
+ *  Copyright (C) 2023 Swansea University
+ *
+ *  This file is part of the SELKIELogger suite of tools.
+ *
+ *  SELKIELogger is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation, either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  SELKIELogger is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this SELKIELogger product.
+ *  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SELKIELoggerNMEA_Fields
+#define SELKIELoggerNMEA_Fields
+
+/*!
+ * @file NMEAFields.h Table driven NMEA sentence field descriptions and decoders
+ * @ingroup SELKIELoggerNMEA
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "NMEATypes.h"
+
+/*!
+ * @addtogroup SELKIELoggerNMEAfields Table driven NMEA decoding
+ * @ingroup SELKIELoggerNMEA
+ *
+ * Each supported sentence is described by an array of nmea_field_desc
+ * entries, giving the position of each field and how it should be converted
+ * to a numerical value. These descriptions are collected in
+ * nmea_sentence_table, and a single generic decoder converts any described
+ * message into an array of values.
+ *
+ * Messages are split into fields by nmea_tokenise(), which records the
+ * position of each field within the raw message data rather than copying
+ * the fields into a new string array.
+ *
+ * To support an additional sentence, add a field array and a matching entry
+ * in nmea_sentence_table (NMEAFields.c).
+ *
+ * @{
+ */
+
+//! Largest number of fields that can be found in a single message
+#define NMEA_MAX_FIELDS 81
+
+//! Largest number of fields that can be described for a single sentence
+#define NMEA_MAX_DECODE 16
+
+//! Field conversion types
+typedef enum {
+	NMEA_FT_NUMBER = 0, //!< Decimal number
+	NMEA_FT_LATLON,     //!< [d]ddmm.mmm position and N/S/E/W field, converted to degrees
+	NMEA_FT_TIME,       //!< hhmmss[.sss] time, converted to seconds since midnight
+	NMEA_FT_DATE,       //!< ddmmyy date, converted to days since 1970-01-01
+	NMEA_FT_SIGNED,     //!< Decimal number, negated if following field is 'S' or 'W'
+	NMEA_FT_SPEED,      //!< Speed in N/K/M/S units (see nmea_field_desc), converted to m/s
+	NMEA_FT_FLAG,       //!< 1 if field matches nmea_field_desc.match, 0 otherwise
+} nmea_field_type;
+
+//! Describe a single field within a sentence
+typedef struct {
+	const char *name;     //!< Field name, used for channel names
+	uint8_t index;        //!< Field number, counted from zero after the message ID
+	nmea_field_type type; //!< Conversion to be applied
+	char match;           //!< Value for NMEA_FT_FLAG, or fixed units for NMEA_FT_SPEED
+} nmea_field_desc;
+
+//! Describe the numerical fields within a sentence
+typedef struct {
+	char message[4];               //!< Message ID (3 characters, null terminated)
+	const char *name;              //!< Short description
+	uint8_t minFields;             //!< Minimum number of fields in a valid message
+	uint8_t nFields;               //!< Number of entries in fields
+	const nmea_field_desc *fields; //!< Field descriptions
+} nmea_sentence_desc;
+
+//! Positions of each field within a message's raw data
+typedef struct {
+	uint8_t count;                   //!< Number of fields found
+	uint8_t start[NMEA_MAX_FIELDS];  //!< Offset of each field from start of raw data
+	uint8_t length[NMEA_MAX_FIELDS]; //!< Length of each field
+} nmea_tokens;
+
+//! Table of known sentences, terminated by an entry with an empty message ID
+extern const nmea_sentence_desc nmea_sentence_table[];
+
+//! Find sentence description in nmea_sentence_table
+const nmea_sentence_desc *nmea_sentence_find(const char *message);
+
+//! Find positions of each field within message, without allocating memory
+int nmea_tokenise(const nmea_msg_t *msg, nmea_tokens *tok);
+
+//! Convert a single field to a number, returning NAN if empty or invalid
+double nmea_field_number(const nmea_msg_t *msg, const nmea_tokens *tok, const int field);
+
+//! Return first character of a field, or 0 if empty
+char nmea_field_char(const nmea_msg_t *msg, const nmea_tokens *tok, const int field);
+
+//! Convert a calendar date to days since 1970-01-01
+long nmea_days_from_civil(int y, const int m, const int d);
+
+//! Decode a single described field, returning NAN if not available
+double nmea_decode_field(const nmea_msg_t *msg, const nmea_tokens *tok,
+                         const nmea_field_desc *f);
+
+//! Decode all described fields from a single message
+int nmea_decode_message(const nmea_sentence_desc *sd, const nmea_msg_t *msg,
+                        const nmea_tokens *tok, double *values);
+//! @}
+#endif
@@ -50,6 +50,9 @@ void nmea_set_checksum(nmea_msg_t *msg);
 //! Verify checksum bytes of NMEA message
 bool nmea_check_checksum(const nmea_msg_t *msg);
 
+//! Convert pair of hexadecimal characters to a single byte
+bool nmea_hex_decode(const uint8_t hi, const uint8_t lo, uint8_t *out);
+
 //! Calculate number of bytes required to represent message
 size_t nmea_message_length(const nmea_msg_t *msg);
 
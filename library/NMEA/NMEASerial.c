@@ -204,78 +204,10 @@ bool nmea_readMessage_buf(int handle, nmea_msg_t *out, uint8_t buf[NMEA_SERIAL_B
 	if (buf[som] == NMEA_CSUM_MARK) {
 		som++; // Skip the delimiter
 		uint8_t cs = 0;
-		char csA = buf[som++];
-		char csB = buf[som++];
-		bool valid = true;
+		const uint8_t csA = buf[som++];
+		const uint8_t csB = buf[som++];
+		bool valid = nmea_hex_decode(csA, csB, &cs);
 
-		switch (csA) {
-			case 'f':
-			case 'e':
-			case 'd':
-			case 'c':
-			case 'b':
-			case 'a':
-				cs = (csA - 'a') + 10;
-				break;
-			case 'F':
-			case 'E':
-			case 'D':
-			case 'C':
-			case 'B':
-			case 'A':
-				cs = (csA - 'A') + 10;
-				break;
-			case '9':
-			case '8':
-			case '7':
-			case '6':
-			case '5':
-			case '4':
-			case '3':
-			case '2':
-			case '1':
-			case '0':
-				cs = (csA - '0');
-				break;
-			default:
-				valid = false;
-				break;
-		}
-
-		cs = (cs << 4);
-		switch (csB) {
-			case 'f':
-			case 'e':
-			case 'd':
-			case 'c':
-			case 'b':
-			case 'a':
-				cs += (csB - 'a') + 10;
-				break;
-			case 'F':
-			case 'E':
-			case 'D':
-			case 'C':
-			case 'B':
-			case 'A':
-				cs += (csB - 'A') + 10;
-				break;
-			case '9':
-			case '8':
-			case '7':
-			case '6':
-			case '5':
-			case '4':
-			case '3':
-			case '2':
-			case '1':
-			case '0':
-				cs += (csB - '0');
-				break;
-			default:
-				valid = false;
-				break;
-		}
 		out->checksum = cs;
 		cs = 0;
 		nmea_calc_checksum(out, &cs);
@@ -31,6 +31,7 @@
  * @ingroup Library
  * @{
  */
+#include "NMEA/NMEAFields.h"
 #include "NMEA/NMEAMessages.h"
 #include "NMEA/NMEASerial.h"
 #include "NMEA/NMEATypes.h"
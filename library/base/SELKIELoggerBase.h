@@ -36,5 +36,6 @@
 #include "base/queue.h"
 #include "base/serial.h"
 #include "base/sources.h"
+#include "base/statetable.h"
 
 #endif
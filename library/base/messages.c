@@ -161,6 +161,35 @@ msg_t *msg_new_bytes(const uint8_t source, const uint8_t type, const size_t len,
 	return newmsg;
 }
 
+/*!
+ * Allocates a new msg_t, sets the source and type and takes ownership of an
+ * existing array of bytes. The data type is set to MSG_BYTES.
+ *
+ * The array is not copied, and must have been allocated with malloc() or
+ * similar as it will be released by msg_destroy(). The caller must not modify
+ * or free the array once this function returns successfully, but retains
+ * ownership if NULL is returned.
+ *
+ * Used to pass filled receive buffers to the message queue without copying.
+ *
+ * @param[in] source Message source
+ * @param[in] type   Message type
+ * @param[in] len    Number of valid bytes in array
+ * @param[in] bytes  Pointer to existing, dynamically allocated, array of uint8_t
+ * @return Pointer to new message, NULL on failure
+ */
+msg_t *msg_new_bytes_owned(const uint8_t source, const uint8_t type, const size_t len, uint8_t *bytes) {
+	if (bytes == NULL) { return NULL; }
+	msg_t *newmsg = calloc(1, sizeof(msg_t));
+	if (newmsg == NULL) { return NULL; }
+	newmsg->source = source;
+	newmsg->type = type;
+	newmsg->dtype = MSG_BYTES;
+	newmsg->length = len;
+	newmsg->data.bytes = bytes;
+	return newmsg;
+}
+
 /*!
  * Allocates a new msg_t, copies in the source, type and array and sets the data type to
  * MSG_NUMARRAY
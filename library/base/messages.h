@@ -74,6 +74,7 @@ typedef struct {
 	size_t length;     //!< Data type dependent, see the msg_new functions.
 	msg_dtype_t dtype; //!< Embedded data type
 	msg_data_t data;   //!< Embedded data
+	uint64_t captured; //!< Capture time [ns, CLOCK_MONOTONIC], zero if unknown. Not serialised
 } msg_t;
 
 //! Create new message with a single numeric value
@@ -91,6 +92,9 @@ msg_t *msg_new_string_array(const uint8_t source, const uint8_t type, const stra
 //! Create a new message containing raw binary data
 msg_t *msg_new_bytes(const uint8_t source, const uint8_t type, const size_t len, const uint8_t *bytes);
 
+//! Create a new message using an existing array of bytes, without copying
+msg_t *msg_new_bytes_owned(const uint8_t source, const uint8_t type, const size_t len, uint8_t *bytes);
+
 //! Create a new message containing an array of floating point data
 msg_t *msg_new_float_array(const uint8_t source, const uint8_t type, const size_t entries, const float *array);
 
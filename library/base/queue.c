@@ -121,6 +121,9 @@ bool queue_push(msgqueue *queue, msg_t *msg) {
  * queue_destroy() or the function responsible for consuming items out of the
  * queue.
  *
+ * If `item` is the first of a chain of items (linked using queueitem.next),
+ * the whole chain is appended while holding the queue lock once.
+ *
  * @param[in] queue Pointer to queue
  * @param[in] item  Pointer to a queue item
  * @return True if item successfully appended to queue, false otherwise
@@ -128,6 +131,12 @@ bool queue_push(msgqueue *queue, msg_t *msg) {
 bool queue_push_qi(msgqueue *queue, queueitem *item) {
 	if (!queue->valid) { return false; }
 
+	// Find end of chain before locking, so the tail hint can be set correctly
+	queueitem *last = item;
+	while (last->next) {
+		last = last->next;
+	}
+
 	queueitem *qi = NULL;
 
 	if (pthread_mutex_lock(&(queue->lock))) {
@@ -141,7 +150,7 @@ bool queue_push_qi(msgqueue *queue, queueitem *item) {
 	// queueitem, unlock the queue and return.
 	if (queue->head == NULL) {
 		queue->head = item;
-		queue->tail = item;
+		queue->tail = last;
 		pthread_mutex_unlock(&(queue->lock));
 		return true;
 	}
@@ -164,9 +173,8 @@ bool queue_push_qi(msgqueue *queue, queueitem *item) {
 		qi->next = item;
 	}
 	// Update the tail pointer so the next push should jump direct to the end
-	// Note that item is a pointer, so assigning it to qi->next and queue->tail is
-	// valid
-	queue->tail = item;
+	// Note that last is a pointer, so assigning it to queue->tail is valid
+	queue->tail = last;
 	pthread_mutex_unlock(&(queue->lock));
 	return true;
 }
@@ -20,11 +20,17 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/ioctl.h>
 #include <termios.h>
 #include <unistd.h>
 
+#ifdef __linux__
+#include <linux/serial.h>
+#endif
+
 #include "serial.h"
 
 /*!
@@ -89,6 +95,58 @@ int openSerialConnection(const char *port, const int baudRate) {
 	return handle;
 }
 
+/*!
+ * Requests that the driver passes received data on immediately, rather than
+ * waiting to fill a buffer or for a latency timer to expire. This mostly
+ * affects USB-serial adapters (e.g. FTDI devices default to a 16ms latency
+ * timer).
+ *
+ * Not all drivers support this request, so failure is not necessarily an
+ * error.
+ *
+ * @param[in] handle File descriptor from openSerialConnection()
+ * @return True if low latency mode was enabled, false otherwise
+ */
+bool serial_set_low_latency(const int handle) {
+#if defined(__linux__) && defined(ASYNC_LOW_LATENCY)
+	struct serial_struct ss = {0};
+	errno = 0;
+	if (ioctl(handle, TIOCGSERIAL, &ss) < 0) { return false; }
+	if (ss.flags & ASYNC_LOW_LATENCY) { return true; }
+	ss.flags |= ASYNC_LOW_LATENCY;
+	if (ioctl(handle, TIOCSSERIAL, &ss) < 0) { return false; }
+	return true;
+#else
+	(void)handle;
+	errno = ENOTSUP;
+	return false;
+#endif
+}
+
+/*!
+ * Waits until data is available to read from handle, or the timeout expires.
+ *
+ * Works with any file descriptor, including network sockets.
+ *
+ * @param[in] handle File descriptor to wait on
+ * @param[in] timeout Maximum time to wait [ms]
+ * @return 1 if data is available, 0 on timeout, -1 on error or if the handle
+ * has been closed or disconnected
+ */
+int serial_wait_readable(const int handle, const int timeout) {
+	struct pollfd pfd = {.fd = handle, .events = POLLIN};
+	errno = 0;
+	int rs = poll(&pfd, 1, timeout);
+	if (rs < 0) {
+		// Interrupted by a signal is equivalent to a timeout here
+		if (errno == EINTR) { return 0; }
+		return -1;
+	}
+	if (rs == 0) { return 0; }
+	if (pfd.revents & (POLLERR | POLLHUP | POLLNVAL)) { return -1; }
+	return 1;
+}
+
 /*!
  * Defaults to returning -1 if a rate is not known/available at compile time.
  *
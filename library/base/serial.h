@@ -21,6 +21,8 @@
 #ifndef SELKIELoggerBase_Serial
 #define SELKIELoggerBase_Serial
 
+#include <stdbool.h>
+
 /*!
  * @file serial.h Generic serial connection and utility functions
  * @ingroup SELKIELoggerBase
@@ -33,6 +35,12 @@
 //! Open a serial connection at a given baud rate
 int openSerialConnection(const char *port, const int baudRate);
 
+//! Request low latency mode from serial driver, if supported
+bool serial_set_low_latency(const int handle);
+
+//! Wait for data to become available on a handle
+int serial_wait_readable(const int handle, const int timeout);
+
 //! Convert a numerical baud rate to termios flag
 int baud_to_flag(const int rate);
 
@@ -54,6 +54,7 @@
 #define SLSOURCE_LOCAL  0x00 //!< Messages generated by the logging software
 #define SLSOURCE_CONV   0x01 //!< Messages generated by data conversion tools
 #define SLSOURCE_TIMER  0x02 //!< Local/Software timers
+#define SLSOURCE_CAPT   0x03 //!< Message capture times (generated by the logging software)
 
 #define SLSOURCE_TEST1  0x05 //!< Test data source ID (1/3)
 #define SLSOURCE_TEST2  0x06 //!< Test data source ID (2/3)
@@ -102,5 +103,12 @@
 #define SLCHAN_LOG_WARN 0x7E //!< Warning messages
 #define SLCHAN_LOG_ERR  0x7F //!< Error messages
 
+/*!
+ * Channels containing numerical arrays can be named with this prefix followed
+ * by a comma separated list of names for each value, so that conversion tools
+ * can output each value separately.
+ */
+#define SLCHAN_PACKED_PREFIX "Packed:"
+
 //! @}
 #endif
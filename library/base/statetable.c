@@ -0,0 +1,351 @@
+/*
+ *  Copyright (C) 2023 Swansea University
+ *
+ *  This file is part of the SELKIELogger suite of tools.
+ *
+ *  SELKIELogger is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation, either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  SELKIELogger is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this SELKIELogger product.
+ *  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "messages.h"
+#include "statetable.h"
+
+_Static_assert(sizeof(state_header) == STATE_HEADER_SIZE, "Unexpected state header size");
+_Static_assert(sizeof(state_entry) == STATE_ENTRY_SIZE, "Unexpected state entry size");
+_Static_assert(sizeof(STATE_MAGIC) == sizeof(((state_header *)0)->magic), "Unexpected magic size");
+
+//! Number of attempts to read a consistent copy of an entry before giving up
+#define STATE_READ_ATTEMPTS 1000
+
+//! Total size of a state table file
+static const size_t state_table_size =
+	STATE_HEADER_SIZE + (128 * 128 * (size_t)STATE_ENTRY_SIZE);
+
+/*!
+ * The table is created and initialised under a temporary name in the same
+ * directory, then renamed to `path` so that readers never see a partially
+ * initialised table.
+ *
+ * @param[out] st State table information
+ * @param[in] path Path to table file
+ * @returns True on success, false on error
+ */
+bool state_table_create(state_table *st, const char *path) {
+	if (!st || !path) { return false; }
+	(*st) = (state_table){.handle = -1};
+
+	char *tmpName = NULL;
+	char *pc = strdup(path);
+	if (!pc) { return false; }
+	// dirname() may modify its argument, so operate on a copy
+	int rv = asprintf(&tmpName, "%s/.stateXXXXXX", dirname(pc));
+	free(pc);
+	if (rv < 0) { return false; }
+
+	st->handle = mkstemp(tmpName);
+	if (st->handle < 0) {
+		free(tmpName);
+		return false;
+	}
+	// Most other files are created with default permissions
+	fchmod(st->handle, 0644);
+
+	if (ftruncate(st->handle, state_table_size) != 0) {
+		unlink(tmpName);
+		free(tmpName);
+		state_table_close(st);
+		return false;
+	}
+
+	void *map =
+		mmap(NULL, state_table_size, PROT_READ | PROT_WRITE, MAP_SHARED, st->handle, 0);
+	if (map == MAP_FAILED) {
+		unlink(tmpName);
+		free(tmpName);
+		state_table_close(st);
+		return false;
+	}
+	st->size = state_table_size;
+	st->writable = true;
+	st->header = map;
+	st->entries = (state_entry *)((uint8_t *)map + STATE_HEADER_SIZE);
+
+	// New file is zero filled, so only the header needs setting up
+	st->header->version = STATE_VERSION;
+	st->header->entrySize = STATE_ENTRY_SIZE;
+	st->header->sources = 128;
+	st->header->channels = 128;
+	st->header->pid = getpid();
+	memcpy(st->header->magic, STATE_MAGIC, sizeof(st->header->magic));
+
+	if (rename(tmpName, path) != 0) {
+		const int e = errno;
+		unlink(tmpName);
+		free(tmpName);
+		state_table_close(st);
+		errno = e;
+		return false;
+	}
+	free(tmpName);
+	return true;
+}
+
+/*!
+ * The table is mapped read-only, and the header is checked to ensure the
+ * table has a compatible format.
+ *
+ * @param[out] st State table information
+ * @param[in] path Path to table file
+ * @returns True on success, false on error
+ */
+bool state_table_open(state_table *st, const char *path) {
+	if (!st || !path) { return false; }
+	(*st) = (state_table){.handle = -1};
+
+	st->handle = open(path, O_RDONLY | O_CLOEXEC);
+	if (st->handle < 0) { return false; }
+
+	struct stat sb = {0};
+	if (fstat(st->handle, &sb) != 0 || (size_t)sb.st_size < state_table_size) {
+		state_table_close(st);
+		errno = EINVAL;
+		return false;
+	}
+
+	void *map = mmap(NULL, state_table_size, PROT_READ, MAP_SHARED, st->handle, 0);
+	if (map == MAP_FAILED) {
+		state_table_close(st);
+		return false;
+	}
+	st->size = state_table_size;
+	st->header = map;
+	st->entries = (state_entry *)((uint8_t *)map + STATE_HEADER_SIZE);
+
+	if (strncmp(st->header->magic, STATE_MAGIC, sizeof(st->header->magic)) != 0 ||
+	    st->header->version != STATE_VERSION || st->header->entrySize != STATE_ENTRY_SIZE) {
+		state_table_close(st);
+		errno = EINVAL;
+		return false;
+	}
+	return true;
+}
+
+/*!
+ * The table file is left in place, so the final values remain available to
+ * readers.
+ *
+ * @param[in] st State table information
+ */
+void state_table_close(state_table *st) {
+	if (!st) { return; }
+	if (st->header) { munmap(st->header, st->size); }
+	if (st->handle >= 0) { close(st->handle); }
+	(*st) = (state_table){.handle = -1};
+}
+
+/*!
+ * Mark start of update to a sequence locked structure
+ * @param[in] seq Sequence number
+ */
+static inline void state_write_begin(atomic_uint *seq) {
+	atomic_store_explicit(seq, atomic_load_explicit(seq, memory_order_relaxed) + 1,
+	                      memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+}
+
+/*!
+ * Mark end of update to a sequence locked structure
+ * @param[in] seq Sequence number
+ */
+static inline void state_write_end(atomic_uint *seq) {
+	atomic_store_explicit(seq, atomic_load_explicit(seq, memory_order_relaxed) + 1,
+	                      memory_order_release);
+}
+
+/*!
+ * Copy a sequence locked structure, retrying if it is modified during the copy
+ *
+ * @param[in] seq Sequence number
+ * @param[out] dst Destination
+ * @param[in] src Source
+ * @param[in] len Size of structure
+ * @returns True if a consistent copy was made
+ */
+static bool state_read_locked(const atomic_uint *seq, void *dst, const void *src,
+                              const size_t len) {
+	for (int i = 0; i < STATE_READ_ATTEMPTS; i++) {
+		const unsigned int s1 = atomic_load_explicit(seq, memory_order_acquire);
+		if (s1 & 1) { continue; }
+		memcpy(dst, src, len);
+		atomic_thread_fence(memory_order_acquire);
+		if (atomic_load_explicit(seq, memory_order_relaxed) == s1) { return true; }
+	}
+	return false;
+}
+
+/*!
+ * Called by the writer for every message. The message count is incremented,
+ * and the message data is stored as described for state_entry.
+ *
+ * Does nothing if the table is not open for writing.
+ *
+ * @param[in] st State table information
+ * @param[in] msg Message to be recorded
+ * @param[in] timestamp Current logger timestamp
+ */
+void state_table_update(state_table *st, const msg_t *msg, const uint32_t timestamp) {
+	if (!st || !st->writable || !msg) { return; }
+
+	// Generate any text representations before the entry is locked
+	char *text = NULL;
+	if (msg->dtype == MSG_STRING || msg->dtype == MSG_STRARRAY) {
+		text = msg_data_to_string(msg);
+	}
+
+	state_entry *e = &(st->entries[(msg->source & 0x7F) * 128 + (msg->type & 0x7F)]);
+	state_write_begin(&(e->seq));
+	e->count++;
+	e->lastTimestamp = timestamp;
+	e->dtype = msg->dtype;
+	switch (msg->dtype) {
+		case MSG_FLOAT:
+			e->length = 1;
+			e->data.value = msg->data.value;
+			break;
+		case MSG_TIMESTAMP:
+			e->length = 1;
+			e->data.timestamp = msg->data.timestamp;
+			break;
+		case MSG_NUMARRAY: {
+			const size_t max = sizeof(e->data.farray) / sizeof(float);
+			const size_t n = (msg->length < max) ? msg->length : max;
+			e->length = msg->length;
+			memcpy(e->data.farray, msg->data.farray, n * sizeof(float));
+			break;
+		}
+		case MSG_STRING:
+		case MSG_STRARRAY:
+			e->length = text ? strlen(text) : 0;
+			e->data.text[0] = '\0';
+			if (text) { strncat(e->data.text, text, sizeof(e->data.text) - 1); }
+			break;
+		case MSG_BYTES:
+		default:
+			e->length = msg->length;
+			break;
+	}
+	state_write_end(&(e->seq));
+	free(text);
+}
+
+/*!
+ * The current system time is also recorded, so that readers can convert
+ * logger timestamps to an approximate date and time.
+ *
+ * @param[in] st State table information
+ * @param[in] timestamp Current logger timestamp
+ */
+void state_table_set_timestamp(state_table *st, const uint32_t timestamp) {
+	if (!st || !st->writable) { return; }
+	struct timespec now = {0};
+	clock_gettime(CLOCK_REALTIME, &now);
+
+	state_write_begin(&(st->header->seq));
+	st->header->lastTimestamp = timestamp;
+	st->header->updated = ((int64_t)now.tv_sec * 1000) + (now.tv_nsec / 1000000);
+	state_write_end(&(st->header->seq));
+}
+
+/*!
+ * @param[in] st State table information
+ * @param[in] varFile Current variable file name, truncated if required
+ */
+void state_table_set_varfile(state_table *st, const char *varFile) {
+	if (!st || !st->writable) { return; }
+	state_write_begin(&(st->header->seq));
+	memset(st->header->varFile, 0, sizeof(st->header->varFile));
+	if (varFile) { strncpy(st->header->varFile, varFile, sizeof(st->header->varFile) - 1); }
+	state_write_end(&(st->header->seq));
+}
+
+/*!
+ * @param[in] st State table information
+ * @param[in] source Source ID
+ * @param[in] channel Channel ID
+ * @param[out] out Copy of entry
+ * @returns False if a consistent copy could not be made
+ */
+bool state_table_read(const state_table *st, const uint8_t source, const uint8_t channel,
+                      state_entry *out) {
+	if (!st || !st->entries || !out || source > 127 || channel > 127) { return false; }
+	const state_entry *e = &(st->entries[source * 128 + channel]);
+	return state_read_locked(&(e->seq), out, e, sizeof(state_entry));
+}
+
+/*!
+ * @param[in] st State table information
+ * @param[out] out Copy of header
+ * @returns False if a consistent copy could not be made
+ */
+bool state_table_read_header(const state_table *st, state_header *out) {
+	if (!st || !st->header || !out) { return false; }
+	return state_read_locked(&(st->header->seq), out, st->header, sizeof(state_header));
+}
+
+/*!
+ * Output matches msg_data_to_string() for the original message, except that
+ * long strings and numeric arrays may have been truncated.
+ *
+ * Allocates a suitable character array, which must be freed by the caller.
+ *
+ * @param[in] entry State table entry (see state_table_read())
+ * @returns Pointer to string, or NULL
+ */
+char *state_entry_to_string(const state_entry *entry) {
+	if (entry == NULL) { return NULL; }
+
+	msg_t m = {.dtype = entry->dtype, .length = entry->length};
+	switch (entry->dtype) {
+		case MSG_FLOAT:
+			m.data.value = entry->data.value;
+			return msg_data_to_string(&m);
+		case MSG_TIMESTAMP:
+			m.data.timestamp = entry->data.timestamp;
+			return msg_data_to_string(&m);
+		case MSG_NUMARRAY: {
+			const size_t max = sizeof(entry->data.farray) / sizeof(float);
+			if (m.length > max) { m.length = max; }
+			// Cast away const - data is not modified
+			m.data.farray = (float *)entry->data.farray;
+			return msg_data_to_string(&m);
+		}
+		case MSG_STRING:
+		case MSG_STRARRAY:
+			return strndup(entry->data.text, sizeof(entry->data.text));
+		default:
+			return msg_data_to_string(&m);
+	}
+}
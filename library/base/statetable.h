@@ -0,0 +1,159 @@
+/*
+ *  Copyright (C) 2023 Swansea University
+ *
+ *  This file is part of the SELKIELogger suite of tools.
+ *
+ *  SELKIELogger is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation, either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  SELKIELogger is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this SELKIELogger product.
+ *  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SELKIELoggerBase_StateTable
+#define SELKIELoggerBase_StateTable
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "messages.h"
+
+/*!
+ * @file statetable.h Shared memory table of latest values for each channel
+ * @ingroup SELKIELoggerBase
+ */
+
+/*!
+ * @addtogroup statetable Shared state table
+ * @ingroup SELKIELoggerBase
+ *
+ * The logger records the most recent value, message count and timestamp for
+ * every source and channel in a memory mapped file, updating each entry in
+ * place as messages are received. Other processes can map the same file
+ * read-only to monitor current values without parsing data or state files.
+ *
+ * The file consists of a state_header followed by an array of 128x128
+ * state_entry structures (indexed by source, then channel). All values are
+ * stored in native byte order.
+ *
+ * There is a single writer (the logger's main thread), and each entry and the
+ * header are protected by a sequence lock: the sequence number is odd while an
+ * update is in progress, so readers copy an entry and retry if the sequence
+ * number was odd or changed during the copy.
+ *
+ * Tables are created under a temporary name and renamed into place, so
+ * readers never see a partially initialised table. Readers holding a mapping
+ * of a previous table will continue to see its final state, and should reopen
+ * the table if state_header.pid changes.
+ *
+ * @{
+ */
+
+//! Identifies a state table file
+#define STATE_MAGIC "SLSTATE"
+
+//! State table format version
+#define STATE_VERSION 1
+
+//! Size of state table header [bytes]
+#define STATE_HEADER_SIZE 4096
+
+//! Size of each state table entry [bytes]
+#define STATE_ENTRY_SIZE 128
+
+//! Space available in each entry for message data [bytes]
+#define STATE_VALUE_SIZE (STATE_ENTRY_SIZE - 20)
+
+//! State table header
+typedef struct {
+	char magic[8];          //!< STATE_MAGIC (null terminated)
+	uint32_t version;       //!< STATE_VERSION
+	uint32_t entrySize;     //!< STATE_ENTRY_SIZE
+	uint32_t sources;       //!< Number of sources in table (128)
+	uint32_t channels;      //!< Number of channels per source (128)
+	atomic_uint seq;        //!< Sequence number, odd while header is being updated
+	uint32_t lastTimestamp; //!< Most recent logger timestamp
+	int64_t updated;        //!< System time when lastTimestamp was updated [ms since epoch]
+	uint32_t pid;           //!< Process ID of writer
+	uint32_t reserved;      //!< Unused, set to zero
+	char varFile[STATE_HEADER_SIZE - 48]; //!< Current variable (channel map) file name
+} state_header;
+
+/*!
+ * @brief Latest message information for a single source and channel
+ *
+ * Only the data types with a fixed size are stored directly:
+ * - MSG_FLOAT and MSG_TIMESTAMP values are stored as data.value and data.timestamp
+ * - MSG_NUMARRAY values are stored in data.farray, and length is the number of
+ *   entries in the original array. Only the first STATE_VALUE_SIZE/4 entries
+ *   are stored.
+ * - MSG_STRING and MSG_STRARRAY values are stored as (null terminated) text in
+ *   data.text, in the same format as msg_data_to_string(), truncated if
+ *   required. length is the length of the original text.
+ * - For MSG_BYTES, only the length of the original message is stored.
+ */
+typedef struct {
+	atomic_uint seq;        //!< Sequence number, odd while entry is being updated
+	uint32_t count;         //!< Number of messages received
+	uint32_t lastTimestamp; //!< Logger timestamp when last message was received
+	uint8_t dtype;          //!< Data type of last message (see msg_dtype_t)
+	uint8_t reserved[3];    //!< Unused, set to zero
+	uint32_t length;        //!< Length of original message data (see above)
+	//! Message data (see above)
+	union {
+		float value;                                //!< MSG_FLOAT
+		uint32_t timestamp;                         //!< MSG_TIMESTAMP
+		float farray[STATE_VALUE_SIZE / sizeof(float)]; //!< MSG_NUMARRAY
+		char text[STATE_VALUE_SIZE];                //!< MSG_STRING, MSG_STRARRAY
+	} data;
+} state_entry;
+
+//! Mapped state table
+typedef struct {
+	int handle;             //!< File handle, or -1
+	size_t size;            //!< Size of mapping [bytes]
+	bool writable;          //!< Table opened for writing
+	state_header *header;   //!< Mapped header, or NULL
+	state_entry *entries;   //!< Mapped entries, or NULL
+} state_table;
+
+//! Create a new (empty) state table, replacing any existing table at that path
+bool state_table_create(state_table *st, const char *path);
+
+//! Open an existing state table for reading
+bool state_table_open(state_table *st, const char *path);
+
+//! Unmap and close a state table
+void state_table_close(state_table *st);
+
+//! Record a message in the state table
+void state_table_update(state_table *st, const msg_t *msg, const uint32_t timestamp);
+
+//! Update the latest logger timestamp in the state table header
+void state_table_set_timestamp(state_table *st, const uint32_t timestamp);
+
+//! Update the current variable file name in the state table header
+void state_table_set_varfile(state_table *st, const char *varFile);
+
+//! Take a consistent copy of a state table entry
+bool state_table_read(const state_table *st, const uint8_t source, const uint8_t channel,
+                      state_entry *out);
+
+//! Take a consistent copy of the state table header
+bool state_table_read_header(const state_table *st, state_header *out);
+
+//! Generate string representation of the data in a state table entry
+char *state_entry_to_string(const state_entry *entry);
+
+//! @}
+#endif
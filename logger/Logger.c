@@ -45,7 +45,10 @@ int main(int argc, char *argv[]) {
 	state.verbose = 1;
 
 	go.saveState = true;
+	go.saveTable = true;
 	go.rotateMonitor = true;
+	go.startupTimeout = DEFAULT_STARTUP_TIMEOUT;
+	go.startupRetry = DEFAULT_STARTUP_RETRY;
 
 	int verbosityModifier = 0;
 
@@ -154,6 +157,30 @@ int main(int argc, char *argv[]) {
 			go.saveState = st;
 		}
 
+		kv = NULL;
+		if ((kv = config_get_key(def, "stateinterval"))) {
+			errno = 0;
+			go.stateInterval = strtol(kv->value, NULL, 0);
+			if (errno || go.stateInterval <= 0) {
+				log_error(&state, "Invalid state file interval: %s", kv->value);
+				doUsage = true;
+			}
+		}
+
+		kv = NULL;
+		if ((kv = config_get_key(def, "statetable"))) { go.tableName = strdup(kv->value); }
+
+		kv = NULL;
+		if ((kv = config_get_key(def, "savetable"))) {
+			int st = config_parse_bool(kv->value);
+			if (st < 0) {
+				log_error(&state, "Error parsing option savetable: %s",
+				          strerror(errno));
+				doUsage = true;
+			}
+			go.saveTable = st;
+		}
+
 		kv = NULL;
 		if ((kv = config_get_key(def, "rotate"))) {
 			int rm = config_parse_bool(kv->value);
@@ -164,6 +191,114 @@ int main(int argc, char *argv[]) {
 			}
 			go.rotateMonitor = rm;
 		}
+
+		kv = NULL;
+		if ((kv = config_get_key(def, "reactor"))) {
+			int ra = config_parse_bool(kv->value);
+			if (ra < 0) {
+				log_error(&state, "Error parsing option reactor: %s",
+				          strerror(errno));
+				doUsage = true;
+			}
+			go.reactor = ra;
+		}
+
+		kv = NULL;
+		if ((kv = config_get_key(def, "capturetimes"))) {
+			if (strcasecmp(kv->value, "none") == 0) {
+				go.captureTimes = CAPTURE_NONE;
+			} else if (strcasecmp(kv->value, "frame") == 0) {
+				go.captureTimes = CAPTURE_FRAME;
+			} else if (strcasecmp(kv->value, "dense") == 0) {
+				go.captureTimes = CAPTURE_DENSE;
+			} else {
+				log_error(&state, "Invalid capture time mode: %s", kv->value);
+				doUsage = true;
+			}
+		}
+
+		kv = NULL;
+		if ((kv = config_get_key(def, "reactorthreads"))) {
+			errno = 0;
+			go.reactorThreads = strtol(kv->value, NULL, 0);
+			if (errno || go.reactorThreads < 1) {
+				log_error(&state, "Invalid number of reactor threads: %s", kv->value);
+				doUsage = true;
+			}
+		}
+
+		kv = NULL;
+		if ((kv = config_get_key(def, "startuptimeout"))) {
+			errno = 0;
+			go.startupTimeout = strtol(kv->value, NULL, 0);
+			if (errno || go.startupTimeout < 0) {
+				log_error(&state, "Invalid startup timeout: %s", kv->value);
+				doUsage = true;
+			}
+		}
+
+		kv = NULL;
+		if ((kv = config_get_key(def, "startupretry"))) {
+			errno = 0;
+			go.startupRetry = strtol(kv->value, NULL, 0);
+			if (errno || go.startupRetry < 1) {
+				log_error(&state, "Invalid startup retry interval: %s", kv->value);
+				doUsage = true;
+			}
+		}
+
+		kv = NULL;
+		if ((kv = config_get_key(def, "degraded"))) {
+			int dg = config_parse_bool(kv->value);
+			if (dg < 0) {
+				log_error(&state, "Error parsing option degraded: %s",
+				          strerror(errno));
+				doUsage = true;
+			}
+			go.degraded = dg;
+		}
+
+		kv = NULL;
+		if ((kv = config_get_key(def, "streamport"))) {
+			errno = 0;
+			go.streamPort = strtol(kv->value, NULL, 0);
+			if (errno || go.streamPort < 0 || go.streamPort > 65535) {
+				log_error(&state, "Invalid live data stream port: %s", kv->value);
+				doUsage = true;
+			}
+		}
+
+		kv = NULL;
+		if ((kv = config_get_key(def, "streamaddress"))) {
+			go.streamAddr = strdup(kv->value);
+		}
+
+		kv = NULL;
+		if ((kv = config_get_key(def, "streamsocket"))) {
+			go.streamSocket = strdup(kv->value);
+		}
+
+		kv = NULL;
+		if ((kv = config_get_key(def, "streambuffer"))) {
+			errno = 0;
+			go.streamBuffer = strtol(kv->value, NULL, 0);
+			if (errno || go.streamBuffer < 1024) {
+				log_error(&state, "Invalid live data stream buffer size: %s",
+				          kv->value);
+				doUsage = true;
+			}
+		}
+
+		kv = NULL;
+		if ((kv = config_get_key(def, "streamclients"))) {
+			errno = 0;
+			go.streamClients = strtol(kv->value, NULL, 0);
+			if (errno || go.streamClients < 1) {
+				log_error(&state, "Invalid number of live data stream clients: %s",
+				          kv->value);
+				doUsage = true;
+			}
+		}
 	}
 
 	state.verbose += verbosityModifier;
@@ -180,6 +315,12 @@ int main(int argc, char *argv[]) {
 			"State file name configured, but state file use disabled by configuration");
 	}
 
+	if (go.tableName && !go.saveTable) {
+		log_warning(
+			&state,
+			"State table name configured, but state table use disabled by configuration");
+	}
+
 	if (doUsage) {
 		fprintf(stderr, usage, argv[0]);
 		destroy_global_opts(&go);
@@ -194,10 +335,24 @@ int main(int argc, char *argv[]) {
 
 	// Default state file name is derived from the port name
 	if (!go.stateName) { go.stateName = strdup(DEFAULT_STATE_NAME); }
+	if (!go.stateInterval) { go.stateInterval = DEFAULT_STATE_INTERVAL; }
+	// Default state table name is derived from the data file prefix, so that
+	// loggers using different prefixes don't share a table
+	if (!go.tableName && asprintf(&go.tableName, "%s.%s", go.dataPrefix, "table") < 0) {
+		go.tableName = NULL;
+	}
 
 	// Set default frequency if not already set
 	if (!go.coreFreq) { go.coreFreq = DEFAULT_MARK_FREQUENCY; }
 
+	// Single reactor thread unless otherwise specified
+	if (!go.reactorThreads) { go.reactorThreads = 1; }
+
+	// Live data stream connections are only accepted locally unless otherwise specified
+	if (!go.streamAddr) { go.streamAddr = strdup("localhost"); }
+	if (!go.streamBuffer) { go.streamBuffer = STREAM_DEFAULT_BUFFER; }
+	if (!go.streamClients) { go.streamClients = STREAM_DEFAULT_CLIENTS; }
+
 	// Per thread/individual source configuration happens after this global section
 	log_info(&state, 3, "Core configuration completed");
 
@@ -294,6 +449,7 @@ int main(int argc, char *argv[]) {
 	log_info(&state, 1, "Version: " GIT_VERSION_STRING);
 
 	if (go.saveState) { log_info(&state, 1, "Using state file %s", go.stateName); }
+	if (go.saveTable) { log_info(&state, 1, "Using state table %s", go.tableName); }
 
 	// Block signal handling until we're up and running
 	signalHandlersBlock();
@@ -354,6 +510,8 @@ int main(int argc, char *argv[]) {
 		}
 	}
 	ltargs[nThreads].funcs = timer_getCallbacks();
+	// The timer is always required, so startup is never retried
+	ltargs[nThreads].startupTimeout = go.startupTimeout;
 
 	nThreads++;
 
@@ -379,6 +537,45 @@ int main(int argc, char *argv[]) {
 		}
 		ltargs[nThreads].type = strdup(type->value);
 		ltargs[nThreads].funcs = dmap_getCallbacks(type->value);
+
+		config_kv *iom = config_get_key(&(conf.sects[i]), "iomode");
+		if (iom) {
+			if (strcasecmp(iom->value, "sleep") == 0) {
+				ltargs[nThreads].ioMode = IOMODE_SLEEP;
+			} else if (strcasecmp(iom->value, "poll") == 0) {
+				ltargs[nThreads].ioMode = IOMODE_POLL;
+			} else {
+				log_error(&state, "Configuration - invalid I/O mode for \"%s\" (%s)",
+				          conf.sects[i].name, iom->value);
+				nextExit = true;
+			}
+		}
+
+		config_kv *ll = config_get_key(&(conf.sects[i]), "lowlatency");
+		if (ll) {
+			int llv = config_parse_bool(ll->value);
+			if (llv < 0) {
+				log_error(&state,
+				          "Configuration - invalid low latency option for \"%s\" (%s)",
+				          conf.sects[i].name, ll->value);
+				nextExit = true;
+			}
+			ltargs[nThreads].lowLatency = (llv > 0);
+		}
+
+		ltargs[nThreads].startupTimeout = go.startupTimeout;
+		ltargs[nThreads].startupRetry = go.degraded ? go.startupRetry : 0;
+		config_kv *sto = config_get_key(&(conf.sects[i]), "startuptimeout");
+		if (sto) {
+			errno = 0;
+			ltargs[nThreads].startupTimeout = strtol(sto->value, NULL, 0);
+			if (errno || ltargs[nThreads].startupTimeout < 0) {
+				log_error(&state,
+				          "Configuration - invalid startup timeout for \"%s\" (%s)",
+				          conf.sects[i].name, sto->value);
+				nextExit = true;
+			}
+		}
 		dc_parser dcp = dmap_getParser(type->value);
 		if (dcp == NULL) {
 			log_error(&state, "Configuration - no parser available for \"%s\" (%s)",
@@ -411,6 +608,8 @@ int main(int argc, char *argv[]) {
 				          strerror(errno));
 				return EXIT_FAILURE;
 			}
+			// Ensure new entries start from a known state
+			memset(&(ltt[ltaSize]), 0, 10 * sizeof(log_thread_args_t));
 			ltaSize += 10;
 			ltargs = ltt;
 		}
@@ -444,106 +643,153 @@ int main(int argc, char *argv[]) {
 		return EXIT_FAILURE;
 	}
 
-	for (int tix = 0; tix < nThreads; tix++) {
-		ltargs[tix].funcs.startup(&(ltargs[tix]));
-		if (ltargs[tix].returnCode < 0) {
-			log_error(&state, "Unable to set up \"%s\"", ltargs[tix].tag);
-			nextExit = true;
-			break;
-		}
-	}
-
-	if (nextExit) {
-		for (int i = 0; i < nThreads; i++) {
-			if (ltargs[i].tag) { free(ltargs[i].tag); }
-			if (ltargs[i].type) { free(ltargs[i].type); }
-			if (ltargs[i].dParams) { free(ltargs[i].dParams); }
-		}
-		free(ltargs);
+	startup_progress *progress = calloc(nThreads, sizeof(startup_progress));
+	if (!progress) {
 		state.shutdown = true;
-		log_error(&state, "Failed to initialise all data sources successfully - exiting.");
+		log_error(&state, "Unable to allocate startup information: %s", strerror(errno));
+		free(ltargs);
+		free(threads);
 		destroy_global_opts(&go);
 		destroy_program_state(&state);
-		free(threads);
 		return EXIT_FAILURE;
 	}
 
-	log_info(&state, 1, "Initialisation complete, starting log threads");
+	// Sources serviced by the reactor threads, if enabled
+	reactor_state reactor = {.epfd = -1};
+	if (go.reactor) {
+		if (!reactor_init(&reactor, &state, nThreads)) {
+			log_error(&state, "Unable to initialise reactor");
+			nextExit = true;
+		}
+		for (int tix = 0; tix < nThreads && !nextExit; tix++) {
+			if (!reactor_supported(&(ltargs[tix]))) { continue; }
+			if (!reactor_register(&reactor, &(ltargs[tix]))) {
+				log_error(&state, "Unable to register %s with reactor", ltargs[tix].tag);
+				nextExit = true;
+			}
+		}
+		log_info(&state, 1, "%d of %zd sources will be serviced by %d reactor thread(s)",
+		         reactor.numSources, nThreads, go.reactorThreads);
+	}
 
-	for (int tix = 0; tix < nThreads; tix++) {
-		if (!ltargs[tix].funcs.logging) {
-			log_error(&state,
-			          "Unable to launch thread %s - no logging function provided",
+	for (int tix = 0; tix < nThreads && !nextExit; tix++) {
+		if (!ltargs[tix].reactor && !ltargs[tix].funcs.logging) {
+			log_error(&state, "Unable to launch thread %s - no logging function",
 			          ltargs[tix].tag);
 			nextExit = true;
-			shutdownFlag = true; // Ensure threads aware
-			for (int it = tix - 1; it >= 0; --it) {
-				if (it < 0) { break; }
-				pthread_join(threads[it], NULL);
-				if (ltargs[it].returnCode != 0) {
-					log_error(&state, "Thread %d has signalled an error: %d",
-					          it, ltargs[it].returnCode);
-				}
-			}
-			break;
 		}
-		if (pthread_create(&(threads[tix]), NULL, ltargs[tix].funcs.logging,
-		                   &(ltargs[tix])) != 0) {
+	}
+
+	// Sources are armed by the reactor once they have started
+	if (go.reactor && !nextExit && !reactor_start(&reactor, go.reactorThreads)) {
+		log_error(&state, "Unable to start reactor threads");
+		nextExit = true;
+	}
+
+	/*
+	 * Each source is started in its own thread, which then continues as the
+	 * logging thread for that source. Sources begin logging as soon as they are
+	 * ready, and progress is monitored from the main loop below.
+	 */
+	ssize_t nLaunched = 0;
+	for (int tix = 0; tix < nThreads && !nextExit; tix++) {
+		if (pthread_create(&(threads[tix]), NULL, &source_thread, &(ltargs[tix])) != 0) {
 			log_error(&state, "Unable to launch %s thread", ltargs[tix].tag);
 			nextExit = true;
-			shutdownFlag = true; // Ensure threads aware
-			for (int it = tix - 1; it >= 0; --it) {
-				if (it < 0) { break; }
-				pthread_join(threads[it], NULL);
-				if (ltargs[it].returnCode != 0) {
-					log_error(&state, "Thread %d has signalled an error: %d",
-					          it, ltargs[it].returnCode);
-				}
-			}
 			break;
 		}
+		nLaunched++;
 
 #ifdef _GNU_SOURCE
 		char threadname[16] = {0};
 		snprintf(threadname, 16, "Logger: %s", ltargs[tix].tag);
 		pthread_setname_np(threads[tix], threadname);
 #endif
-		if (ltargs[tix].funcs.channels) { ltargs[tix].funcs.channels(&ltargs[tix]); }
 	}
 
 	if (nextExit) {
-		for (int i = 0; i < nThreads; i++) {
-			if (ltargs[i].tag) { free(ltargs[i].tag); }
-			if (ltargs[i].type) { free(ltargs[i].type); }
-			if (ltargs[i].dParams) { free(ltargs[i].dParams); }
+		shutdownFlag = true; // Ensure threads aware
+		bool abandoned = false;
+		for (int it = 0; it < nLaunched; it++) {
+			if (!source_join(&(ltargs[it]), threads[it])) { abandoned = true; }
+		}
+		reactor_stop(&reactor);
+		reactor_destroy(&reactor);
+		// Abandoned threads may still be using their source information
+		if (!abandoned) {
+			for (int i = 0; i < nThreads; i++) {
+				if (ltargs[i].tag) { free(ltargs[i].tag); }
+				if (ltargs[i].type) { free(ltargs[i].type); }
+				if (ltargs[i].dParams) { free(ltargs[i].dParams); }
+			}
+			free(ltargs);
 		}
-		free(ltargs);
 		state.shutdown = true;
 		log_error(&state, "Failed to start all data sources - exiting.");
 		destroy_global_opts(&go);
 		destroy_program_state(&state);
+		free(progress);
 		free(threads);
 		return EXIT_FAILURE;
 	}
 
+	log_info(&state, 1, "Initialisation complete, starting data sources");
+	// Startup deadlines are measured from this point
+	const uint64_t startTime = capture_time();
+	int startPending = nThreads;
+
 	state.started = true;
 	fflush(stdout);
 	log_info(&state, 1, "Startup complete");
 
-	if (!log_softwareVersion(&log_queue)) {
-		log_error(&state, "Error pushing version message to queue");
-		for (int i = 0; i < nThreads; i++) {
-			if (ltargs[i].tag) { free(ltargs[i].tag); }
-			if (ltargs[i].type) { free(ltargs[i].type); }
-			if (ltargs[i].dParams) { free(ltargs[i].dParams); }
+	if (!log_softwareVersion(&log_queue) || !log_captureChannels(&log_queue, go.captureTimes)) {
+		log_error(&state, "Error pushing startup messages to queue");
+		shutdownFlag = true; // Sources and reactor threads are already running
+		bool abandoned = false;
+		for (int it = 0; it < nLaunched; it++) {
+			if (!source_join(&(ltargs[it]), threads[it])) { abandoned = true; }
 		}
-		free(ltargs);
+		reactor_stop(&reactor);
+		reactor_destroy(&reactor);
+		// Abandoned threads may still be using their source information
+		if (!abandoned) {
+			for (int i = 0; i < nThreads; i++) {
+				if (ltargs[i].tag) { free(ltargs[i].tag); }
+				if (ltargs[i].type) { free(ltargs[i].type); }
+				if (ltargs[i].dParams) { free(ltargs[i].dParams); }
+			}
+			free(ltargs);
+		}
+		state.shutdown = true;
 		destroy_global_opts(&go);
 		destroy_program_state(&state);
+		free(progress);
 		free(threads);
 		return EXIT_FAILURE;
 	}
 
+	// Live data streaming server, if enabled
+	stream_server stream = {.listenTCP = -1, .listenUnix = -1, .wake = {-1, -1}};
+	if (go.streamPort > 0 || go.streamSocket) {
+		if (!stream_init(&stream, &state, go.streamAddr, go.streamPort, go.streamSocket,
+		                 go.streamBuffer, go.streamClients) ||
+		    !stream_start(&stream)) {
+			log_error(&state, "Unable to start live data streaming server");
+			shutdownFlag = true;
+		}
+	}
+
+	// Latest values for each channel, shared with monitoring tools
+	state_table table = {.handle = -1};
+	if (go.saveTable) {
+		errno = 0;
+		// Logging continues without the table if it can't be created
+		if (!state_table_create(&table, go.tableName)) {
+			log_warning(&state, "Unable to create state table: %s", strerror(errno));
+		}
+		state_table_set_varfile(&table, varFileName);
+	}
+
 	/***
 	 * Once startup is complete, enable external signal processing
 	 **/
@@ -559,6 +805,9 @@ int main(int argc, char *argv[]) {
 	// Last 'tick' / timestamp value seen
 	uint32_t lastTimestamp = 0;
 
+	// Last capture time written for each source
+	uint32_t lastCapture[128] = {0};
+
 	// Last statefile save time
 	time_t lastSave = 0;
 
@@ -589,8 +838,20 @@ int main(int argc, char *argv[]) {
 		// Increment on each iteration - used below to run tasks periodically
 		loopCount++;
 
+		// Report on sources as they start, and enforce startup deadlines
+		if (startPending > 0) {
+			const int elapsed = (capture_time() - startTime) / 1000000000;
+			startPending = source_startup_check(&state, ltargs, progress, nThreads,
+			                                    elapsed, go.degraded);
+			if (startPending == 0 && !shutdownFlag) {
+				log_info(&state, 1, "All data sources started");
+			}
+		}
+
 		// Check if any of the monitoring threads have exited with an error
 		for (int it = 0; it < nThreads; it++) {
+			// Failed startup attempts are reported above
+			if (ltargs[it].status != SOURCE_READY) { continue; }
 			if (ltargs[it].returnCode != 0) {
 				log_error(&state, "Thread %d has signalled an error: %d", it,
 				          ltargs[it].returnCode);
@@ -603,6 +864,12 @@ int main(int argc, char *argv[]) {
 			}
 		}
 
+		if (reactor.returnCode != 0) {
+			log_error(&state, "Reactor thread has signalled an error: %d",
+			          reactor.returnCode);
+			shutdownFlag = true;
+		}
+
 		// If we're not shutting down, Check if we need to pause
 		if (pauseLog && !shutdownFlag) {
 			log_info(&state, 0, "Logging paused");
@@ -647,7 +914,7 @@ int main(int argc, char *argv[]) {
 				fflush(NULL);
 				if (go.saveState) {
 					time_t now = time(NULL);
-					if ((now - lastSave) > 60) {
+					if ((now - lastSave) > go.stateInterval) {
 						errno = 0;
 						if (!write_state_file(go.stateName, stats,
 						                      lastTimestamp,
@@ -772,8 +1039,12 @@ int main(int argc, char *argv[]) {
 				fclose(go.varFile);
 				log_info(&state, 2, "Using variable file %s.var", go.monFileStem);
 				go.varFile = newVar;
+				state_table_set_varfile(&table, varFileName);
 			}
 
+			// Ensure capture times are repeated in the new files
+			memset(lastCapture, 0, sizeof(lastCapture));
+
 			// Re-request channel names for the new files
 			for (int tix = 0; tix < nThreads; tix++) {
 				if (ltargs[tix].funcs.channels) {
@@ -787,6 +1058,12 @@ int main(int argc, char *argv[]) {
 				return -1;
 			}
 
+			if (!log_captureChannels(&log_queue, go.captureTimes)) {
+				log_error(&state,
+				          "Unable to push capture time channel map to queue");
+				return -1;
+			}
+
 			log_info(&state, 0, "%d messages read successfully - resetting count",
 			         msgCount);
 			msgCount = 0;
@@ -794,6 +1071,9 @@ int main(int argc, char *argv[]) {
 			rotateNow = false;
 		}
 
+		// Names and channel maps for new live data clients
+		stream_catchup(&stream, stats);
+
 		// Check for waiting messages to be logged
 		msg_t *res = queue_pop(&log_queue);
 		if (res == NULL) {
@@ -802,7 +1082,9 @@ int main(int argc, char *argv[]) {
 			continue;
 		}
 		msgCount++;
-		if (!mp_writeMessage(fileno(go.monitorFile), res)) {
+		if (!write_capture_time(fileno(go.monitorFile), &stream, go.captureTimes, res,
+		                        lastCapture) ||
+		    !write_message(fileno(go.monitorFile), &stream, res)) {
 			log_error(&state, "Unable to write out data to log file: %s",
 			          strerror(errno));
 			return -1;
@@ -813,7 +1095,9 @@ int main(int argc, char *argv[]) {
 
 		if (res->type == SLCHAN_TSTAMP && res->source == 0x02) {
 			lastTimestamp = res->data.timestamp;
+			state_table_set_timestamp(&table, lastTimestamp);
 		}
+		state_table_update(&table, res, lastTimestamp);
 
 		stats[res->source][res->type].count++;
 		stats[res->source][res->type].lastTimestamp = lastTimestamp;
@@ -830,24 +1114,37 @@ int main(int argc, char *argv[]) {
 	state.shutdown = true;
 	shutdownFlag = true; // Ensure threads aware
 	log_info(&state, 1, "Shutting down");
+	stream_stop(&stream);
+	stream_destroy(&stream);
+	state_table_close(&table);
+	bool abandoned = false;
 	for (int it = 0; it < nThreads; it++) {
-		pthread_join(threads[it], NULL);
+		if (!source_join(&(ltargs[it]), threads[it])) {
+			progress[it].abandoned = true;
+			abandoned = true;
+			continue;
+		}
 		if (ltargs[it].returnCode != 0) {
 			log_error(&state, "Thread %d (%s) has signalled an error: %d", it,
 			          ltargs[it].tag, ltargs[it].returnCode);
 		}
 	}
+	reactor_stop(&reactor);
 
 	for (int tix = 0; tix < nThreads; tix++) {
+		if (progress[tix].abandoned) { continue; }
 		ltargs[tix].funcs.shutdown(&(ltargs[tix]));
 	}
+	reactor_destroy(&reactor);
 
-	for (int i = 0; i < nThreads; i++) {
+	// Abandoned threads may still be using their source information
+	for (int i = 0; i < nThreads && !abandoned; i++) {
 		if (ltargs[i].tag) { free(ltargs[i].tag); }
 		if (ltargs[i].type) { free(ltargs[i].type); }
 		if (ltargs[i].dParams) { free(ltargs[i].dParams); }
 	}
-	free(ltargs);
+	if (!abandoned) { free(ltargs); }
+	free(progress);
 	free(threads);
 
 	if (queue_count(&log_queue) > 0) {
@@ -856,7 +1153,9 @@ int main(int argc, char *argv[]) {
 			msg_t *res = queue_pop(&log_queue);
 			msgCount++;
 			msgCount++;
-			mp_writeMessage(fileno(go.monitorFile), res);
+			write_capture_time(fileno(go.monitorFile), NULL, go.captureTimes, res,
+			                   lastCapture);
+			write_message(fileno(go.monitorFile), NULL, res);
 			msg_destroy(res);
 			free(res);
 		}
@@ -919,6 +1218,368 @@ bool timespec_subtract(struct timespec *result, struct timespec *x, struct times
 	return x->tv_sec < y->tv_sec;
 }
 
+/*!
+ * Used by logging threads between calls to their `readable` functions.
+ *
+ * In IOMODE_POLL mode, waits until data is available on the handle (up to
+ * IOMODE_POLL_TIMEOUT ms) so that threads wake as soon as data arrives.
+ * Otherwise, or if the handle is invalid or has been disconnected, sleeps for
+ * the specified interval.
+ *
+ * @param[in] args Pointer to log_thread_args_t
+ * @param[in] handle Handle to wait on
+ * @param[in] sleepTime Sleep interval [us]
+ */
+void source_wait(log_thread_args_t *args, const int handle, const useconds_t sleepTime) {
+	if (args->ioMode == IOMODE_POLL && handle >= 0) {
+		if (serial_wait_readable(handle, IOMODE_POLL_TIMEOUT) >= 0) { return; }
+	}
+	usleep(sleepTime);
+}
+
+/*!
+ * Runs the source's startup function, repeating it every args->startupRetry
+ * seconds until it succeeds (if enabled). Startup functions release anything
+ * they have opened or allocated when they fail, so each attempt starts from
+ * the same state. Once started, low latency mode is
+ * configured if requested, the source's channel map is queued and this thread
+ * continues as the source's logging thread. Sources serviced by the reactor
+ * threads have no logging thread, so the thread exits at this point.
+ *
+ * Progress is reported through args->status, which is monitored by main().
+ * The returnCode from a failed startup attempt is cleared before retrying, so
+ * that only sources that have started successfully can trigger a shutdown
+ * through their returnCode.
+ *
+ * @param[in] ptargs Pointer to log_thread_args_t
+ * @returns NULL, or the return value of the source's logging function
+ */
+void *source_thread(void *ptargs) {
+	signalHandlersBlock();
+	log_thread_args_t *args = (log_thread_args_t *)ptargs;
+
+	while (true) {
+		args->returnCode = 0;
+		args->funcs.startup(args);
+		if (args->returnCode >= 0) { break; }
+		if (args->startupRetry <= 0 || shutdownFlag) {
+			args->status = SOURCE_FAILED;
+			return NULL;
+		}
+		log_warning(args->pstate, "Unable to set up \"%s\" - retrying in %d seconds",
+		            args->tag, args->startupRetry);
+		args->returnCode = 0;
+		args->status = SOURCE_RETRYING;
+		// Short sleeps, so that shutdown isn't delayed
+		for (int s = 0; s < 10 * args->startupRetry && !shutdownFlag; s++) {
+			usleep(1E5);
+		}
+		if (shutdownFlag) {
+			args->status = SOURCE_FAILED;
+			return NULL;
+		}
+	}
+
+	if (args->lowLatency && args->funcs.handle) {
+		int h = args->funcs.handle(args);
+		if (h >= 0 && serial_set_low_latency(h)) {
+			log_info(args->pstate, 2, "Low latency mode enabled for \"%s\"",
+			         args->tag);
+		} else {
+			log_warning(args->pstate,
+			            "Unable to enable low latency mode for \"%s\": %s", args->tag,
+			            strerror(errno));
+		}
+	}
+
+	if (args->funcs.channels) { args->funcs.channels(args); }
+	args->status = SOURCE_READY;
+
+	if (args->reactor) { return NULL; }
+	return args->funcs.logging(args);
+}
+
+/*!
+ * Logs sources as they start, and sets shutdownFlag if a source fails to
+ * start or misses its startup deadline, unless degraded operation is enabled.
+ * In that case, a warning is logged and the source continues to be retried
+ * in the background by source_thread().
+ *
+ * @param[in] pstate Program state, used for logging
+ * @param[in] ltargs Source information array
+ * @param[in,out] progress Startup progress for each source
+ * @param[in] nThreads Number of entries in ltargs and progress
+ * @param[in] elapsed Time since sources were started [s]
+ * @param[in] degraded Continue without sources that fail to start
+ * @returns Number of sources still starting
+ */
+int source_startup_check(program_state *pstate, log_thread_args_t *ltargs,
+                         startup_progress *progress, const int nThreads, const int elapsed,
+                         const bool degraded) {
+	int pending = 0;
+	for (int it = 0; it < nThreads; it++) {
+		log_thread_args_t *lta = &(ltargs[it]);
+		startup_progress *sp = &(progress[it]);
+		if (sp->status == SOURCE_READY || sp->status == SOURCE_FAILED) { continue; }
+
+		const source_status st = lta->status;
+		if (st != sp->status) {
+			sp->status = st;
+			if (st == SOURCE_READY) {
+				log_info(pstate, 1, "\"%s\" started after %d seconds", lta->tag,
+				         elapsed);
+				continue;
+			} else if (st == SOURCE_FAILED) {
+				log_error(pstate, "Unable to set up \"%s\"", lta->tag);
+				shutdownFlag = true;
+				continue;
+			} else if (st == SOURCE_RETRYING) {
+				log_warning(pstate, "\"%s\" failed to start - continuing",
+				            lta->tag);
+			}
+		}
+
+		if (!sp->overdue && lta->startupTimeout > 0 && elapsed >= lta->startupTimeout) {
+			sp->overdue = true;
+			if (degraded) {
+				log_warning(pstate, "\"%s\" not started within %d seconds",
+				            lta->tag, lta->startupTimeout);
+			} else {
+				log_error(pstate, "\"%s\" not started within %d seconds", lta->tag,
+				          lta->startupTimeout);
+				shutdownFlag = true;
+			}
+		}
+		pending++;
+	}
+	return pending;
+}
+
+/*!
+ * Threads for sources that have started are waited on indefinitely, as their
+ * logging functions will exit once shutdownFlag is set. Sources that are still
+ * starting may be blocked in their startup function, so these are given
+ * STARTUP_JOIN_TIMEOUT seconds before being abandoned.
+ *
+ * Abandoned threads may still access their log_thread_args_t structure, so
+ * this (and the source's parameters) must not be released.
+ *
+ * @param[in] args Pointer to log_thread_args_t for this thread
+ * @param[in] thread Thread handle
+ * @returns True if thread has exited, false if abandoned
+ */
+bool source_join(log_thread_args_t *args, pthread_t thread) {
+	if (args->status == SOURCE_READY) {
+		pthread_join(thread, NULL);
+		return true;
+	}
+
+	struct timespec deadline = {0};
+	clock_gettime(CLOCK_REALTIME, &deadline);
+	deadline.tv_sec += STARTUP_JOIN_TIMEOUT;
+	if (pthread_timedjoin_np(thread, NULL, &deadline) == 0) { return true; }
+	log_warning(args->pstate, "\"%s\" has not finished starting - abandoning", args->tag);
+	return false;
+}
+
+/*!
+ * @returns Current CLOCK_MONOTONIC time [ns]
+ */
+uint64_t capture_time(void) {
+	struct timespec now = {0};
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+/*!
+ * Sources should update args->captured (using capture_time()) as data is
+ * read from a device or a sample is taken, so that all messages generated
+ * from that data are tagged with the same capture time regardless of any
+ * later queuing delays.
+ *
+ * The message is not destroyed on failure.
+ *
+ * @param[in] args Pointer to log_thread_args_t
+ * @param[in] msg Message to be queued
+ * @returns True on success, false if message could not be queued
+ */
+bool source_push(log_thread_args_t *args, msg_t *msg) {
+	if (msg == NULL) { return false; }
+	msg->captured = args->captured;
+	return queue_push(args->logQ, msg);
+}
+
+/*!
+ * Sources generating several messages from each read or sample can add them
+ * to a batch, then queue them with a single call to source_batch_push(), so
+ * that the queue lock is only taken once.
+ *
+ * The message is not destroyed on failure.
+ *
+ * @param[in] args Pointer to log_thread_args_t
+ * @param[in,out] batch Batch to be extended
+ * @param[in] msg Message to be added
+ * @returns True on success, false if message could not be added
+ */
+bool source_batch_add(log_thread_args_t *args, source_batch *batch, msg_t *msg) {
+	if (msg == NULL) { return false; }
+	queueitem *qi = calloc(1, sizeof(queueitem));
+	if (qi == NULL) { return false; }
+	msg->captured = args->captured;
+	qi->item = msg;
+	if (batch->head == NULL) {
+		batch->head = qi;
+	} else {
+		batch->tail->next = qi;
+	}
+	batch->tail = qi;
+	batch->count++;
+	return true;
+}
+
+/*!
+ * On failure, the messages in the batch are destroyed.
+ *
+ * @param[in] args Pointer to log_thread_args_t
+ * @param[in,out] batch Batch to be queued
+ * @returns True on success (or if the batch is empty), false on error
+ */
+bool source_batch_push(log_thread_args_t *args, source_batch *batch) {
+	if (batch->head == NULL) { return true; }
+	if (!queue_push_qi(args->logQ, batch->head)) {
+		source_batch_discard(batch);
+		return false;
+	}
+	*batch = (source_batch){0};
+	return true;
+}
+
+/*!
+ * @param[in,out] batch Batch to be emptied
+ */
+void source_batch_discard(source_batch *batch) {
+	queueitem *qi = batch->head;
+	while (qi) {
+		queueitem *next = qi->next;
+		msg_destroy(qi->item);
+		free(qi->item);
+		free(qi);
+		qi = next;
+	}
+	*batch = (source_batch){0};
+}
+
+/*!
+ * Used by raw capture sources to pass received data to the main thread.
+ *
+ * The message is stamped with args->captured as for source_push(), so the
+ * time of the read that completed this chunk can be recorded using the
+ * `capturetimes` option.
+ *
+ * If the chunk fills at least half of the buffer, the buffer itself becomes
+ * the message payload and a new (uninitialised) buffer is allocated in its
+ * place. Smaller chunks are copied into a new message and the buffer is kept,
+ * so that short messages do not hold on to a full size buffer. In either case
+ * the buffer contents need not be cleared before reuse.
+ *
+ * @param[in] args Pointer to log_thread_args_t
+ * @param[in] source Source ID for messages
+ * @param[in,out] buf Pointer to receive buffer, which may be replaced
+ * @param[in] len Number of bytes held in buffer
+ * @param[in] size Allocated size of buffer
+ * @returns True on success, false if messages could not be queued
+ */
+bool source_push_buffer(log_thread_args_t *args, const uint8_t source, uint8_t **buf,
+                        const int len, const int size) {
+	msg_t *sm = NULL;
+	if (len >= size / 2) {
+		uint8_t *nb = malloc(size);
+		if (nb) {
+			sm = msg_new_bytes_owned(source, SLCHAN_RAW, len, *buf);
+			if (sm) {
+				*buf = nb;
+			} else {
+				free(nb);
+			}
+		}
+	}
+
+	// Copy if buffer not handed off (small chunk or allocation failure)
+	if (sm == NULL) { sm = msg_new_bytes(source, SLCHAN_RAW, len, *buf); }
+
+	if (!source_push(args, sm)) {
+		msg_destroy(sm);
+		free(sm);
+		return false;
+	}
+	return true;
+}
+
+/*!
+ * Called by the main thread before writing each message to the data file.
+ *
+ * Capture times are written as timestamps with the source ID set to
+ * SLSOURCE_CAPT and the channel number set to the source ID of the message
+ * being described, so they can't be confused with any timestamps generated by
+ * the source itself. They use the same CLOCK_MONOTONIC base as the timer
+ * sources.
+ *
+ * In CAPTURE_FRAME mode, a timestamp in milliseconds is written whenever the
+ * capture time for a source changes, so groups of messages generated from the
+ * same read or sample share a single timestamp.
+ *
+ * In CAPTURE_DENSE mode, a timestamp in microseconds is written before every
+ * message. This 32 bit counter wraps every ~71 minutes, but can be unwrapped
+ * using the millisecond resolution timer channel.
+ *
+ * Messages without capture times, and channel names, maps and log messages,
+ * are skipped. Messages from sources 0x7D-0x7F are also skipped, as these
+ * source IDs would be written to the log message channels of SLSOURCE_CAPT.
+ *
+ * @param[in] handle Data file handle
+ * @param[in] ss Live data streaming server (may be NULL)
+ * @param[in] mode Capture time output mode
+ * @param[in] msg Message about to be written
+ * @param[in,out] lastCapture Last capture time written for each source [ms]
+ * @returns False on write failure, true otherwise
+ */
+bool write_capture_time(const int handle, stream_server *ss, const capture_mode mode,
+                        const msg_t *msg, uint32_t lastCapture[128]) {
+	if (mode == CAPTURE_NONE || msg->captured == 0) { return true; }
+	if (msg->type == SLCHAN_NAME || msg->type == SLCHAN_MAP || msg->type >= SLCHAN_LOG_INFO) {
+		return true;
+	}
+	if (msg->source >= SLCHAN_LOG_INFO) { return true; }
+
+	msg_t cm = {.source = SLSOURCE_CAPT, .type = msg->source, .dtype = MSG_TIMESTAMP, .length = 1};
+	if (mode == CAPTURE_FRAME) {
+		cm.data.timestamp = msg->captured / 1000000;
+		if (cm.data.timestamp == lastCapture[msg->source]) { return true; }
+		lastCapture[msg->source] = cm.data.timestamp;
+	} else {
+		cm.data.timestamp = msg->captured / 1000;
+	}
+	return write_message(handle, ss, &cm);
+}
+
+/*!
+ * Each message is packed once, and the same frame is written to the data file
+ * and passed to stream_publish().
+ *
+ * @param[in] handle Data file handle
+ * @param[in] ss Live data streaming server (may be NULL)
+ * @param[in] msg Message to be written
+ * @returns True if message successfully written to data file
+ */
+bool write_message(const int handle, stream_server *ss, const msg_t *msg) {
+	msgpack_sbuffer sbuf;
+	if (!mp_packMessage(&sbuf, msg)) { return false; }
+	const bool ok = (write(handle, sbuf.data, sbuf.size) == (ssize_t)sbuf.size);
+	if (ok) { stream_publish(ss, msg, sbuf.data, sbuf.size); }
+	msgpack_sbuffer_destroy(&sbuf);
+	return ok;
+}
+
 /*!
  * @param[in] q Log queue
  * @return True on success
@@ -934,6 +1595,50 @@ bool log_softwareVersion(msgqueue *q) {
 	return true;
 }
 
+/*!
+ * Capture times use the source ID being described as the channel number, so
+ * the map names each channel after the corresponding source ID. Channels that
+ * would overlap the name, map and log channels are not used (see
+ * write_capture_time()).
+ *
+ * Nothing is pushed if capture times are disabled.
+ *
+ * @param[in] q Log queue
+ * @param[in] mode Capture time output mode
+ * @return True on success
+ */
+bool log_captureChannels(msgqueue *q, const capture_mode mode) {
+	if (mode == CAPTURE_NONE) { return true; }
+
+	const char *name = (mode == CAPTURE_DENSE) ? "Capture Times [us]" : "Capture Times [ms]";
+	msg_t *m_sn = msg_new_string(SLSOURCE_CAPT, SLCHAN_NAME, strlen(name), name);
+	if (!queue_push(q, m_sn)) {
+		msg_destroy(m_sn);
+		free(m_sn);
+		return false;
+	}
+
+	strarray *channels = sa_new(SLCHAN_LOG_INFO);
+	if (!channels) { return false; }
+	sa_create_entry(channels, SLCHAN_NAME, 4, "Name");
+	sa_create_entry(channels, SLCHAN_MAP, 8, "Channels");
+	for (int c = SLSOURCE_TIMER; c < SLCHAN_LOG_INFO; c++) {
+		char cn[16] = {0};
+		const int len = snprintf(cn, sizeof(cn), "Capture:%02X", c);
+		sa_create_entry(channels, c, len, cn);
+	}
+
+	msg_t *m_cmap = msg_new_string_array(SLSOURCE_CAPT, SLCHAN_MAP, channels);
+	sa_destroy(channels);
+	free(channels);
+	if (!queue_push(q, m_cmap)) {
+		msg_destroy(m_cmap);
+		free(m_cmap);
+		return false;
+	}
+	return true;
+}
+
 /*!
  * The global_opts structure should be left in a safe state after calling this
  * function, and calling this function repeatedly should not cause an error.
@@ -944,12 +1649,18 @@ void destroy_global_opts(struct global_opts *go) {
 	if (go->configFileName) { free(go->configFileName); }
 	if (go->dataPrefix) { free(go->dataPrefix); }
 	if (go->stateName) { free(go->stateName); }
+	if (go->tableName) { free(go->tableName); }
 	if (go->monFileStem) { free(go->monFileStem); }
+	if (go->streamAddr) { free(go->streamAddr); }
+	if (go->streamSocket) { free(go->streamSocket); }
 
 	go->configFileName = NULL;
 	go->dataPrefix = NULL;
 	go->stateName = NULL;
+	go->tableName = NULL;
 	go->monFileStem = NULL;
+	go->streamAddr = NULL;
+	go->streamSocket = NULL;
 
 	if (go->monitorFile) { fclose(go->monitorFile); }
 	if (go->varFile) { fclose(go->varFile); }
@@ -987,15 +1698,23 @@ bool write_state_file(char *sFName, channel_stats stats[128][128], uint32_t lTS,
 
 	int sfilefd = mkstemp(tmptmp);
 	FILE *stateFile = fdopen(sfilefd, "w");
-	if (stateFile == NULL) { return false; }
+	if (stateFile == NULL) {
+		if (sfilefd >= 0) {
+			close(sfilefd);
+			unlink(tmptmp);
+		}
+		free(tmptmp);
+		return false;
+	}
 	fprintf(stateFile, "%u\n", lTS);
 	fprintf(stateFile, "%s\n", vFName);
 	for (int s = 0; s < 128; s++) {
 		for (int c = 0; c < 128; c++) {
 			if (stats[s][c].count > 0) {
+				char *val = msg_data_to_string(stats[s][c].lastMessage);
 				fprintf(stateFile, "0x%02x,0x%02x,%u,%u,\'%s\'\n", s, c,
-				        stats[s][c].count, stats[s][c].lastTimestamp,
-				        msg_data_to_string(stats[s][c].lastMessage));
+				        stats[s][c].count, stats[s][c].lastTimestamp, val);
+				free(val);
 			}
 		}
 	}
@@ -1005,6 +1724,7 @@ bool write_state_file(char *sFName, channel_stats stats[128][128], uint32_t lTS,
 	if (rename(tmptmp, sFName) < 0) {
 		perror("write_state_file:rename");
 		unlink(tmptmp);
+		free(tmptmp);
 		return false;
 	}
 	if (!unlink(tmptmp)) {
@@ -1012,5 +1732,6 @@ bool write_state_file(char *sFName, channel_stats stats[128][128], uint32_t lTS,
 		// While not ideal don't want to stop logging in this instance, so return true
 		// anyway
 	}
+	free(tmptmp);
 	return true;
 }
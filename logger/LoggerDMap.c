@@ -47,6 +47,7 @@ struct dmap dmap[] = {
 	{"SERIAL", &rx_getCallbacks, &rx_parseConfig},
 	{"NET", &net_getCallbacks, &net_parseConfig},
 	{"TCP", &net_getCallbacks, &net_parseConfig},
+	{"UDP", &udp_getCallbacks, &udp_parseConfig},
 	{"TIMER", &timer_getCallbacks, &timer_parseConfig},
 	{"TICK", &timer_getCallbacks, &timer_parseConfig},
 	{"LPMS", &lpms_getCallbacks, &lpms_parseConfig},
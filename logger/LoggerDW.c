@@ -25,6 +25,7 @@
 #include "LoggerSignals.h"
 
 #include <fcntl.h>
+#include <math.h>
 #include <netdb.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
@@ -42,6 +43,7 @@
  */
 void *dw_setup(void *ptargs) {
 	log_thread_args_t *args = (log_thread_args_t *)ptargs;
+	dw_params *dwInfo = (dw_params *)args->dParams;
 
 	// Delegate connection logic to net_ functions
 	if (!dw_net_connect(ptargs)) {
@@ -50,231 +52,427 @@ void *dw_setup(void *ptargs) {
 		return NULL;
 	}
 
+	dwInfo->hw = 0;
+	dwInfo->lastRead = time(NULL);
+	dwInfo->lastGoodSignal = dwInfo->lastRead;
+
 	log_info(args->pstate, 2, "[DW:%s] Connected", args->tag);
 	args->returnCode = 0;
 	return NULL;
 }
 
 /*!
- * Reads messages from the connection established by dw_setup(), and pushes them to the
- * queue. As messages are already in the right format, no further processing is done here.
+ * Reads all data currently available from the connection established by
+ * dw_setup(), decodes it and pushes the results to the queue along with the
+ * raw data.
+ *
+ * Every complete HXV line received is decoded (see dw_process_hxv()), and any
+ * partial line is kept until the remainder is received. The decoded values
+ * and raw data from each read are queued together as a single batch.
+ *
+ * If no data has been received within the configured timeout, the connection
+ * is closed and reopened. This relies on this function being called
+ * periodically, even when no data is available.
+ *
+ * Does not block, so can be called repeatedly by dw_logging() or by the
+ * reactor threads.
  *
  * @param[in] ptargs Pointer to log_thread_args_t
- * @returns NULL - thread terminated on error.
+ * @returns NULL - Error code set in ptargs->returnCode if required
  */
-void *dw_logging(void *ptargs) {
-	signalHandlersBlock();
+void *dw_readable(void *ptargs) {
 	log_thread_args_t *args = (log_thread_args_t *)ptargs;
 	dw_params *dwInfo = (dw_params *)args->dParams;
 
-	log_info(args->pstate, 1, "[DW:%s] Logging thread started", args->tag);
-
-	const size_t bufSize = 1024;
-	uint8_t *buf = calloc(bufSize, sizeof(uint8_t));
-	int dw_hw = 0;
-	time_t lastRead = time(NULL);
-	time_t lastGoodSignal = time(NULL);
-
-	uint16_t cycdata[20] = {0};
-	uint8_t cCount = 0;
-
-	bool sdset[16] = {0};
-	uint16_t sysdata[16] = {0};
+	uint8_t *buf = dwInfo->buf;
 	while (!shutdownFlag) {
 		time_t now = time(NULL);
-		if ((lastRead + dwInfo->timeout) < now) {
+		if ((dwInfo->lastRead + dwInfo->timeout) < now) {
 			log_warning(args->pstate, "[DW:%s] Network timeout, reconnecting",
 			            args->tag);
 			close(dwInfo->handle);
 			dwInfo->handle = -1;
 			errno = 0;
-			if (net_connect(args)) {
+			if (dw_net_connect(args)) {
 				log_info(args->pstate, 1, "[DW:%s] Reconnected", args->tag);
+				dwInfo->lastRead = now;
 			} else {
 				log_error(args->pstate, "[DW:%s] Unable to reconnect: %s",
 				          args->tag, strerror(errno));
 				args->returnCode = -2;
-				pthread_exit(&(args->returnCode));
 				return NULL;
 			}
 		}
 
 		int ti = 0;
-		if (dw_hw < (ssize_t)(bufSize - 1)) {
+		if (dwInfo->hw < DW_BUFF) {
 			errno = 0;
-			ti = read(dwInfo->handle, &(buf[dw_hw]), bufSize - dw_hw);
-			if (ti >= 0) {
-				dw_hw += ti;
-				if (ti > 0) {
-					// 0 may not be an error, but could be a dropped
-					// connection if it persists
-					lastRead = now;
-				}
-			} else {
-				if (errno != EAGAIN) {
-					// clang-format off
-					log_error(args->pstate, "[DW:%s] Unexpected error while reading from network (%s)",
-					          args->tag, strerror(errno));
-					// clang-format on
-					args->returnCode = -1;
-					pthread_exit(&(args->returnCode));
-				}
+			ti = read(dwInfo->handle, &(buf[dwInfo->hw]), DW_BUFF - dwInfo->hw);
+			if (ti > 0) {
+				dwInfo->hw += ti;
+				args->captured = capture_time();
+				// 0 may not be an error, but could be a dropped
+				// connection if it persists
+				dwInfo->lastRead = now;
+			} else if (ti < 0 && errno != EAGAIN) {
+				// clang-format off
+				log_error(args->pstate, "[DW:%s] Unexpected error while reading from network (%s)",
+				          args->tag, strerror(errno));
+				// clang-format on
+				args->returnCode = -1;
+				return NULL;
 			}
 		}
 
-		if (dw_hw < 25) {
-			// Sleep briefly, then loop until we have more than the minimum
-			// number of bytes available
-			usleep(5E4);
-			continue;
+		if (dwInfo->hw < 25) {
+			// Wait until we have more than the minimum number of bytes available
+			return NULL;
 		}
 		/////////// Message parsing
-		size_t end = dw_hw;
-		dw_hxv tmp = {0};
-		if (dw_string_hxv((char *)buf, &end, &tmp)) {
-			uint16_t cd = dw_hxv_cycdat(&tmp);
-			// Parse and queue
-			dw_push_message(args, dwInfo->sourceNum, DWCHAN_SIG, tmp.status);
-			if (tmp.status < 2) {
-				lastGoodSignal = now;
-				dw_push_message(args, dwInfo->sourceNum, DWCHAN_DN,
-				                dw_hxv_north(&tmp));
-				dw_push_message(args, dwInfo->sourceNum, DWCHAN_DW,
-				                dw_hxv_west(&tmp));
-				dw_push_message(args, dwInfo->sourceNum, DWCHAN_DV,
-				                dw_hxv_vertical(&tmp));
-				cycdata[cCount++] = cd;
+		// Decode every complete line currently held, leaving any partial
+		// line in the buffer until the rest of it has been received
+		source_batch batch = {0};
+		bool ok = true;
+		size_t pos = 0;
+		uint8_t *le = NULL;
+		while (ok && (le = memchr(&(buf[pos]), '\r', dwInfo->hw - pos))) {
+			size_t end = (le - &(buf[pos])) + 1;
+			dw_hxv tmp = {0};
+			if (dw_string_hxv((char *)&(buf[pos]), &end, &tmp)) {
+				dwInfo->records++;
+				ok &= dw_process_hxv(args, &batch, &tmp, now);
+			} else {
+				dwInfo->invalid++;
 			}
+			pos += end;
+			// Keep line feeds with the line they terminate
+			if (pos < (size_t)dwInfo->hw && buf[pos] == '\n') { pos++; }
+		}
+		if (!ok) {
+			source_batch_discard(&batch);
+			return NULL;
+		}
+
+		if (pos == 0 && dwInfo->hw == DW_BUFF) {
+			// Full buffer without a line ending, so can't be HXV data
+			dwInfo->invalid++;
+			pos = DW_BUFF;
 		}
 
-		if ((now - lastGoodSignal) > 300) {
+		if ((now - dwInfo->lastGoodSignal) > 300) {
 			log_warning(args->pstate, "[DW:%s] No valid data received from buoy",
 			            args->tag);
 			// Reset timer for another 5 minutes
-			lastGoodSignal = now;
-		}
-
-		if (cCount > 18) {
-			bool syncFound = false;
-			for (int i = 0; i < cCount; ++i) {
-				if (cycdata[i] == 0x7FFF) {
-					syncFound = true;
-					if (i > 0) {
-						for (int j = 0; j < cCount && (j + i) < 20; ++j) {
-							cycdata[j] = cycdata[j + i];
-						}
-						cCount = cCount - i;
-					}
-					break; // End search
-				}
-			}
-			if (!syncFound) {
-				cCount = 0;
-				memset(cycdata, 0, 20 * sizeof(cycdata[0]));
-				continue; // Continue main processing loop
-			}
+			dwInfo->lastGoodSignal = now;
+		}
 
-			dw_spectrum ds = {0};
-			if (!dw_spectrum_from_array(cycdata, &ds)) {
-				log_info(args->pstate, 1, "[DW:%s] Invalid spectrum data (cCount: %d)\n",
-				         args->tag, cCount);
-			} else {
-				sysdata[ds.sysseq] = ds.sysword;
-				sdset[ds.sysseq] = true;
-				// Parse and queue frequency data?
-				if (dwInfo->parseSpectrum) {
-					for (int n = 0; n < 4; ++n) {
-						// clang-format off
-						dw_push_message(args, dwInfo->sourceNum, DWCHAN_SPF, ds.frequencyBin[n]);
-						dw_push_message(args, dwInfo->sourceNum, DWCHAN_SPD, ds.direction[n]);
-						dw_push_message(args, dwInfo->sourceNum, DWCHAN_SPS, ds.spread[n]);
-						dw_push_message(args, dwInfo->sourceNum, DWCHAN_SPM, ds.m2[n]);
-						dw_push_message(args, dwInfo->sourceNum, DWCHAN_SPN, ds.n2[n]);
-						dw_push_message(args, dwInfo->sourceNum, DWCHAN_SPR, ds.rpsd[n]);
-						dw_push_message(args, dwInfo->sourceNum, DWCHAN_SPK, ds.K[n]);
-						// clang-format on
-					}
-				}
+		// Raw data is recorded in complete lines, matching the decoded values
+		if (pos > 0 && dwInfo->recordRaw) {
+			msg_t *sm = msg_new_bytes(dwInfo->sourceNum, DWCHAN_RAW, pos, buf);
+			if (!source_batch_add(args, &batch, sm)) {
+				msg_destroy(sm);
+				free(sm);
+				ok = false;
 			}
+		}
+
+		if (!ok || !source_batch_push(args, &batch)) {
+			log_error(args->pstate, "[DW:%s] Error pushing messages to queue",
+			          args->tag);
+			source_batch_discard(&batch);
+			args->returnCode = -1;
+			return NULL;
+		}
 
-			uint8_t count = 0;
-			for (int i = 0; i < 16; ++i) {
-				if (sdset[i]) {
-					++count;
-				} else {
-					// First gap found, no point continuing to count
-					break;
+		if (pos > 0) {
+			memmove(buf, &(buf[pos]), dwInfo->hw - pos);
+			dwInfo->hw -= pos;
+		}
+
+		// No more data available for now
+		if (ti <= 0) { return NULL; }
+	}
+	return NULL;
+}
+
+/*!
+ * Queues signal status and displacements from a single HXV line, and adds the
+ * cyclic data word to those held in dw_params. Once enough cyclic data has
+ * been received, spectral and system data are decoded and queued.
+ *
+ * Messages are added to `batch`, and must be pushed to the queue by the caller.
+ *
+ * @param[in] args Pointer to log_thread_args_t
+ * @param[in,out] batch Messages to be queued
+ * @param[in] hxv Decoded HXV line
+ * @param[in] now Current time, used to track last good signal
+ * @returns True on success, false on error (ptargs->returnCode will be set)
+ */
+bool dw_process_hxv(log_thread_args_t *args, source_batch *batch, const dw_hxv *hxv,
+                    const time_t now) {
+	dw_params *dwInfo = (dw_params *)args->dParams;
+	uint16_t *cycdata = dwInfo->cycdata;
+	bool *sdset = dwInfo->sdset;
+	uint16_t *sysdata = dwInfo->sysdata;
+	const uint8_t sn = dwInfo->sourceNum;
+
+	bool ok = dw_push_message(args, batch, sn, DWCHAN_SIG, hxv->status);
+	if (dwInfo->waveStats) {
+		// Displacements are stored in metres, and marked invalid if signal is poor
+		if (hxv->status >= 2) {
+			dw_ring_add(&(dwInfo->ring), NAN, NAN, NAN);
+		} else {
+			dw_ring_add(&(dwInfo->ring), dw_hxv_north(hxv) / 100.0,
+			            dw_hxv_west(hxv) / 100.0, dw_hxv_vertical(hxv) / 100.0);
+		}
+		dwInfo->statsSamples++;
+		if (dwInfo->statsSamples >= (dwInfo->statsInterval * 60 * DW_HXV_RATE)) {
+			ok &= dw_process_stats(args, batch);
+		}
+	}
+	if (hxv->status >= 2) { return ok; }
+
+	dwInfo->lastGoodSignal = now;
+	ok &= dw_push_message(args, batch, sn, DWCHAN_DN, dw_hxv_north(hxv));
+	ok &= dw_push_message(args, batch, sn, DWCHAN_DW, dw_hxv_west(hxv));
+	ok &= dw_push_message(args, batch, sn, DWCHAN_DV, dw_hxv_vertical(hxv));
+	cycdata[dwInfo->cCount++] = dw_hxv_cycdat(hxv);
+
+	if (dwInfo->cCount <= 18) { return ok; }
+
+	bool syncFound = false;
+	for (int i = 0; i < dwInfo->cCount; ++i) {
+		if (cycdata[i] == 0x7FFF) {
+			syncFound = true;
+			if (i > 0) {
+				for (int j = 0; j < dwInfo->cCount && (j + i) < 20; ++j) {
+					cycdata[j] = cycdata[j + i];
 				}
+				dwInfo->cCount = dwInfo->cCount - i;
 			}
+			break; // End search
+		}
+	}
+	if (!syncFound) {
+		dwInfo->cCount = 0;
+		memset(cycdata, 0, 20 * sizeof(cycdata[0]));
+		return ok;
+	}
 
-			if (count == 16) {
-				dw_system dsys = {0};
-				if (!dw_system_from_array(sysdata, &dsys)) {
-					log_info(args->pstate, 2, "[DW:%s] Invalid system data\n",
-					         args->tag);
-				} else {
-					// Parse system data and queue
-					// clang-format off
-					dw_push_message(args, dwInfo->sourceNum, DWCHAN_LAT, dsys.lat);
-					dw_push_message(args, dwInfo->sourceNum, DWCHAN_LON, dsys.lon);
-					dw_push_message(args, dwInfo->sourceNum, DWCHAN_ORIENT, dsys.orient);
-					dw_push_message(args, dwInfo->sourceNum, DWCHAN_INCLIN, dsys.incl);
-					dw_push_message(args, dwInfo->sourceNum, DWCHAN_GPSFIX, dsys.GPSfix);
-					dw_push_message(args, dwInfo->sourceNum, DWCHAN_HRMS, dsys.Hrms);
-					dw_push_message(args, dwInfo->sourceNum, DWCHAN_TREF, dsys.refTemp);
-					dw_push_message(args, dwInfo->sourceNum, DWCHAN_TWTR, dsys.waterTemp);
-					dw_push_message(args, dwInfo->sourceNum, DWCHAN_WEEKS, dsys.opTime);
-					// clang-format on
-				}
-				memset(&sysdata, 0, 16 * sizeof(uint16_t));
-				memset(&sdset, 0, 16 * sizeof(bool));
+	dw_spectrum ds = {0};
+	if (!dw_spectrum_from_array(cycdata, &ds)) {
+		log_info(args->pstate, 1, "[DW:%s] Invalid spectrum data (cCount: %d)", args->tag,
+		         dwInfo->cCount);
+	} else {
+		dwInfo->spectra++;
+		sysdata[ds.sysseq] = ds.sysword;
+		sdset[ds.sysseq] = true;
+		// Parse and queue frequency data?
+		if (dwInfo->parseSpectrum) {
+			for (int n = 0; n < 4; ++n) {
+				// clang-format off
+				ok &= dw_push_message(args, batch, sn, DWCHAN_SPF, ds.frequencyBin[n]);
+				ok &= dw_push_message(args, batch, sn, DWCHAN_SPD, ds.direction[n]);
+				ok &= dw_push_message(args, batch, sn, DWCHAN_SPS, ds.spread[n]);
+				ok &= dw_push_message(args, batch, sn, DWCHAN_SPM, ds.m2[n]);
+				ok &= dw_push_message(args, batch, sn, DWCHAN_SPN, ds.n2[n]);
+				ok &= dw_push_message(args, batch, sn, DWCHAN_SPR, ds.rpsd[n]);
+				ok &= dw_push_message(args, batch, sn, DWCHAN_SPK, ds.K[n]);
+				// clang-format on
 			}
+		}
+	}
 
-			cycdata[0] = cycdata[18];
-			cycdata[1] = cycdata[19];
-			memset(&(cycdata[2]), 0, 18 * sizeof(uint16_t));
-			cCount = 2;
+	uint8_t count = 0;
+	for (int i = 0; i < 16; ++i) {
+		if (sdset[i]) {
+			++count;
+		} else {
+			// First gap found, no point continuing to count
+			break;
 		}
+	}
 
-		msg_t *sm = msg_new_bytes(dwInfo->sourceNum, 3, dw_hw, buf);
-		if (!queue_push(args->logQ, sm)) {
-			log_error(args->pstate, "[DW:%s] Error pushing message to queue",
-			          args->tag);
-			msg_destroy(sm);
-			args->returnCode = -1;
-			pthread_exit(&(args->returnCode));
+	if (count == 16) {
+		dw_system dsys = {0};
+		if (!dw_system_from_array(sysdata, &dsys)) {
+			log_info(args->pstate, 2, "[DW:%s] Invalid system data", args->tag);
+		} else {
+			// Parse system data and queue
+			dwInfo->systemRecords++;
+			ok &= dw_push_message(args, batch, sn, DWCHAN_LAT, dsys.lat);
+			ok &= dw_push_message(args, batch, sn, DWCHAN_LON, dsys.lon);
+			ok &= dw_push_message(args, batch, sn, DWCHAN_ORIENT, dsys.orient);
+			ok &= dw_push_message(args, batch, sn, DWCHAN_INCLIN, dsys.incl);
+			ok &= dw_push_message(args, batch, sn, DWCHAN_GPSFIX, dsys.GPSfix);
+			ok &= dw_push_message(args, batch, sn, DWCHAN_HRMS, dsys.Hrms);
+			ok &= dw_push_message(args, batch, sn, DWCHAN_TREF, dsys.refTemp);
+			ok &= dw_push_message(args, batch, sn, DWCHAN_TWTR, dsys.waterTemp);
+			ok &= dw_push_message(args, batch, sn, DWCHAN_WEEKS, dsys.opTime);
+		}
+		memset(sysdata, 0, 16 * sizeof(uint16_t));
+		memset(sdset, 0, 16 * sizeof(bool));
+	}
+
+	cycdata[0] = cycdata[18];
+	cycdata[1] = cycdata[19];
+	memset(&(cycdata[2]), 0, 18 * sizeof(uint16_t));
+	dwInfo->cCount = 2;
+	return ok;
+}
+
+/*!
+ * Estimates wave statistics from the displacements held in dw_params (see
+ * dw_wave_statistics()), and adds the results to `batch`.
+ *
+ * Statistics are not generated until enough data has been received to fill
+ * the configured period, and are skipped if too much of the data is invalid.
+ *
+ * @param[in] args Pointer to log_thread_args_t
+ * @param[in,out] batch Messages to be queued
+ * @returns True on success, false on error (ptargs->returnCode will be set)
+ */
+bool dw_process_stats(log_thread_args_t *args, source_batch *batch) {
+	dw_params *dwInfo = (dw_params *)args->dParams;
+	const uint8_t sn = dwInfo->sourceNum;
+
+	if (dwInfo->ring.count < dwInfo->ring.size) { return true; }
+	dwInfo->statsSamples = 0;
+
+	dw_wave_stats ws = {0};
+	if (!dw_wave_statistics(&(dwInfo->ring), dwInfo->statsWindow, DW_HXV_RATE,
+	                        dwInfo->statsBands, &ws)) {
+		log_warning(args->pstate, "[DW:%s] Insufficient valid data for wave statistics",
+		            args->tag);
+		return true;
+	}
+	log_info(args->pstate, 2,
+	         "[DW:%s] Hs: %.2fm, Tp: %.1fs, Tz: %.1fs, Dm: %.0f (%d segments)", args->tag,
+	         ws.Hs, ws.Tp, ws.Tz, ws.Dm, ws.segments);
+
+	bool ok = dw_push_message(args, batch, sn, DWCHAN_WHS, ws.Hs);
+	ok &= dw_push_message(args, batch, sn, DWCHAN_WTP, ws.Tp);
+	ok &= dw_push_message(args, batch, sn, DWCHAN_WTZ, ws.Tz);
+	ok &= dw_push_message(args, batch, sn, DWCHAN_WDM, ws.Dm);
+	ok &= dw_push_message(args, batch, sn, DWCHAN_WDP, ws.Dp);
+	if (!ok) { return false; }
+
+	msg_t *mp = msg_new_float_array(sn, DWCHAN_WPSD, ws.bands, ws.psd);
+	msg_t *md = msg_new_float_array(sn, DWCHAN_WDIR, ws.bands, ws.dir);
+	if (mp == NULL || md == NULL) {
+		log_error(args->pstate, "[DW:%s] Unable to allocate message", args->tag);
+		if (mp) {
+			msg_destroy(mp);
+			free(mp);
+		}
+		if (md) {
+			msg_destroy(md);
+			free(md);
 		}
-		dw_hw = 0;
-		memset(buf, 0, bufSize);
+		args->returnCode = -1;
+		return false;
+	}
+	if (!source_batch_add(args, batch, mp)) {
+		msg_destroy(mp);
+		free(mp);
+		ok = false;
+	}
+	if (!source_batch_add(args, batch, md)) {
+		msg_destroy(md);
+		free(md);
+		ok = false;
+	}
+	if (!ok) {
+		log_error(args->pstate, "[DW:%s] Error adding data to queue batch", args->tag);
+		args->returnCode = -1;
+	}
+	return ok;
+}
+
+/*!
+ * Compact spectra are recorded as arrays, with one entry per band. The channel
+ * name lists the centre frequency of each band, so that each entry can be
+ * identified during analysis.
+ *
+ * @param[in] prefix Prefix for each name
+ * @param[in] bands Number of bands
+ * @returns Comma separated list of names (to be freed by caller), or NULL on error
+ */
+char *dw_band_names(const char *prefix, const int bands) {
+	if (prefix == NULL || bands <= 0) { return NULL; }
+	const double bw = (DW_STATS_FMAX - DW_STATS_FMIN) / bands;
+	const size_t len = bands * (strlen(prefix) + 10);
+	char *names = calloc(len, sizeof(char));
+	if (names == NULL) { return NULL; }
+	size_t pos = 0;
+	for (int b = 0; b < bands && pos < len; b++) {
+		pos += snprintf(&(names[pos]), len - pos, "%s%s%.3fHz", (b > 0) ? "," : "", prefix,
+		                DW_STATS_FMIN + (b + 0.5) * bw);
+	}
+	return names;
+}
+
+/*!
+ * Calls dw_readable() repeatedly until shutdown, waiting between calls for the
+ * device to send more data (see source_wait()).
+ *
+ * @param[in] ptargs Pointer to log_thread_args_t
+ * @returns NULL - thread terminated on error.
+ */
+void *dw_logging(void *ptargs) {
+	signalHandlersBlock();
+	log_thread_args_t *args = (log_thread_args_t *)ptargs;
+
+	log_info(args->pstate, 1, "[DW:%s] Logging thread started", args->tag);
+
+	while (!shutdownFlag) {
+		dw_readable(ptargs);
+		if (args->returnCode != 0) { pthread_exit(&(args->returnCode)); }
+		source_wait(args, dw_handle(ptargs), 5E4);
 	}
-	free(buf);
 	pthread_exit(NULL);
 	return NULL; // Superfluous, as returning zero via pthread_exit above
 }
 
 /*!
- * Generate a single message for specified source and channel.
+ * @param[in] ptargs Pointer to log_thread_args_t
+ * @returns Handle for currently opened connection
+ */
+int dw_handle(void *ptargs) {
+	log_thread_args_t *args = (log_thread_args_t *)ptargs;
+	dw_params *dwInfo = (dw_params *)args->dParams;
+	return dwInfo->handle;
+}
+
+/*!
+ * Generate a single message for specified source and channel, and add it to a
+ * batch of messages to be queued.
  *
- * Terminates thread in the event of an error
+ * Sets args->returnCode in the event of an error
  *
  * @param[in] args Pointer to log_thread_args_t
+ * @param[in,out] batch Messages to be queued
  * @param[in] sNum Source number
  * @param[in] cNum Channel number. @sa loggerDWChannels
  * @param[in] data Message value
+ * @returns True on success, false on error
  */
-void dw_push_message(log_thread_args_t *args, uint8_t sNum, uint8_t cNum, float data) {
+bool dw_push_message(log_thread_args_t *args, source_batch *batch, uint8_t sNum, uint8_t cNum,
+                     float data) {
 	msg_t *mm = msg_new_float(sNum, cNum, data);
 	if (mm == NULL) {
 		log_error(args->pstate, "[DW:%s] Unable to allocate message", args->tag);
 		args->returnCode = -1;
-		pthread_exit(&(args->returnCode));
+		return false;
 	}
-	if (!queue_push(args->logQ, mm)) {
-		log_error(args->pstate, "[DW:%s] Error pushing data to queue", args->tag);
+	if (!source_batch_add(args, batch, mm)) {
+		log_error(args->pstate, "[DW:%s] Error adding data to queue batch", args->tag);
 		msg_destroy(mm);
+		free(mm);
 		args->returnCode = -1;
-		pthread_exit(&(args->returnCode));
+		return false;
 	}
+	return true;
 }
 
 /*!
@@ -286,11 +484,16 @@ void dw_push_message(log_thread_args_t *args, uint8_t sNum, uint8_t cNum, float
 void *dw_shutdown(void *ptargs) {
 	log_thread_args_t *args = (log_thread_args_t *)ptargs;
 	dw_params *dwInfo = (dw_params *)args->dParams;
+	log_info(args->pstate, 1,
+	         "[DW:%s] %u HXV records decoded (%u invalid), %u spectral and %u system records",
+	         args->tag, dwInfo->records, dwInfo->invalid, dwInfo->spectra,
+	         dwInfo->systemRecords);
 	if (dwInfo->handle >= 0) { // Admittedly 0 is unlikely
 		shutdown(dwInfo->handle, SHUT_RDWR);
 		close(dwInfo->handle);
 	}
 	dwInfo->handle = -1;
+	dw_ring_destroy(&(dwInfo->ring));
 	if (dwInfo->addr) {
 		free(dwInfo->addr);
 		dwInfo->addr = NULL;
@@ -370,7 +573,9 @@ device_callbacks dw_getCallbacks() {
 	device_callbacks cb = {.startup = &dw_setup,
 	                       .logging = &dw_logging,
 	                       .shutdown = &dw_shutdown,
-	                       .channels = &dw_channels};
+	                       .channels = &dw_channels,
+	                       .readable = &dw_readable,
+	                       .handle = &dw_handle};
 	return cb;
 }
 
@@ -383,7 +588,12 @@ dw_params dw_getParams() {
 	                .handle = -1,
 	                .timeout = 60,
 	                .recordRaw = true,
-	                .parseSpectrum = false};
+	                .parseSpectrum = false,
+	                .waveStats = false,
+	                .statsInterval = 30,
+	                .statsPeriod = 30,
+	                .statsWindow = 256,
+	                .statsBands = 16};
 	return dw;
 }
 
@@ -400,7 +610,7 @@ void *dw_channels(void *ptargs) {
 	msg_t *m_sn = msg_new_string(dwInfo->sourceNum, SLCHAN_NAME, strlen(dwInfo->sourceName),
 	                             dwInfo->sourceName);
 
-	if (!queue_push(args->logQ, m_sn)) {
+	if (!source_push(args, m_sn)) {
 		log_error(args->pstate, "[DW:%s] Error pushing channel name to queue", args->tag);
 		msg_destroy(m_sn);
 		args->returnCode = -1;
@@ -409,6 +619,7 @@ void *dw_channels(void *ptargs) {
 
 	int nChans = 17;
 	if (dwInfo->parseSpectrum) { nChans = 24; }
+	if (dwInfo->waveStats) { nChans = 31; }
 
 	strarray *channels = sa_new(nChans);
 	sa_create_entry(channels, SLCHAN_NAME, 4, "Name");
@@ -446,9 +657,29 @@ void *dw_channels(void *ptargs) {
 		sa_create_entry(channels, DWCHAN_SPR, 7, "Sp-RPSD");
 		sa_create_entry(channels, DWCHAN_SPK, 4, "Sp-K");
 	}
+	/*
+	 * Wave statistics:
+	 */
+	if (dwInfo->waveStats) {
+		sa_create_entry(channels, DWCHAN_WHS, 5, "WS-Hs");
+		sa_create_entry(channels, DWCHAN_WTP, 5, "WS-Tp");
+		sa_create_entry(channels, DWCHAN_WTZ, 5, "WS-Tz");
+		sa_create_entry(channels, DWCHAN_WDM, 5, "WS-Dm");
+		sa_create_entry(channels, DWCHAN_WDP, 5, "WS-Dp");
+		char *psdNames = dw_band_names("WS-PSD ", dwInfo->statsBands);
+		char *dirNames = dw_band_names("WS-Dir ", dwInfo->statsBands);
+		if (psdNames) {
+			sa_create_entry(channels, DWCHAN_WPSD, strlen(psdNames), psdNames);
+		}
+		if (dirNames) {
+			sa_create_entry(channels, DWCHAN_WDIR, strlen(dirNames), dirNames);
+		}
+		free(psdNames);
+		free(dirNames);
+	}
 	msg_t *m_cmap = msg_new_string_array(dwInfo->sourceNum, SLCHAN_MAP, channels);
 
-	if (!queue_push(args->logQ, m_cmap)) {
+	if (!source_push(args, m_cmap)) {
 		log_error(args->pstate, "[DW:%s] Error pushing channel map to queue", args->tag);
 		msg_destroy(m_cmap);
 		sa_destroy(channels);
@@ -566,6 +797,82 @@ bool dw_parseConfig(log_thread_args_t *lta, config_section *s) {
 		dw->parseSpectrum = (tmp == 1);
 	}
 	t = NULL;
+
+	if ((t = config_get_key(s, "stats"))) {
+		int tmp = config_parse_bool(t->value);
+		if (tmp < 0) {
+			log_error(lta->pstate, "[DW:%s] Invalid value provided for 'stats': %s",
+			          lta->tag, t->value);
+			free(dw);
+			return false;
+		}
+		dw->waveStats = (tmp == 1);
+	}
+	t = NULL;
+
+	if ((t = config_get_key(s, "statsinterval"))) {
+		errno = 0;
+		dw->statsInterval = strtol(t->value, NULL, 0);
+		if (errno || dw->statsInterval <= 0) {
+			log_error(lta->pstate, "[DW:%s] Invalid statistics interval: %s", lta->tag,
+			          t->value);
+			free(dw);
+			return false;
+		}
+	}
+	t = NULL;
+
+	if ((t = config_get_key(s, "statsperiod"))) {
+		errno = 0;
+		dw->statsPeriod = strtol(t->value, NULL, 0);
+		if (errno || dw->statsPeriod <= 0) {
+			log_error(lta->pstate, "[DW:%s] Invalid statistics period: %s", lta->tag,
+			          t->value);
+			free(dw);
+			return false;
+		}
+	}
+	t = NULL;
+
+	if ((t = config_get_key(s, "statswindow"))) {
+		errno = 0;
+		dw->statsWindow = strtol(t->value, NULL, 0);
+		if (errno || dw->statsWindow < 16 || (dw->statsWindow & (dw->statsWindow - 1))) {
+			log_error(lta->pstate, "[DW:%s] Invalid statistics window: %s", lta->tag,
+			          t->value);
+			free(dw);
+			return false;
+		}
+	}
+	t = NULL;
+
+	if ((t = config_get_key(s, "statsbands"))) {
+		errno = 0;
+		dw->statsBands = strtol(t->value, NULL, 0);
+		if (errno || dw->statsBands <= 0 || dw->statsBands > DW_STATS_MAX_BANDS) {
+			log_error(lta->pstate, "[DW:%s] Invalid number of bands (%s, max. %d)",
+			          lta->tag, t->value, DW_STATS_MAX_BANDS);
+			free(dw);
+			return false;
+		}
+	}
+	t = NULL;
+
+	if (dw->waveStats) {
+		const size_t samples = dw->statsPeriod * 60 * DW_HXV_RATE;
+		if (samples < (size_t)dw->statsWindow) {
+			log_error(lta->pstate, "[DW:%s] Statistics period shorter than window",
+			          lta->tag);
+			free(dw);
+			return false;
+		}
+		if (!dw_ring_init(&(dw->ring), samples)) {
+			log_error(lta->pstate, "[DW:%s] Unable to allocate displacement buffer",
+			          lta->tag);
+			free(dw);
+			return false;
+		}
+	}
 	lta->dParams = dw;
 	return true;
 }
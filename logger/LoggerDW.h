@@ -24,9 +24,11 @@
 #include <errno.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "SELKIELoggerBase.h"
+#include "SELKIELoggerDW.h"
 //! @file
 
 /*!
@@ -38,15 +40,37 @@
  * @{
  */
 
+//! Receive buffer size for Datawell sources
+#define DW_BUFF 1024
+
 //! Configuration is as per simple network sources
 typedef struct {
-	char *sourceName;   //!< User defined name for this source
-	uint8_t sourceNum;  //!< Source ID for messages
-	char *addr;         //!< Target name
-	int handle;         //!< Handle for currently opened device
-	int timeout;        //!< Reconnect if no data received after this interval [s]
-	bool recordRaw;     //!< Enable retention of raw data
-	bool parseSpectrum; //!< Enable parsing of spectral data
+	char *sourceName;      //!< User defined name for this source
+	uint8_t sourceNum;     //!< Source ID for messages
+	char *addr;            //!< Target name
+	int handle;            //!< Handle for currently opened device
+	int timeout;           //!< Reconnect if no data received after this interval [s]
+	bool recordRaw;        //!< Enable retention of raw data
+	bool parseSpectrum;    //!< Enable parsing of spectral data
+	uint8_t buf[DW_BUFF];  //!< Receive buffer
+	int hw;                //!< Number of bytes currently held in buf
+	time_t lastRead;       //!< Time of last successful read
+	time_t lastGoodSignal; //!< Time of last message with acceptable signal status
+	uint16_t cycdata[20];  //!< Cyclic data words awaiting decoding
+	uint8_t cCount;        //!< Number of entries in cycdata
+	bool sdset[16];        //!< Marks system data words received
+	uint16_t sysdata[16];  //!< System data words awaiting decoding
+	unsigned int records;  //!< Number of HXV lines decoded
+	unsigned int invalid;  //!< Number of lines that could not be decoded
+	unsigned int spectra;  //!< Number of spectral data blocks decoded
+	unsigned int systemRecords; //!< Number of system data records decoded
+	bool waveStats;        //!< Enable onboard wave statistics
+	int statsInterval;     //!< Interval between wave statistics [minutes]
+	int statsPeriod;       //!< Duration of data used for wave statistics [minutes]
+	int statsWindow;       //!< Welch segment length [samples]
+	int statsBands;        //!< Number of bands in compact spectra
+	dw_disp_ring ring;     //!< Recent displacements, for wave statistics
+	unsigned int statsSamples; //!< Samples received since wave statistics last calculated
 } dw_params;
 
 /*!
@@ -81,6 +105,14 @@ typedef struct {
 #define DWCHAN_SPR    22 //!< Spectral data: Relative PSD
 #define DWCHAN_SPK    23 //!< Spectral data: K factor
 
+#define DWCHAN_WHS    24 //!< Wave statistics: Significant wave height (Hm0)
+#define DWCHAN_WTP    25 //!< Wave statistics: Peak period
+#define DWCHAN_WTZ    26 //!< Wave statistics: Mean zero crossing period
+#define DWCHAN_WDM    27 //!< Wave statistics: Mean direction
+#define DWCHAN_WDP    28 //!< Wave statistics: Peak direction
+#define DWCHAN_WPSD   29 //!< Wave statistics: Compact spectrum (PSD per band)
+#define DWCHAN_WDIR   30 //!< Wave statistics: Compact spectrum (Direction per band)
+
 //! @}
 
 //! Datawell thread setup
@@ -89,6 +121,22 @@ void *dw_setup(void *ptargs);
 //! Datawell source main logging loop
 void *dw_logging(void *ptargs);
 
+//! Read, decode and queue all currently available data
+void *dw_readable(void *ptargs);
+
+//! Decode and queue data from a single HXV line
+bool dw_process_hxv(log_thread_args_t *args, source_batch *batch, const dw_hxv *hxv,
+                    const time_t now);
+
+//! Calculate wave statistics from recent displacements and add them to a batch
+bool dw_process_stats(log_thread_args_t *args, source_batch *batch);
+
+//! Generate comma separated channel names for compact spectrum bands
+char *dw_band_names(const char *prefix, const int bands);
+
+//! Return current network handle
+int dw_handle(void *ptargs);
+
 //! Datawell source shutdown
 void *dw_shutdown(void *ptargs);
 
@@ -98,8 +146,9 @@ bool dw_net_connect(void *ptargs);
 //! Channel map
 void *dw_channels(void *ptargs);
 
-//! Create and push messages to queue
-void dw_push_message(log_thread_args_t *args, uint8_t sNum, uint8_t cNum, float data);
+//! Create messages and add them to a batch to be queued
+bool dw_push_message(log_thread_args_t *args, source_batch *batch, uint8_t sNum, uint8_t cNum,
+                     float data);
 
 //! Fill out device callback functions for logging
 device_callbacks dw_getCallbacks(void);
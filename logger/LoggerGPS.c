@@ -26,16 +26,23 @@
 /*!
  * Perform initial setup of a u-blox GPS device.
  *
- * The serial set up is carried out by ubx_openConnection().
+ * The serial set up is carried out by ubx_openConnectionAsync().
  *
  * The module is configured for Galileo support, and to output required
  * navigation information. Satellite information is also requested, but at a
- * lower rate (Once per 100 navigation updates - approximately every 50
+ * lower rate (Once per 120 navigation updates - approximately every 60
  * seconds).
  *
  * GPS module information is also requested at initial startup, but not on a
  * regular basis.
  *
+ * Configuration messages are not sent from here, but are queued as a
+ * ubx_config sequence and sent by gps_readable() as each previous message is
+ * acknowledged. This function therefore returns without waiting for the
+ * module, and other sources can be started while configuration continues.
+ * The sequence ends by polling the module to verify the navigation and
+ * message rates have been applied.
+ *
  * @param[in] ptargs Pointer to log_thread_args_t
  * @returns NULL - Error code set in ptargs->returnCode if required
  */
@@ -43,117 +50,180 @@ void *gps_setup(void *ptargs) {
 	log_thread_args_t *args = (log_thread_args_t *)ptargs;
 	gps_params *gpsInfo = (gps_params *)args->dParams;
 
-	gpsInfo->handle = ubx_openConnection(gpsInfo->portName, gpsInfo->initialBaud);
+	gpsInfo->handle = ubx_openConnectionAsync(gpsInfo->portName, gpsInfo->initialBaud);
 	if (gpsInfo->handle < 0) {
 		log_error(args->pstate, "[GPS:%s] Unable to open a connection", args->tag);
 		args->returnCode = -1;
 		return NULL;
 	}
 
-	log_info(args->pstate, 1, "[GPS:%s] Configuring GPS...", args->tag);
-	{
-		bool msgSuccess = true;
-		errno = 0;
-		log_info(args->pstate, 2, "[GPS:%s] Enabling log messages", args->tag);
-		msgSuccess &= ubx_enableLogMessages(gpsInfo->handle);
-		// The usleep commands are probably not required, but mindful
-		// that there's a limited RX buffer on the GPS module
-		usleep(5E3);
-		msgSuccess &= ubx_enableGalileo(gpsInfo->handle);
-		log_info(args->pstate, 2, "[GPS:%s] Enabling Galileo (GNSS Reset)", args->tag);
-
-		// This one *is* necessary, as enabling Galileo can require a GNSS reset
-		sleep(3);
-		// 500ms Update rate, new output each time
-		msgSuccess &= ubx_setNavigationRate(gpsInfo->handle, 500, 1);
-		usleep(5E3);
-		msgSuccess &= ubx_setI2CAddress(gpsInfo->handle, 0x0a);
-		usleep(5E3);
-		log_info(args->pstate, 2, "[GPS:%s] Configuring message rates", args->tag);
-
-		// NAV-PVT on every update
-		msgSuccess &= ubx_setMessageRate(gpsInfo->handle, 0x01, 0x07, 1);
-		usleep(5E3);
-
-		// NAV-SAT on every 100th update
-		msgSuccess &= ubx_setMessageRate(gpsInfo->handle, 0x01, 0x35, 120);
-		usleep(5E3);
-
-		// NAV-TIMEUTC on every update
-		msgSuccess &= ubx_setMessageRate(gpsInfo->handle, 0x01, 0x21, 1);
-		usleep(5E3);
-
-		log_info(args->pstate, 2, "[GPS:%s] Polling for status information", args->tag);
-		msgSuccess &= ubx_pollMessage(gpsInfo->handle, 0x0A, 0x04);
-		usleep(5E3);
-
-		// Poll for GNSS status (MON)
-		msgSuccess &= ubx_pollMessage(gpsInfo->handle, 0x0A, 0x28);
-		usleep(5E3);
-
-		// Poll again for CFG
-		msgSuccess &= ubx_pollMessage(gpsInfo->handle, 0x06, 0x3E);
-		usleep(5E3);
-
-		if (!msgSuccess) {
-			log_error(args->pstate, "[GPS:%s] Unable to configure: %s", args->tag,
-			          strerror(errno));
-			ubx_closeConnection(gpsInfo->handle);
-			args->returnCode = -2;
-			return NULL;
-		}
-		log_info(args->pstate, 1, "[GPS:%s] Configuration completed", args->tag);
+	gpsInfo->buf = calloc(UBX_SERIAL_BUFF, sizeof(uint8_t));
+	gpsInfo->index = 0;
+	gpsInfo->hw = 0;
+	if (!gpsInfo->buf) {
+		log_error(args->pstate, "[GPS:%s] Unable to allocate buffer", args->tag);
+		ubx_closeConnection(gpsInfo->handle);
+		gpsInfo->handle = -1;
+		args->returnCode = -1;
+		return NULL;
 	}
+
+	const int to = gpsInfo->cfgTimeout;
+	ubx_config *cfg = &(gpsInfo->config);
+	ubx_config_init(cfg, gpsInfo->cfgRetries);
+
+	ubx_message m = {0};
+	bool ok = true;
+	// Repeat baud rate command until acknowledged at the new rate
+	m = ubx_buildSetBaudRate(115200);
+	ok &= ubx_config_add_command(cfg, &m, to, 0);
+	m = ubx_buildEnableLogMessages();
+	ok &= ubx_config_add_command(cfg, &m, to, 0);
+	// Enabling Galileo can require a GNSS reset, so allow extra time
+	m = ubx_buildEnableGalileo();
+	ok &= ubx_config_add_command(cfg, &m, 2 * to, to);
+	// 500ms Update rate, new output each time
+	m = ubx_buildSetNavigationRate(500, 1);
+	ok &= ubx_config_add_command(cfg, &m, to, 0);
+	m = ubx_buildSetI2CAddress(0x0a);
+	ok &= ubx_config_add_command(cfg, &m, to, 0);
+
+	// NAV-PVT on every update
+	m = ubx_buildSetMessageRate(0x01, 0x07, 1);
+	ok &= ubx_config_add_command(cfg, &m, to, 0);
+	// NAV-SAT on every 120th update
+	m = ubx_buildSetMessageRate(0x01, 0x35, 120);
+	ok &= ubx_config_add_command(cfg, &m, to, 0);
+	// NAV-TIMEUTC on every update
+	m = ubx_buildSetMessageRate(0x01, 0x21, 1);
+	ok &= ubx_config_add_command(cfg, &m, to, 0);
+
+	// Verify navigation rate and NAV-PVT output on UART1
+	const uint8_t navRate[] = {0xF4, 0x01, 0x01, 0x00};
+	m = ubx_buildPollMessage(0x06, 0x08);
+	ok &= ubx_config_add_poll(cfg, &m, navRate, sizeof(navRate), to);
+	const uint8_t pvtRate[] = {0x01, 0x07, 0x00, 0x01};
+	m = ubx_buildPollMessageRate(0x01, 0x07);
+	ok &= ubx_config_add_poll(cfg, &m, pvtRate, sizeof(pvtRate), to);
+
+	// Status information: MON-VER, MON-GNSS and CFG-GNSS
+	m = ubx_buildPollMessage(0x0A, 0x04);
+	ok &= ubx_config_add_poll(cfg, &m, NULL, 0, to);
+	m = ubx_buildPollMessage(0x0A, 0x28);
+	ok &= ubx_config_add_poll(cfg, &m, NULL, 0, to);
+	m = ubx_buildPollMessage(0x06, 0x3E);
+	ok &= ubx_config_add_poll(cfg, &m, NULL, 0, to);
+
+	if (!ok) {
+		log_error(args->pstate, "[GPS:%s] Unable to prepare configuration", args->tag);
+		ubx_closeConnection(gpsInfo->handle);
+		gpsInfo->handle = -1;
+		free(gpsInfo->buf);
+		gpsInfo->buf = NULL;
+		args->returnCode = -2;
+		return NULL;
+	}
+
+	log_info(args->pstate, 1, "[GPS:%s] Configuring GPS...", args->tag);
+	gpsInfo->configured = false;
 	args->returnCode = 0;
+	if (!gps_config_run(args, capture_time() / 1000000)) {
+		ubx_closeConnection(gpsInfo->handle);
+		gpsInfo->handle = -1;
+		free(gpsInfo->buf);
+		gpsInfo->buf = NULL;
+	}
 	return NULL;
 }
 
+/*!
+ * Sends the next configuration message if required, and checks for failure
+ * or completion of the configuration sequence started by gps_setup().
+ *
+ * @param[in] args Pointer to log_thread_args_t
+ * @param[in] now Current time [ms]
+ * @returns False if configuration has failed (ptargs->returnCode will be set)
+ */
+bool gps_config_run(log_thread_args_t *args, const uint64_t now) {
+	gps_params *gpsInfo = (gps_params *)args->dParams;
+	if (gpsInfo->configured) { return true; }
+
+	ubx_config *cfg = &(gpsInfo->config);
+	switch (ubx_config_run(cfg, gpsInfo->handle, now)) {
+		case UBXCFG_DONE:
+			log_info(args->pstate, 1,
+			         "[GPS:%s] Configuration completed (%u timeouts, %u rejected)",
+			         args->tag, cfg->timeouts, cfg->naks);
+			gpsInfo->configured = true;
+			break;
+		case UBXCFG_FAILED:
+			log_error(args->pstate,
+			          "[GPS:%s] No valid response to config message 0x%02x/0x%02x",
+			          args->tag, cfg->steps[cfg->current].msg.msgClass,
+			          cfg->steps[cfg->current].msg.msgID);
+			args->returnCode = -2;
+			return false;
+		default:
+			break;
+	}
+	return true;
+}
+
 /*!
  * Takes a gps_params struct (passed via log_thread_args_t)
  *
- * Reads messages from a device configured with gps_setup() and pushes them to
- * the message queue.
+ * Reads all messages currently available from a device configured with
+ * gps_setup() and pushes them to the message queue.
  *
- * Exits on error or when shutdown is signalled.
+ * Messages are decoded in place within the receive buffer (see
+ * ubx_readFrame_buf()), so the only copy made of each message is the one
+ * placed in the outgoing raw data message.
+ *
+ * Does not block, so can be called repeatedly by gps_logging() or by the
+ * reactor threads.
  *
  * @param[in] ptargs Pointer to log_thread_args_t
  * @returns NULL - Error code set in ptargs->returnCode if required
  */
-void *gps_logging(void *ptargs) {
-	signalHandlersBlock();
+void *gps_readable(void *ptargs) {
 	log_thread_args_t *args = (log_thread_args_t *)ptargs;
 	gps_params *gpsInfo = (gps_params *)args->dParams;
 
-	log_info(args->pstate, 1, "[GPS:%s] Logging thread started", args->tag);
+	if (!gps_config_run(args, capture_time() / 1000000)) { return NULL; }
 
-	uint8_t *buf = calloc(UBX_SERIAL_BUFF, sizeof(uint8_t));
-	int ubx_index = 0;
-	int ubx_hw = 0;
 	while (!shutdownFlag) {
-		ubx_message out = {0};
-		if (ubx_readMessage_buf(gpsInfo->handle, &out, buf, &ubx_index, &ubx_hw)) {
-			uint8_t *data = NULL;
-			ssize_t len = ubx_flat_array(&out, &data);
+		ubx_frame out = {0};
+		args->captured = capture_time();
+		if (ubx_readFrame_buf(gpsInfo->handle, &out, gpsInfo->buf, &(gpsInfo->index),
+		                      &(gpsInfo->hw))) {
+			const uint64_t now = args->captured / 1000000;
+			if (!gpsInfo->configured) {
+				// Send next configuration message as soon as this one is confirmed
+				if (ubx_config_frame(&(gpsInfo->config), &out, now) &&
+				    !gps_config_run(args, now)) {
+					return NULL;
+				}
+			}
 			bool handled = false;
-			if (out.msgClass == UBXNAV && out.msgID == 0x21) {
+			if (out.msgClass == UBXNAV && out.msgID == 0x21 && out.length >= 4) {
 				// Extract GPS ToW
 				uint32_t ts = out.data[0] + (out.data[1] << 8) +
 				              (out.data[2] << 16) + (out.data[3] << 24);
 				msg_t *utc =
 					msg_new_timestamp(gpsInfo->sourceNum, SLCHAN_TSTAMP, ts);
-				if (!queue_push(args->logQ, utc)) {
+				if (!source_push(args, utc)) {
 					log_error(args->pstate,
 					          "[GPS:%s] Error pushing message to queue",
 					          args->tag);
 					msg_destroy(utc);
 					args->returnCode = -1;
-					pthread_exit(&(args->returnCode));
+					return NULL;
 				}
 				handled = true;
 			} else if (out.msgClass == UBXNAV && out.msgID == 0x07) {
 				// NAV-PVT
 				ubx_nav_pvt nav = {0};
-				if (!ubx_decode_nav_pvt(&out, &nav)) {
+				if (!ubx_decode_nav_pvt_frame(&out, &nav)) {
 					log_error(args->pstate,
 					          "[GPS:%s] Unable to decode NAV-PVT message",
 					          args->tag);
@@ -179,9 +249,9 @@ void *gps_logging(void *ptargs) {
 					msg_t *mdt = msg_new_float_array(gpsInfo->sourceNum, 6, 8, dt);
 					// clang-format on
 
-					if (!queue_push(args->logQ, mnav) ||
-					    !queue_push(args->logQ, mvel) ||
-					    !queue_push(args->logQ, mdt)) {
+					if (!source_push(args, mnav) ||
+					    !source_push(args, mvel) ||
+					    !source_push(args, mdt)) {
 						log_error(
 							args->pstate,
 							"[GPS:%s] Error pushing messages to queue",
@@ -190,26 +260,24 @@ void *gps_logging(void *ptargs) {
 						msg_destroy(mvel);
 						msg_destroy(mdt);
 						args->returnCode = -1;
-						pthread_exit(&(args->returnCode));
+						return NULL;
 					}
 					handled = true;
 				}
 			}
 			if (!handled || gpsInfo->dumpAll) {
-				msg_t *sm = msg_new_bytes(gpsInfo->sourceNum, 3, len, data);
-				if (!queue_push(args->logQ, sm)) {
+				// Copied directly from the receive buffer
+				msg_t *sm = msg_new_bytes(gpsInfo->sourceNum, 3,
+				                          UBX_FRAME_SIZE(out.length), out.frame);
+				if (!source_push(args, sm)) {
 					log_error(args->pstate,
 					          "[GPS:%s] Error pushing message to queue",
 					          args->tag);
 					msg_destroy(sm);
 					args->returnCode = -1;
-					pthread_exit(&(args->returnCode));
+					return NULL;
 				}
 			}
-			if (data) {
-				// Copied into message, so can safely free here
-				free(data);
-			}
 			// Do not destroy or free sm (or other msg_t objects) here
 			// After pushing it to the queue, it is the responsibility of the
 			// consumer to dispose of it after use.
@@ -224,30 +292,53 @@ void *gps_logging(void *ptargs) {
 				//
 				// 0xEE indicates an invalid message following valid sync bytes
 				log_error(args->pstate,
-				          "[GPS:%s] Error signalled from gps_readMessage_buf",
+				          "[GPS:%s] Error signalled from ubx_readFrame_buf",
 				          args->tag);
 				args->returnCode = -2;
-				free(buf);
-				if (out.extdata) { free(out.extdata); }
-				pthread_exit(&(args->returnCode));
+				return NULL;
 			}
-			// We've already exited (via pthread_exit) for error
-			// cases, so at this point sleep briefly and wait for
-			// more data
-			usleep(SERIAL_SLEEP);
+			// Wait for more data
+			if (out.sync1 != 0xEE) { return NULL; }
 		}
+	}
+	return NULL;
+}
 
-		// Clean up before next iteration
-		if (out.extdata) { // Similarly, we are finished with this copy
-			free(out.extdata);
-		}
+/*!
+ * Calls gps_readable() repeatedly until shutdown, waiting between calls
+ * for more data (see source_wait()).
+ *
+ * Exits on error or when shutdown is signalled.
+ *
+ * @param[in] ptargs Pointer to log_thread_args_t
+ * @returns NULL - Error code set in ptargs->returnCode if required
+ */
+void *gps_logging(void *ptargs) {
+	signalHandlersBlock();
+	log_thread_args_t *args = (log_thread_args_t *)ptargs;
+
+	log_info(args->pstate, 1, "[GPS:%s] Logging thread started", args->tag);
+
+	while (!shutdownFlag) {
+		gps_readable(ptargs);
+		if (args->returnCode != 0) { pthread_exit(&(args->returnCode)); }
+		source_wait(args, gps_handle(ptargs), SERIAL_SLEEP);
 	}
-	free(buf);
 	log_info(args->pstate, 1, "[GPS:%s] Logging thread exiting", args->tag);
 	pthread_exit(NULL);
 	return NULL; // Superfluous, as returning zero via pthread_exit above
 }
 
+/*!
+ * @param[in] ptargs Pointer to log_thread_args_t
+ * @returns Handle for currently opened device
+ */
+int gps_handle(void *ptargs) {
+	log_thread_args_t *args = (log_thread_args_t *)ptargs;
+	gps_params *gpsInfo = (gps_params *)args->dParams;
+	return gpsInfo->handle;
+}
+
 /*!
  * Calls ubx_closeConnection(), which will do any cleanup required.
  *
@@ -270,6 +361,10 @@ void *gps_shutdown(void *ptargs) {
 		free(gpsInfo->portName);
 		gpsInfo->portName = NULL;
 	}
+	if (gpsInfo->buf) {
+		free(gpsInfo->buf);
+		gpsInfo->buf = NULL;
+	}
 	return NULL;
 }
 
@@ -288,7 +383,7 @@ void *gps_channels(void *ptargs) {
 	msg_t *m_sn = msg_new_string(gpsInfo->sourceNum, SLCHAN_NAME, strlen(gpsInfo->sourceName),
 	                             gpsInfo->sourceName);
 
-	if (!queue_push(args->logQ, m_sn)) {
+	if (!source_push(args, m_sn)) {
 		log_error(args->pstate, "[GPS:%s] Error pushing channel name to queue", args->tag);
 		msg_destroy(m_sn);
 		args->returnCode = -1;
@@ -306,7 +401,7 @@ void *gps_channels(void *ptargs) {
 
 	msg_t *m_cmap = msg_new_string_array(gpsInfo->sourceNum, SLCHAN_MAP, channels);
 
-	if (!queue_push(args->logQ, m_cmap)) {
+	if (!source_push(args, m_cmap)) {
 		log_error(args->pstate, "[GPS:%s] Error pushing channel map to queue", args->tag);
 		msg_destroy(m_cmap);
 		sa_destroy(channels);
@@ -327,7 +422,9 @@ device_callbacks gps_getCallbacks() {
 	device_callbacks cb = {.startup = &gps_setup,
 	                       .logging = &gps_logging,
 	                       .shutdown = &gps_shutdown,
-	                       .channels = &gps_channels};
+	                       .channels = &gps_channels,
+	                       .readable = &gps_readable,
+	                       .handle = &gps_handle};
 	return cb;
 }
 
@@ -340,7 +437,13 @@ gps_params gps_getParams() {
 	                 .initialBaud = 9600,
 	                 .targetBaud = 115200,
 	                 .handle = -1,
-	                 .dumpAll = false};
+	                 .dumpAll = false,
+	                 .buf = NULL,
+	                 .index = 0,
+	                 .hw = 0,
+	                 .configured = false,
+	                 .cfgRetries = 4,
+	                 .cfgTimeout = 500};
 	return gp;
 }
 
@@ -402,6 +505,30 @@ bool gps_parseConfig(log_thread_args_t *lta, config_section *s) {
 	}
 	t = NULL;
 
+	if ((t = config_get_key(s, "configretries"))) {
+		errno = 0;
+		gp->cfgRetries = strtol(t->value, NULL, 0);
+		if (errno || gp->cfgRetries < 0) {
+			log_error(lta->pstate, "[GPS:%s] Invalid configuration retry count: %s",
+			          lta->tag, t->value);
+			free(gp);
+			return false;
+		}
+	}
+	t = NULL;
+
+	if ((t = config_get_key(s, "configtimeout"))) {
+		errno = 0;
+		gp->cfgTimeout = strtol(t->value, NULL, 0);
+		if (errno || gp->cfgTimeout <= 0) {
+			log_error(lta->pstate, "[GPS:%s] Invalid configuration timeout: %s",
+			          lta->tag, t->value);
+			free(gp);
+			return false;
+		}
+	}
+	t = NULL;
+
 	if ((t = config_get_key(s, "sourcenum"))) {
 		errno = 0;
 		int sn = strtol(t->value, NULL, 0);
@@ -55,6 +55,13 @@ typedef struct {
 	int targetBaud;    //!< Baud rate for operations (currently unused)
 	int handle;        //!< Handle for currently opened device
 	bool dumpAll;      //!< Dump all GPS messages to output queue
+	uint8_t *buf;      //!< Receive buffer (allocated by gps_setup())
+	int index;         //!< Current search position within buf
+	int hw;            //!< End of valid data in buf
+	ubx_config config; //!< Configuration sequence (see gps_setup())
+	bool configured;   //!< Configuration sequence completed
+	int cfgRetries;    //!< Number of times each configuration message will be re-sent
+	int cfgTimeout;    //!< Time to wait for each configuration response [ms]
 } gps_params;
 
 //! GPS Setup
@@ -63,6 +70,15 @@ void *gps_setup(void *ptargs);
 //! GPS logging (with pthread function signature)
 void *gps_logging(void *ptargs);
 
+//! Read and queue all currently available messages
+void *gps_readable(void *ptargs);
+
+//! Progress GPS configuration sequence
+bool gps_config_run(log_thread_args_t *args, const uint64_t now);
+
+//! Return current GPS device handle
+int gps_handle(void *ptargs);
+
 //! GPS Shutdown
 void *gps_shutdown(void *ptargs);
 
@@ -48,17 +48,163 @@ void *i2c_setup(void *ptargs) {
 		return NULL;
 	}
 	log_info(args->pstate, 2, "[I2C:%s] Connected", args->tag);
+
+	i2cInfo->batch = calloc(i2cInfo->en_count, sizeof(i2c_reg_read));
+	i2cInfo->batchIndex = calloc(i2cInfo->en_count, sizeof(int));
+	i2cInfo->sampled = calloc(i2cInfo->en_count, sizeof(bool));
+	if (!i2cInfo->batch || !i2cInfo->batchIndex || !i2cInfo->sampled) {
+		log_error(args->pstate, "[I2C:%s] Unable to allocate memory for batch reads",
+		          args->tag);
+		i2c_closeConnection(i2cInfo->handle);
+		i2cInfo->handle = -1;
+		free(i2cInfo->batch);
+		i2cInfo->batch = NULL;
+		free(i2cInfo->batchIndex);
+		i2cInfo->batchIndex = NULL;
+		free(i2cInfo->sampled);
+		i2cInfo->sampled = NULL;
+		args->returnCode = -1;
+		return NULL;
+	}
+
+	// Configure each device once, rather than before every reading
+	for (int mm = 0; mm < i2cInfo->en_count; mm++) {
+		i2c_msg_map *map = &(i2cInfo->chanmap[mm]);
+		if (!map->init) { continue; }
+		bool seen = false;
+		for (int p = 0; p < mm; p++) {
+			if (i2cInfo->chanmap[p].deviceAddr == map->deviceAddr &&
+			    i2cInfo->chanmap[p].init == map->init) {
+				seen = true;
+				break;
+			}
+		}
+		if (seen) { continue; }
+		if (!map->init(i2cInfo->handle, map->deviceAddr)) {
+			log_warning(args->pstate, "[I2C:%s] Unable to configure device at 0x%02x",
+			            args->tag, map->deviceAddr);
+		}
+	}
 	args->returnCode = 0;
 	return NULL;
 }
 
 /*!
- * Iterates over all registered channels, calling the appropriate read function against
- * the registered I2C device ID.
+ * Reads each registered channel once.
+ *
+ * Channels with a conversion function are read in rounds: any conversions
+ * required are started on every device in the round, the longest conversion
+ * time is allowed to elapse and then the result registers for all channels in
+ * the round are read using a single combined transaction (see
+ * i2c_read_registers()). Conversion times therefore overlap across devices,
+ * and only one channel is converted on each device per round.
+ *
+ * Channels without a conversion function are read individually using their
+ * read function.
+ *
+ * @param[in] args Pointer to log_thread_args_t
+ * @returns False if messages could not be queued
+ */
+bool i2c_sample(log_thread_args_t *args) {
+	i2c_params *i2cInfo = (i2c_params *)args->dParams;
+	const int handle = i2cInfo->handle;
+	const uint8_t sn = i2cInfo->sourceNum;
+	memset(i2cInfo->sampled, 0, i2cInfo->en_count * sizeof(bool));
+
+	int remaining = i2cInfo->en_count;
+	while (remaining > 0 && !shutdownFlag) {
+		int count = 0;
+		int delay = 0;
+		for (int mm = 0; mm < i2cInfo->en_count; mm++) {
+			if (i2cInfo->sampled[mm]) { continue; }
+			i2c_msg_map *map = &(i2cInfo->chanmap[mm]);
+			if (!map->convert) {
+				i2cInfo->sampled[mm] = true;
+				remaining--;
+				args->captured = capture_time();
+				float value = map->func(handle, map->deviceAddr, map->ext);
+				msg_t *msg = msg_new_float(sn, map->messageID, value);
+				if (!i2c_queue_message(args, msg)) { return false; }
+				continue;
+			}
+
+			if (map->start) {
+				// Only one conversion per device per round
+				bool busy = false;
+				for (int b = 0; b < count; b++) {
+					const int bi = i2cInfo->batchIndex[b];
+					if (i2cInfo->chanmap[bi].start &&
+					    i2cInfo->chanmap[bi].deviceAddr == map->deviceAddr) {
+						busy = true;
+						break;
+					}
+				}
+				if (busy) { continue; }
+
+				i2cInfo->sampled[mm] = true;
+				remaining--;
+				int d = map->start(handle, map->deviceAddr, map->ext);
+				if (d < 0) {
+					args->captured = capture_time();
+					msg_t *msg = msg_new_float(sn, map->messageID, NAN);
+					if (!i2c_queue_message(args, msg)) { return false; }
+					continue;
+				}
+				if (d > delay) { delay = d; }
+			} else {
+				i2cInfo->sampled[mm] = true;
+				remaining--;
+			}
+
+			i2cInfo->batch[count].devAddr = map->deviceAddr;
+			i2cInfo->batch[count].reg = map->reg;
+			i2cInfo->batch[count].value = 0;
+			i2cInfo->batchIndex[count] = mm;
+			count++;
+		}
+
+		if (count == 0) { continue; }
+		if (delay > 0) { usleep(delay); }
+
+		args->captured = capture_time();
+		const bool ok = i2c_read_registers(handle, i2cInfo->batch, count);
+		for (int b = 0; b < count; b++) {
+			i2c_msg_map *map = &(i2cInfo->chanmap[i2cInfo->batchIndex[b]]);
+			float value = ok ? map->convert(i2cInfo->batch[b].value, map->ext) : NAN;
+			msg_t *msg = msg_new_float(sn, map->messageID, value);
+			if (!i2c_queue_message(args, msg)) { return false; }
+		}
+	}
+	return true;
+}
+
+/*!
+ * Message is destroyed if it cannot be queued.
  *
- * After each conversion function has been called, this thread will sleep in an
- * attempt to keep the poll frequency at the rate requested. This is a best
- * effort attempt.
+ * @param[in] args Pointer to log_thread_args_t
+ * @param[in] msg Message to push
+ * @returns True on success, false on error
+ */
+bool i2c_queue_message(log_thread_args_t *args, msg_t *msg) {
+	if (!source_push(args, msg)) {
+		log_error(args->pstate, "[I2C:%s] Error pushing message to queue", args->tag);
+		msg_destroy(msg);
+		free(msg);
+		return false;
+	}
+	return true;
+}
+
+/*!
+ * Waits for each sampling deadline (see deadline_wait()), samples all
+ * registered channels (see i2c_sample()) and then pushes the sweep index and
+ * scheduled sweep time to the queue.
+ *
+ * Deadlines are taken from the shared sample clock, so all I2C buses running
+ * at the same frequency are sampled at the same time and report the same
+ * sweep index for each sweep. Values from different buses can therefore be
+ * aligned exactly by sweep index. Timing statistics are reported
+ * periodically.
  *
  * Thread will exit on error
  *
@@ -72,51 +218,32 @@ void *i2c_logging(void *ptargs) {
 
 	log_info(args->pstate, 1, "[I2C:%s] Logging thread started", args->tag);
 
-	struct timespec lastIter = {0};
-	clock_gettime(CLOCK_MONOTONIC, &lastIter);
+	deadline_timer dt = {0};
+	deadline_init(&dt, i2cInfo->frequency);
 	while (!shutdownFlag) {
-		for (int mm = 0; mm < i2cInfo->en_count; mm++) {
-			i2c_msg_map *map = &(i2cInfo->chanmap[mm]);
-			float value = map->func(i2cInfo->handle, map->deviceAddr, map->ext);
-
-			msg_t *msg = msg_new_float(i2cInfo->sourceNum, map->messageID, value);
-			if (!queue_push(args->logQ, msg)) {
-				log_error(args->pstate, "[I2C:%s] Error pushing message to queue",
-				          args->tag);
-				msg_destroy(msg);
-				args->returnCode = -1;
-				pthread_exit(&(args->returnCode));
-			}
-		}
+		deadline_wait(&dt);
+		if (shutdownFlag) { break; }
 
-		lastIter.tv_nsec += 1E9 / i2cInfo->frequency;
-		if (lastIter.tv_nsec > 1E9) {
-			int nsec = lastIter.tv_nsec / 1000000000;
-			lastIter.tv_nsec = lastIter.tv_nsec % 1000000000;
-			lastIter.tv_sec += nsec;
+		if (!i2c_sample(args)) {
+			args->returnCode = -1;
+			pthread_exit(&(args->returnCode));
 		}
-		struct timespec now = {0};
-		clock_gettime(CLOCK_MONOTONIC, &now);
-		msg_t *msg = msg_new_timestamp(i2cInfo->sourceNum, SLCHAN_TSTAMP,
-		                               (1000 * now.tv_sec + now.tv_nsec / 1000000));
-		if (!queue_push(args->logQ, msg)) {
-			log_error(args->pstate, "[I2C:%s] Error pushing message to queue",
-			          args->tag);
-			msg_destroy(msg);
+
+		args->captured = capture_time();
+		if (!i2c_queue_message(args, msg_new_timestamp(i2cInfo->sourceNum, I2C_CHAN_SWEEP,
+		                                               deadline_index(&dt)))) {
 			args->returnCode = -1;
 			pthread_exit(&(args->returnCode));
 		}
-		struct timespec target = {0};
-		if (timespec_subtract(&target, &lastIter, &now)) {
-			// Target has passed!
-			log_warning(args->pstate, "[I2C:%s] Deadline missed", args->tag);
-			clock_gettime(CLOCK_MONOTONIC, &lastIter);
-		} else {
-			clock_gettime(CLOCK_MONOTONIC, &lastIter);
-			// If we're interrupted, just carry on. We might need to handle
-			// the shutdown flag, and worst case is we log a bit of extra data
-			nanosleep(&target, NULL);
+
+		// Scheduled sweep time, on the same (arbitrary) millisecond scale as other sources
+		if (!i2c_queue_message(args, msg_new_timestamp(i2cInfo->sourceNum, SLCHAN_TSTAMP,
+		                                               dt.current / 1000000))) {
+			args->returnCode = -1;
+			pthread_exit(&(args->returnCode));
 		}
+
+		deadline_report(&dt, args, "I2C");
 	}
 	pthread_exit(NULL);
 	return NULL; // Superfluous, as returning zero via pthread_exit above
@@ -149,6 +276,12 @@ void *i2c_shutdown(void *ptargs) {
 		free(i2cInfo->chanmap);
 		i2cInfo->chanmap = NULL;
 	}
+	free(i2cInfo->batch);
+	i2cInfo->batch = NULL;
+	free(i2cInfo->batchIndex);
+	i2cInfo->batchIndex = NULL;
+	free(i2cInfo->sampled);
+	i2cInfo->sampled = NULL;
 	return NULL;
 }
 
@@ -167,14 +300,14 @@ void *i2c_channels(void *ptargs) {
 	msg_t *m_sn = msg_new_string(i2cInfo->sourceNum, SLCHAN_NAME, strlen(i2cInfo->sourceName),
 	                             i2cInfo->sourceName);
 
-	if (!queue_push(args->logQ, m_sn)) {
+	if (!source_push(args, m_sn)) {
 		log_error(args->pstate, "[I2C:%s] Error pushing channel name to queue", args->tag);
 		msg_destroy(m_sn);
 		args->returnCode = -1;
 		pthread_exit(&(args->returnCode));
 	}
 
-	uint8_t maxID = 3;
+	uint8_t maxID = I2C_CHAN_SWEEP;
 	for (int i = 0; i < i2cInfo->en_count; i++) {
 		if (i2cInfo->chanmap[i].messageID > maxID) {
 			maxID = i2cInfo->chanmap[i].messageID;
@@ -184,6 +317,7 @@ void *i2c_channels(void *ptargs) {
 	sa_create_entry(channels, SLCHAN_NAME, 4, "Name");
 	sa_create_entry(channels, SLCHAN_MAP, 8, "Channels");
 	sa_create_entry(channels, SLCHAN_TSTAMP, 9, "Timestamp");
+	sa_create_entry(channels, I2C_CHAN_SWEEP, 5, "Sweep");
 
 	for (int i = 0; i < i2cInfo->en_count; i++) {
 		sa_set_entry(channels, i2cInfo->chanmap[i].messageID,
@@ -192,7 +326,7 @@ void *i2c_channels(void *ptargs) {
 
 	msg_t *m_cmap = msg_new_string_array(i2cInfo->sourceNum, SLCHAN_MAP, channels);
 
-	if (!queue_push(args->logQ, m_cmap)) {
+	if (!source_push(args, m_cmap)) {
 		log_error(args->pstate, "[I2C:%s] Error pushing channel map to queue", args->tag);
 		msg_destroy(m_cmap);
 		sa_destroy(channels);
@@ -227,7 +361,11 @@ i2c_params i2c_getParams() {
 	                  .handle = -1,
 	                  .frequency = 10,
 	                  .en_count = 0,
-	                  .chanmap = NULL};
+	                  .chanmap = NULL,
+	                  .adsRate = ADS1015_CONFIG_DRATE_1600,
+	                  .batch = NULL,
+	                  .batchIndex = NULL,
+	                  .sampled = NULL};
 	return i2c;
 }
 
@@ -247,6 +385,7 @@ bool i2c_validate_chanmap(i2c_params *ip) {
 	seen[SLCHAN_MAP] = true;
 	seen[SLCHAN_TSTAMP] = true;
 	seen[SLCHAN_RAW] = true;
+	seen[I2C_CHAN_SWEEP] = true;
 	seen[SLCHAN_LOG_INFO] = true;
 	seen[SLCHAN_LOG_WARN] = true;
 	seen[SLCHAN_LOG_ERR] = true;
@@ -289,6 +428,11 @@ bool i2c_chanmap_add_ina219(i2c_params *ip, const uint8_t devAddr, const uint8_t
 	str_update(&(ip->chanmap[ip->en_count].message_name), 18, tmpS);
 	ip->chanmap[ip->en_count].deviceAddr = devAddr;
 	ip->chanmap[ip->en_count].func = &i2c_ina219_read_shuntVoltage;
+	ip->chanmap[ip->en_count].ext = NULL;
+	ip->chanmap[ip->en_count].init = &i2c_ina219_configure;
+	ip->chanmap[ip->en_count].start = NULL;
+	ip->chanmap[ip->en_count].convert = &i2c_ina219_convert_shuntVoltage;
+	ip->chanmap[ip->en_count].reg = INA219_REG_SHUNT;
 	ip->en_count++;
 
 	snprintf(tmpS, 16, "0x%02x:BusVoltage", devAddr);
@@ -298,6 +442,11 @@ bool i2c_chanmap_add_ina219(i2c_params *ip, const uint8_t devAddr, const uint8_t
 	str_update(&(ip->chanmap[ip->en_count].message_name), 16, tmpS);
 	ip->chanmap[ip->en_count].deviceAddr = devAddr;
 	ip->chanmap[ip->en_count].func = &i2c_ina219_read_busVoltage;
+	ip->chanmap[ip->en_count].ext = NULL;
+	ip->chanmap[ip->en_count].init = &i2c_ina219_configure;
+	ip->chanmap[ip->en_count].start = NULL;
+	ip->chanmap[ip->en_count].convert = &i2c_ina219_convert_busVoltage;
+	ip->chanmap[ip->en_count].reg = INA219_REG_BUS;
 	ip->en_count++;
 
 	snprintf(tmpS, 16, "0x%02x:BusCurrent", devAddr);
@@ -307,6 +456,11 @@ bool i2c_chanmap_add_ina219(i2c_params *ip, const uint8_t devAddr, const uint8_t
 	str_update(&(ip->chanmap[ip->en_count].message_name), 16, tmpS);
 	ip->chanmap[ip->en_count].deviceAddr = devAddr;
 	ip->chanmap[ip->en_count].func = &i2c_ina219_read_current;
+	ip->chanmap[ip->en_count].ext = NULL;
+	ip->chanmap[ip->en_count].init = &i2c_ina219_configure;
+	ip->chanmap[ip->en_count].start = NULL;
+	ip->chanmap[ip->en_count].convert = &i2c_ina219_convert_current;
+	ip->chanmap[ip->en_count].reg = INA219_REG_CURRENT;
 	ip->en_count++;
 
 	return true;
@@ -321,6 +475,8 @@ bool i2c_chanmap_add_ina219(i2c_params *ip, const uint8_t devAddr, const uint8_t
  * - `baseID+2`: A2 [V]
  * - `baseID+3`: A3 [V]
  *
+ * Continuous conversions are performed at the data rate set in ip->adsRate.
+ *
  * @param[in] ip i2c_params structure to modify
  * @param[in] devAddr ADS1015 Device Address
  * @param[in] baseID Message ID for first channel (A0)
@@ -352,6 +508,7 @@ bool i2c_chanmap_add_ads1015(i2c_params *ip, const uint8_t devAddr, const uint8_
 	adsopts->max = maxV;
 	adsopts->scale = scale;
 	adsopts->offset = offset;
+	adsopts->rate = ip->adsRate;
 
 	snprintf(tmpS, 8, "0x%02x:A0", devAddr);
 	ip->chanmap[ip->en_count].messageID = baseID;
@@ -362,6 +519,10 @@ bool i2c_chanmap_add_ads1015(i2c_params *ip, const uint8_t devAddr, const uint8_
 	ip->chanmap[ip->en_count].deviceAddr = devAddr;
 	ip->chanmap[ip->en_count].func = &i2c_ads1015_read_ch0;
 	ip->chanmap[ip->en_count].ext = adsopts;
+	ip->chanmap[ip->en_count].init = NULL;
+	ip->chanmap[ip->en_count].start = &i2c_ads1015_start_ch0;
+	ip->chanmap[ip->en_count].convert = &i2c_ads1015_convert;
+	ip->chanmap[ip->en_count].reg = ADS1015_REG_RESULT;
 	ip->en_count++;
 
 	snprintf(tmpS, 8, "0x%02x:A1", devAddr);
@@ -372,6 +533,10 @@ bool i2c_chanmap_add_ads1015(i2c_params *ip, const uint8_t devAddr, const uint8_
 	ip->chanmap[ip->en_count].deviceAddr = devAddr;
 	ip->chanmap[ip->en_count].func = &i2c_ads1015_read_ch1;
 	ip->chanmap[ip->en_count].ext = adsopts;
+	ip->chanmap[ip->en_count].init = NULL;
+	ip->chanmap[ip->en_count].start = &i2c_ads1015_start_ch1;
+	ip->chanmap[ip->en_count].convert = &i2c_ads1015_convert;
+	ip->chanmap[ip->en_count].reg = ADS1015_REG_RESULT;
 	ip->en_count++;
 
 	snprintf(tmpS, 8, "0x%02x:A2", devAddr);
@@ -382,6 +547,10 @@ bool i2c_chanmap_add_ads1015(i2c_params *ip, const uint8_t devAddr, const uint8_
 	ip->chanmap[ip->en_count].deviceAddr = devAddr;
 	ip->chanmap[ip->en_count].func = &i2c_ads1015_read_ch2;
 	ip->chanmap[ip->en_count].ext = adsopts;
+	ip->chanmap[ip->en_count].init = NULL;
+	ip->chanmap[ip->en_count].start = &i2c_ads1015_start_ch2;
+	ip->chanmap[ip->en_count].convert = &i2c_ads1015_convert;
+	ip->chanmap[ip->en_count].reg = ADS1015_REG_RESULT;
 	ip->en_count++;
 
 	snprintf(tmpS, 8, "0x%02x:A3", devAddr);
@@ -392,6 +561,10 @@ bool i2c_chanmap_add_ads1015(i2c_params *ip, const uint8_t devAddr, const uint8_
 	ip->chanmap[ip->en_count].deviceAddr = devAddr;
 	ip->chanmap[ip->en_count].func = &i2c_ads1015_read_ch3;
 	ip->chanmap[ip->en_count].ext = adsopts;
+	ip->chanmap[ip->en_count].init = NULL;
+	ip->chanmap[ip->en_count].start = &i2c_ads1015_start_ch3;
+	ip->chanmap[ip->en_count].convert = &i2c_ads1015_convert;
+	ip->chanmap[ip->en_count].reg = ADS1015_REG_RESULT;
 	ip->en_count++;
 
 	return true;
@@ -430,21 +603,27 @@ bool i2c_parseConfig(log_thread_args_t *lta, config_section *s) {
 
 	if ((t = config_get_key(s, "frequency"))) {
 		errno = 0;
-		ip->frequency = strtol(t->value, NULL, 0);
+		const long freq = strtol(t->value, NULL, 0);
 		if (errno) {
 			log_error(lta->pstate, "[I2C:%s] Error parsing sample frequency: %s",
 			          lta->tag, strerror(errno));
 			free(ip);
 			return false;
 		}
-		if (ip->frequency <= 0) {
+		if (freq <= 0 || freq > DEADLINE_LIMIT_FREQ) {
 			log_error(
 				lta->pstate,
-				"[I2C:%s] Invalid frequency requested (%d) - must be positive and non-zero",
-				lta->tag, ip->frequency);
+				"[I2C:%s] Invalid frequency requested (%ld) - must be between 1 and %d",
+				lta->tag, freq, DEADLINE_LIMIT_FREQ);
 			free(ip);
 			return false;
 		}
+		ip->frequency = freq;
+		if (ip->frequency > DEADLINE_MAX_FREQ) {
+			log_warning(lta->pstate,
+			            "[I2C:%s] Requested frequency (%d) may not be maintained reliably",
+			            lta->tag, ip->frequency);
+		}
 	}
 	t = NULL;
 
@@ -477,6 +656,27 @@ bool i2c_parseConfig(log_thread_args_t *lta, config_section *s) {
 	}
 	t = NULL;
 
+	if ((t = config_get_key(s, "ads1015rate"))) {
+		errno = 0;
+		int sps = strtol(t->value, NULL, 0);
+		bool valid = false;
+		for (uint16_t r = ADS1015_CONFIG_DRATE_0128; r <= ADS1015_CONFIG_DRATE_3300;
+		     r += ADS1015_CONFIG_DRATE_0250) {
+			if (i2c_ads1015_rate_to_sps(r) == sps) {
+				ip->adsRate = r;
+				valid = true;
+				break;
+			}
+		}
+		if (errno || !valid) {
+			log_error(lta->pstate, "[I2C:%s] Invalid ADS1015 data rate requested (%s)",
+			          lta->tag, t->value);
+			free(ip);
+			return false;
+		}
+	}
+	t = NULL;
+
 	// Initial message ID, in case not specified in configuration.
 	// There is scope for conflict in case of a mix of automatic and
 	// manually specified IDs, which should be caught by i2c_validate_chanmap
@@ -45,16 +45,26 @@
  * value that needs to be logged must be registered into the channel map in
  * i2c_params before i2c_logging is called.
  *
+ * Each bus is sampled by its own thread, with sweeps scheduled from a sample
+ * clock shared by all buses (see deadline_init()).
+ *
  * @{
  */
 
+//! Channel used to report sweep index (see i2c_logging())
+#define I2C_CHAN_SWEEP 0x7C
+
 //! Map device functions to message IDs
 typedef struct {
-	uint8_t messageID;    //!< Message ID to report
-	string message_name;  //!< Message name to report
-	uint8_t deviceAddr;   //!< I2C Device address
-	i2c_dev_read_fn func; //!< Pointer to device read function
-	void *ext;            //!< If not NULL, pointer to additional device data
+	uint8_t messageID;          //!< Message ID to report
+	string message_name;        //!< Message name to report
+	uint8_t deviceAddr;         //!< I2C Device address
+	i2c_dev_read_fn func;       //!< Pointer to device read function
+	void *ext;                  //!< If not NULL, pointer to additional device data
+	i2c_dev_init_fn init;       //!< If not NULL, called once per device in i2c_setup()
+	i2c_dev_start_fn start;     //!< If not NULL, called to start a conversion before reading
+	i2c_dev_convert_fn convert; //!< If not NULL, read `reg` in batches and convert with this
+	uint8_t reg;                //!< Register containing result (if `convert` set)
 } i2c_msg_map;
 
 //! I2C Source device specific parameters
@@ -66,6 +76,10 @@ typedef struct {
 	int frequency;        //!< Aim to sample this many times per second
 	int en_count;         //!< Number of messages in chanmap
 	i2c_msg_map *chanmap; //!< Map of device functions to poll
+	uint16_t adsRate;     //!< ADS1015 data rate setting (applies to all devices on bus)
+	i2c_reg_read *batch;  //!< Register reads for current sampling round (en_count entries)
+	int *batchIndex;      //!< Channel map index for each entry in batch
+	bool *sampled;        //!< Channels already sampled in current cycle
 } i2c_params;
 
 //! I2C Connection setup
@@ -74,6 +88,12 @@ void *i2c_setup(void *ptargs);
 //! I2C main logging loop
 void *i2c_logging(void *ptargs);
 
+//! Sample all registered channels once
+bool i2c_sample(log_thread_args_t *args);
+
+//! Push a message to the queue, destroying it on failure
+bool i2c_queue_message(log_thread_args_t *args, msg_t *msg);
+
 //! I2C shutdown
 void *i2c_shutdown(void *ptargs);
 
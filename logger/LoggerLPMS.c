@@ -49,6 +49,47 @@
 #define CHAN_ACC_LIN_Z 27
 #define CHAN_ALTITUDE  28
 
+// Packed channels, used in place of the individual channels above
+#define CHAN_PK_ACC_RAW 32
+#define CHAN_PK_ACC_CAL 33
+#define CHAN_PK_G_RAW   34
+#define CHAN_PK_G_CAL   35
+#define CHAN_PK_G_ALIGN 36
+#define CHAN_PK_OMEGA   37
+#define CHAN_PK_EULER   38
+#define CHAN_PK_ACC_LIN 39
+#define CHAN_PK_FRAME   40
+
+//! Number of values in each LPMS_PACK_FRAME message
+#define LPMS_FRAME_VALUES 25
+
+/*
+ * Packed channels are named with SLCHAN_PACKED_PREFIX and a comma separated
+ * list of the values they contain, which dat2csv and the python tools use to
+ * expand them back into named columns.
+ */
+#define NAMES_ACC_RAW   "AccelerationRaw_X,AccelerationRaw_Y,AccelerationRaw_Z"
+#define NAMES_ACC_CAL   "AccelerationCal_X,AccelerationCal_Y,AccelerationCal_Z"
+#define NAMES_G_RAW     "GyroRaw_X,GyroRaw_Y,GyroRaw_Z"
+#define NAMES_G_CAL     "GyroCal_X,GyroCal_Y,GyroCal_Z"
+#define NAMES_G_ALIGN   "GyroAlign_X,GyroAlign_Y,GyroAlign_Z"
+#define NAMES_OMEGA     "AngularVel X,AngularVel Y,AngularVel Z"
+#define NAMES_EULER     "Roll,Pitch,Yaw"
+#define NAMES_ACC_LIN   "AccelerationLin_X,AccelerationLin_Y,AccelerationLin_Z"
+#define NAMES_FRAME                                                                         \
+	NAMES_ACC_RAW "," NAMES_ACC_CAL "," NAMES_G_RAW "," NAMES_G_CAL "," NAMES_G_ALIGN "," \
+		NAMES_OMEGA "," NAMES_EULER "," NAMES_ACC_LIN ",Altitude"
+
+//! Add packed channel to channel map, with names as above
+#define PACKED_ENTRY(sa, chan, names) \
+	sa_create_entry(sa, chan, strlen(SLCHAN_PACKED_PREFIX names), SLCHAN_PACKED_PREFIX names)
+
+//! Output fields requested from the unit (see LPMS_IMU)
+#define LPMS_OUTPUTS                                                                          \
+	((1U << LPMS_IMU_ACCEL_RAW) + (1U << LPMS_IMU_ACCEL_CAL) + (1U << LPMS_IMU_GYRO_RAW) + \
+	 (1U << LPMS_IMU_GYRO_CAL) + (1U << LPMS_IMU_GYRO_ALIGN) + (1U << LPMS_IMU_OMEGA) +     \
+	 (1U << LPMS_IMU_EULER) + (1U << LPMS_IMU_ACCEL_LINEAR) + (1U << LPMS_IMU_ALTITUDE))
+
 /*!
  * Opens a serial connection and the required baud rate.
  *
@@ -66,6 +107,25 @@ void *lpms_setup(void *ptargs) {
 		return NULL;
 	}
 
+	lpmsInfo->buf = calloc(LPMS_BUFF, sizeof(uint8_t));
+	lpmsInfo->hw = 0;
+	lpmsInfo->end = 0;
+	// Message data array is reused for every message received
+	lpmsInfo->msg.data = calloc(LPMS_BUFF, sizeof(uint8_t));
+	lpmsInfo->msg.capacity = LPMS_BUFF;
+	if (!lpmsInfo->buf || !lpmsInfo->msg.data) {
+		log_error(args->pstate, "[LPMS:%s] Unable to allocate buffer", args->tag);
+		lpms_closeConnection(lpmsInfo->handle);
+		lpmsInfo->handle = -1;
+		free(lpmsInfo->buf);
+		lpmsInfo->buf = NULL;
+		free(lpmsInfo->msg.data);
+		lpmsInfo->msg.data = NULL;
+		lpmsInfo->msg.capacity = 0;
+		args->returnCode = -1;
+		return NULL;
+	}
+
 	args->returnCode = 0;
 
 	lpms_send_command_mode(lpmsInfo->handle);
@@ -98,11 +158,7 @@ void *lpms_setup(void *ptargs) {
 	lpms_send_command(lpmsInfo->handle, &getRate);
 	usleep(10000);
 
-	const uint32_t outputs =
-		((1U << LPMS_IMU_ACCEL_RAW) + (1U << LPMS_IMU_ACCEL_CAL) +
-	         (1U << LPMS_IMU_GYRO_RAW) + (1U << LPMS_IMU_GYRO_CAL) +
-	         (1U << LPMS_IMU_GYRO_ALIGN) + (1U << LPMS_IMU_OMEGA) + (1U << LPMS_IMU_EULER) +
-	         (1U << LPMS_IMU_ACCEL_LINEAR) + (1U << LPMS_IMU_ALTITUDE));
+	const uint32_t outputs = LPMS_OUTPUTS;
 	uint8_t outputData[4] = {(outputs & 0xFF), (outputs & 0xFF00) >> 8,
 	                         (outputs & 0xFF0000) >> 16, (outputs & 0xFF000000) >> 24};
 
@@ -125,140 +181,226 @@ void *lpms_setup(void *ptargs) {
  * numbers, and push it to the queue (Q). If unable to create or push the
  * message, tidy up and return false.
  *
- * Reduces code duplication in lpms_logging()
+ * Reduces code duplication in lpms_readable()
  *
- * @param[in] Q Pointer to message queue
+ * @param[in] args Pointer to log_thread_args_t
  * @param[in] src Message source number
  * @param[in] chan Message type/channel number
  * @param[in] val Message value
  * @returns True on success, False on error
  */
-inline bool lpms_queue_message(msgqueue *Q, const uint8_t src, const uint8_t chan,
+inline bool lpms_queue_message(log_thread_args_t *args, const uint8_t src, const uint8_t chan,
                                const float val) {
 	msg_t *m = msg_new_float(src, chan, val);
 	if (m == NULL) { return false; }
-	if (!queue_push(Q, m)) {
+	if (!source_push(args, m)) {
+		msg_destroy(m);
+		free(m);
+		return false;
+	}
+	return true;
+}
+
+/*!
+ * @param[in] args Pointer to log_thread_args_t
+ * @param[in] src Message source number
+ * @param[in] chan Message type/channel number
+ * @param[in] entries Number of values in array
+ * @param[in] vals Values to be sent
+ * @returns True on success, False on error
+ */
+bool lpms_queue_array(log_thread_args_t *args, const uint8_t src, const uint8_t chan,
+                      const size_t entries, const float *vals) {
+	msg_t *m = msg_new_float_array(src, chan, entries, vals);
+	if (m == NULL) { return false; }
+	if (!source_push(args, m)) {
 		msg_destroy(m);
+		free(m);
 		return false;
 	}
 	return true;
 }
 
 /*!
- * Reads messages from the connection established by lpms_setup(), and pushes them to the
- * queue. Data is not interpreted, just pushed into the queue with suitable headers.
+ * Queues data decoded from a single IMU data message, according to the
+ * packing mode configured for this source.
  *
- * Message size is variable, based on min/max limits and the amount of data
- * available to read from the source.
+ * In LPMS_PACK_VECTOR mode, each vector quantity is sent as a single
+ * numerical array, with altitude sent as a single value. In LPMS_PACK_FRAME
+ * mode, all values are sent in a single array in the same order as the
+ * individual channels.
  *
- * Terminates thread in case of error.
+ * @param[in] args Pointer to log_thread_args_t
+ * @param[in] d Decoded IMU data
+ * @returns True on success, False on error
+ */
+bool lpms_queue_data(log_thread_args_t *args, const lpms_data *d) {
+	lpms_params *lpmsInfo = (lpms_params *)args->dParams;
+	const uint8_t src = lpmsInfo->sourceNum;
+	float frame[LPMS_FRAME_VALUES];
+	bool rs = true;
+	switch (lpmsInfo->packing) {
+		case LPMS_PACK_NONE:
+			rs &= lpms_queue_message(args, src, CHAN_ACC_RAW_X, d->accel_raw[0]);
+			rs &= lpms_queue_message(args, src, CHAN_ACC_RAW_Y, d->accel_raw[1]);
+			rs &= lpms_queue_message(args, src, CHAN_ACC_RAW_Z, d->accel_raw[2]);
+			rs &= lpms_queue_message(args, src, CHAN_ACC_CAL_X, d->accel_cal[0]);
+			rs &= lpms_queue_message(args, src, CHAN_ACC_CAL_Y, d->accel_cal[1]);
+			rs &= lpms_queue_message(args, src, CHAN_ACC_CAL_Z, d->accel_cal[2]);
+			rs &= lpms_queue_message(args, src, CHAN_G_RAW_X, d->gyro_raw[0]);
+			rs &= lpms_queue_message(args, src, CHAN_G_RAW_Y, d->gyro_raw[1]);
+			rs &= lpms_queue_message(args, src, CHAN_G_RAW_Z, d->gyro_raw[2]);
+			rs &= lpms_queue_message(args, src, CHAN_G_CAL_X, d->gyro_cal[0]);
+			rs &= lpms_queue_message(args, src, CHAN_G_CAL_Y, d->gyro_cal[1]);
+			rs &= lpms_queue_message(args, src, CHAN_G_CAL_Z, d->gyro_cal[2]);
+			rs &= lpms_queue_message(args, src, CHAN_G_ALIGN_X, d->gyro_aligned[0]);
+			rs &= lpms_queue_message(args, src, CHAN_G_ALIGN_Y, d->gyro_aligned[1]);
+			rs &= lpms_queue_message(args, src, CHAN_G_ALIGN_Z, d->gyro_aligned[2]);
+			rs &= lpms_queue_message(args, src, CHAN_OMEGA_X, d->omega[0]);
+			rs &= lpms_queue_message(args, src, CHAN_OMEGA_Y, d->omega[1]);
+			rs &= lpms_queue_message(args, src, CHAN_OMEGA_Z, d->omega[2]);
+			rs &= lpms_queue_message(args, src, CHAN_ROLL, d->euler_angles[0]);
+			rs &= lpms_queue_message(args, src, CHAN_PITCH, d->euler_angles[1]);
+			rs &= lpms_queue_message(args, src, CHAN_YAW, d->euler_angles[2]);
+			rs &= lpms_queue_message(args, src, CHAN_ACC_LIN_X, d->accel_linear[0]);
+			rs &= lpms_queue_message(args, src, CHAN_ACC_LIN_Y, d->accel_linear[1]);
+			rs &= lpms_queue_message(args, src, CHAN_ACC_LIN_Z, d->accel_linear[2]);
+			rs &= lpms_queue_message(args, src, CHAN_ALTITUDE, d->altitude);
+			break;
+		case LPMS_PACK_VECTOR:
+			rs &= lpms_queue_array(args, src, CHAN_PK_ACC_RAW, 3, d->accel_raw);
+			rs &= lpms_queue_array(args, src, CHAN_PK_ACC_CAL, 3, d->accel_cal);
+			rs &= lpms_queue_array(args, src, CHAN_PK_G_RAW, 3, d->gyro_raw);
+			rs &= lpms_queue_array(args, src, CHAN_PK_G_CAL, 3, d->gyro_cal);
+			rs &= lpms_queue_array(args, src, CHAN_PK_G_ALIGN, 3, d->gyro_aligned);
+			rs &= lpms_queue_array(args, src, CHAN_PK_OMEGA, 3, d->omega);
+			rs &= lpms_queue_array(args, src, CHAN_PK_EULER, 3, d->euler_angles);
+			rs &= lpms_queue_array(args, src, CHAN_PK_ACC_LIN, 3, d->accel_linear);
+			rs &= lpms_queue_message(args, src, CHAN_ALTITUDE, d->altitude);
+			break;
+		case LPMS_PACK_FRAME:
+			memcpy(&(frame[0]), d->accel_raw, 3 * sizeof(float));
+			memcpy(&(frame[3]), d->accel_cal, 3 * sizeof(float));
+			memcpy(&(frame[6]), d->gyro_raw, 3 * sizeof(float));
+			memcpy(&(frame[9]), d->gyro_cal, 3 * sizeof(float));
+			memcpy(&(frame[12]), d->gyro_aligned, 3 * sizeof(float));
+			memcpy(&(frame[15]), d->omega, 3 * sizeof(float));
+			memcpy(&(frame[18]), d->euler_angles, 3 * sizeof(float));
+			memcpy(&(frame[21]), d->accel_linear, 3 * sizeof(float));
+			frame[24] = d->altitude;
+			rs &= lpms_queue_array(args, src, CHAN_PK_FRAME, LPMS_FRAME_VALUES, frame);
+			break;
+	}
+	return rs;
+}
+
+/*!
+ * Reads all messages currently available from the connection established by
+ * lpms_setup(), and pushes them to the queue.
+ *
+ * The unit is switched to streaming mode on the first call.
+ *
+ * Messages are read into a data array allocated once by lpms_setup(), and IMU
+ * data is decoded using field offsets calculated when the output configuration
+ * is received, so no allocation is required for each message.
+ *
+ * Does not block, so can be called repeatedly by lpms_logging() or by the
+ * reactor threads.
  *
  * @param[in] ptargs Pointer to log_thread_args_t
  * @returns NULL - Exit code in ptargs->returnCode if required
  */
-void *lpms_logging(void *ptargs) {
-	signalHandlersBlock();
+void *lpms_readable(void *ptargs) {
 	log_thread_args_t *args = (log_thread_args_t *)ptargs;
 	lpms_params *lpmsInfo = (lpms_params *)args->dParams;
 
-	log_info(args->pstate, 1, "[LPMS:%s] Logging thread started", args->tag);
-	lpms_send_stream_mode(lpmsInfo->handle);
-
-	uint8_t *buf = calloc(LPMS_BUFF, sizeof(uint8_t));
-	size_t lpms_hw = 0;
-	size_t lpms_end = 0;
-	uint32_t outputs = 0;
-	bool unitMismatch = false;
-	unsigned int pendingCount = 0;
-	unsigned int missingCount = 0;
+	if (!lpmsInfo->streaming) {
+		lpms_send_stream_mode(lpmsInfo->handle);
+		lpmsInfo->streaming = true;
+	}
+
 	while (!shutdownFlag) {
-		lpms_data d = {.present = outputs};
-		lpms_message *m = calloc(1, sizeof(lpms_message));
-		if (!m) {
-			perror("lpms_message calloc");
-			args->returnCode = -1;
-			pthread_exit(&(args->returnCode));
-			return NULL;
-		}
-		bool r = lpms_readMessage_buf(lpmsInfo->handle, m, buf, &lpms_end, &lpms_hw);
+		lpms_data d = {.present = lpmsInfo->outputs};
+		lpms_message *m = &(lpmsInfo->msg);
+		args->captured = capture_time();
+		bool r = lpms_readMessage_buf(lpmsInfo->handle, m, lpmsInfo->buf, &(lpmsInfo->end),
+		                              &(lpmsInfo->hw));
 		if (r) {
 			uint16_t cs = 0;
-			if (!(lpms_checksum(m, &cs) && cs == m->checksum)) {
-				free(m->data);
-				free(m);
-				continue;
-			}
-			if ((m->id != lpmsInfo->unitID) && !unitMismatch) {
+			if (!(lpms_checksum(m, &cs) && cs == m->checksum)) { continue; }
+			if ((m->id != lpmsInfo->unitID) && !lpmsInfo->unitMismatch) {
 				log_warning(
 					args->pstate,
 					"[LPMS:%s] Unexpected unit ID (got 0x%02x, expected 0x%02x)",
 					args->tag, m->id, lpmsInfo->unitID);
-				unitMismatch = true;
+				lpmsInfo->unitMismatch = true;
 			}
 			if (m->command == LPMS_MSG_GET_OUTPUTS) {
 				d.present = (uint32_t)m->data[0] + ((uint32_t)m->data[1] << 8) +
 				            ((uint32_t)m->data[2] << 16) +
 				            ((uint32_t)m->data[3] << 24);
-				outputs = d.present;
+				lpmsInfo->outputs = d.present;
+				lpms_imu_layout_init(&(lpmsInfo->layout), d.present);
 				log_info(args->pstate, 1,
 				         "[LPMS:%s] Output configuration received for unit 0x%02x",
 				         args->tag, m->id);
 			} else if (m->command == LPMS_MSG_GET_SENSORMODEL) {
 				log_info(args->pstate, 1,
-				         "[LPMS:%s] Unit 0x%02x: Sensor model: %-24s", args->tag,
-				         m->id, (char *)m->data);
+				         "[LPMS:%s] Unit 0x%02x: Sensor model: %-24.*s", args->tag,
+				         m->id, m->length, (char *)m->data);
 				char *lm = NULL;
-				int sl = asprintf(&lm, "LPMS Unit 0x%02x: Sensor model: %-24s",
-				                  m->id, (char *)m->data);
+				int sl = asprintf(&lm, "LPMS Unit 0x%02x: Sensor model: %-24.*s",
+				                  m->id, m->length, (char *)m->data);
 				msg_t *sm = msg_new_string(lpmsInfo->sourceNum, SLCHAN_LOG_INFO,
 				                           sl, lm);
 				free(lm);
 				lm = NULL;
-				if (!queue_push(args->logQ, sm)) {
+				if (!source_push(args, sm)) {
 					log_error(args->pstate,
 					          "[LPMS:%s] Error pushing message to queue",
 					          args->tag);
 					msg_destroy(sm);
 					args->returnCode = -1;
-					pthread_exit(&(args->returnCode));
+					return NULL;
 				}
 			} else if (m->command == LPMS_MSG_GET_SERIALNUM) {
 				log_info(args->pstate, 1,
-				         "[LPMS:%s] Unit 0x%02x: Serial number: %-24s", args->tag,
-				         m->id, (char *)m->data);
+				         "[LPMS:%s] Unit 0x%02x: Serial number: %-24.*s",
+				         args->tag, m->id, m->length, (char *)m->data);
 				char *lm = NULL;
-				int sl = asprintf(&lm, "LPMS Unit 0x%02x: Serial number: %-24s",
-				                  m->id, (char *)m->data);
+				int sl = asprintf(&lm, "LPMS Unit 0x%02x: Serial number: %-24.*s",
+				                  m->id, m->length, (char *)m->data);
 				msg_t *sm = msg_new_string(lpmsInfo->sourceNum, SLCHAN_LOG_INFO,
 				                           sl, lm);
 				free(lm);
 				lm = NULL;
-				if (!queue_push(args->logQ, sm)) {
+				if (!source_push(args, sm)) {
 					log_error(args->pstate,
 					          "[LPMS:%s] Error pushing message to queue",
 					          args->tag);
 					msg_destroy(sm);
 					args->returnCode = -1;
-					pthread_exit(&(args->returnCode));
+					return NULL;
 				}
 			} else if (m->command == LPMS_MSG_GET_FIRMWAREVER) {
 				log_info(args->pstate, 1,
-				         "[LPMS:%s] Unit 0x%02x: Firmware version: %-24s",
-				         args->tag, m->id, (char *)m->data);
+				         "[LPMS:%s] Unit 0x%02x: Firmware version: %-24.*s",
+				         args->tag, m->id, m->length, (char *)m->data);
 				char *lm = NULL;
-				int sl = asprintf(&lm, "LPMS Unit 0x%02x: Firmware version: %-24s",
-				                  m->id, (char *)m->data);
+				int sl = asprintf(&lm,
+				                  "LPMS Unit 0x%02x: Firmware version: %-24.*s",
+				                  m->id, m->length, (char *)m->data);
 				msg_t *sm = msg_new_string(lpmsInfo->sourceNum, SLCHAN_LOG_INFO,
 				                           sl, lm);
 				free(lm);
 				lm = NULL;
-				if (!queue_push(args->logQ, sm)) {
+				if (!source_push(args, sm)) {
 					log_error(args->pstate,
 					          "[LPMS:%s] Error pushing message to queue",
 					          args->tag);
 					msg_destroy(sm);
 					args->returnCode = -1;
-					pthread_exit(&(args->returnCode));
+					return NULL;
 				}
 			} else if (m->command == LPMS_MSG_GET_FREQ) {
 				uint32_t rate = m->data[0] + ((uint32_t)m->data[1] << 8) +
@@ -270,11 +412,11 @@ void *lpms_logging(void *ptargs) {
 			} else if (m->command == LPMS_MSG_GET_IMUDATA) {
 				if (!d.present) {
 					// Can't extract data until configuration has appeared
-					if ((pendingCount++ % 100) == 0) {
+					if ((lpmsInfo->pendingCount++ % 100) == 0) {
 						log_warning(
 							args->pstate,
 							"[LPMS:%s] No output configuration received - skipping messages (%d skipped so far)",
-							args->tag, pendingCount);
+							args->tag, lpmsInfo->pendingCount);
 						log_info(args->pstate, 3,
 						         "[LPMS:%s] Repeating GET_OUTPUTS request",
 						         args->tag);
@@ -284,139 +426,101 @@ void *lpms_logging(void *ptargs) {
 						lpms_send_command(lpmsInfo->handle,
 						                  &getTransmitted);
 					}
-					free(m->data);
-					free(m);
 					continue;
 				}
-				if (lpms_imu_set_timestamp(m, &d)) {
+				// Single pass decode, using offsets calculated when the
+				// output configuration was received
+				bool dataSet = lpms_imu_decode(m, &(lpmsInfo->layout), &d);
+				dataSet &= ((d.present & LPMS_OUTPUTS) == LPMS_OUTPUTS);
+				if (m->length >= 4) {
 					// Internal timestamp is in 500ths, double to get
 					// milliseconds
 					msg_t *ts =
 						msg_new_timestamp(lpmsInfo->sourceNum,
 					                          SLCHAN_TSTAMP, d.timestamp * 2);
-					if (!queue_push(args->logQ, ts)) {
+					if (!source_push(args, ts)) {
 						log_error(
 							args->pstate,
 							"[LPMS:%s] Error pushing message to queue",
 							args->tag);
 						msg_destroy(ts);
-						free(m->data);
-						free(m);
 						args->returnCode = -1;
-						pthread_exit(&(args->returnCode));
+						return NULL;
 					}
 				} else {
 					log_warning(args->pstate,
 					            "[LPMS:%s] Unit 0x%02x: Timestamp invalid",
 					            args->tag, m->id);
 				}
-				bool dataSet = true;
-				dataSet &= lpms_imu_set_accel_raw(m, &d);
-				dataSet &= lpms_imu_set_accel_cal(m, &d);
-				dataSet &= lpms_imu_set_gyro_raw(m, &d);
-				dataSet &= lpms_imu_set_gyro_cal(m, &d);
-				dataSet &= lpms_imu_set_gyro_aligned(m, &d);
-				dataSet &= lpms_imu_set_omega(m, &d);
-				dataSet &= lpms_imu_set_euler_angles(m, &d);
-				dataSet &= lpms_imu_set_accel_linear(m, &d);
-				dataSet &= lpms_imu_set_altitude(m, &d);
-				/*
-				Not currently included in outputs
-				dataSet |= lpms_imu_set_mag_raw(m, &d);
-				dataSet |= lpms_imu_set_mag_cal(m, &d);
-				dataSet |= lpms_imu_set_pressure(m, &d);
-				dataSet |= lpms_imu_set_temperature(m, &d);
-				*/
 				if (!dataSet) {
-					if (missingCount == 0) {
+					if (lpmsInfo->missingCount == 0) {
 						log_warning(
 							args->pstate,
 							"[LPMS:%s] Unit 0x%02x: Some data missing in update",
 							args->tag, m->id);
 					}
-					missingCount++;
+					lpmsInfo->missingCount++;
 				} else {
-					missingCount = 0;
+					lpmsInfo->missingCount = 0;
 				}
 				// Create output messages and push to queue
-				bool rs = true;
-				rs &= lpms_queue_message(args->logQ, lpmsInfo->sourceNum,
-				                         CHAN_ACC_RAW_X, d.accel_raw[0]);
-				rs &= lpms_queue_message(args->logQ, lpmsInfo->sourceNum,
-				                         CHAN_ACC_RAW_Y, d.accel_raw[1]);
-				rs &= lpms_queue_message(args->logQ, lpmsInfo->sourceNum,
-				                         CHAN_ACC_RAW_Z, d.accel_raw[2]);
-				rs &= lpms_queue_message(args->logQ, lpmsInfo->sourceNum,
-				                         CHAN_ACC_CAL_X, d.accel_cal[0]);
-				rs &= lpms_queue_message(args->logQ, lpmsInfo->sourceNum,
-				                         CHAN_ACC_CAL_Y, d.accel_cal[1]);
-				rs &= lpms_queue_message(args->logQ, lpmsInfo->sourceNum,
-				                         CHAN_ACC_CAL_Z, d.accel_cal[2]);
-				rs &= lpms_queue_message(args->logQ, lpmsInfo->sourceNum,
-				                         CHAN_G_RAW_X, d.gyro_raw[0]);
-				rs &= lpms_queue_message(args->logQ, lpmsInfo->sourceNum,
-				                         CHAN_G_RAW_Y, d.gyro_raw[1]);
-				rs &= lpms_queue_message(args->logQ, lpmsInfo->sourceNum,
-				                         CHAN_G_RAW_Z, d.gyro_raw[2]);
-				rs &= lpms_queue_message(args->logQ, lpmsInfo->sourceNum,
-				                         CHAN_G_CAL_X, d.gyro_cal[0]);
-				rs &= lpms_queue_message(args->logQ, lpmsInfo->sourceNum,
-				                         CHAN_G_CAL_Y, d.gyro_cal[1]);
-				rs &= lpms_queue_message(args->logQ, lpmsInfo->sourceNum,
-				                         CHAN_G_CAL_Z, d.gyro_cal[2]);
-				rs &= lpms_queue_message(args->logQ, lpmsInfo->sourceNum,
-				                         CHAN_G_ALIGN_X, d.gyro_aligned[0]);
-				rs &= lpms_queue_message(args->logQ, lpmsInfo->sourceNum,
-				                         CHAN_G_ALIGN_Y, d.gyro_aligned[1]);
-				rs &= lpms_queue_message(args->logQ, lpmsInfo->sourceNum,
-				                         CHAN_G_ALIGN_Z, d.gyro_aligned[2]);
-				rs &= lpms_queue_message(args->logQ, lpmsInfo->sourceNum,
-				                         CHAN_OMEGA_X, d.omega[0]);
-				rs &= lpms_queue_message(args->logQ, lpmsInfo->sourceNum,
-				                         CHAN_OMEGA_Y, d.omega[1]);
-				rs &= lpms_queue_message(args->logQ, lpmsInfo->sourceNum,
-				                         CHAN_OMEGA_Z, d.omega[2]);
-				rs &= lpms_queue_message(args->logQ, lpmsInfo->sourceNum,
-				                         CHAN_ROLL, d.euler_angles[0]);
-				rs &= lpms_queue_message(args->logQ, lpmsInfo->sourceNum,
-				                         CHAN_PITCH, d.euler_angles[1]);
-				rs &= lpms_queue_message(args->logQ, lpmsInfo->sourceNum, CHAN_YAW,
-				                         d.euler_angles[2]);
-				rs &= lpms_queue_message(args->logQ, lpmsInfo->sourceNum,
-				                         CHAN_ACC_LIN_X, d.accel_linear[0]);
-				rs &= lpms_queue_message(args->logQ, lpmsInfo->sourceNum,
-				                         CHAN_ACC_LIN_Y, d.accel_linear[1]);
-				rs &= lpms_queue_message(args->logQ, lpmsInfo->sourceNum,
-				                         CHAN_ACC_LIN_Z, d.accel_linear[2]);
-				rs &= lpms_queue_message(args->logQ, lpmsInfo->sourceNum,
-				                         CHAN_ALTITUDE, d.altitude);
-				if (!rs) {
+				if (!lpms_queue_data(args, &d)) {
 					log_error(
 						args->pstate,
 						"[LPMS:%s] Unable to allocate and/or queue all messages (%d)",
 						args->tag, errno);
-					free(m->data);
-					free(m);
 					args->returnCode = -1;
-					pthread_exit(&(args->returnCode));
+					return NULL;
 				}
 			} else {
 				log_info(args->pstate, 2,
 				         "[LPSM:%s] Unhandled message type: 0x%02x [%02d bytes]",
 				         args->tag, m->command, m->length);
 			}
-			free(m->data);
-			free(m);
 		} else {
-			// No message available, so sleep
-			usleep(1E5);
+			// No message available, so wait for more data
+			return NULL;
 		}
 	}
-	free(buf);
+	return NULL;
+}
+
+/*!
+ * Calls lpms_readable() repeatedly until shutdown, waiting between calls for
+ * more data (see source_wait()).
+ *
+ * Terminates thread in case of error.
+ *
+ * @param[in] ptargs Pointer to log_thread_args_t
+ * @returns NULL - Exit code in ptargs->returnCode if required
+ */
+void *lpms_logging(void *ptargs) {
+	signalHandlersBlock();
+	log_thread_args_t *args = (log_thread_args_t *)ptargs;
+
+	log_info(args->pstate, 1, "[LPMS:%s] Logging thread started", args->tag);
+
+	while (!shutdownFlag) {
+		lpms_readable(ptargs);
+		if (args->returnCode != 0) { pthread_exit(&(args->returnCode)); }
+		source_wait(args, lpms_handle(ptargs), 1E5);
+	}
 	pthread_exit(NULL);
 	return NULL; // Superfluous, as returning zero via pthread_exit above
 }
 
+/*!
+ * @param[in] ptargs Pointer to log_thread_args_t
+ * @returns Handle for currently opened device
+ */
+int lpms_handle(void *ptargs) {
+	log_thread_args_t *args = (log_thread_args_t *)ptargs;
+	lpms_params *lpmsInfo = (lpms_params *)args->dParams;
+	return lpmsInfo->handle;
+}
+
+
+
 /*!
  * Simple wrapper around lpms_closeConnection(), which will do any cleanup required.
  *
@@ -435,6 +539,15 @@ void *lpms_shutdown(void *ptargs) {
 		free(lpmsInfo->portName);
 		lpmsInfo->portName = NULL;
 	}
+	if (lpmsInfo->buf) {
+		free(lpmsInfo->buf);
+		lpmsInfo->buf = NULL;
+	}
+	if (lpmsInfo->msg.data) {
+		free(lpmsInfo->msg.data);
+		lpmsInfo->msg.data = NULL;
+		lpmsInfo->msg.capacity = 0;
+	}
 	return NULL;
 }
 
@@ -445,7 +558,9 @@ device_callbacks lpms_getCallbacks() {
 	device_callbacks cb = {.startup = &lpms_setup,
 	                       .logging = &lpms_logging,
 	                       .shutdown = &lpms_shutdown,
-	                       .channels = &lpms_channels};
+	                       .channels = &lpms_channels,
+	                       .readable = &lpms_readable,
+	                       .handle = &lpms_handle};
 	return cb;
 }
 
@@ -453,8 +568,22 @@ device_callbacks lpms_getCallbacks() {
  * @returns Default parameters for serial sources
  */
 lpms_params lpms_getParams() {
-	lpms_params mp = {
-		.portName = NULL, .baudRate = 921600, .handle = -1, .unitID = 1, .pollFreq = 10};
+	lpms_params mp = {.portName = NULL,
+	                  .baudRate = 921600,
+	                  .handle = -1,
+	                  .unitID = 1,
+	                  .pollFreq = 10,
+	                  .packing = LPMS_PACK_NONE,
+	                  .buf = NULL,
+	                  .hw = 0,
+	                  .end = 0,
+	                  .outputs = 0,
+	                  .msg = {0},
+	                  .layout = {0},
+	                  .streaming = false,
+	                  .unitMismatch = false,
+	                  .pendingCount = 0,
+	                  .missingCount = 0};
 	return mp;
 }
 
@@ -473,7 +602,7 @@ void *lpms_channels(void *ptargs) {
 	msg_t *m_sn = msg_new_string(lpmsInfo->sourceNum, SLCHAN_NAME,
 	                             strlen(lpmsInfo->sourceName), lpmsInfo->sourceName);
 
-	if (!queue_push(args->logQ, m_sn)) {
+	if (!source_push(args, m_sn)) {
 		log_error(args->pstate, "[LPMS:%s] Error pushing channel name to queue",
 		          args->tag);
 		msg_destroy(m_sn);
@@ -481,39 +610,58 @@ void *lpms_channels(void *ptargs) {
 		pthread_exit(&(args->returnCode));
 	}
 
-	strarray *channels = sa_new(29);
+	strarray *channels = sa_new(lpmsInfo->packing == LPMS_PACK_NONE ? 29 : CHAN_PK_FRAME + 1);
 	sa_create_entry(channels, SLCHAN_NAME, 4, "Name");
 	sa_create_entry(channels, SLCHAN_MAP, 8, "Channels");
 	sa_create_entry(channels, SLCHAN_TSTAMP, 9, "Timestamp");
 	sa_create_entry(channels, SLCHAN_RAW, 8, "Raw Data");
-	sa_create_entry(channels, CHAN_ACC_RAW_X, 17, "AccelerationRaw_X");
-	sa_create_entry(channels, CHAN_ACC_RAW_Y, 17, "AccelerationRaw_Y");
-	sa_create_entry(channels, CHAN_ACC_RAW_Z, 17, "AccelerationRaw_Z");
-	sa_create_entry(channels, CHAN_ACC_CAL_X, 17, "AccelerationCal_X");
-	sa_create_entry(channels, CHAN_ACC_CAL_Y, 17, "AccelerationCal_Y");
-	sa_create_entry(channels, CHAN_ACC_CAL_Z, 17, "AccelerationCal_Z");
-	sa_create_entry(channels, CHAN_G_RAW_X, 9, "GyroRaw_X");
-	sa_create_entry(channels, CHAN_G_RAW_Y, 9, "GyroRaw_Y");
-	sa_create_entry(channels, CHAN_G_RAW_Z, 9, "GyroRaw_Z");
-	sa_create_entry(channels, CHAN_G_CAL_X, 9, "GyroCal_X");
-	sa_create_entry(channels, CHAN_G_CAL_Y, 9, "GyroCal_Y");
-	sa_create_entry(channels, CHAN_G_CAL_Z, 9, "GyroCal_Z");
-	sa_create_entry(channels, CHAN_G_ALIGN_X, 11, "GyroAlign_X");
-	sa_create_entry(channels, CHAN_G_ALIGN_Y, 11, "GyroAlign_Y");
-	sa_create_entry(channels, CHAN_G_ALIGN_Z, 11, "GyroAlign_Z");
-	sa_create_entry(channels, CHAN_OMEGA_X, 12, "AngularVel X");
-	sa_create_entry(channels, CHAN_OMEGA_Y, 12, "AngularVel Y");
-	sa_create_entry(channels, CHAN_OMEGA_Z, 12, "AngularVel Z");
-	sa_create_entry(channels, CHAN_ROLL, 4, "Roll");
-	sa_create_entry(channels, CHAN_PITCH, 5, "Pitch");
-	sa_create_entry(channels, CHAN_YAW, 3, "Yaw");
-	sa_create_entry(channels, CHAN_ACC_LIN_X, 17, "AccelerationLin_X");
-	sa_create_entry(channels, CHAN_ACC_LIN_Y, 17, "AccelerationLin_Y");
-	sa_create_entry(channels, CHAN_ACC_LIN_Z, 17, "AccelerationLin_Z");
-	sa_create_entry(channels, CHAN_ALTITUDE, 8, "Altitude");
+	switch (lpmsInfo->packing) {
+		case LPMS_PACK_NONE:
+			sa_create_entry(channels, CHAN_ACC_RAW_X, 17, "AccelerationRaw_X");
+			sa_create_entry(channels, CHAN_ACC_RAW_Y, 17, "AccelerationRaw_Y");
+			sa_create_entry(channels, CHAN_ACC_RAW_Z, 17, "AccelerationRaw_Z");
+			sa_create_entry(channels, CHAN_ACC_CAL_X, 17, "AccelerationCal_X");
+			sa_create_entry(channels, CHAN_ACC_CAL_Y, 17, "AccelerationCal_Y");
+			sa_create_entry(channels, CHAN_ACC_CAL_Z, 17, "AccelerationCal_Z");
+			sa_create_entry(channels, CHAN_G_RAW_X, 9, "GyroRaw_X");
+			sa_create_entry(channels, CHAN_G_RAW_Y, 9, "GyroRaw_Y");
+			sa_create_entry(channels, CHAN_G_RAW_Z, 9, "GyroRaw_Z");
+			sa_create_entry(channels, CHAN_G_CAL_X, 9, "GyroCal_X");
+			sa_create_entry(channels, CHAN_G_CAL_Y, 9, "GyroCal_Y");
+			sa_create_entry(channels, CHAN_G_CAL_Z, 9, "GyroCal_Z");
+			sa_create_entry(channels, CHAN_G_ALIGN_X, 11, "GyroAlign_X");
+			sa_create_entry(channels, CHAN_G_ALIGN_Y, 11, "GyroAlign_Y");
+			sa_create_entry(channels, CHAN_G_ALIGN_Z, 11, "GyroAlign_Z");
+			sa_create_entry(channels, CHAN_OMEGA_X, 12, "AngularVel X");
+			sa_create_entry(channels, CHAN_OMEGA_Y, 12, "AngularVel Y");
+			sa_create_entry(channels, CHAN_OMEGA_Z, 12, "AngularVel Z");
+			sa_create_entry(channels, CHAN_ROLL, 4, "Roll");
+			sa_create_entry(channels, CHAN_PITCH, 5, "Pitch");
+			sa_create_entry(channels, CHAN_YAW, 3, "Yaw");
+			sa_create_entry(channels, CHAN_ACC_LIN_X, 17, "AccelerationLin_X");
+			sa_create_entry(channels, CHAN_ACC_LIN_Y, 17, "AccelerationLin_Y");
+			sa_create_entry(channels, CHAN_ACC_LIN_Z, 17, "AccelerationLin_Z");
+			sa_create_entry(channels, CHAN_ALTITUDE, 8, "Altitude");
+			break;
+		case LPMS_PACK_VECTOR:
+			sa_create_entry(channels, CHAN_ALTITUDE, 8, "Altitude");
+			PACKED_ENTRY(channels, CHAN_PK_ACC_RAW, NAMES_ACC_RAW);
+			PACKED_ENTRY(channels, CHAN_PK_ACC_CAL, NAMES_ACC_CAL);
+			PACKED_ENTRY(channels, CHAN_PK_G_RAW, NAMES_G_RAW);
+			PACKED_ENTRY(channels, CHAN_PK_G_CAL, NAMES_G_CAL);
+			PACKED_ENTRY(channels, CHAN_PK_G_ALIGN, NAMES_G_ALIGN);
+			PACKED_ENTRY(channels, CHAN_PK_OMEGA, NAMES_OMEGA);
+			PACKED_ENTRY(channels, CHAN_PK_EULER, NAMES_EULER);
+			PACKED_ENTRY(channels, CHAN_PK_ACC_LIN, NAMES_ACC_LIN);
+			break;
+		case LPMS_PACK_FRAME:
+			PACKED_ENTRY(channels, CHAN_PK_FRAME, NAMES_FRAME);
+			break;
+	}
+
 	msg_t *m_cmap = msg_new_string_array(lpmsInfo->sourceNum, SLCHAN_MAP, channels);
 
-	if (!queue_push(args->logQ, m_cmap)) {
+	if (!source_push(args, m_cmap)) {
 		log_error(args->pstate, "[LPMS:%s] Error pushing channel map to queue", args->tag);
 		msg_destroy(m_cmap);
 		sa_destroy(channels);
@@ -650,6 +798,22 @@ bool lpms_parseConfig(log_thread_args_t *lta, config_section *s) {
 		}
 	}
 	t = NULL;
+
+	if ((t = config_get_key(s, "packing"))) {
+		if (strcasecmp(t->value, "none") == 0) {
+			lpmsInfo->packing = LPMS_PACK_NONE;
+		} else if (strcasecmp(t->value, "vector") == 0) {
+			lpmsInfo->packing = LPMS_PACK_VECTOR;
+		} else if (strcasecmp(t->value, "frame") == 0) {
+			lpmsInfo->packing = LPMS_PACK_FRAME;
+		} else {
+			log_error(lta->pstate, "[LPMS:%s] Invalid packing mode (%s)", lta->tag,
+			          t->value);
+			free(lpmsInfo);
+			return false;
+		}
+	}
+	t = NULL;
 	lta->dParams = lpmsInfo;
 	return true;
 }
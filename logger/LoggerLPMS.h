@@ -40,6 +40,14 @@
  *
  * @{
  */
+
+//! Output packing modes
+typedef enum {
+	LPMS_PACK_NONE = 0, //!< One floating point message per value (default)
+	LPMS_PACK_VECTOR,   //!< One numerical array message per vector quantity
+	LPMS_PACK_FRAME,    //!< One numerical array message per IMU data frame
+} lpms_packing;
+
 //! Serial device specific parameters
 typedef struct {
 	char *sourceName;  //!< User defined name for this source
@@ -49,17 +57,42 @@ typedef struct {
 	int baudRate;      //!< Baud rate for operations (Default 921600)
 	int handle;        //!< Handle for currently opened device
 	int pollFreq;      //!< Desired number of measurements per second
+	lpms_packing packing; //!< Output packing mode
+	uint8_t *buf;      //!< Receive buffer (allocated by lpms_setup())
+	size_t hw;         //!< End of valid data in buf
+	size_t end;        //!< End of last message processed in buf
+	uint32_t outputs;  //!< Output configuration reported by unit
+	lpms_message msg;  //!< Received message (data array allocated by lpms_setup())
+	lpms_imu_layout layout; //!< IMU data field offsets for current output configuration
+	bool streaming;    //!< Unit has been switched to streaming mode
+	bool unitMismatch; //!< Unexpected unit ID warning has been issued
+	unsigned int pendingCount; //!< Messages skipped while waiting for output configuration
+	unsigned int missingCount; //!< Consecutive updates with missing data
 } lpms_params;
 
 //! Generic serial connection setup
 void *lpms_setup(void *ptargs);
 
 //! Helper function: Create and queue data messages, with error handling
-bool lpms_queue_message(msgqueue *Q, const uint8_t src, const uint8_t chan, const float val);
+bool lpms_queue_message(log_thread_args_t *args, const uint8_t src, const uint8_t chan,
+                        const float val);
+
+//! Helper function: Create and queue numerical array messages, with error handling
+bool lpms_queue_array(log_thread_args_t *args, const uint8_t src, const uint8_t chan,
+                      const size_t entries, const float *vals);
+
+//! Queue decoded IMU data according to configured packing mode
+bool lpms_queue_data(log_thread_args_t *args, const lpms_data *d);
 
 //! Serial source main logging loop
 void *lpms_logging(void *ptargs);
 
+//! Read and queue all currently available messages
+void *lpms_readable(void *ptargs);
+
+//! Return current LPMS device handle
+int lpms_handle(void *ptargs);
+
 //! Serial source shutdown
 void *lpms_shutdown(void *ptargs);
 
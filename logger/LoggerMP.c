@@ -41,39 +41,55 @@ void *mp_setup(void *ptargs) {
 		return NULL;
 	}
 
+	mpInfo->buf = calloc(MP_SERIAL_BUFF, sizeof(uint8_t));
+	mpInfo->index = 0;
+	mpInfo->hw = 0;
+	if (!mpInfo->buf) {
+		log_error(args->pstate, "[MP:%s] Unable to allocate buffer", args->tag);
+		mp_closeConnection(mpInfo->handle);
+		mpInfo->handle = -1;
+		args->returnCode = -1;
+		return NULL;
+	}
+
 	log_info(args->pstate, 2, "[MP:%s] Connected", args->tag);
 	args->returnCode = 0;
 	return NULL;
 }
 
 /*!
- * Reads messages from the serial connection established by mp_setup(), and pushes them to
- * the queue. As messages are already in the right format, no further processing is done
- * here.
+ * Reads all messages currently available from the serial connection
+ * established by mp_setup(), and pushes them to the queue. As messages are
+ * already in the right format, no further processing is done here.
+ *
+ * Does not block, so can be called repeatedly by mp_logging() or by the
+ * reactor threads.
  *
  * @param[in] ptargs Pointer to log_thread_args_t
  * @returns NULL - Error code stored in ptarges->returnCode if required
  */
-void *mp_logging(void *ptargs) {
-	signalHandlersBlock();
+void *mp_readable(void *ptargs) {
 	log_thread_args_t *args = (log_thread_args_t *)ptargs;
 	mp_params *mpInfo = (mp_params *)args->dParams;
 
-	log_info(args->pstate, 1, "[MP:%s] Logging thread started", args->tag);
-
-	uint8_t *buf = calloc(MP_SERIAL_BUFF, sizeof(uint8_t));
-	int mp_index = 0;
-	int mp_hw = 0;
 	while (!shutdownFlag) {
 		// Needs to be on the heap as we'll be queuing it
 		msg_t *out = calloc(1, sizeof(msg_t));
-		if (mp_readMessage_buf(mpInfo->handle, out, buf, &mp_index, &mp_hw)) {
-			if (!queue_push(args->logQ, out)) {
+		if (!out) {
+			log_error(args->pstate, "[MP:%s] Unable to allocate message", args->tag);
+			args->returnCode = -1;
+			return NULL;
+		}
+		args->captured = capture_time();
+		if (mp_readMessage_buf(mpInfo->handle, out, mpInfo->buf, &(mpInfo->index),
+		                       &(mpInfo->hw))) {
+			if (!source_push(args, out)) {
 				log_error(args->pstate, "[MP:%s] Error pushing message to queue",
 				          args->tag);
 				msg_destroy(out);
+				free(out);
 				args->returnCode = -1;
-				pthread_exit(&(args->returnCode));
+				return NULL;
 			}
 
 			if (out->type == SLCHAN_NAME) {
@@ -112,7 +128,7 @@ void *mp_logging(void *ptargs) {
 					          "[MP:%s] Error caching channel map", args->tag);
 					// Not destroying "out", as already queued
 					args->returnCode = -1;
-					pthread_exit(&(args->returnCode));
+					return NULL;
 				}
 			}
 			// After pushing it to the queue, it is the responsibility of the
@@ -133,26 +149,57 @@ void *mp_logging(void *ptargs) {
 				log_error(args->pstate,
 				          "[MP:%s] Error signalled from mp_readMessage_buf",
 				          args->tag);
-				free(buf);
 				free(out);
 				args->returnCode = -2;
-				pthread_exit(&(args->returnCode));
+				return NULL;
 			}
+			const bool moreData = (out->data.value == 0xEE);
 			// out was allocated but not pushed to the queue, so free it here.
 			msg_destroy(out);
 			free(out);
 
-			// We've already exited (via pthread_exit) for error
-			// cases, so at this point sleep briefly and wait for
-			// more data
-			usleep(SERIAL_SLEEP);
+			// Return and wait for more data, unless there may be further
+			// messages following an invalid one
+			if (!moreData) { return NULL; }
 		}
 	}
-	free(buf);
+	return NULL;
+}
+
+/*!
+ * Calls mp_readable() repeatedly until shutdown, waiting between calls
+ * for more data (see source_wait()).
+ *
+ * Terminates thread on error.
+ *
+ * @param[in] ptargs Pointer to log_thread_args_t
+ * @returns NULL - Error code stored in ptarges->returnCode if required
+ */
+void *mp_logging(void *ptargs) {
+	signalHandlersBlock();
+	log_thread_args_t *args = (log_thread_args_t *)ptargs;
+
+	log_info(args->pstate, 1, "[MP:%s] Logging thread started", args->tag);
+
+	while (!shutdownFlag) {
+		mp_readable(ptargs);
+		if (args->returnCode != 0) { pthread_exit(&(args->returnCode)); }
+		source_wait(args, mp_handle(ptargs), SERIAL_SLEEP);
+	}
 	pthread_exit(NULL);
 	return NULL; // Superfluous, as returning zero via pthread_exit above
 }
 
+/*!
+ * @param[in] ptargs Pointer to log_thread_args_t
+ * @returns Handle for currently opened device
+ */
+int mp_handle(void *ptargs) {
+	log_thread_args_t *args = (log_thread_args_t *)ptargs;
+	mp_params *mpInfo = (mp_params *)args->dParams;
+	return mpInfo->handle;
+}
+
 /*!
  * Duplicate cached channel map and enqueue
  *
@@ -173,7 +220,7 @@ void *mp_channels(void *ptargs) {
 		msg_t *out = msg_new_string(mpInfo->csource, SLCHAN_NAME, strlen(mpInfo->cname),
 		                            mpInfo->cname);
 
-		if (!queue_push(args->logQ, out)) {
+		if (!source_push(args, out)) {
 			log_error(args->pstate, "[MP:%s] Error pushing source name to queue",
 			          args->tag);
 			msg_destroy(out);
@@ -185,7 +232,7 @@ void *mp_channels(void *ptargs) {
 	if (mpInfo->cmap.entries > 0) {
 		msg_t *out = msg_new_string_array(mpInfo->csource, SLCHAN_MAP, &mpInfo->cmap);
 
-		if (!queue_push(args->logQ, out)) {
+		if (!source_push(args, out)) {
 			log_error(args->pstate, "[MP:%s] Error pushing channel map to queue",
 			          args->tag);
 			msg_destroy(out);
@@ -215,6 +262,10 @@ void *mp_shutdown(void *ptargs) {
 		free(mpInfo->portName);
 		mpInfo->portName = NULL;
 	}
+	if (mpInfo->buf) {
+		free(mpInfo->buf);
+		mpInfo->buf = NULL;
+	}
 	return NULL;
 }
 
@@ -225,7 +276,9 @@ device_callbacks mp_getCallbacks() {
 	device_callbacks cb = {.startup = &mp_setup,
 	                       .logging = &mp_logging,
 	                       .shutdown = &mp_shutdown,
-	                       .channels = &mp_channels};
+	                       .channels = &mp_channels,
+	                       .readable = &mp_readable,
+	                       .handle = &mp_handle};
 	return cb;
 }
 
@@ -238,7 +291,10 @@ mp_params mp_getParams() {
 	                .handle = -1,
 	                .csource = 0,
 	                .cname = NULL,
-	                .cmap = {0}};
+	                .cmap = {0},
+	                .buf = NULL,
+	                .index = 0,
+	                .hw = 0};
 	return mp;
 }
 
@@ -50,6 +50,9 @@ typedef struct {
 	uint8_t csource; //!< Cache source ID
 	char *cname;     //!< Cache latest device name
 	strarray cmap;   //!< Cache latest channel map
+	uint8_t *buf;    //!< Receive buffer (allocated by mp_setup())
+	int index;       //!< Current search position within buf
+	int hw;          //!< End of valid data in buf
 } mp_params;
 
 //! MP connection setup
@@ -58,6 +61,12 @@ void *mp_setup(void *ptargs);
 //! MP source main logging loop
 void *mp_logging(void *ptargs);
 
+//! Read and queue all currently available messages
+void *mp_readable(void *ptargs);
+
+//! Return current MP device handle
+int mp_handle(void *ptargs);
+
 //! Push device information from cache to queue
 void *mp_channels(void *ptargs);
 
@@ -34,8 +34,10 @@ void *mqtt_setup(void *ptargs) {
 	log_thread_args_t *args = (log_thread_args_t *)ptargs;
 	mqtt_params *mqttInfo = (mqtt_params *)args->dParams;
 
-	queue_init(&(mqttInfo->qm.q));
 	mqttInfo->qm.sourceNum = mqttInfo->sourceNum;
+	mqttInfo->qm.deliver = &mqtt_deliver;
+	mqttInfo->qm.deliverData = args;
+	atomic_store(&(mqttInfo->lastMessage), time(NULL));
 	mqttInfo->conn = mqtt_openConnection(mqttInfo->addr, mqttInfo->port, &(mqttInfo->qm));
 	if (mqttInfo->conn == NULL) {
 		log_error(args->pstate, "[MQTT:%s] Unable to open a connection", args->tag);
@@ -44,7 +46,10 @@ void *mqtt_setup(void *ptargs) {
 	}
 
 	if (!mqtt_subscribe_batch(mqttInfo->conn, &(mqttInfo->qm))) {
-		log_error(args->pstate, "Unable to subscribe to topics");
+		log_error(args->pstate, "[MQTT:%s] Unable to subscribe to topics", args->tag);
+		mqtt_closeConnection(mqttInfo->conn);
+		mqttInfo->conn = NULL;
+		args->returnCode = -1;
 		return NULL;
 	}
 
@@ -53,16 +58,80 @@ void *mqtt_setup(void *ptargs) {
 	return NULL;
 }
 
+/*!
+ * Pushes an updated channel map if required, then moves any messages received
+ * before startup completed into the main message queue.
+ *
+ * Must be called with mqtt_params.lock held, so that messages are not
+ * reordered between the MQTT queue and the main queue.
+ *
+ * @param[in] args Pointer to log_thread_args_t
+ * @returns True on success, false if a message could not be queued
+ */
+static bool mqtt_flush_queue(log_thread_args_t *args) {
+	mqtt_params *mqttInfo = (mqtt_params *)args->dParams;
+
+	// Wildcard channels assigned since the last channel map was pushed
+	if (atomic_exchange(&(mqttInfo->qm.remapped), false)) {
+		if (!mqtt_push_channel_map(args)) {
+			log_warning(args->pstate, "[MQTT:%s] Unable to update channel map",
+			            args->tag);
+		}
+	}
+
+	msg_t *in = NULL;
+	while ((in = queue_pop(&mqttInfo->qm.q))) {
+		if (!queue_push(args->logQ, in)) {
+			msg_destroy(in);
+			free(in);
+			return false;
+		}
+	}
+	return true;
+}
+
+/*!
+ * Messages are delivered to this function by mqtt_enqueue_messages(), from
+ * a thread managed by the mosquitto library, and pushed directly to the main
+ * message queue.
+ *
+ * Messages received before the source has finished starting are held in the
+ * MQTT specific queue, so that they are recorded after the initial channel
+ * map. Any messages still held are moved to the main queue before the first
+ * message is delivered directly, and an updated channel map is queued first
+ * if a wildcard topic has been assigned a new channel.
+ *
+ * @param[in] ptargs Pointer to log_thread_args_t
+ * @param[in] msg Message to be queued
+ * @returns True on success, false on error
+ */
+bool mqtt_deliver(void *ptargs, msg_t *msg) {
+	log_thread_args_t *args = (log_thread_args_t *)ptargs;
+	mqtt_params *mqttInfo = (mqtt_params *)args->dParams;
+	atomic_store(&(mqttInfo->lastMessage), time(NULL));
+
+	bool rv = false;
+	pthread_mutex_lock(&(mqttInfo->lock));
+	if (atomic_load(&(args->status)) != SOURCE_READY) {
+		rv = queue_push(&(mqttInfo->qm.q), msg);
+	} else if (mqtt_flush_queue(args)) {
+		// Capture time already set by mqtt_enqueue_messages()
+		rv = queue_push(args->logQ, msg);
+	}
+	pthread_mutex_unlock(&(mqttInfo->lock));
+	return rv;
+}
+
 /*!
  * MQTT Logging thread
  *
- * Handles sending keepalive commands (if enabled) and popping items from
- * within the MQTT specific queue and moving them into the main message queue.
+ * Handles sending keepalive commands (if enabled), and moves any messages
+ * received before startup completed into the main message queue.
  *
  * Unlike the _logging function for other sources, this doesn't read anything
  * directly. Message processing is handled in a thread managed by the mosquitto
- * library and we pass in a callback function to format and enqueue the
- * messages.
+ * library, and messages are delivered straight to the main queue by
+ * mqtt_deliver().
  *
  * Terminates thread on error
  *
@@ -76,11 +145,10 @@ void *mqtt_logging(void *ptargs) {
 	log_info(args->pstate, 1, "[MQTT:%s] Logging thread started", args->tag);
 
 	time_t lastKA = 0;
-	time_t lastMessage = 0;
 	uint16_t count = 0; // Unsigned so that it wraps around
 	while (!shutdownFlag) {
 		if (mqttInfo->victron_keepalives &&
-		    (count % 200) == 0) { // Check ~ every 10 seconds
+		    (count % 100) == 0) { // Check ~ every 10 seconds
 			time_t now = time(NULL);
 			if ((now - lastKA) >= mqttInfo->keepalive_interval) {
 				lastKA = now;
@@ -91,30 +159,27 @@ void *mqtt_logging(void *ptargs) {
 					            args->tag);
 				}
 			}
-			if ((now - lastMessage) > 180) {
+			if ((now - atomic_load(&(mqttInfo->lastMessage))) > 180) {
 				log_warning(
 					args->pstate,
 					"[MQTT:%s] More than 3 minutes since last message. Resetting timer",
 					args->tag);
-				lastMessage = now;
+				atomic_store(&(mqttInfo->lastMessage), now);
 			}
 		}
 		count++;
 
-		msg_t *in = NULL;
-		in = queue_pop(&mqttInfo->qm.q);
-		if (in == NULL) {
-			usleep(5E4);
-			continue;
-		}
-		if (!queue_push(args->logQ, in)) {
+		// Messages received before startup completed
+		pthread_mutex_lock(&(mqttInfo->lock));
+		const bool flushed = mqtt_flush_queue(args);
+		pthread_mutex_unlock(&(mqttInfo->lock));
+		if (!flushed) {
 			log_error(args->pstate, "[MQTT:%s] Error pushing message to queue",
 			          args->tag);
-			msg_destroy(in);
 			args->returnCode = -1;
 			pthread_exit(&(args->returnCode));
 		}
-		lastMessage = time(NULL);
+		usleep(1E5);
 	}
 	return NULL;
 }
@@ -130,6 +195,7 @@ void *mqtt_shutdown(void *ptargs) {
 	mqtt_params *mqttInfo = (mqtt_params *)args->dParams;
 	mqtt_closeConnection(mqttInfo->conn);
 	mqtt_destroy_queue_map(&(mqttInfo->qm));
+	pthread_mutex_destroy(&(mqttInfo->lock));
 	if (mqttInfo->addr) {
 		free(mqttInfo->addr);
 		mqttInfo->addr = NULL;
@@ -145,6 +211,50 @@ void *mqtt_shutdown(void *ptargs) {
 	return NULL;
 }
 
+/*!
+ * Channels reserved for wildcard topics are named as described in
+ * mqtt_channel_name(), so the channel map is pushed again whenever a new
+ * topic is assigned to one of these channels.
+ *
+ * @param[in] args Pointer to log_thread_args_t
+ * @returns True on success, false on error
+ */
+bool mqtt_push_channel_map(log_thread_args_t *args) {
+	mqtt_params *mqttInfo = (mqtt_params *)args->dParams;
+
+	int maxID = SLCHAN_RAW;
+	for (int t = 0; t < mqttInfo->qm.numtopics; t++) {
+		const int last = mqttInfo->qm.tc[t].type + mqttInfo->qm.tc[t].count - 1;
+		if (last > maxID) { maxID = last; }
+	}
+
+	strarray *channels = sa_new(maxID + 1);
+	if (channels == NULL) { return false; }
+	sa_create_entry(channels, SLCHAN_NAME, 4, "Name");
+	sa_create_entry(channels, SLCHAN_MAP, 8, "Channels");
+	sa_create_entry(channels, SLCHAN_TSTAMP, 9, "Timestamp");
+	sa_create_entry(channels, SLCHAN_RAW, 1, "-");
+	for (int c = SLCHAN_RAW + 1; c <= maxID; c++) {
+		char *cn = mqtt_channel_name(&(mqttInfo->qm), c);
+		if (cn == NULL) { continue; }
+		sa_create_entry(channels, c, strlen(cn), cn);
+		free(cn);
+	}
+
+	msg_t *m_cmap = msg_new_string_array(mqttInfo->sourceNum, SLCHAN_MAP, channels);
+	sa_destroy(channels);
+	free(channels);
+	if (m_cmap == NULL) { return false; }
+
+	// May be called from the mosquitto thread, so args->captured is not used
+	m_cmap->captured = capture_time();
+	if (!queue_push(args->logQ, m_cmap)) {
+		msg_destroy(m_cmap);
+		return false;
+	}
+	return true;
+}
+
 /*!
  * Create channel map from configured IDs and push to queue.
  *
@@ -160,7 +270,7 @@ void *mqtt_channels(void *ptargs) {
 	msg_t *m_sn = msg_new_string(mqttInfo->sourceNum, SLCHAN_NAME,
 	                             strlen(mqttInfo->sourceName), mqttInfo->sourceName);
 
-	if (!queue_push(args->logQ, m_sn)) {
+	if (!source_push(args, m_sn)) {
 		log_error(args->pstate, "[MQTT:%s] Error pushing channel name to queue",
 		          args->tag);
 		msg_destroy(m_sn);
@@ -168,29 +278,13 @@ void *mqtt_channels(void *ptargs) {
 		pthread_exit(&(args->returnCode));
 	}
 
-	strarray *channels = sa_new(4 + mqttInfo->qm.numtopics);
-	sa_create_entry(channels, SLCHAN_NAME, 4, "Name");
-	sa_create_entry(channels, SLCHAN_MAP, 8, "Channels");
-	sa_create_entry(channels, SLCHAN_TSTAMP, 9, "Timestamp");
-	sa_create_entry(channels, SLCHAN_RAW, 1, "-");
-	for (int t = 0; t < mqttInfo->qm.numtopics; t++) {
-		sa_create_entry(channels, 4 + t, strlen(mqttInfo->qm.tc[t].name),
-		                mqttInfo->qm.tc[t].name);
-	}
-
-	msg_t *m_cmap = msg_new_string_array(mqttInfo->sourceNum, SLCHAN_MAP, channels);
-
-	if (!queue_push(args->logQ, m_cmap)) {
+	// This map includes any wildcard assignments made so far
+	atomic_store(&(mqttInfo->qm.remapped), false);
+	if (!mqtt_push_channel_map(args)) {
 		log_error(args->pstate, "[MQTT:%s] Error pushing channel map to queue", args->tag);
-		msg_destroy(m_cmap);
-		sa_destroy(channels);
-		free(channels);
 		args->returnCode = -1;
 		pthread_exit(&(args->returnCode));
 	}
-
-	sa_destroy(channels);
-	free(channels);
 	return NULL;
 }
 
@@ -218,11 +312,73 @@ mqtt_params mqtt_getParams() {
 		.keepalive_interval = 30,
 		.sysid = NULL,
 		.conn = NULL,
-		.qm = {{0}, 0, 0, {{0}}, false},
 	};
 	return mp;
 }
 
+/*!
+ * Topic configuration format is `topic[:channel name[:text mode[:channels]]]`
+ *
+ * Channels are allocated consecutively, starting from `nextID`, which is
+ * updated to the next unused channel.
+ *
+ * @param[in] lta Pointer to log_thread_args_t
+ * @param[in,out] qm Topic map to add topic to
+ * @param[in] value Configuration value (modified)
+ * @param[in,out] nextID Next unused channel number
+ * @returns True on success, false on error
+ */
+bool mqtt_parseTopic(log_thread_args_t *lta, mqtt_queue_map *qm, char *value, int *nextID) {
+	char *strtsp = NULL;
+	char *topic = strtok_r(value, ":", &strtsp);
+	if (topic == NULL) {
+		log_error(lta->pstate, "[MQTT:%s] Empty topic specified", lta->tag);
+		return false;
+	}
+
+	char *name = strtok_r(NULL, ":", &strtsp);
+	if (name == NULL) { name = topic; }
+
+	bool text = true;
+	char *token = NULL;
+	if ((token = strtok_r(NULL, ":", &strtsp))) {
+		int tmp = config_parse_bool(token);
+		if (tmp < 0) {
+			log_error(lta->pstate,
+			          "[MQTT:%s] Invalid textmode specifier (%s) for topic '%s' ",
+			          lta->tag, token, topic);
+			return false;
+		}
+		text = (tmp > 0);
+	}
+
+	int count = 1;
+	if ((token = strtok_r(NULL, ":", &strtsp))) {
+		errno = 0;
+		count = strtol(token, NULL, 0);
+		if (errno || count < 1) {
+			log_error(lta->pstate,
+			          "[MQTT:%s] Invalid channel count (%s) for topic '%s'", lta->tag,
+			          token, topic);
+			return false;
+		}
+	}
+
+	if ((*nextID + count - 1) >= SLCHAN_LOG_INFO) {
+		log_error(lta->pstate, "[MQTT:%s] Insufficient channels available for topic '%s'",
+		          lta->tag, topic);
+		return false;
+	}
+
+	if (!mqtt_add_topic(qm, topic, name, *nextID, count, text)) {
+		// Multiple channels are only valid for topics containing wildcards
+		log_error(lta->pstate, "[MQTT:%s] Unable to add topic '%s'", lta->tag, topic);
+		return false;
+	}
+	*nextID += count;
+	return true;
+}
+
 /*!
  * @param[in] lta Pointer to log_thread_args_t
  * @param[in] s Pointer to config_section to be parsed
@@ -241,7 +397,14 @@ bool mqtt_parseConfig(log_thread_args_t *lta, config_section *s) {
 		return false;
 	}
 	(*mqtt) = mqtt_getParams();
+	if (!mqtt_init_queue_map(&(mqtt->qm))) {
+		log_error(lta->pstate, "[MQTT:%s] Unable to initialise topic map", lta->tag);
+		free(mqtt);
+		return false;
+	}
+	pthread_mutex_init(&(mqtt->lock), NULL);
 
+	int nextID = SLCHAN_RAW + 1;
 	for (int i = 0; i < s->numopts; i++) {
 		config_kv *t = &(s->opts[i]);
 		if (strcasecmp(t->key, "host") == 0) {
@@ -327,30 +490,9 @@ bool mqtt_parseConfig(log_thread_args_t *lta, config_section *s) {
 			}
 			mqtt->qm.dumpall = (tmp > 0);
 		} else if (strcasecmp(t->key, "topic") == 0) {
-			int n = mqtt->qm.numtopics++;
-			char *strtsp = NULL;
-			mqtt->qm.tc[n].type = 4 + n;
-			mqtt->qm.tc[n].text = true;
-			char *token = NULL;
-			if ((token = strtok_r(t->value, ":", &strtsp))) {
-				// Topic:ChannelName:text
-				mqtt->qm.tc[n].topic = strdup(token);
-				mqtt->qm.tc[n].name = strdup(strtok_r(NULL, ":", &strtsp));
-				if ((token = strtok_r(NULL, ":", &strtsp))) {
-					int tmp = config_parse_bool(token);
-					if (tmp < 0) {
-						log_error(
-							lta->pstate,
-							"[MQTT:%s] Invalid textmode specifier (%s) for topic '%s' ",
-							lta->tag, t->value, mqtt->qm.tc[n].topic);
-						free(mqtt);
-						return false;
-					}
-					mqtt->qm.tc[n].text = (tmp > 0);
-				}
-			} else {
-				mqtt->qm.tc[n].topic = strdup(t->value);
-				mqtt->qm.tc[n].name = strdup(t->value);
+			if (!mqtt_parseTopic(lta, &(mqtt->qm), t->value, &nextID)) {
+				free(mqtt);
+				return false;
 			}
 		} else {
 			if (!(strcasecmp(t->key, "type") == 0 || strcasecmp(t->key, "tag") == 0)) {
@@ -375,6 +517,10 @@ bool mqtt_parseConfig(log_thread_args_t *lta, config_section *s) {
 		free(mqtt);
 		return false;
 	}
+	if (mqtt->sourceName == NULL) {
+		// Must set a name, so nick the tag value
+		mqtt->sourceName = strdup(lta->tag);
+	}
 	lta->dParams = mqtt;
 	return true;
 }
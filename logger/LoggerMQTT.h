@@ -21,6 +21,8 @@
 #ifndef SL_LOGGER_MQTT_H
 #define SL_LOGGER_MQTT_H
 
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -31,15 +33,17 @@
 
 //! MQTT source specific parameters
 typedef struct {
-	char *sourceName;        //!< User defined name for this source
-	uint8_t sourceNum;       //!< Source ID for messages
-	char *addr;              //!< Target host
-	int port;                //!< Target port number
-	bool victron_keepalives; //!< Victron compatible keep alives
-	int keepalive_interval;  //!< Interval between keepalives
-	char *sysid;             //!< Portal/System ID for use with victron_keepalive
-	mqtt_conn *conn;         //!< Connection
-	mqtt_queue_map qm;       //!< Topic mapping
+	char *sourceName;         //!< User defined name for this source
+	uint8_t sourceNum;        //!< Source ID for messages
+	char *addr;               //!< Target host
+	int port;                 //!< Target port number
+	bool victron_keepalives;  //!< Victron compatible keep alives
+	int keepalive_interval;   //!< Interval between keepalives
+	char *sysid;              //!< Portal/System ID for use with victron_keepalive
+	mqtt_conn *conn;          //!< Connection
+	mqtt_queue_map qm;        //!< Topic mapping
+	atomic_llong lastMessage; //!< Time last message was received
+	pthread_mutex_t lock;     //!< Serialises delivery from qm.q to the main queue
 } mqtt_params;
 
 //! Device thread setup
@@ -54,12 +58,21 @@ void *mqtt_shutdown(void *ptargs);
 //! Channel map
 void *mqtt_channels(void *ptargs);
 
+//! Push current channel map to queue, without exiting on error
+bool mqtt_push_channel_map(log_thread_args_t *args);
+
+//! Deliver messages from the MQTT callback directly to the main queue
+bool mqtt_deliver(void *ptargs, msg_t *msg);
+
 //! Fill out device callback functions for logging
 device_callbacks mqtt_getCallbacks(void);
 
 //! Fill out default MP source parameters
 mqtt_params mqtt_getParams(void);
 
+//! Parse a single topic configuration entry
+bool mqtt_parseTopic(log_thread_args_t *lta, mqtt_queue_map *qm, char *value, int *nextID);
+
 //! Take a configuration section and parse parameters
 bool mqtt_parseConfig(log_thread_args_t *lta, config_section *s);
 #endif
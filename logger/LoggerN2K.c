@@ -18,6 +18,8 @@
  *  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <math.h>
+
 #include "Logger.h"
 
 #include "LoggerN2K.h"
@@ -44,34 +46,43 @@ void *n2k_setup(void *ptargs) {
 		return NULL;
 	}
 
+	n2kInfo->buf = calloc(N2K_BUFF, sizeof(uint8_t));
+	n2kInfo->index = 0;
+	n2kInfo->hw = 0;
+	if (!n2kInfo->buf) {
+		log_error(args->pstate, "[N2K:%s] Unable to allocate buffer", args->tag);
+		n2k_closeConnection(n2kInfo->handle);
+		n2kInfo->handle = -1;
+		args->returnCode = -1;
+		return NULL;
+	}
+
 	log_info(args->pstate, 2, "[N2K:%s] Connected", args->tag);
 	args->returnCode = 0;
 	return NULL;
 }
 
 /*!
- * Takes a n2k_params struct (passed via log_thread_args_t)
- * messages from a device configured with n2k_setup() and pushes them to the
- * message queue.
+ * Takes a n2k_params struct (passed via log_thread_args_t), reads all
+ * messages currently available from a device configured with n2k_setup() and
+ * pushes them to the message queue.
  *
- * Exits thread on error or when shutdown is signalled.
+ * Does not block, so can be called repeatedly by n2k_logging() or by the
+ * reactor threads.
  *
  * @param[in] ptargs Pointer to log_thread_args_t
  * @returns NULL - Exit code in ptargs->returnCode if required
  */
-void *n2k_logging(void *ptargs) {
-	signalHandlersBlock();
+void *n2k_readable(void *ptargs) {
 	log_thread_args_t *args = (log_thread_args_t *)ptargs;
 	n2k_params *n2kInfo = (n2k_params *)args->dParams;
 
-	log_info(args->pstate, 1, "[N2K:%s] Logging thread started", args->tag);
-
-	uint8_t *buf = calloc(N2K_BUFF, sizeof(uint8_t));
-	size_t n2k_index = 0;
-	size_t n2k_hw = 0;
 	while (!shutdownFlag) {
+		bool wait = false;
 		n2k_act_message out = {0};
-		if (n2k_act_readMessage_buf(n2kInfo->handle, &out, buf, &n2k_index, &n2k_hw)) {
+		args->captured = capture_time();
+		if (n2k_act_readMessage_buf(n2kInfo->handle, &out, n2kInfo->buf, &(n2kInfo->index),
+		                            &(n2kInfo->hw))) {
 			bool handled = false;
 
 			if (out.PGN == 129025) {
@@ -80,26 +91,28 @@ void *n2k_logging(void *ptargs) {
 				if (n2k_129025_values(&out, &lat, &lon)) {
 					msg_t *rm = NULL;
 					rm = msg_new_float(n2kInfo->sourceNum, N2KCHAN_LAT, lat);
-					if (!queue_push(args->logQ, rm)) {
+					if (!source_push(args, rm)) {
 						log_error(
 							args->pstate,
 							"[N2K:%s] Error pushing message to queue",
 							args->tag);
 						msg_destroy(rm);
 						args->returnCode = -1;
-						pthread_exit(&(args->returnCode));
+						if (out.data) { free(out.data); }
+						return NULL;
 					}
 					rm = NULL; // Discard pointer as message is now "owned" by
 					           // queue
 					rm = msg_new_float(n2kInfo->sourceNum, N2KCHAN_LON, lon);
-					if (!queue_push(args->logQ, rm)) {
+					if (!source_push(args, rm)) {
 						log_error(
 							args->pstate,
 							"[N2K:%s] Error pushing message to queue",
 							args->tag);
 						msg_destroy(rm);
 						args->returnCode = -1;
-						pthread_exit(&(args->returnCode));
+						if (out.data) { free(out.data); }
+						return NULL;
 					}
 				} else {
 					log_warning(
@@ -108,6 +121,37 @@ void *n2k_logging(void *ptargs) {
 						args->tag, out.PGN, out.src);
 				}
 			}
+
+			for (int p = 0; p < n2kInfo->numPGNs; p++) {
+				const n2k_pgn_output *po = &(n2kInfo->pgnOut[p]);
+				if (out.PGN != po->desc->PGN) { continue; }
+
+				double v[N2K_MAX_FIELDS] = {0};
+				if (n2k_decode_message(po->desc, &out, v) < 0) {
+					log_warning(
+						args->pstate,
+						"[N2K:%s] Failed to decode message (PGN %d, Source %d)",
+						args->tag, out.PGN, out.src);
+					continue;
+				}
+
+				for (int f = 0; f < po->desc->nFields; f++) {
+					// Fields marked as not available are skipped
+					if (!isfinite(v[f])) { continue; }
+					msg_t *rm = msg_new_float(n2kInfo->sourceNum, po->baseID + f, v[f]);
+					if (!source_push(args, rm)) {
+						log_error(
+							args->pstate,
+							"[N2K:%s] Error pushing message to queue",
+							args->tag);
+						msg_destroy(rm);
+						args->returnCode = -1;
+						if (out.data) { free(out.data); }
+						return NULL;
+					}
+				}
+			}
+
 			if (!handled) {
 				size_t mlen = 0;
 				uint8_t *rd = NULL;
@@ -117,17 +161,19 @@ void *n2k_logging(void *ptargs) {
 						"[N2K:%s] Unable to serialise message (PGN %d, Source %d)",
 						args->tag, out.PGN, out.src);
 					if (rd) { free(rd); }
+					if (out.data) { free(out.data); }
 					continue;
 				}
 				msg_t *rm = NULL;
 				rm = msg_new_bytes(n2kInfo->sourceNum, N2KCHAN_RAW, mlen, rd);
-				if (!queue_push(args->logQ, rm)) {
+				if (!source_push(args, rm)) {
 					log_error(args->pstate,
 					          "[N2K:%s] Error pushing message to queue",
 					          args->tag);
 					msg_destroy(rm);
 					args->returnCode = -1;
-					pthread_exit(&(args->returnCode));
+					if (out.data) { free(out.data); }
+					return NULL;
 				}
 			}
 			// Do not destroy or free message here
@@ -149,29 +195,64 @@ void *n2k_logging(void *ptargs) {
 				          "[N2K:%s] Error signalled from n2k_readMessage_buf",
 				          args->tag);
 				args->returnCode = -2;
-				free(buf);
-				pthread_exit(&(args->returnCode));
+				if (out.data) { free(out.data); }
+				return NULL;
 			}
-			// We've already exited (via pthread_exit) for error
-			// cases, so at this point sleep briefly and wait for
-			// more data
-			usleep(SERIAL_SLEEP);
+			// 0xEE is also returned for incomplete messages, so always
+			// wait for more data here
+			wait = true;
 		}
 		if (out.data) { free(out.data); }
 
-		if (n2k_hw == 1024) { log_error(args->pstate, "[N2K:%s] Buffer full", args->tag); }
+		if (n2kInfo->hw == 1024) {
+			log_error(args->pstate, "[N2K:%s] Buffer full", args->tag);
+		}
 
-		if (n2k_hw == 1024 && n2k_index == 0) {
+		if (n2kInfo->hw == 1024 && n2kInfo->index == 0) {
 			log_error(args->pstate, "[N2K:%s] Ignoring first 100 bytes", args->tag);
-			n2k_index += 100; // Leave memory juggling to the other functions
+			n2kInfo->index += 100; // Leave memory juggling to the other functions
 		}
+
+		if (wait) { return NULL; }
+	}
+	return NULL;
+}
+
+/*!
+ * Calls n2k_readable() repeatedly until shutdown, waiting between calls
+ * for more data (see source_wait()).
+ *
+ * Exits thread on error or when shutdown is signalled.
+ *
+ * @param[in] ptargs Pointer to log_thread_args_t
+ * @returns NULL - Exit code in ptargs->returnCode if required
+ */
+void *n2k_logging(void *ptargs) {
+	signalHandlersBlock();
+	log_thread_args_t *args = (log_thread_args_t *)ptargs;
+
+	log_info(args->pstate, 1, "[N2K:%s] Logging thread started", args->tag);
+
+	while (!shutdownFlag) {
+		n2k_readable(ptargs);
+		if (args->returnCode != 0) { pthread_exit(&(args->returnCode)); }
+		source_wait(args, n2k_handle(ptargs), SERIAL_SLEEP);
 	}
-	free(buf);
 	log_info(args->pstate, 1, "[N2K:%s] Logging thread exiting", args->tag);
 	pthread_exit(NULL);
 	return NULL; // Superfluous, as returning zero via pthread_exit above
 }
 
+/*!
+ * @param[in] ptargs Pointer to log_thread_args_t
+ * @returns Handle for currently opened device
+ */
+int n2k_handle(void *ptargs) {
+	log_thread_args_t *args = (log_thread_args_t *)ptargs;
+	n2k_params *n2kInfo = (n2k_params *)args->dParams;
+	return n2kInfo->handle;
+}
+
 /*!
  * Calls n2k_closeConnection(), which will do any cleanup required.
  *
@@ -194,6 +275,15 @@ void *n2k_shutdown(void *ptargs) {
 		free(n2kInfo->portName);
 		n2kInfo->portName = NULL;
 	}
+	if (n2kInfo->pgnOut) {
+		free(n2kInfo->pgnOut);
+		n2kInfo->pgnOut = NULL;
+		n2kInfo->numPGNs = 0;
+	}
+	if (n2kInfo->buf) {
+		free(n2kInfo->buf);
+		n2kInfo->buf = NULL;
+	}
 	return NULL;
 }
 
@@ -212,14 +302,21 @@ void *n2k_channels(void *ptargs) {
 	msg_t *m_sn = msg_new_string(n2kInfo->sourceNum, SLCHAN_NAME, strlen(n2kInfo->sourceName),
 	                             n2kInfo->sourceName);
 
-	if (!queue_push(args->logQ, m_sn)) {
+	if (!source_push(args, m_sn)) {
 		log_error(args->pstate, "[N2K:%s] Error pushing channel name to queue", args->tag);
 		msg_destroy(m_sn);
 		args->returnCode = -1;
 		pthread_exit(&(args->returnCode));
 	}
 
-	strarray *channels = sa_new(6);
+	int maxID = N2KCHAN_LON;
+	for (int p = 0; p < n2kInfo->numPGNs; p++) {
+		const n2k_pgn_output *po = &(n2kInfo->pgnOut[p]);
+		const int last = po->baseID + po->desc->nFields - 1;
+		if (last > maxID) { maxID = last; }
+	}
+
+	strarray *channels = sa_new(maxID + 1);
 	sa_create_entry(channels, N2KCHAN_NAME, 4, "Name");
 	sa_create_entry(channels, N2KCHAN_MAP, 8, "Channels");
 	sa_create_entry(channels, N2KCHAN_TSTAMP, 9, "Timestamp");
@@ -227,9 +324,21 @@ void *n2k_channels(void *ptargs) {
 	sa_create_entry(channels, N2KCHAN_LAT, 9, "Latitude");
 	sa_create_entry(channels, N2KCHAN_LON, 9, "Longitude");
 
+	for (int p = 0; p < n2kInfo->numPGNs; p++) {
+		const n2k_pgn_output *po = &(n2kInfo->pgnOut[p]);
+		for (int f = 0; f < po->desc->nFields; f++) {
+			// Channel names are prefixed with the PGN to avoid ambiguity
+			char cn[64] = {0};
+			int cl = snprintf(cn, sizeof(cn), "%u:%s", po->desc->PGN,
+			                  po->desc->fields[f].name);
+			if (cl >= (int)sizeof(cn)) { cl = sizeof(cn) - 1; }
+			sa_create_entry(channels, po->baseID + f, cl, cn);
+		}
+	}
+
 	msg_t *m_cmap = msg_new_string_array(n2kInfo->sourceNum, SLCHAN_MAP, channels);
 
-	if (!queue_push(args->logQ, m_cmap)) {
+	if (!source_push(args, m_cmap)) {
 		log_error(args->pstate, "[N2K:%s] Error pushing channel map to queue", args->tag);
 		msg_destroy(m_cmap);
 		sa_destroy(channels);
@@ -250,7 +359,9 @@ device_callbacks n2k_getCallbacks() {
 	device_callbacks cb = {.startup = &n2k_setup,
 	                       .logging = &n2k_logging,
 	                       .shutdown = &n2k_shutdown,
-	                       .channels = &n2k_channels};
+	                       .channels = &n2k_channels,
+	                       .readable = &n2k_readable,
+	                       .handle = &n2k_handle};
 	return cb;
 }
 
@@ -258,8 +369,15 @@ device_callbacks n2k_getCallbacks() {
  * @returns Default parameters for N2K serial sources
  */
 n2k_params n2k_getParams() {
-	n2k_params gp = {
-		.portName = NULL, .sourceNum = SLSOURCE_N2K, .baudRate = 115200, .handle = -1};
+	n2k_params gp = {.portName = NULL,
+	                 .sourceNum = SLSOURCE_N2K,
+	                 .baudRate = 115200,
+	                 .handle = -1,
+	                 .numPGNs = 0,
+	                 .pgnOut = NULL,
+	                 .buf = NULL,
+	                 .index = 0,
+	                 .hw = 0};
 	return gp;
 }
 
@@ -335,6 +453,81 @@ bool n2k_parseConfig(log_thread_args_t *lta, config_section *s) {
 		}
 	}
 	t = NULL;
+
+	// Loop over all keys present, as PGN outputs may be specified multiple times
+	uint8_t nextID = N2KCHAN_FIRST;
+	for (int i = 0; i < s->numopts; i++) {
+		t = &(s->opts[i]);
+		if (strncasecmp(t->key, "pgn", 4) != 0) { continue; }
+
+		// Format is PGN[:base channel]
+		char *sep = NULL;
+		errno = 0;
+		const long pgn = strtol(t->value, &sep, 10);
+		bool valid = !errno && sep != t->value && (*sep == ':' || *sep == '\0');
+		long base = nextID;
+		if (valid && *sep == ':') {
+			char *end = NULL;
+			base = strtol(sep + 1, &end, 0);
+			valid = !errno && end != (sep + 1) && *end == '\0';
+		}
+		if (!valid || pgn < 0 || pgn > 0x3FFFF) {
+			log_error(lta->pstate,
+			          "[N2K:%s] Invalid PGN output (%s) - expected PGN[:base channel]",
+			          lta->tag, t->value);
+			free(nmp->pgnOut);
+			free(nmp);
+			return false;
+		}
+
+		const n2k_pgn_desc *pd = n2k_pgn_find(pgn);
+		if (!pd) {
+			log_error(lta->pstate, "[N2K:%s] No decoder available for PGN %ld",
+			          lta->tag, pgn);
+			free(nmp->pgnOut);
+			free(nmp);
+			return false;
+		}
+
+		const long last = base + pd->nFields - 1;
+		if (base < N2KCHAN_FIRST || last >= SLCHAN_LOG_INFO) {
+			log_error(lta->pstate,
+			          "[N2K:%s] Invalid channel range for PGN %ld (0x%02lx - 0x%02lx)",
+			          lta->tag, pgn, base, last);
+			free(nmp->pgnOut);
+			free(nmp);
+			return false;
+		}
+
+		for (int p = 0; p < nmp->numPGNs; p++) {
+			const n2k_pgn_output *po = &(nmp->pgnOut[p]);
+			const int pl = po->baseID + po->desc->nFields - 1;
+			if (po->desc == pd || (base <= pl && last >= po->baseID)) {
+				log_error(lta->pstate,
+				          "[N2K:%s] PGN %ld output conflicts with PGN %u",
+				          lta->tag, pgn, po->desc->PGN);
+				free(nmp->pgnOut);
+				free(nmp);
+				return false;
+			}
+		}
+
+		n2k_pgn_output *po = realloc(nmp->pgnOut, (nmp->numPGNs + 1) * sizeof(n2k_pgn_output));
+		if (!po) {
+			log_error(lta->pstate, "[N2K:%s] Unable to allocate memory for PGN outputs",
+			          lta->tag);
+			free(nmp->pgnOut);
+			free(nmp);
+			return false;
+		}
+		nmp->pgnOut = po;
+		nmp->pgnOut[nmp->numPGNs].desc = pd;
+		nmp->pgnOut[nmp->numPGNs].baseID = base;
+		nmp->numPGNs++;
+		if (last + 1 > nextID) { nextID = last + 1; }
+	}
+	t = NULL;
+
 	lta->dParams = nmp;
 	return true;
 }
@@ -49,14 +49,26 @@
 #define N2KCHAN_RAW    SLCHAN_RAW    //!< Raw data (recorded unmodified)
 #define N2KCHAN_LAT    4             //!< Latitude (from GPS)
 #define N2KCHAN_LON    5             //!< Longitude (from GPS)
+#define N2KCHAN_FIRST  6             //!< First channel available for decoded PGN fields
+
+//! Decoded PGN output configuration
+typedef struct {
+	const n2k_pgn_desc *desc; //!< Field descriptions for this PGN
+	uint8_t baseID;           //!< Channel number for first field
+} n2k_pgn_output;
 
 //! N2K Device specific parameters
 typedef struct {
-	char *portName;    //!< Target port name
-	char *sourceName;  //!< User defined name for this source
-	uint8_t sourceNum; //!< Source ID for messages
-	int baudRate;      //!< Baud rate for operations
-	int handle;        //!< Handle for currently opened device
+	char *portName;         //!< Target port name
+	char *sourceName;       //!< User defined name for this source
+	uint8_t sourceNum;      //!< Source ID for messages
+	int baudRate;           //!< Baud rate for operations
+	int handle;             //!< Handle for currently opened device
+	int numPGNs;            //!< Number of entries in pgnOut
+	n2k_pgn_output *pgnOut; //!< PGNs to be decoded into individual channels
+	uint8_t *buf;           //!< Receive buffer (allocated by n2k_setup())
+	size_t index;           //!< Current search position within buf
+	size_t hw;              //!< End of valid data in buf
 } n2k_params;
 
 //! N2K Setup
@@ -65,6 +77,12 @@ void *n2k_setup(void *ptargs);
 //! N2K logging (with pthread function signature)
 void *n2k_logging(void *ptargs);
 
+//! Read and queue all currently available messages
+void *n2k_readable(void *ptargs);
+
+//! Return current N2K device handle
+int n2k_handle(void *ptargs);
+
 //! N2K Shutdown
 void *n2k_shutdown(void *ptargs);
 
@@ -18,6 +18,9 @@
  *  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <ctype.h>
+#include <math.h>
+
 #include "Logger.h"
 
 #include "LoggerNMEA.h"
@@ -42,34 +45,42 @@ void *nmea_setup(void *ptargs) {
 		return NULL;
 	}
 
+	nmeaInfo->buf = calloc(NMEA_SERIAL_BUFF, sizeof(uint8_t));
+	nmeaInfo->index = 0;
+	nmeaInfo->hw = 0;
+	if (!nmeaInfo->buf) {
+		log_error(args->pstate, "[NMEA:%s] Unable to allocate buffer", args->tag);
+		nmea_closeConnection(nmeaInfo->handle);
+		nmeaInfo->handle = -1;
+		args->returnCode = -1;
+		return NULL;
+	}
+
 	log_info(args->pstate, 2, "[NMEA:%s] Connected", args->tag);
 	args->returnCode = 0;
 	return NULL;
 }
 
 /*!
- * Takes a nmea_params struct (passed via log_thread_args_t)
- * messages from a device configured with nmea_setup() and pushes them to the
- * message queue.
+ * Takes a nmea_params struct (passed via log_thread_args_t), reads all
+ * messages currently available from a device configured with nmea_setup() and
+ * pushes them to the message queue.
  *
- * Exits on error or when shutdown is signalled.
+ * Does not block, so can be called repeatedly by nmea_logging() or by the
+ * reactor threads.
  *
  * @param[in] ptargs Pointer to log_thread_args_t
  * @returns NULL - Exit code in ptargs->returnCode if required
  */
-void *nmea_logging(void *ptargs) {
-	signalHandlersBlock();
+void *nmea_readable(void *ptargs) {
 	log_thread_args_t *args = (log_thread_args_t *)ptargs;
 	nmea_params *nmeaInfo = (nmea_params *)args->dParams;
 
-	log_info(args->pstate, 1, "[NMEA:%s] Logging thread started", args->tag);
-
-	uint8_t *buf = calloc(NMEA_SERIAL_BUFF, sizeof(uint8_t));
-	int nmea_index = 0;
-	int nmea_hw = 0;
 	while (!shutdownFlag) {
 		nmea_msg_t out = {0};
-		if (nmea_readMessage_buf(nmeaInfo->handle, &out, buf, &nmea_index, &nmea_hw)) {
+		args->captured = capture_time();
+		if (nmea_readMessage_buf(nmeaInfo->handle, &out, nmeaInfo->buf, &(nmeaInfo->index),
+		                         &(nmeaInfo->hw))) {
 			char *data = NULL;
 			ssize_t len = nmea_flat_array(&out, &data);
 			bool handled = false;
@@ -81,32 +92,66 @@ void *nmea_logging(void *ptargs) {
 					time_t epoch = mktime(t) - t->tm_gmtoff;
 					if (epoch != (time_t)(-1)) {
 						// clang-format off
-						msg_t *tm = msg_new_timestamp(nmeaInfo->sourceNum, 4, epoch);
+						msg_t *tm = msg_new_timestamp(nmeaInfo->sourceNum, NMEACHAN_EPOCH, epoch);
 						// clang-format on
-						if (!queue_push(args->logQ, tm)) {
+						if (!source_push(args, tm)) {
 							log_error(
 								args->pstate,
 								"[NMEA:%s] Error pushing message to queue",
 								args->tag);
 							msg_destroy(tm);
 							free(t);
+							free(data);
+							sa_destroy(&(out.fields));
 							args->returnCode = -1;
-							pthread_exit(&(args->returnCode));
+							return NULL;
 						}
 						handled = true; // Suppress ZDA messages
 					}
 				}
 			}
+
+			for (int p = 0; p < nmeaInfo->numSentences; p++) {
+				const nmea_sentence_output *so = &(nmeaInfo->sentenceOut[p]);
+				if (strncmp(out.message, so->desc->message, 3) != 0) { continue; }
+
+				nmea_tokens tok = {0};
+				double v[NMEA_MAX_DECODE] = {0};
+				nmea_tokenise(&out, &tok);
+				if (nmea_decode_message(so->desc, &out, &tok, v) < 0) { break; }
+
+				for (int f = 0; f < so->desc->nFields; f++) {
+					// Empty and invalid fields are skipped
+					if (!isfinite(v[f])) { continue; }
+					const uint8_t ch = so->baseID + f;
+					msg_t *fm = msg_new_float(nmeaInfo->sourceNum, ch, v[f]);
+					if (!source_push(args, fm)) {
+						log_error(
+							args->pstate,
+							"[NMEA:%s] Error pushing message to queue",
+							args->tag);
+						msg_destroy(fm);
+						free(data);
+						sa_destroy(&(out.fields));
+						args->returnCode = -1;
+						return NULL;
+					}
+				}
+				break; // Each sentence can only be configured once
+			}
+
 			if (!handled) {
-				msg_t *sm = msg_new_bytes(nmeaInfo->sourceNum, 3, len,
+				msg_t *sm = msg_new_bytes(nmeaInfo->sourceNum, NMEACHAN_RAW, len,
 				                          (uint8_t *)data);
-				if (!queue_push(args->logQ, sm)) {
+				if (!source_push(args, sm)) {
 					log_error(args->pstate,
 					          "[NMEA:%s] Error pushing message to queue",
 					          args->tag);
 					msg_destroy(sm);
+					free(data);
+					sa_destroy(&(out.fields));
 					args->returnCode = -1;
-					pthread_exit(&(args->returnCode));
+					return NULL;
 				}
 			}
 			if (data) {
@@ -131,25 +176,57 @@ void *nmea_logging(void *ptargs) {
 				          "[NMEA:%s] Error signalled from nmea_readMessage_buf",
 				          args->tag);
 				args->returnCode = -2;
-				free(buf);
 				sa_destroy(&(out.fields));
-				pthread_exit(&(args->returnCode));
+				return NULL;
+			}
+			if (out.raw[0] != 0xEE) {
+				// Wait for more data
+				sa_destroy(&(out.fields));
+				return NULL;
 			}
-			// We've already exited (via pthread_exit) for error
-			// cases, so at this point sleep briefly and wait for
-			// more data
-			usleep(SERIAL_SLEEP);
 		}
 
 		// Clean up before next iteration
 		sa_destroy(&(out.fields));
 	}
-	free(buf);
+	return NULL;
+}
+
+/*!
+ * Calls nmea_readable() repeatedly until shutdown, waiting between calls
+ * for more data (see source_wait()).
+ *
+ * Exits on error or when shutdown is signalled.
+ *
+ * @param[in] ptargs Pointer to log_thread_args_t
+ * @returns NULL - Exit code in ptargs->returnCode if required
+ */
+void *nmea_logging(void *ptargs) {
+	signalHandlersBlock();
+	log_thread_args_t *args = (log_thread_args_t *)ptargs;
+
+	log_info(args->pstate, 1, "[NMEA:%s] Logging thread started", args->tag);
+
+	while (!shutdownFlag) {
+		nmea_readable(ptargs);
+		if (args->returnCode != 0) { pthread_exit(&(args->returnCode)); }
+		source_wait(args, nmea_handle(ptargs), SERIAL_SLEEP);
+	}
 	log_info(args->pstate, 1, "[NMEA:%s] Logging thread exiting", args->tag);
 	pthread_exit(NULL);
 	return NULL; // Superfluous, as returning zero via pthread_exit above
 }
 
+/*!
+ * @param[in] ptargs Pointer to log_thread_args_t
+ * @returns Handle for currently opened device
+ */
+int nmea_handle(void *ptargs) {
+	log_thread_args_t *args = (log_thread_args_t *)ptargs;
+	nmea_params *nmeaInfo = (nmea_params *)args->dParams;
+	return nmeaInfo->handle;
+}
+
 /*!
  * Calls nmea_closeConnection(), which will do any cleanup required.
  *
@@ -172,6 +249,15 @@ void *nmea_shutdown(void *ptargs) {
 		free(nmeaInfo->portName);
 		nmeaInfo->portName = NULL;
 	}
+	if (nmeaInfo->sentenceOut) {
+		free(nmeaInfo->sentenceOut);
+		nmeaInfo->sentenceOut = NULL;
+		nmeaInfo->numSentences = 0;
+	}
+	if (nmeaInfo->buf) {
+		free(nmeaInfo->buf);
+		nmeaInfo->buf = NULL;
+	}
 	return NULL;
 }
 
@@ -190,7 +276,7 @@ void *nmea_channels(void *ptargs) {
 	msg_t *m_sn = msg_new_string(nmeaInfo->sourceNum, SLCHAN_NAME,
 	                             strlen(nmeaInfo->sourceName), nmeaInfo->sourceName);
 
-	if (!queue_push(args->logQ, m_sn)) {
+	if (!source_push(args, m_sn)) {
 		log_error(args->pstate, "[NMEA:%s] Error pushing channel name to queue",
 		          args->tag);
 		msg_destroy(m_sn);
@@ -198,16 +284,35 @@ void *nmea_channels(void *ptargs) {
 		pthread_exit(&(args->returnCode));
 	}
 
-	strarray *channels = sa_new(5);
-	sa_create_entry(channels, SLCHAN_NAME, 4, "Name");
-	sa_create_entry(channels, SLCHAN_MAP, 8, "Channels");
-	sa_create_entry(channels, SLCHAN_TSTAMP, 9, "Timestamp");
-	sa_create_entry(channels, SLCHAN_RAW, 8, "Raw NMEA");
-	sa_create_entry(channels, 4, 5, "Epoch");
+	int maxID = NMEACHAN_EPOCH;
+	for (int p = 0; p < nmeaInfo->numSentences; p++) {
+		const nmea_sentence_output *so = &(nmeaInfo->sentenceOut[p]);
+		const int last = so->baseID + so->desc->nFields - 1;
+		if (last > maxID) { maxID = last; }
+	}
+
+	strarray *channels = sa_new(maxID + 1);
+	sa_create_entry(channels, NMEACHAN_NAME, 4, "Name");
+	sa_create_entry(channels, NMEACHAN_MAP, 8, "Channels");
+	sa_create_entry(channels, NMEACHAN_TSTAMP, 9, "Timestamp");
+	sa_create_entry(channels, NMEACHAN_RAW, 8, "Raw NMEA");
+	sa_create_entry(channels, NMEACHAN_EPOCH, 5, "Epoch");
+
+	for (int p = 0; p < nmeaInfo->numSentences; p++) {
+		const nmea_sentence_output *so = &(nmeaInfo->sentenceOut[p]);
+		for (int f = 0; f < so->desc->nFields; f++) {
+			// Channel names are prefixed with the sentence ID to avoid ambiguity
+			char cn[64] = {0};
+			int cl = snprintf(cn, sizeof(cn), "%s:%s", so->desc->message,
+			                  so->desc->fields[f].name);
+			if (cl >= (int)sizeof(cn)) { cl = sizeof(cn) - 1; }
+			sa_create_entry(channels, so->baseID + f, cl, cn);
+		}
+	}
 
 	msg_t *m_cmap = msg_new_string_array(nmeaInfo->sourceNum, SLCHAN_MAP, channels);
 
-	if (!queue_push(args->logQ, m_cmap)) {
+	if (!source_push(args, m_cmap)) {
 		log_error(args->pstate, "[NMEA:%s] Error pushing channel map to queue", args->tag);
 		msg_destroy(m_cmap);
 		sa_destroy(channels);
@@ -228,7 +333,9 @@ device_callbacks nmea_getCallbacks() {
 	device_callbacks cb = {.startup = &nmea_setup,
 	                       .logging = &nmea_logging,
 	                       .shutdown = &nmea_shutdown,
-	                       .channels = &nmea_channels};
+	                       .channels = &nmea_channels,
+	                       .readable = &nmea_readable,
+	                       .handle = &nmea_handle};
 	return cb;
 }
 
@@ -236,8 +343,15 @@ device_callbacks nmea_getCallbacks() {
  * @returns Default parameters for NMEA serial sources
  */
 nmea_params nmea_getParams() {
-	nmea_params gp = {
-		.portName = NULL, .sourceNum = SLSOURCE_NMEA, .baudRate = 115200, .handle = -1};
+	nmea_params gp = {.portName = NULL,
+	                  .sourceNum = SLSOURCE_NMEA,
+	                  .baudRate = 115200,
+	                  .handle = -1,
+	                  .numSentences = 0,
+	                  .sentenceOut = NULL,
+	                  .buf = NULL,
+	                  .index = 0,
+	                  .hw = 0};
 	return gp;
 }
 
@@ -313,6 +427,79 @@ bool nmea_parseConfig(log_thread_args_t *lta, config_section *s) {
 		}
 	}
 	t = NULL;
+
+	// Loop over all keys present, as sentence outputs may be specified multiple times
+	uint8_t nextID = NMEACHAN_FIRST;
+	for (int i = 0; i < s->numopts; i++) {
+		t = &(s->opts[i]);
+		if (strncasecmp(t->key, "sentence", 9) != 0) { continue; }
+
+		// Format is ID[:base channel]
+		const char *sep = strchr(t->value, ':');
+		const size_t idlen = sep ? (size_t)(sep - t->value) : strlen(t->value);
+		long base = nextID;
+		errno = 0;
+		if (sep) { base = strtol(sep + 1, NULL, 0); }
+		if (errno) {
+			log_error(lta->pstate, "[NMEA:%s] Error parsing sentence output (%s): %s",
+			          lta->tag, t->value, strerror(errno));
+			free(nmp->sentenceOut);
+			free(nmp);
+			return false;
+		}
+
+		char id[4] = {0};
+		for (size_t c = 0; c < idlen && c < 3; c++) {
+			id[c] = toupper(t->value[c]);
+		}
+		const nmea_sentence_desc *sd = (idlen == 3) ? nmea_sentence_find(id) : NULL;
+		if (!sd) {
+			log_error(lta->pstate, "[NMEA:%s] No decoder available for sentence %.*s",
+			          lta->tag, (int)idlen, t->value);
+			free(nmp->sentenceOut);
+			free(nmp);
+			return false;
+		}
+
+		const long last = base + sd->nFields - 1;
+		if (base < NMEACHAN_FIRST || last >= SLCHAN_LOG_INFO) {
+			log_error(lta->pstate,
+			          "[NMEA:%s] Invalid channel range for %s (0x%02lx - 0x%02lx)",
+			          lta->tag, sd->message, base, last);
+			free(nmp->sentenceOut);
+			free(nmp);
+			return false;
+		}
+
+		for (int p = 0; p < nmp->numSentences; p++) {
+			const nmea_sentence_output *so = &(nmp->sentenceOut[p]);
+			const int pl = so->baseID + so->desc->nFields - 1;
+			if (so->desc == sd || (base <= pl && last >= so->baseID)) {
+				log_error(lta->pstate, "[NMEA:%s] %s output conflicts with %s",
+				          lta->tag, sd->message, so->desc->message);
+				free(nmp->sentenceOut);
+				free(nmp);
+				return false;
+			}
+		}
+
+		const size_t ns = (nmp->numSentences + 1) * sizeof(nmea_sentence_output);
+		nmea_sentence_output *so = realloc(nmp->sentenceOut, ns);
+		if (!so) {
+			log_error(lta->pstate, "[NMEA:%s] Unable to allocate sentence outputs",
+			          lta->tag);
+			free(nmp->sentenceOut);
+			free(nmp);
+			return false;
+		}
+		nmp->sentenceOut = so;
+		nmp->sentenceOut[nmp->numSentences].desc = sd;
+		nmp->sentenceOut[nmp->numSentences].baseID = base;
+		nmp->numSentences++;
+		if (last + 1 > nextID) { nextID = last + 1; }
+	}
+	t = NULL;
+
 	lta->dParams = nmp;
 	return true;
 }
@@ -40,17 +40,37 @@
  *
  * Reading messages from the device and parsing to the internal message pack
  * format used by the logger is handled in SELKIELoggerNMEA.h
+ *
+ * Selected sentences can also be decoded into individual floating point
+ * channels (see NMEAFields.h), in addition to the raw message data.
  * @{
  */
 
+#define NMEACHAN_NAME   SLCHAN_NAME   //!< Source name
+#define NMEACHAN_MAP    SLCHAN_MAP    //!< Channel map
+#define NMEACHAN_TSTAMP SLCHAN_TSTAMP //!< Timestamps
+#define NMEACHAN_RAW    SLCHAN_RAW    //!< Raw data (recorded unmodified)
+#define NMEACHAN_EPOCH  4             //!< Epoch timestamp (from IIZDA messages)
+#define NMEACHAN_FIRST  5             //!< First channel available for decoded sentence fields
+
+//! Decoded sentence output configuration
+typedef struct {
+	const nmea_sentence_desc *desc; //!< Field descriptions for this sentence
+	uint8_t baseID;                 //!< Channel number for first field
+} nmea_sentence_output;
+
 //! NMEA Device specific parameters
 typedef struct {
-	char *portName;    //!< Target port name
-	char *sourceName;  //!< User defined name for this source
-	uint8_t sourceNum; //!< Source ID for messages
-	int baudRate;      //!< Baud rate for operations
-	int handle;        //!< Handle for currently opened device
-	                   // Future expansion: Talker/Message -> Source/Message map?
+	char *portName;                    //!< Target port name
+	char *sourceName;                  //!< User defined name for this source
+	uint8_t sourceNum;                 //!< Source ID for messages
+	int baudRate;                      //!< Baud rate for operations
+	int handle;                        //!< Handle for currently opened device
+	int numSentences;                  //!< Number of entries in sentenceOut
+	nmea_sentence_output *sentenceOut; //!< Sentences to be decoded into individual channels
+	uint8_t *buf;                      //!< Receive buffer (allocated by nmea_setup())
+	int index;                         //!< Current search position within buf
+	int hw;                            //!< End of valid data in buf
 } nmea_params;
 
 //! NMEA Setup
@@ -59,6 +79,12 @@ void *nmea_setup(void *ptargs);
 //! NMEA logging (with pthread function signature)
 void *nmea_logging(void *ptargs);
 
+//! Read and queue all currently available messages
+void *nmea_readable(void *ptargs);
+
+//! Return current NMEA device handle
+int nmea_handle(void *ptargs);
+
 //! NMEA Shutdown
 void *nmea_shutdown(void *ptargs);
 
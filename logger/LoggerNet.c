@@ -40,7 +40,7 @@
  */
 void *net_setup(void *ptargs) {
 	log_thread_args_t *args = (log_thread_args_t *)ptargs;
-	// net_params *netInfo = (net_params *) args->dParams;
+	net_params *netInfo = (net_params *)args->dParams;
 
 	if (!net_connect(ptargs)) {
 		log_error(args->pstate, "[Network:%s] Unable to open a connection", args->tag);
@@ -48,96 +48,317 @@ void *net_setup(void *ptargs) {
 		return NULL;
 	}
 
+	if (netInfo->buf) { free(netInfo->buf); }
+	const int bufSize = netInfo->framed ? MP_SERIAL_BUFF : netInfo->maxBytes;
+	netInfo->buf = calloc(bufSize, sizeof(uint8_t));
+	netInfo->hw = 0;
+	netInfo->index = 0;
+	netInfo->lastRead = time(NULL);
+	if (!netInfo->buf) {
+		log_error(args->pstate, "[Network:%s] Unable to allocate buffer", args->tag);
+		args->returnCode = -1;
+		return NULL;
+	}
+
 	log_info(args->pstate, 2, "[Network:%s] Connected", args->tag);
 	args->returnCode = 0;
 	return NULL;
 }
 
 /*!
- * Reads messages from the connection established by net_setup(), and pushes them to the
- * queue. Data is not interpreted, just pushed into the queue with suitable headers.
+ * Reads all data currently available from the connection established by
+ * net_setup(), and pushes it to the queue. Data is not interpreted, just
+ * pushed into the queue with suitable headers.
  *
  * Message size is variable, based on min/max limits and the amount of data
- * available to read from the source.
+ * available to read from the source. Data is retained between calls until at
+ * least the minimum number of bytes is available.
+ *
+ * If no data has been received within the configured timeout, the connection
+ * is closed and reopened. This relies on this function being called
+ * periodically, even when no data is available.
+ *
+ * Does not block, so can be called repeatedly by net_logging() or by the
+ * reactor threads.
  *
  * @param[in] ptargs Pointer to log_thread_args_t
  * @returns NULL - Exit code in ptargs->returnCode if required
  */
-void *net_logging(void *ptargs) {
-	signalHandlersBlock();
+void *net_readable(void *ptargs) {
 	log_thread_args_t *args = (log_thread_args_t *)ptargs;
 	net_params *netInfo = (net_params *)args->dParams;
 
-	log_info(args->pstate, 1, "[Network:%s] Logging thread started", args->tag);
+	if (netInfo->framed) { return net_readable_frames(ptargs); }
 
-	uint8_t *buf = calloc(netInfo->maxBytes, sizeof(uint8_t));
-	int net_hw = 0;
-	time_t lastRead = time(NULL);
 	while (!shutdownFlag) {
 		time_t now = time(NULL);
-		if ((lastRead + netInfo->timeout) < now) {
-			log_warning(args->pstate, "[Network:%s] Network timeout, reconnecting",
-			            args->tag);
-			close(netInfo->handle);
-			netInfo->handle = -1;
+		if (!net_check_timeout(args, now)) { return NULL; }
+
+		int ti = 0;
+		if (netInfo->hw < netInfo->maxBytes) {
 			errno = 0;
-			if (net_connect(args)) {
-				log_info(args->pstate, 1, "[Network:%s] Reconnected", args->tag);
-			} else {
-				log_error(args->pstate, "[Network:%s] Unable to reconnect: %s",
+			ti = read(netInfo->handle, &(netInfo->buf[netInfo->hw]),
+			          netInfo->maxBytes - netInfo->hw);
+			if (ti > 0) {
+				netInfo->hw += ti;
+				args->captured = capture_time();
+				// 0 may not be an error, but could be a dropped
+				// connection if it persists
+				netInfo->lastRead = now;
+			} else if (ti < 0 && errno != EAGAIN) {
+				log_error(args->pstate,
+				          "[Network:%s] Unexpected error while reading from network (%s)",
 				          args->tag, strerror(errno));
-				args->returnCode = -2;
-				pthread_exit(&(args->returnCode));
+				args->returnCode = -1;
 				return NULL;
 			}
 		}
 
+		if (netInfo->hw < netInfo->minBytes) {
+			// Wait until we have more than the minimum number of bytes available
+			return NULL;
+		}
+
+		if (!source_push_buffer(args, netInfo->sourceNum, &(netInfo->buf), netInfo->hw,
+		                        netInfo->maxBytes)) {
+			log_error(args->pstate, "[Network:%s] Error pushing message to queue",
+			          args->tag);
+			args->returnCode = -1;
+			return NULL;
+		}
+		netInfo->hw = 0;
+
+		// No more data available for now
+		if (ti <= 0) { return NULL; }
+	}
+	return NULL;
+}
+
+/*!
+ * Used in framed mode, where the data received is expected to be a stream of
+ * messages in this software's own format (e.g. a data file or stream
+ * forwarded from another logger).
+ *
+ * All data currently available is read into the receive buffer with a single
+ * read, then every complete message in the buffer is decoded using
+ * mp_decodeMessage_buf() and passed to net_frame_message(). The messages
+ * generated from each read are queued together. Partial messages are retained
+ * until the remaining data is received.
+ *
+ * Connection timeouts are handled as for net_readable(), and any partial
+ * message is discarded on reconnection.
+ *
+ * @param[in] ptargs Pointer to log_thread_args_t
+ * @returns NULL - Exit code in ptargs->returnCode if required
+ */
+void *net_readable_frames(void *ptargs) {
+	log_thread_args_t *args = (log_thread_args_t *)ptargs;
+	net_params *netInfo = (net_params *)args->dParams;
+
+	while (!shutdownFlag) {
+		time_t now = time(NULL);
+		if (!net_check_timeout(args, now)) { return NULL; }
+
+		if (netInfo->index > 0) {
+			// Move remaining data back to zero position
+			memmove(netInfo->buf, &(netInfo->buf[netInfo->index]),
+			        netInfo->hw - netInfo->index);
+			netInfo->hw -= netInfo->index;
+			netInfo->index = 0;
+		}
+
 		int ti = 0;
-		if (net_hw < netInfo->maxBytes - 1) {
+		if (netInfo->hw < MP_SERIAL_BUFF) {
 			errno = 0;
-			ti = read(netInfo->handle, &(buf[net_hw]), netInfo->maxBytes - net_hw);
-			if (ti >= 0) {
-				net_hw += ti;
-				if (ti > 0) {
-					// 0 may not be an error, but could be a dropped
-					// connection if it persists
-					lastRead = now;
-				}
-			} else {
-				if (errno != EAGAIN) {
-					log_error(
-						args->pstate,
-						"[Network:%s] Unexpected error while reading from network (%s)",
-						args->tag, strerror(errno));
-					args->returnCode = -1;
-					pthread_exit(&(args->returnCode));
+			ti = read(netInfo->handle, &(netInfo->buf[netInfo->hw]),
+			          MP_SERIAL_BUFF - netInfo->hw);
+			if (ti > 0) {
+				netInfo->hw += ti;
+				args->captured = capture_time();
+				netInfo->lastRead = now;
+			} else if (ti < 0 && errno != EAGAIN) {
+				log_error(args->pstate,
+				          "[Network:%s] Unexpected error while reading from network (%s)",
+				          args->tag, strerror(errno));
+				args->returnCode = -1;
+				return NULL;
+			}
+		}
+
+		source_batch batch = {0};
+		while (true) {
+			// Needs to be on the heap as we'll be queuing it
+			msg_t *out = calloc(1, sizeof(msg_t));
+			if (!out) {
+				log_error(args->pstate, "[Network:%s] Unable to allocate message",
+				          args->tag);
+				source_batch_discard(&batch);
+				args->returnCode = -1;
+				return NULL;
+			}
+			const int hw = netInfo->hw;
+			if (!mp_decodeMessage_buf(out, netInfo->buf, &(netInfo->index), hw)) {
+				const bool skipped = (out->data.value == 0xEE);
+				msg_destroy(out);
+				free(out);
+				if (skipped) {
+					netInfo->invalid++;
+					continue;
 				}
+				// No complete messages left
+				break;
+			}
+			netInfo->frames++;
+			if (!net_frame_message(args, &batch, out)) {
+				source_batch_discard(&batch);
+				args->returnCode = -1;
+				return NULL;
 			}
 		}
 
-		if (net_hw < netInfo->minBytes) {
-			// Sleep briefly, then loop until we have more than the minimum
-			// number of bytes available
-			usleep(5E4);
-			continue;
+		if (netInfo->index == 0 && netInfo->hw == MP_SERIAL_BUFF) {
+			// Buffer full, but no message found - skip ahead and resynchronise
+			netInfo->index = 1;
+			netInfo->invalid++;
 		}
 
-		msg_t *sm = msg_new_bytes(netInfo->sourceNum, 3, net_hw, buf);
-		if (!queue_push(args->logQ, sm)) {
-			log_error(args->pstate, "[Network:%s] Error pushing message to queue",
+		if (!source_batch_push(args, &batch)) {
+			log_error(args->pstate, "[Network:%s] Error pushing messages to queue",
 			          args->tag);
-			msg_destroy(sm);
 			args->returnCode = -1;
-			pthread_exit(&(args->returnCode));
+			return NULL;
 		}
-		net_hw = 0;
-		memset(buf, 0, netInfo->maxBytes);
+
+		// No more data available for now
+		if (ti <= 0) { return NULL; }
+	}
+	return NULL;
+}
+
+/*!
+ * Messages from each remote source are recorded using the local source ID
+ * configured in net_params.remap, and are discarded if this is zero.
+ *
+ * Source names and channel maps are cached (using the local source ID) before
+ * the message is added to the batch, so that they can be repeated by
+ * net_channels() when new data files are started.
+ *
+ * Sets args->returnCode in the event of an error
+ *
+ * @param[in] args Pointer to log_thread_args_t
+ * @param[in,out] batch Messages to be queued
+ * @param[in] msg Decoded message. Added to batch, or destroyed.
+ * @returns True on success, false on error
+ */
+bool net_frame_message(log_thread_args_t *args, source_batch *batch, msg_t *msg) {
+	net_params *netInfo = (net_params *)args->dParams;
+
+	const uint8_t ls = netInfo->remap[msg->source];
+	if (ls == 0) {
+		netInfo->discarded++;
+		msg_destroy(msg);
+		free(msg);
+		return true;
+	}
+	msg->source = ls;
+
+	if (msg->type == SLCHAN_NAME && msg->dtype == MSG_STRING) {
+		pthread_mutex_lock(&(netInfo->cacheLock));
+		free(netInfo->cname[ls]);
+		netInfo->cname[ls] = strndup(msg->data.string.data, msg->data.string.length);
+		pthread_mutex_unlock(&(netInfo->cacheLock));
+	} else if (msg->type == SLCHAN_MAP && msg->dtype == MSG_STRARRAY) {
+		pthread_mutex_lock(&(netInfo->cacheLock));
+		const bool cached = sa_copy(&(netInfo->cmap[ls]), &(msg->data.names));
+		pthread_mutex_unlock(&(netInfo->cacheLock));
+		if (!cached) {
+			log_error(args->pstate, "[Network:%s] Error caching channel map",
+			          args->tag);
+			msg_destroy(msg);
+			free(msg);
+			args->returnCode = -1;
+			return false;
+		}
+	}
+
+	if (!source_batch_add(args, batch, msg)) {
+		log_error(args->pstate, "[Network:%s] Error adding message to queue batch",
+		          args->tag);
+		msg_destroy(msg);
+		free(msg);
+		args->returnCode = -1;
+		return false;
+	}
+	return true;
+}
+
+/*!
+ * If no data has been received within the configured timeout, the connection
+ * is closed and reopened. This relies on being called periodically, even
+ * when no data is available.
+ *
+ * Sets args->returnCode if unable to reconnect.
+ *
+ * @param[in] args Pointer to log_thread_args_t
+ * @param[in] now Current time
+ * @returns False if unable to reconnect, true otherwise
+ */
+bool net_check_timeout(log_thread_args_t *args, const time_t now) {
+	net_params *netInfo = (net_params *)args->dParams;
+	if ((netInfo->lastRead + netInfo->timeout) >= now) { return true; }
+
+	log_warning(args->pstate, "[Network:%s] Network timeout, reconnecting", args->tag);
+	close(netInfo->handle);
+	netInfo->handle = -1;
+	errno = 0;
+	if (!net_connect(args)) {
+		log_error(args->pstate, "[Network:%s] Unable to reconnect: %s", args->tag,
+		          strerror(errno));
+		args->returnCode = -2;
+		return false;
+	}
+	log_info(args->pstate, 1, "[Network:%s] Reconnected", args->tag);
+	netInfo->lastRead = now;
+	// Any partial message will not be completed on the new connection
+	netInfo->hw = 0;
+	netInfo->index = 0;
+	return true;
+}
+
+/*!
+ * Calls net_readable() repeatedly until shutdown, waiting between calls for
+ * the device to send more data (see source_wait()).
+ *
+ * Terminates thread in case of error.
+ *
+ * @param[in] ptargs Pointer to log_thread_args_t
+ * @returns NULL - Exit code in ptargs->returnCode if required
+ */
+void *net_logging(void *ptargs) {
+	signalHandlersBlock();
+	log_thread_args_t *args = (log_thread_args_t *)ptargs;
+
+	log_info(args->pstate, 1, "[Network:%s] Logging thread started", args->tag);
+
+	while (!shutdownFlag) {
+		net_readable(ptargs);
+		if (args->returnCode != 0) { pthread_exit(&(args->returnCode)); }
+		source_wait(args, net_handle(ptargs), 5E4);
 	}
-	free(buf);
 	pthread_exit(NULL);
 	return NULL; // Superfluous, as returning zero via pthread_exit above
 }
 
+/*!
+ * @param[in] ptargs Pointer to log_thread_args_t
+ * @returns Handle for currently opened connection
+ */
+int net_handle(void *ptargs) {
+	log_thread_args_t *args = (log_thread_args_t *)ptargs;
+	net_params *netInfo = (net_params *)args->dParams;
+	return netInfo->handle;
+}
+
 /*!
  * Simple wrapper around net_closeConnection(), which will do any cleanup required.
  *
@@ -148,11 +369,26 @@ void *net_shutdown(void *ptargs) {
 	log_thread_args_t *args = (log_thread_args_t *)ptargs;
 	net_params *netInfo = (net_params *)args->dParams;
 
+	if (netInfo->framed) {
+		log_info(args->pstate, 1,
+		         "[Network:%s] %u messages decoded (%u discarded), %u invalid messages",
+		         args->tag, netInfo->frames, netInfo->discarded, netInfo->invalid);
+	}
 	if (netInfo->handle >= 0) { // Admittedly 0 is unlikely
 		shutdown(netInfo->handle, SHUT_RDWR);
 		close(netInfo->handle);
 	}
 	netInfo->handle = -1;
+	if (netInfo->framed) {
+		pthread_mutex_lock(&(netInfo->cacheLock));
+		for (int i = 0; i < 128; i++) {
+			free(netInfo->cname[i]);
+			netInfo->cname[i] = NULL;
+			sa_destroy(&(netInfo->cmap[i]));
+		}
+		pthread_mutex_unlock(&(netInfo->cacheLock));
+		pthread_mutex_destroy(&(netInfo->cacheLock));
+	}
 	if (netInfo->addr) {
 		free(netInfo->addr);
 		netInfo->addr = NULL;
@@ -161,6 +397,10 @@ void *net_shutdown(void *ptargs) {
 		free(netInfo->sourceName);
 		netInfo->sourceName = NULL;
 	}
+	if (netInfo->buf) {
+		free(netInfo->buf);
+		netInfo->buf = NULL;
+	}
 	return NULL;
 }
 
@@ -237,7 +477,9 @@ device_callbacks net_getCallbacks() {
 	device_callbacks cb = {.startup = &net_setup,
 	                       .logging = &net_logging,
 	                       .shutdown = &net_shutdown,
-	                       .channels = &net_channels};
+	                       .channels = &net_channels,
+	                       .readable = &net_readable,
+	                       .handle = &net_handle};
 	return cb;
 }
 
@@ -250,7 +492,17 @@ net_params net_getParams() {
 	                 .handle = -1,
 	                 .minBytes = 10,
 	                 .maxBytes = 1024,
-	                 .timeout = 60};
+	                 .timeout = 60,
+	                 .buf = NULL,
+	                 .hw = 0,
+	                 .lastRead = 0,
+	                 .framed = false,
+	                 .index = 0};
+	// Remote sources 0x00-0x03 (local, conversion, timer, capture) would
+	// collide with our own, so are discarded unless explicitly remapped
+	for (int i = 4; i < 128; i++) {
+		mp.remap[i] = i;
+	}
 	return mp;
 }
 
@@ -264,10 +516,15 @@ void *net_channels(void *ptargs) {
 	log_thread_args_t *args = (log_thread_args_t *)ptargs;
 	net_params *netInfo = (net_params *)args->dParams;
 
+	if (netInfo->framed) {
+		net_channels_cached(args);
+		return NULL;
+	}
+
 	msg_t *m_sn = msg_new_string(netInfo->sourceNum, SLCHAN_NAME, strlen(netInfo->sourceName),
 	                             netInfo->sourceName);
 
-	if (!queue_push(args->logQ, m_sn)) {
+	if (!source_push(args, m_sn)) {
 		log_error(args->pstate, "[Network:%s] Error pushing channel name to queue",
 		          args->tag);
 		msg_destroy(m_sn);
@@ -283,7 +540,7 @@ void *net_channels(void *ptargs) {
 
 	msg_t *m_cmap = msg_new_string_array(netInfo->sourceNum, SLCHAN_MAP, channels);
 
-	if (!queue_push(args->logQ, m_cmap)) {
+	if (!source_push(args, m_cmap)) {
 		log_error(args->pstate, "[Network:%s] Error pushing channel map to queue",
 		          args->tag);
 		msg_destroy(m_cmap);
@@ -298,6 +555,50 @@ void *net_channels(void *ptargs) {
 	return NULL;
 }
 
+/*!
+ * In framed mode, the source names and channel maps are provided by the remote
+ * end of the connection. Repeat the most recent names and maps received for
+ * each (local) source ID so that they appear in each new data file.
+ *
+ * Sources that have not yet sent a name or channel map will not be included.
+ *
+ * @param[in] args Pointer to log_thread_args_t
+ */
+void net_channels_cached(log_thread_args_t *args) {
+	net_params *netInfo = (net_params *)args->dParams;
+
+	pthread_mutex_lock(&(netInfo->cacheLock));
+	for (int i = 0; i < 128; i++) {
+		if (netInfo->cname[i]) {
+			msg_t *m_sn = msg_new_string(i, SLCHAN_NAME, strlen(netInfo->cname[i]),
+			                             netInfo->cname[i]);
+			if (!source_push(args, m_sn)) {
+				log_error(args->pstate,
+				          "[Network:%s] Error pushing channel name to queue",
+				          args->tag);
+				msg_destroy(m_sn);
+				pthread_mutex_unlock(&(netInfo->cacheLock));
+				args->returnCode = -1;
+				pthread_exit(&(args->returnCode));
+			}
+		}
+
+		if (netInfo->cmap[i].entries > 0) {
+			msg_t *m_cmap = msg_new_string_array(i, SLCHAN_MAP, &(netInfo->cmap[i]));
+			if (!source_push(args, m_cmap)) {
+				log_error(args->pstate,
+				          "[Network:%s] Error pushing channel map to queue",
+				          args->tag);
+				msg_destroy(m_cmap);
+				pthread_mutex_unlock(&(netInfo->cacheLock));
+				args->returnCode = -1;
+				pthread_exit(&(args->returnCode));
+			}
+		}
+	}
+	pthread_mutex_unlock(&(netInfo->cacheLock));
+}
+
 /*!
  * @param[in] lta Pointer to log_thread_args_t
  * @param[in] s Pointer to config_section to be parsed
@@ -442,6 +743,63 @@ bool net_parseConfig(log_thread_args_t *lta, config_section *s) {
 		}
 	}
 	t = NULL;
+
+	if ((t = config_get_key(s, "framing"))) {
+		if (strcasecmp(t->value, "raw") == 0) {
+			net->framed = false;
+		} else if (strcasecmp(t->value, "mp") == 0) {
+			net->framed = true;
+		} else {
+			log_error(lta->pstate, "[Network:%s] Invalid framing mode (%s)", lta->tag,
+			          t->value);
+			free(net);
+			return false;
+		}
+	}
+	t = NULL;
+
+	for (int i = 0; i < s->numopts; i++) {
+		t = &(s->opts[i]);
+		if (strcasecmp(t->key, "remap") != 0) { continue; }
+
+		char *sep = NULL;
+		errno = 0;
+		const long rs = strtol(t->value, &sep, 0);
+		if (errno || sep == t->value || *sep != ':') {
+			log_error(lta->pstate, "[Network:%s] Invalid source mapping (%s)",
+			          lta->tag, t->value);
+			free(net);
+			return false;
+		}
+
+		char *end = NULL;
+		const long ls = strtol(sep + 1, &end, 0);
+		if (errno || end == (sep + 1) || *end != '\0') {
+			log_error(lta->pstate, "[Network:%s] Invalid source mapping (%s)",
+			          lta->tag, t->value);
+			free(net);
+			return false;
+		}
+
+		if (rs < 0 || rs > 127 || ls < 0 || ls > 127 || (ls > 0 && ls < 4)) {
+			log_error(lta->pstate, "[Network:%s] Source mapping out of range (%s)",
+			          lta->tag, t->value);
+			free(net);
+			return false;
+		}
+		net->remap[rs] = ls;
+	}
+	t = NULL;
+
+	if (net->framed) {
+		if (pthread_mutex_init(&(net->cacheLock), NULL)) {
+			log_error(lta->pstate, "[Network:%s] Unable to initialise cache lock",
+			          lta->tag);
+			free(net);
+			return false;
+		}
+	}
+
 	lta->dParams = net;
 	return true;
 }
@@ -22,11 +22,14 @@
 #define SL_LOGGER_NET_H
 
 #include <errno.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "SELKIELoggerBase.h"
+#include "SELKIELoggerMP.h"
 
 //! @file
 
@@ -37,18 +40,34 @@
  * Adds support for reading arbitrary data from network devices that output
  * messages not otherwise covered or interpreted by this software.
  *
+ * Alternatively, messages in this software's own format (e.g. forwarded from
+ * another logger) can be decoded and recorded individually, keeping their
+ * original source and channel IDs unless remapped.
+ *
  * @{
  */
 //! Network device specific parameters
 typedef struct {
-	char *sourceName;  //!< User defined name for this source
-	uint8_t sourceNum; //!< Source ID for messages
-	char *addr;        //!< Target name
-	int port;          //!< Target port number
-	int handle;        //!< Handle for currently opened device
-	int minBytes;      //!< Minimum number of bytes to group into a message
-	int maxBytes;      //!< Maximum number of bytes to group into a message
-	int timeout;       //!< Reconnect if no data received after this interval [s]
+	char *sourceName;          //!< User defined name for this source
+	uint8_t sourceNum;         //!< Source ID for messages
+	char *addr;                //!< Target name
+	int port;                  //!< Target port number
+	int handle;                //!< Handle for currently opened device
+	int minBytes;              //!< Minimum number of bytes to group into a message
+	int maxBytes;              //!< Maximum number of bytes to group into a message
+	int timeout;               //!< Reconnect if no data received after this interval [s]
+	uint8_t *buf;              //!< Receive buffer (allocated by net_setup())
+	int hw;                    //!< Number of bytes currently held in buf
+	time_t lastRead;           //!< Time of last successful read
+	bool framed;               //!< Decode messages from data, rather than recording raw data
+	int index;                 //!< Current search position within buf (framed mode)
+	uint8_t remap[128];        //!< Local source ID for each remote source, or 0 to discard
+	char *cname[128];          //!< Cached name for each (local) source ID
+	strarray cmap[128];        //!< Cached channel map for each (local) source ID
+	pthread_mutex_t cacheLock; //!< Protects cname and cmap, also used by net_channels()
+	uint32_t frames;           //!< Messages decoded (framed mode)
+	uint32_t discarded;        //!< Messages discarded (framed mode)
+	uint32_t invalid;          //!< Invalid messages skipped (framed mode)
 } net_params;
 
 //! Device thread setup
@@ -57,12 +76,30 @@ void *net_setup(void *ptargs);
 //! Network  source main logging loop
 void *net_logging(void *ptargs);
 
+//! Read and queue all currently available data
+void *net_readable(void *ptargs);
+
+//! Read all currently available data, then decode and queue messages from it
+void *net_readable_frames(void *ptargs);
+
+//! Cache source information and add a decoded message to a batch
+bool net_frame_message(log_thread_args_t *args, source_batch *batch, msg_t *msg);
+
+//! Reconnect if no data has been received recently
+bool net_check_timeout(log_thread_args_t *args, const time_t now);
+
+//! Return current network handle
+int net_handle(void *ptargs);
+
 //! Network source shutdown
 void *net_shutdown(void *ptargs);
 
 //! Channel map
 void *net_channels(void *ptargs);
 
+//! Push cached source names and channel maps (framed mode)
+void net_channels_cached(log_thread_args_t *args);
+
 //! Network connection helper function
 bool net_connect(void *ptargs);
 
@@ -0,0 +1,302 @@
+/*
+ *  Copyright (C) 2023 Swansea University
+ *
+ *  This file is part of the SELKIELogger suite of tools.
+ *
+ *  SELKIELogger is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation, either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  SELKIELogger is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this SELKIELogger product.
+ *  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <errno.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <time.h>
+
+#include "Logger.h"
+
+#include "LoggerReactor.h"
+#include "LoggerSignals.h"
+
+/*!
+ * @param[in] lta Pointer to log_thread_args_t
+ * @returns True if source provides the callbacks required by the reactor
+ */
+bool reactor_supported(const log_thread_args_t *lta) {
+	return (lta && lta->funcs.readable && lta->funcs.handle);
+}
+
+/*!
+ * @param[out] r Reactor state to initialise
+ * @param[in] pstate Program state, used for logging
+ * @param[in] maxSources Maximum number of sources that will be registered
+ * @returns True on success, false on error
+ */
+bool reactor_init(reactor_state *r, program_state *pstate, const int maxSources) {
+	if (!r || maxSources <= 0) { return false; }
+	(*r) = (reactor_state){.epfd = -1, .pstate = pstate};
+
+	errno = 0;
+	r->epfd = epoll_create1(EPOLL_CLOEXEC);
+	if (r->epfd < 0) {
+		log_error(pstate, "[Reactor] Unable to create epoll instance: %s", strerror(errno));
+		return false;
+	}
+
+	r->sources = calloc(maxSources, sizeof(reactor_source));
+	if (!r->sources) {
+		log_error(pstate, "[Reactor] Unable to allocate source information");
+		close(r->epfd);
+		r->epfd = -1;
+		return false;
+	}
+	r->maxSources = maxSources;
+	return true;
+}
+
+/*!
+ * Add or re-arm a source's handle in the epoll instance.
+ *
+ * Handles are always modified before being added, as a closed and reopened
+ * handle may reuse the same number but will no longer be registered. Closed
+ * handles are removed from the epoll instance automatically, so previous
+ * handles are not explicitly removed here (their numbers may already have been
+ * reused by another source).
+ *
+ * Must be called with the source lock held.
+ *
+ * @param[in] r Reactor state
+ * @param[in] rs Source to update
+ * @returns True on success, or if source currently has no valid handle
+ */
+static bool reactor_arm(reactor_state *r, reactor_source *rs) {
+	const int h = rs->args->funcs.handle(rs->args);
+	rs->handle = h;
+	if (h < 0) {
+		// No handle available - rely on idle calls until the source reconnects
+		return true;
+	}
+
+	struct epoll_event ev = {.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT, .data.ptr = rs};
+	if (epoll_ctl(r->epfd, EPOLL_CTL_MOD, h, &ev) == 0) { return true; }
+	if (errno == ENOENT && epoll_ctl(r->epfd, EPOLL_CTL_ADD, h, &ev) == 0) { return true; }
+	log_error(r->pstate, "[Reactor] Unable to register handle for %s: %s", rs->args->tag,
+	          strerror(errno));
+	rs->handle = -1;
+	return false;
+}
+
+/*!
+ * Source handles are not registered with the epoll instance until the
+ * reactor threads are started by reactor_start() and the source has finished
+ * starting, so sources may be registered before their startup functions have
+ * been called.
+ *
+ * @param[in] r Reactor state
+ * @param[in] lta Source to register
+ * @returns True on success, false on error
+ */
+bool reactor_register(reactor_state *r, log_thread_args_t *lta) {
+	if (!r || !reactor_supported(lta)) { return false; }
+	if (r->numSources >= r->maxSources) {
+		log_error(r->pstate, "[Reactor] Too many sources registered");
+		return false;
+	}
+
+	reactor_source *rs = &(r->sources[r->numSources]);
+	rs->args = lta;
+	rs->handle = -1;
+	rs->failed = false;
+	if (pthread_mutex_init(&(rs->lock), NULL) != 0) {
+		log_error(r->pstate, "[Reactor] Unable to initialise lock for %s", lta->tag);
+		return false;
+	}
+	lta->reactor = true;
+	r->numSources++;
+	log_info(r->pstate, 2, "[Reactor] Registered %s", lta->tag);
+	return true;
+}
+
+/*!
+ * Call source's readable function and re-arm handle if the source hasn't
+ * signalled an error.
+ *
+ * Handles that have reported a hangup or error (including a network peer
+ * closing the connection) remain permanently readable, so
+ * these are left disarmed until the next idle call to avoid spinning while the
+ * source detects the problem or reconnects.
+ *
+ * Must be called with the source lock held.
+ *
+ * @param[in] r Reactor state
+ * @param[in] rs Source to service
+ * @param[in] rearm Re-arm handle after servicing source
+ */
+static void reactor_service(reactor_state *r, reactor_source *rs, const bool rearm) {
+	if (rs->failed || rs->args->status != SOURCE_READY) { return; }
+
+	rs->args->funcs.readable(rs->args);
+	if (rs->args->returnCode != 0) {
+		log_error(r->pstate, "[Reactor] %s has signalled an error: %d", rs->args->tag,
+		          rs->args->returnCode);
+		const int h = rs->args->funcs.handle(rs->args);
+		if (h >= 0) { epoll_ctl(r->epfd, EPOLL_CTL_DEL, h, NULL); }
+		rs->handle = -1;
+		rs->failed = true;
+		return;
+	}
+
+	if (!rearm) { return; }
+	if (!reactor_arm(r, rs)) {
+		rs->args->returnCode = -1;
+		rs->failed = true;
+	}
+}
+
+/*!
+ * Each thread waits for events on the shared epoll instance and services
+ * sources as their handles become readable.
+ *
+ * The first thread (index 0) also services every source at startup and then
+ * every REACTOR_IDLE_INTERVAL seconds. Sources that are already being serviced
+ * by another thread are skipped. Sources that finish starting after the reactor
+ * threads have been started are armed during these idle calls.
+ *
+ * @param[in] ptargs Pointer to reactor_thread_args
+ * @returns NULL - Exit code in reactor_state->returnCode if required
+ */
+void *reactor_thread(void *ptargs) {
+	signalHandlersBlock();
+	reactor_thread_args *ta = (reactor_thread_args *)ptargs;
+	reactor_state *r = ta->r;
+
+	log_info(r->pstate, 1, "[Reactor] Thread %d started", ta->index);
+
+	struct timespec lastIdle = {0};
+	while (!shutdownFlag) {
+		if (ta->index == 0) {
+			struct timespec now = {0};
+			clock_gettime(CLOCK_MONOTONIC, &now);
+			if (lastIdle.tv_sec == 0 || (now.tv_sec - lastIdle.tv_sec) >= REACTOR_IDLE_INTERVAL) {
+				for (int s = 0; s < r->numSources; s++) {
+					reactor_source *rs = &(r->sources[s]);
+					if (pthread_mutex_trylock(&(rs->lock)) != 0) { continue; }
+					reactor_service(r, rs, true);
+					pthread_mutex_unlock(&(rs->lock));
+				}
+				lastIdle = now;
+			}
+		}
+
+		struct epoll_event ev[REACTOR_MAX_EVENTS];
+		errno = 0;
+		int n = epoll_wait(r->epfd, ev, REACTOR_MAX_EVENTS, REACTOR_WAIT_MS);
+		if (n < 0) {
+			if (errno == EINTR) { continue; }
+			log_error(r->pstate, "[Reactor] Error waiting for events: %s", strerror(errno));
+			r->returnCode = -1;
+			pthread_exit(&(r->returnCode));
+		}
+
+		for (int e = 0; e < n; e++) {
+			reactor_source *rs = (reactor_source *)ev[e].data.ptr;
+			const bool hup = (ev[e].events & (EPOLLHUP | EPOLLRDHUP | EPOLLERR));
+			pthread_mutex_lock(&(rs->lock));
+			reactor_service(r, rs, !hup);
+			pthread_mutex_unlock(&(rs->lock));
+		}
+	}
+	log_info(r->pstate, 1, "[Reactor] Thread %d exiting", ta->index);
+	pthread_exit(NULL);
+	return NULL; // Superfluous, as returning zero via pthread_exit above
+}
+
+/*!
+ * Registers handles for all sources that have already started with the epoll
+ * instance, then starts the requested number of threads.
+ *
+ * If a thread cannot be started, no further threads are started but those
+ * already running are left for reactor_stop() to clean up.
+ *
+ * @param[in] r Reactor state
+ * @param[in] numThreads Number of threads to start
+ * @returns True if all threads started successfully
+ */
+bool reactor_start(reactor_state *r, const int numThreads) {
+	if (!r || numThreads <= 0) { return false; }
+
+	for (int s = 0; s < r->numSources; s++) {
+		if (r->sources[s].args->status != SOURCE_READY) { continue; }
+		if (!reactor_arm(r, &(r->sources[s]))) { return false; }
+	}
+
+	r->threads = calloc(numThreads, sizeof(pthread_t));
+	r->targs = calloc(numThreads, sizeof(reactor_thread_args));
+	if (!r->threads || !r->targs) {
+		log_error(r->pstate, "[Reactor] Unable to allocate thread information");
+		return false;
+	}
+
+	for (int t = 0; t < numThreads; t++) {
+		r->targs[t].r = r;
+		r->targs[t].index = t;
+		if (pthread_create(&(r->threads[t]), NULL, &reactor_thread, &(r->targs[t])) != 0) {
+			log_error(r->pstate, "[Reactor] Unable to launch thread %d", t);
+			return false;
+		}
+		r->numThreads++;
+#ifdef _GNU_SOURCE
+		char threadname[16] = {0};
+		snprintf(threadname, 16, "Reactor %hu", (uint16_t)t);
+		pthread_setname_np(r->threads[t], threadname);
+#endif
+	}
+	return true;
+}
+
+/*!
+ * Threads will exit once shutdownFlag is set, so this must be set before
+ * calling this function.
+ *
+ * @param[in] r Reactor state
+ */
+void reactor_stop(reactor_state *r) {
+	if (!r) { return; }
+	for (int t = 0; t < r->numThreads; t++) {
+		pthread_join(r->threads[t], NULL);
+	}
+	r->numThreads = 0;
+	if (r->returnCode != 0) {
+		log_error(r->pstate, "[Reactor] Reactor thread signalled an error: %d", r->returnCode);
+	}
+}
+
+/*!
+ * Threads must be stopped with reactor_stop() first.
+ *
+ * Source handles are not closed here, as they remain owned by each source's
+ * shutdown function.
+ *
+ * @param[in] r Reactor state
+ */
+void reactor_destroy(reactor_state *r) {
+	if (!r) { return; }
+	for (int s = 0; s < r->numSources; s++) {
+		pthread_mutex_destroy(&(r->sources[s].lock));
+	}
+	if (r->epfd >= 0) { close(r->epfd); }
+	free(r->sources);
+	free(r->threads);
+	free(r->targs);
+	(*r) = (reactor_state){.epfd = -1};
+}
@@ -0,0 +1,115 @@
+/*
+ *  Copyright (C) 2023 Swansea University
+ *
+ *  This file is part of the SELKIELogger suite of tools.
+ *
+ *  SELKIELogger is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation, either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  SELKIELogger is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this SELKIELogger product.
+ *  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SL_LOGGER_REACTOR_H
+#define SL_LOGGER_REACTOR_H
+
+#include <pthread.h>
+#include <stdbool.h>
+
+//! @file
+
+/*!
+ * @addtogroup loggerReactor Logger: Shared reactor threads
+ * @ingroup logger
+ *
+ * As an alternative to running a dedicated logging thread for every source,
+ * sources that read from a file descriptor can be serviced by a small number of
+ * shared reactor threads. Each thread waits on a common epoll instance, and
+ * calls the `readable` callback for a source when its handle has data
+ * available.
+ *
+ * Handles are registered with EPOLLONESHOT and re-armed after each callback,
+ * so a source is never serviced by more than one thread at a time. The first
+ * reactor thread also calls each `readable` callback periodically, regardless
+ * of handle state, so that sources can implement timeouts and reconnect to
+ * devices as required.
+ *
+ * Sources are only serviced once their status is SOURCE_READY, so sources can
+ * be registered before they are started (see source_thread()).
+ *
+ * Callbacks must not block, and must not call pthread_exit(). Errors are
+ * signalled through the returnCode member of log_thread_args_t, after which
+ * the source is no longer serviced by the reactor.
+ *
+ * @{
+ */
+
+//! Maximum number of events to be returned from each call to epoll_wait()
+#define REACTOR_MAX_EVENTS 16
+
+//! Maximum time to wait for events before checking shutdown status [ms]
+#define REACTOR_WAIT_MS 100
+
+//! Interval between calls to each source regardless of handle state [s]
+#define REACTOR_IDLE_INTERVAL 1
+
+//! Reactor registration information for a single source
+typedef struct {
+	log_thread_args_t *args; //!< Source information and callbacks
+	int handle;              //!< Handle currently registered with epoll, or -1
+	bool failed;             //!< Source has signalled an error and is no longer serviced
+	pthread_mutex_t lock;    //!< Held while servicing this source
+} reactor_source;
+
+//! Forward declaration, allowing reactor_thread_args to refer to reactor_state
+typedef struct reactor_state reactor_state;
+
+//! Information passed to each reactor thread
+typedef struct {
+	reactor_state *r; //!< Shared reactor state
+	int index;        //!< Thread index. Thread zero also performs idle calls
+} reactor_thread_args;
+
+//! Reactor thread information
+struct reactor_state {
+	int epfd;                     //!< epoll instance shared by all threads
+	program_state *pstate;        //!< Current program state, used for logging
+	int numSources;               //!< Number of registered sources
+	int maxSources;               //!< Number of entries allocated in sources
+	reactor_source *sources;      //!< Registered sources
+	int numThreads;               //!< Number of reactor threads started
+	pthread_t *threads;           //!< Reactor thread handles
+	reactor_thread_args *targs;   //!< Arguments for each reactor thread
+	int returnCode;               //!< Set non-zero if a reactor thread fails
+};
+
+//! Check whether a source can be serviced by the reactor
+bool reactor_supported(const log_thread_args_t *lta);
+
+//! Create epoll instance and allocate source registrations
+bool reactor_init(reactor_state *r, program_state *pstate, const int maxSources);
+
+//! Register a source with the reactor
+bool reactor_register(reactor_state *r, log_thread_args_t *lta);
+
+//! Start reactor threads
+bool reactor_start(reactor_state *r, const int numThreads);
+
+//! Reactor thread main loop (with pthread function signature)
+void *reactor_thread(void *ptargs);
+
+//! Wait for reactor threads to exit
+void reactor_stop(reactor_state *r);
+
+//! Release resources allocated by reactor_init()
+void reactor_destroy(reactor_state *r);
+//! @}
+#endif
@@ -24,7 +24,8 @@
 #include "LoggerSignals.h"
 
 /*!
- * Opens a serial connection and the required baud rate.
+ * Opens a serial connection and the required baud rate, and allocates a
+ * buffer for incoming data.
  *
  * It is assumed that no other setup is required for these devices.
  *
@@ -42,75 +43,113 @@ void *rx_setup(void *ptargs) {
 		return NULL;
 	}
 
+	rxInfo->buf = calloc(rxInfo->maxBytes, sizeof(uint8_t));
+	rxInfo->hw = 0;
+	if (!rxInfo->buf) {
+		log_error(args->pstate, "[Serial:%s] Unable to allocate buffer", args->tag);
+		close(rxInfo->handle);
+		rxInfo->handle = -1;
+		args->returnCode = -1;
+		return NULL;
+	}
+
 	log_info(args->pstate, 2, "[Serial:%s] Connected", args->tag);
 	args->returnCode = 0;
 	return NULL;
 }
 
 /*!
- * Reads messages from the connection established by rx_setup(), and pushes them to the
- * queue. Data is not interpreted, just pushed into the queue with suitable headers.
+ * Reads all data currently available from the connection established by
+ * rx_setup(), and pushes it to the queue. Data is not interpreted, just pushed
+ * into the queue with suitable headers.
  *
  * Message size is variable, based on min/max limits and the amount of data
- * available to read from the source.
+ * available to read from the source. Data is retained between calls until at
+ * least the minimum number of bytes is available.
  *
- * Terminates thread in case of error.
+ * Does not block, so can be called repeatedly by rx_logging() or by the
+ * reactor threads when the handle is readable.
  *
  * @param[in] ptargs Pointer to log_thread_args_t
  * @returns NULL - Exit code in ptargs->returnCode if required
  */
-void *rx_logging(void *ptargs) {
-	signalHandlersBlock();
+void *rx_readable(void *ptargs) {
 	log_thread_args_t *args = (log_thread_args_t *)ptargs;
 	rx_params *rxInfo = (rx_params *)args->dParams;
 
-	log_info(args->pstate, 1, "[Serial:%s] Logging thread started", args->tag);
-
-	uint8_t *buf = calloc(rxInfo->maxBytes, sizeof(uint8_t));
-	int rx_hw = 0;
 	while (!shutdownFlag) {
-		// Need to implement a message handling loop here
 		int ti = 0;
-		if (rx_hw < rxInfo->maxBytes - 1) {
+		if (rxInfo->hw < rxInfo->maxBytes) {
 			errno = 0;
-			ti = read(rxInfo->handle, &(buf[rx_hw]), rxInfo->maxBytes - rx_hw);
-			if (ti >= 0) {
-				rx_hw += ti;
-			} else {
-				if (errno != EAGAIN) {
-					log_error(
-						args->pstate,
-						"[Serial:%s] Unexpected error while reading from serial port (%s)",
-						args->tag, strerror(errno));
-					args->returnCode = -1;
-					pthread_exit(&(args->returnCode));
-				}
+			ti = read(rxInfo->handle, &(rxInfo->buf[rxInfo->hw]),
+			          rxInfo->maxBytes - rxInfo->hw);
+			if (ti > 0) {
+				rxInfo->hw += ti;
+				args->captured = capture_time();
+			} else if (ti < 0 && errno != EAGAIN) {
+				log_error(args->pstate,
+				          "[Serial:%s] Unexpected error while reading from serial port (%s)",
+				          args->tag, strerror(errno));
+				args->returnCode = -1;
+				return NULL;
 			}
 		}
 
-		if (rx_hw < rxInfo->minBytes) {
-			// Sleep briefly, then loop until we have more than the minimum
-			// number of bytes available
-			usleep(1E6 / rxInfo->pollFreq);
-			continue;
+		if (rxInfo->hw < rxInfo->minBytes) {
+			// Wait until we have more than the minimum number of bytes available
+			return NULL;
 		}
 
-		msg_t *sm = msg_new_bytes(rxInfo->sourceNum, 3, rx_hw, buf);
-		if (!queue_push(args->logQ, sm)) {
+		if (!source_push_buffer(args, rxInfo->sourceNum, &(rxInfo->buf), rxInfo->hw,
+		                        rxInfo->maxBytes)) {
 			log_error(args->pstate, "[Serial:%s] Error pushing message to queue",
 			          args->tag);
-			msg_destroy(sm);
 			args->returnCode = -1;
-			pthread_exit(&(args->returnCode));
+			return NULL;
 		}
-		rx_hw = 0;
-		memset(buf, 0, rxInfo->maxBytes);
+		rxInfo->hw = 0;
+
+		// No more data available for now
+		if (ti <= 0) { return NULL; }
+	}
+	return NULL;
+}
+
+/*!
+ * Calls rx_readable() repeatedly until shutdown, waiting between calls for the
+ * device to send more data (see source_wait()).
+ *
+ * Terminates thread in case of error.
+ *
+ * @param[in] ptargs Pointer to log_thread_args_t
+ * @returns NULL - Exit code in ptargs->returnCode if required
+ */
+void *rx_logging(void *ptargs) {
+	signalHandlersBlock();
+	log_thread_args_t *args = (log_thread_args_t *)ptargs;
+	rx_params *rxInfo = (rx_params *)args->dParams;
+
+	log_info(args->pstate, 1, "[Serial:%s] Logging thread started", args->tag);
+
+	while (!shutdownFlag) {
+		rx_readable(ptargs);
+		if (args->returnCode != 0) { pthread_exit(&(args->returnCode)); }
+		source_wait(args, rxInfo->handle, 1E6 / rxInfo->pollFreq);
 	}
-	free(buf);
 	pthread_exit(NULL);
 	return NULL; // Superfluous, as returning zero via pthread_exit above
 }
 
+/*!
+ * @param[in] ptargs Pointer to log_thread_args_t
+ * @returns Handle for currently opened device
+ */
+int rx_handle(void *ptargs) {
+	log_thread_args_t *args = (log_thread_args_t *)ptargs;
+	rx_params *rxInfo = (rx_params *)args->dParams;
+	return rxInfo->handle;
+}
+
 /*!
  * Simple wrapper around rx_closeConnection(), which will do any cleanup required.
  *
@@ -129,6 +168,10 @@ void *rx_shutdown(void *ptargs) {
 		free(rxInfo->portName);
 		rxInfo->portName = NULL;
 	}
+	if (rxInfo->buf) {
+		free(rxInfo->buf);
+		rxInfo->buf = NULL;
+	}
 	return NULL;
 }
 
@@ -139,7 +182,9 @@ device_callbacks rx_getCallbacks() {
 	device_callbacks cb = {.startup = &rx_setup,
 	                       .logging = &rx_logging,
 	                       .shutdown = &rx_shutdown,
-	                       .channels = &rx_channels};
+	                       .channels = &rx_channels,
+	                       .readable = &rx_readable,
+	                       .handle = &rx_handle};
 	return cb;
 }
 
@@ -152,7 +197,9 @@ rx_params rx_getParams() {
 	                .handle = -1,
 	                .minBytes = 10,
 	                .maxBytes = 1024,
-	                .pollFreq = 10};
+	                .pollFreq = 10,
+	                .buf = NULL,
+	                .hw = 0};
 	return mp;
 }
 
@@ -171,7 +218,7 @@ void *rx_channels(void *ptargs) {
 	msg_t *m_sn = msg_new_string(rxInfo->sourceNum, SLCHAN_NAME, strlen(rxInfo->sourceName),
 	                             rxInfo->sourceName);
 
-	if (!queue_push(args->logQ, m_sn)) {
+	if (!source_push(args, m_sn)) {
 		log_error(args->pstate, "[Serial:%s] Error pushing channel name to queue",
 		          args->tag);
 		msg_destroy(m_sn);
@@ -187,7 +234,7 @@ void *rx_channels(void *ptargs) {
 
 	msg_t *m_cmap = msg_new_string_array(rxInfo->sourceNum, SLCHAN_MAP, channels);
 
-	if (!queue_push(args->logQ, m_cmap)) {
+	if (!source_push(args, m_cmap)) {
 		log_error(args->pstate, "[Serial:%s] Error pushing channel map to queue",
 		          args->tag);
 		msg_destroy(m_cmap);
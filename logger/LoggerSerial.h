@@ -49,6 +49,8 @@ typedef struct {
 	int minBytes;      //!< Minimum number of bytes to group into a message
 	int maxBytes;      //!< Maximum number of bytes to group into a message
 	int pollFreq;      //!< Minimum number of times per second to check for data
+	uint8_t *buf;      //!< Receive buffer (maxBytes, allocated by rx_setup())
+	int hw;            //!< Number of bytes currently held in buf
 } rx_params;
 
 //! Generic serial connection setup
@@ -57,6 +59,12 @@ void *rx_setup(void *ptargs);
 //! Serial source main logging loop
 void *rx_logging(void *ptargs);
 
+//! Read and queue all currently available data
+void *rx_readable(void *ptargs);
+
+//! Return current serial handle
+int rx_handle(void *ptargs);
+
 //! Serial source shutdown
 void *rx_shutdown(void *ptargs);
 
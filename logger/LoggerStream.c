@@ -0,0 +1,602 @@
+/*
+ *  Copyright (C) 2023 Swansea University
+ *
+ *  This file is part of the SELKIELogger suite of tools.
+ *
+ *  SELKIELogger is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation, either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  SELKIELogger is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this SELKIELogger product.
+ *  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "Logger.h"
+
+#include "LoggerSignals.h"
+#include "LoggerStream.h"
+
+/*!
+ * Listen on TCP port `port` at address `addr`.
+ *
+ * @param[in] ss Streaming server state
+ * @param[in] addr Local address to listen on (NULL for any)
+ * @param[in] port Local TCP port
+ * @returns Listening socket, or -1 on error
+ */
+static int stream_listen_tcp(stream_server *ss, const char *addr, const int port) {
+	struct addrinfo hints = {
+		.ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM, .ai_flags = AI_PASSIVE};
+	struct addrinfo *res = NULL;
+	char portStr[12] = {0};
+	snprintf(portStr, sizeof(portStr), "%d", port);
+
+	int rv = getaddrinfo(addr, portStr, &hints, &res);
+	if (rv != 0) {
+		log_error(ss->pstate, "[Stream] Unable to resolve listening address: %s",
+		          gai_strerror(rv));
+		return -1;
+	}
+
+	int h = -1;
+	for (struct addrinfo *ai = res; ai != NULL; ai = ai->ai_next) {
+		h = socket(ai->ai_family, ai->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC,
+		           ai->ai_protocol);
+		if (h < 0) { continue; }
+		const int on = 1;
+		setsockopt(h, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+		if (bind(h, ai->ai_addr, ai->ai_addrlen) == 0 && listen(h, 8) == 0) { break; }
+		close(h);
+		h = -1;
+	}
+	freeaddrinfo(res);
+
+	if (h < 0) {
+		log_error(ss->pstate, "[Stream] Unable to listen on port %d: %s", port,
+		          strerror(errno));
+	}
+	return h;
+}
+
+/*!
+ * Listen on a Unix domain socket at `path`. A stale socket left at the same
+ * path (e.g. after a crash) is removed first, but any other type of file is
+ * left in place and treated as an error.
+ *
+ * @param[in] ss Streaming server state
+ * @param[in] path Socket path
+ * @returns Listening socket, or -1 on error
+ */
+static int stream_listen_unix(stream_server *ss, const char *path) {
+	struct sockaddr_un sa = {.sun_family = AF_UNIX};
+	if (strlen(path) >= sizeof(sa.sun_path)) {
+		log_error(ss->pstate, "[Stream] Socket path too long: %s", path);
+		return -1;
+	}
+	strncpy(sa.sun_path, path, sizeof(sa.sun_path) - 1);
+
+	struct stat st = {0};
+	if (lstat(path, &st) == 0 && S_ISSOCK(st.st_mode)) { unlink(path); }
+
+	int h = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (h < 0) {
+		log_error(ss->pstate, "[Stream] Unable to create socket: %s", strerror(errno));
+		return -1;
+	}
+
+	if (bind(h, (struct sockaddr *)&sa, sizeof(sa)) != 0 || listen(h, 8) != 0) {
+		log_error(ss->pstate, "[Stream] Unable to listen on %s: %s", path,
+		          strerror(errno));
+		close(h);
+		return -1;
+	}
+	return h;
+}
+
+/*!
+ * At least one of `port` and `path` must be specified.
+ *
+ * @param[out] ss Streaming server state to initialise
+ * @param[in] pstate Program state, used for logging
+ * @param[in] addr Local address for TCP connections (NULL for any)
+ * @param[in] port Local TCP port (0 to disable)
+ * @param[in] path Unix domain socket path (NULL to disable)
+ * @param[in] bufSize Output buffer size for each client [bytes]
+ * @param[in] maxClients Maximum number of simultaneous clients
+ * @returns True on success, false on error
+ */
+bool stream_init(stream_server *ss, program_state *pstate, const char *addr, const int port,
+                 const char *path, const int bufSize, const int maxClients) {
+	if (!ss || bufSize <= 0 || maxClients <= 0 || (port <= 0 && !path)) { return false; }
+	(*ss) = (stream_server){
+		.pstate = pstate, .listenTCP = -1, .listenUnix = -1, .wake = {-1, -1}};
+	ss->bufSize = bufSize;
+
+	if (pipe2(ss->wake, O_NONBLOCK | O_CLOEXEC) != 0) {
+		log_error(pstate, "[Stream] Unable to create wake pipe: %s", strerror(errno));
+		ss->wake[0] = -1;
+		ss->wake[1] = -1;
+		return false;
+	}
+
+	ss->clients = calloc(maxClients, sizeof(stream_client));
+	ss->pfds = calloc(maxClients + 3, sizeof(struct pollfd));
+	if (!ss->clients || !ss->pfds) {
+		log_error(pstate, "[Stream] Unable to allocate client information");
+		stream_destroy(ss);
+		return false;
+	}
+
+	for (int c = 0; c < maxClients; c++) {
+		ss->clients[c].handle = -1;
+		if (pthread_mutex_init(&(ss->clients[c].lock), NULL) != 0) {
+			log_error(pstate, "[Stream] Unable to initialise client lock");
+			stream_destroy(ss);
+			return false;
+		}
+		ss->maxClients++;
+	}
+
+	if (port > 0) {
+		ss->listenTCP = stream_listen_tcp(ss, addr, port);
+		if (ss->listenTCP < 0) {
+			stream_destroy(ss);
+			return false;
+		}
+		log_info(pstate, 1, "[Stream] Listening on port %d (%s)", port,
+		         addr ? addr : "any");
+	}
+
+	if (path) {
+		ss->listenUnix = stream_listen_unix(ss, path);
+		if (ss->listenUnix < 0) {
+			stream_destroy(ss);
+			return false;
+		}
+		ss->socketPath = strdup(path);
+		log_info(pstate, 1, "[Stream] Listening on %s", path);
+	}
+	return true;
+}
+
+/*!
+ * @param[in] ss Streaming server state
+ * @returns True if thread started successfully
+ */
+bool stream_start(stream_server *ss) {
+	if (!ss || !ss->clients) { return false; }
+	if (pthread_create(&(ss->thread), NULL, &stream_thread, ss) != 0) {
+		log_error(ss->pstate, "[Stream] Unable to launch server thread");
+		return false;
+	}
+	ss->running = true;
+#ifdef _GNU_SOURCE
+	pthread_setname_np(ss->thread, "Logger: Stream");
+#endif
+	return true;
+}
+
+/*!
+ * Must be called with the client lock held.
+ *
+ * @param[in] c Client
+ * @param[in] msg Message to be checked
+ * @returns True if the client has selected this message
+ */
+static bool stream_selected(const stream_client *c, const msg_t *msg) {
+	if (!c->filtered) { return true; }
+	const uint64_t *sel = c->select[msg->source];
+	if (msg->type == SLCHAN_NAME || msg->type == SLCHAN_MAP) { return (sel[0] | sel[1]) != 0; }
+	return (sel[msg->type >> 6] & (1ULL << (msg->type & 63))) != 0;
+}
+
+/*!
+ * Frames are either added in full, or dropped if there is insufficient space
+ * remaining in the client's buffer, so clients never receive partial frames.
+ *
+ * Must be called with the client lock held.
+ *
+ * @param[in] ss Streaming server state
+ * @param[in] c Client
+ * @param[in] frame Packed message
+ * @param[in] len Length of packed message
+ * @returns True if frame added to buffer
+ */
+static bool stream_append(stream_server *ss, stream_client *c, const char *frame,
+                          const size_t len) {
+	if ((c->head - c->tail) + len > (uint64_t)ss->bufSize) {
+		c->dropped++;
+		return false;
+	}
+	const size_t off = c->head % ss->bufSize;
+	const size_t first = (len < (ss->bufSize - off)) ? len : (ss->bufSize - off);
+	memcpy(&(c->ring[off]), frame, first);
+	if (first < len) { memcpy(c->ring, &(frame[first]), len - first); }
+	c->head += len;
+	c->frames++;
+	return true;
+}
+
+/*!
+ * Writes to the wake pipe are skipped if the server thread has already been
+ * woken and has not yet started sending, so the main thread makes at most one
+ * system call per server thread iteration.
+ *
+ * @param[in] ss Streaming server state
+ */
+static void stream_wake(stream_server *ss) {
+	if (atomic_exchange(&(ss->wakePending), true)) { return; }
+	const uint8_t b = 1;
+	if (write(ss->wake[1], &b, 1) < 0) {
+		// Pipe full - server thread will be woken anyway
+	}
+}
+
+/*!
+ * Called from the main thread for each message written to the data file.
+ * Returns immediately if no clients are connected.
+ *
+ * @param[in] ss Streaming server state
+ * @param[in] msg Message (used to check each client's selection)
+ * @param[in] frame Packed message, as written to the data file
+ * @param[in] len Length of packed message
+ */
+void stream_publish(stream_server *ss, const msg_t *msg, const char *frame, const size_t len) {
+	if (!ss || atomic_load(&(ss->active)) == 0) { return; }
+
+	bool added = false;
+	for (int c = 0; c < ss->maxClients; c++) {
+		stream_client *sc = &(ss->clients[c]);
+		pthread_mutex_lock(&(sc->lock));
+		if (sc->state == STREAM_ACTIVE && stream_selected(sc, msg)) {
+			if (stream_append(ss, sc, frame, len)) { added = true; }
+		}
+		pthread_mutex_unlock(&(sc->lock));
+	}
+	if (added) { stream_wake(ss); }
+}
+
+/*!
+ * Called from the main thread, which owns the channel statistics. Each client
+ * in the STREAM_PENDING state is sent the most recent name and channel map for
+ * every source, and is then moved to the STREAM_ACTIVE state so that it
+ * receives new messages from stream_publish().
+ *
+ * Returns immediately if no clients are waiting.
+ *
+ * @param[in] ss Streaming server state
+ * @param[in] stats Channel statistics from the main thread
+ */
+void stream_catchup(stream_server *ss, channel_stats stats[128][128]) {
+	if (!ss || atomic_load(&(ss->pending)) == 0) { return; }
+
+	for (int c = 0; c < ss->maxClients; c++) {
+		stream_client *sc = &(ss->clients[c]);
+		pthread_mutex_lock(&(sc->lock));
+		if (sc->state != STREAM_PENDING) {
+			pthread_mutex_unlock(&(sc->lock));
+			continue;
+		}
+
+		for (int src = 0; src < 128; src++) {
+			const msg_t *m[2] = {stats[src][SLCHAN_NAME].lastMessage,
+			                     stats[src][SLCHAN_MAP].lastMessage};
+			for (int i = 0; i < 2; i++) {
+				if (!m[i] || !stream_selected(sc, m[i])) { continue; }
+				msgpack_sbuffer sbuf;
+				if (!mp_packMessage(&sbuf, m[i])) { continue; }
+				stream_append(ss, sc, sbuf.data, sbuf.size);
+				msgpack_sbuffer_destroy(&sbuf);
+			}
+		}
+		sc->state = STREAM_ACTIVE;
+		atomic_fetch_sub(&(ss->pending), 1);
+		atomic_fetch_add(&(ss->active), 1);
+		pthread_mutex_unlock(&(sc->lock));
+	}
+	stream_wake(ss);
+}
+
+/*!
+ * Only called from the server thread.
+ *
+ * @param[in] ss Streaming server state
+ * @param[in] c Client
+ */
+static void stream_close_client(stream_server *ss, stream_client *c) {
+	pthread_mutex_lock(&(c->lock));
+	if (c->state == STREAM_PENDING) { atomic_fetch_sub(&(ss->pending), 1); }
+	if (c->state == STREAM_ACTIVE) { atomic_fetch_sub(&(ss->active), 1); }
+	log_info(ss->pstate, 1, "[Stream] Client disconnected (%u frames buffered, %u dropped)",
+	         c->frames, c->dropped);
+	c->state = STREAM_FREE;
+	close(c->handle);
+	c->handle = -1;
+	free(c->ring);
+	c->ring = NULL;
+	pthread_mutex_unlock(&(c->lock));
+}
+
+/*!
+ * Only called from the server thread. Connections are refused if all client
+ * slots are in use.
+ *
+ * @param[in] ss Streaming server state
+ * @param[in] lh Listening socket with connection waiting
+ */
+static void stream_accept(stream_server *ss, const int lh) {
+	int h = accept4(lh, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+	if (h < 0) { return; }
+
+	for (int c = 0; c < ss->maxClients; c++) {
+		stream_client *sc = &(ss->clients[c]);
+		pthread_mutex_lock(&(sc->lock));
+		const bool inUse = (sc->state != STREAM_FREE);
+		pthread_mutex_unlock(&(sc->lock));
+		// Only the server thread moves slots out of STREAM_FREE
+		if (inUse) { continue; }
+
+		uint8_t *ring = calloc(ss->bufSize, sizeof(uint8_t));
+		if (!ring) {
+			log_warning(ss->pstate, "[Stream] Unable to allocate client buffer");
+			close(h);
+			return;
+		}
+		pthread_mutex_lock(&(sc->lock));
+		sc->handle = h;
+		sc->ring = ring;
+		sc->head = 0;
+		sc->tail = 0;
+		sc->filtered = false;
+		sc->cmdLen = 0;
+		sc->frames = 0;
+		sc->dropped = 0;
+		sc->state = STREAM_PENDING;
+		atomic_fetch_add(&(ss->pending), 1);
+		pthread_mutex_unlock(&(sc->lock));
+		log_info(ss->pstate, 1, "[Stream] Client connected");
+		return;
+	}
+	log_warning(ss->pstate, "[Stream] Connection refused - too many clients");
+	close(h);
+}
+
+/*!
+ * Must be called with the client lock held.
+ *
+ * @param[in] c Client
+ * @param[in] cmd Command string, without line ending
+ * @returns True if command was valid
+ */
+static bool stream_command(stream_client *c, const char *cmd) {
+	if (strcasecmp(cmd, "all") == 0) {
+		c->filtered = false;
+		return true;
+	}
+
+	if (strcasecmp(cmd, "none") == 0) {
+		c->filtered = true;
+		memset(c->select, 0, sizeof(c->select));
+		return true;
+	}
+
+	if (cmd[0] != '+' && cmd[0] != '-') { return false; }
+	const bool add = (cmd[0] == '+');
+
+	char *end = NULL;
+	errno = 0;
+	const long src = strtol(&(cmd[1]), &end, 0);
+	if (errno || end == &(cmd[1]) || src < 0 || src > 127) { return false; }
+
+	long chan = -1;
+	if (*end == ':') {
+		const char *cs = end + 1;
+		chan = strtol(cs, &end, 0);
+		if (errno || end == cs || chan < 0 || chan > 127) { return false; }
+	}
+	if (*end != '\0') { return false; }
+
+	if (!c->filtered) {
+		// First selection change replaces (for +) or modifies (for -) the default
+		c->filtered = true;
+		memset(c->select, add ? 0x00 : 0xFF, sizeof(c->select));
+	}
+
+	if (chan < 0) {
+		c->select[src][0] = add ? UINT64_MAX : 0;
+		c->select[src][1] = add ? UINT64_MAX : 0;
+	} else if (add) {
+		c->select[src][chan >> 6] |= (1ULL << (chan & 63));
+	} else {
+		c->select[src][chan >> 6] &= ~(1ULL << (chan & 63));
+	}
+	return true;
+}
+
+/*!
+ * Only called from the server thread. Reads any commands sent by the client.
+ *
+ * @param[in] ss Streaming server state
+ * @param[in] c Client
+ * @returns False if the connection has been closed
+ */
+static bool stream_receive(stream_server *ss, stream_client *c) {
+	char in[256] = {0};
+	ssize_t n = read(c->handle, in, sizeof(in));
+	if (n == 0 || (n < 0 && errno != EAGAIN && errno != EINTR)) { return false; }
+
+	for (ssize_t i = 0; i < n; i++) {
+		if (in[i] != '\n' && in[i] != '\r') {
+			// Overlong commands are truncated, and will be rejected
+			if (c->cmdLen < (STREAM_CMD_MAX - 1)) { c->cmd[c->cmdLen++] = in[i]; }
+			continue;
+		}
+		if (c->cmdLen == 0) { continue; }
+		c->cmd[c->cmdLen] = '\0';
+		c->cmdLen = 0;
+
+		pthread_mutex_lock(&(c->lock));
+		const bool valid = stream_command(c, c->cmd);
+		pthread_mutex_unlock(&(c->lock));
+		if (!valid) {
+			log_info(ss->pstate, 2, "[Stream] Invalid client command: %s", c->cmd);
+		}
+	}
+	return true;
+}
+
+/*!
+ * Only called from the server thread. Sends as much buffered data as the
+ * socket will accept without blocking.
+ *
+ * The lock is released while sending, which is safe as the main thread only
+ * writes to the unused part of the buffer.
+ *
+ * @param[in] ss Streaming server state
+ * @param[in] c Client
+ * @returns False if the connection has failed
+ */
+static bool stream_send(stream_server *ss, stream_client *c) {
+	while (true) {
+		pthread_mutex_lock(&(c->lock));
+		const uint64_t used = c->head - c->tail;
+		const size_t off = c->tail % ss->bufSize;
+		pthread_mutex_unlock(&(c->lock));
+		if (used == 0) { return true; }
+
+		const size_t len = (used < (ss->bufSize - off)) ? used : (ss->bufSize - off);
+		ssize_t n = send(c->handle, &(c->ring[off]), len, MSG_NOSIGNAL | MSG_DONTWAIT);
+		if (n < 0) { return (errno == EAGAIN || errno == EINTR); }
+
+		pthread_mutex_lock(&(c->lock));
+		c->tail += n;
+		pthread_mutex_unlock(&(c->lock));
+		if ((size_t)n < len) { return true; }
+	}
+}
+
+/*!
+ * Waits for new connections, commands from clients, and for buffered data to
+ * be sent. The wake pipe is used by the main thread to signal that new data
+ * has been buffered.
+ *
+ * @param[in] ptargs Pointer to stream_server
+ * @returns NULL - Exit code in stream_server->returnCode if required
+ */
+void *stream_thread(void *ptargs) {
+	signalHandlersBlock();
+	stream_server *ss = (stream_server *)ptargs;
+
+	log_info(ss->pstate, 1, "[Stream] Server thread started");
+	while (!shutdownFlag) {
+		int np = 0;
+		ss->pfds[np++] = (struct pollfd){.fd = ss->wake[0], .events = POLLIN};
+		ss->pfds[np++] = (struct pollfd){.fd = ss->listenTCP, .events = POLLIN};
+		ss->pfds[np++] = (struct pollfd){.fd = ss->listenUnix, .events = POLLIN};
+		for (int c = 0; c < ss->maxClients; c++) {
+			stream_client *sc = &(ss->clients[c]);
+			pthread_mutex_lock(&(sc->lock));
+			ss->pfds[np] = (struct pollfd){.fd = -1};
+			if (sc->state != STREAM_FREE) {
+				ss->pfds[np].fd = sc->handle;
+				ss->pfds[np].events = POLLIN;
+				if (sc->head != sc->tail) { ss->pfds[np].events |= POLLOUT; }
+			}
+			pthread_mutex_unlock(&(sc->lock));
+			np++;
+		}
+
+		errno = 0;
+		int n = poll(ss->pfds, np, STREAM_WAIT_MS);
+		if (n < 0) {
+			if (errno == EINTR) { continue; }
+			log_error(ss->pstate, "[Stream] Error waiting for events: %s",
+			          strerror(errno));
+			ss->returnCode = -1;
+			pthread_exit(&(ss->returnCode));
+		}
+
+		if (ss->pfds[0].revents & POLLIN) {
+			uint8_t drain[64];
+			while (read(ss->wake[0], drain, sizeof(drain)) > 0) {}
+			// Cleared before sending, so data added after this point wakes us again
+			atomic_store(&(ss->wakePending), false);
+		}
+
+		if (ss->pfds[1].revents & POLLIN) { stream_accept(ss, ss->listenTCP); }
+		if (ss->pfds[2].revents & POLLIN) { stream_accept(ss, ss->listenUnix); }
+
+		for (int c = 0; c < ss->maxClients; c++) {
+			stream_client *sc = &(ss->clients[c]);
+			const short ev = ss->pfds[c + 3].revents;
+			// Connections accepted above are not polled until the next iteration
+			const int h = ss->pfds[c + 3].fd;
+			if (h < 0 || h != sc->handle) { continue; }
+			bool ok = true;
+			if (ev & (POLLIN | POLLHUP | POLLERR)) { ok = stream_receive(ss, sc); }
+			if (ok) { ok = stream_send(ss, sc); }
+			if (!ok) { stream_close_client(ss, sc); }
+		}
+	}
+	log_info(ss->pstate, 1, "[Stream] Server thread exiting");
+	pthread_exit(NULL);
+	return NULL; // Superfluous, as returning zero via pthread_exit above
+}
+
+/*!
+ * The server thread will exit once shutdownFlag is set, so this must be set
+ * before calling this function.
+ *
+ * @param[in] ss Streaming server state
+ */
+void stream_stop(stream_server *ss) {
+	if (!ss || !ss->running) { return; }
+	pthread_join(ss->thread, NULL);
+	ss->running = false;
+	if (ss->returnCode != 0) {
+		log_error(ss->pstate, "[Stream] Server thread signalled an error: %d",
+		          ss->returnCode);
+	}
+}
+
+/*!
+ * The server thread must be stopped with stream_stop() first. Safe to call on
+ * a partially initialised or zeroed (with handles set to -1) structure.
+ *
+ * @param[in] ss Streaming server state
+ */
+void stream_destroy(stream_server *ss) {
+	if (!ss) { return; }
+	for (int c = 0; c < ss->maxClients; c++) {
+		stream_client *sc = &(ss->clients[c]);
+		if (sc->state != STREAM_FREE) { stream_close_client(ss, sc); }
+		pthread_mutex_destroy(&(sc->lock));
+	}
+	if (ss->listenTCP >= 0) { close(ss->listenTCP); }
+	if (ss->listenUnix >= 0) { close(ss->listenUnix); }
+	if (ss->socketPath) {
+		unlink(ss->socketPath);
+		free(ss->socketPath);
+	}
+	if (ss->wake[0] >= 0) { close(ss->wake[0]); }
+	if (ss->wake[1] >= 0) { close(ss->wake[1]); }
+	free(ss->clients);
+	free(ss->pfds);
+	(*ss) = (stream_server){.listenTCP = -1, .listenUnix = -1, .wake = {-1, -1}};
+}
@@ -0,0 +1,140 @@
+/*
+ *  Copyright (C) 2023 Swansea University
+ *
+ *  This file is part of the SELKIELogger suite of tools.
+ *
+ *  SELKIELogger is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation, either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  SELKIELogger is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this SELKIELogger product.
+ *  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SL_LOGGER_STREAM_H
+#define SL_LOGGER_STREAM_H
+
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+//! @file
+
+/*!
+ * @addtogroup loggerStream Logger: Live data streaming
+ * @ingroup logger
+ *
+ * Optionally, the messages written to the main data file can also be streamed
+ * to any number of local clients over TCP or a Unix domain socket. Clients
+ * receive exactly the same frames as are written to the data file, so can use
+ * the same decoding functions (e.g. mp_decodeMessage_buf()).
+ *
+ * Each client has its own fixed size output buffer. Frames are added to these
+ * buffers by the main thread as they are written to file, and sent by a
+ * dedicated thread. If a client's buffer is full, frames are dropped for that
+ * client rather than delaying the main thread.
+ *
+ * On connection, clients are sent the most recent name and channel map for
+ * each source before any new data. Clients may also send simple text
+ * commands (one per line) to select the sources and channels they receive:
+ * - `all` - Receive all messages (default)
+ * - `none` - Receive no messages
+ * - `+<source>[:<channel>]` - Receive messages from a source or channel
+ * - `-<source>[:<channel>]` - Stop receiving messages from a source or channel
+ *
+ * The first `+` command received replaces the default selection, and the
+ * first `-` command removes from it. Names and channel maps are sent for any
+ * source with at least one selected channel.
+ *
+ * @{
+ */
+
+//! Default output buffer size for each client [bytes]
+#define STREAM_DEFAULT_BUFFER 262144
+
+//! Default maximum number of simultaneous clients
+#define STREAM_DEFAULT_CLIENTS 8
+
+//! Maximum time to wait for events before checking shutdown status [ms]
+#define STREAM_WAIT_MS 100
+
+//! Maximum length of a client command
+#define STREAM_CMD_MAX 64
+
+//! Client connection states
+typedef enum {
+	STREAM_FREE = 0, //!< Slot not in use
+	STREAM_PENDING,  //!< Connected, waiting for names and channel maps
+	STREAM_ACTIVE,   //!< Connected, receiving data
+} stream_client_state;
+
+//! Connection and output buffer for a single client
+typedef struct {
+	int handle;                  //!< Client socket, or -1
+	stream_client_state state;   //!< Connection state
+	uint8_t *ring;               //!< Output buffer (allocated on connection)
+	uint64_t head;               //!< Total bytes added to ring
+	uint64_t tail;               //!< Total bytes sent from ring
+	bool filtered;               //!< Only send selected channels
+	uint64_t select[128][2];     //!< Selected channels for each source (bitmask)
+	char cmd[STREAM_CMD_MAX];    //!< Partial command received from client
+	int cmdLen;                  //!< Length of partial command
+	uint32_t frames;             //!< Frames added to ring
+	uint32_t dropped;            //!< Frames dropped because ring was full
+	pthread_mutex_t lock;        //!< Protects all of the above except cmd and cmdLen
+} stream_client;
+
+//! Forward declaration, also used in Logger.h
+typedef struct stream_server stream_server;
+
+//! Streaming server state
+struct stream_server {
+	program_state *pstate;       //!< Current program state, used for logging
+	int listenTCP;               //!< Listening TCP socket, or -1
+	int listenUnix;              //!< Listening Unix domain socket, or -1
+	char *socketPath;            //!< Unix domain socket path (removed at exit)
+	int wake[2];                 //!< Pipe used to wake server thread when data added
+	atomic_bool wakePending;     //!< Server thread has already been woken
+	int bufSize;                 //!< Size of each client output buffer [bytes]
+	int maxClients;              //!< Number of client slots allocated
+	stream_client *clients;      //!< Client slots
+	struct pollfd *pfds;         //!< Poll set used by server thread
+	atomic_int pending;          //!< Number of clients in STREAM_PENDING state
+	atomic_int active;           //!< Number of clients in STREAM_ACTIVE state
+	pthread_t thread;            //!< Server thread handle
+	bool running;                //!< Server thread started
+	int returnCode;              //!< Set non-zero if server thread fails
+};
+
+//! Open listening sockets and allocate client slots
+bool stream_init(stream_server *ss, program_state *pstate, const char *addr, const int port,
+                 const char *path, const int bufSize, const int maxClients);
+
+//! Start server thread
+bool stream_start(stream_server *ss);
+
+//! Server thread main loop (with pthread function signature)
+void *stream_thread(void *ptargs);
+
+//! Add a packed message to the output buffer of each client that has selected it
+void stream_publish(stream_server *ss, const msg_t *msg, const char *frame, const size_t len);
+
+//! Send names and channel maps to newly connected clients
+void stream_catchup(stream_server *ss, channel_stats stats[128][128]);
+
+//! Wait for server thread to exit
+void stream_stop(stream_server *ss);
+
+//! Close all connections and release resources allocated by stream_init()
+void stream_destroy(stream_server *ss);
+//! @}
+#endif
@@ -18,11 +18,158 @@
  *  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <inttypes.h>
+#include <time.h>
+
 #include "Logger.h"
 
 #include "LoggerSignals.h"
 #include "LoggerTime.h"
 
+//! Upper bounds for deadline_timer lateness histogram bins [ns]
+static const uint64_t deadline_bins[DEADLINE_HIST_BINS - 1] = {1E4, 5E4, 1E5, 5E5, 1E6, 5E6, 1E7};
+
+//! Labels for deadline_timer lateness histogram bins
+static const char *deadline_labels[DEADLINE_HIST_BINS] = {"<10us", "<50us", "<100us", "<500us",
+                                                          "<1ms",  "<5ms",  "<10ms",  ">=10ms"};
+
+//! Guards initialisation of clockOrigin
+static pthread_once_t clockOnce = PTHREAD_ONCE_INIT;
+
+//! Shared sample clock origin [ns, CLOCK_MONOTONIC]
+static uint64_t clockOrigin = 0;
+
+//! Set clockOrigin to the start of the current second
+static void sample_clock_set_origin(void) {
+	clockOrigin = capture_time() / 1000000000 * 1000000000;
+}
+
+/*!
+ * The origin is fixed the first time this function is called, and is the
+ * same for all threads for the lifetime of the program.
+ *
+ * @returns Shared sample clock origin [ns, CLOCK_MONOTONIC]
+ */
+uint64_t sample_clock_origin(void) {
+	pthread_once(&clockOnce, &sample_clock_set_origin);
+	return clockOrigin;
+}
+
+/*!
+ * The first deadline is set to the next multiple of the timer period after
+ * the shared sample clock origin, so that timers with the same frequency are
+ * synchronised.
+ *
+ * Frequencies above DEADLINE_LIMIT_FREQ are rejected when parsing the
+ * configuration, but the period is never allowed to reach zero.
+ *
+ * @param[out] dt Timer state
+ * @param[in] frequency Deadlines per second
+ */
+void deadline_init(deadline_timer *dt, const int frequency) {
+	*dt = (deadline_timer){0};
+	dt->origin = sample_clock_origin();
+	dt->period = 1000000000 / frequency;
+	if (dt->period == 0) { dt->period = 1; }
+	dt->current = dt->origin + (capture_time() - dt->origin) / dt->period * dt->period;
+	dt->next = dt->current + dt->period;
+	dt->lastReport = time(NULL);
+}
+
+/*!
+ * Timers with the same frequency return the same index for the same deadline,
+ * regardless of when each timer was started.
+ *
+ * @param[in] dt Timer state
+ * @returns Index of most recent deadline
+ */
+uint32_t deadline_index(const deadline_timer *dt) {
+	return (dt->current - dt->origin) / dt->period;
+}
+
+/*!
+ * Sleeps until the next deadline using clock_nanosleep() with an absolute
+ * CLOCK_MONOTONIC target, then records how late the thread woke.
+ *
+ * If more than one deadline has passed on waking, all but the most recent are
+ * skipped and the most recent deadline is reported as the current deadline,
+ * so that the caller does not attempt to catch up with a burst of iterations
+ * and the deadline index (see deadline_index()) matches the time the caller
+ * actually runs. Deadlines always remain aligned with the original schedule.
+ *
+ * @param[in,out] dt Timer state
+ * @returns Number of deadlines skipped
+ */
+int deadline_wait(deadline_timer *dt) {
+	const struct timespec target = {.tv_sec = dt->next / 1000000000,
+	                                .tv_nsec = dt->next % 1000000000};
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &target, NULL) == EINTR) {
+		if (shutdownFlag) { break; }
+	}
+
+	const uint64_t now = capture_time();
+	const uint64_t lateness = (now > dt->next) ? now - dt->next : 0;
+	int bin = 0;
+	while (bin < (DEADLINE_HIST_BINS - 1) && lateness >= deadline_bins[bin]) {
+		bin++;
+	}
+	dt->hist[bin]++;
+	dt->ticks++;
+	dt->sumLate += lateness;
+	if (lateness > dt->maxLate) { dt->maxLate = lateness; }
+
+	const uint64_t missed = lateness / dt->period;
+	if (missed > 0) {
+		dt->late++;
+		dt->skipped += missed;
+		dt->next += missed * dt->period;
+	}
+	dt->current = dt->next;
+	dt->next += dt->period;
+	return missed;
+}
+
+/*!
+ * Reports the number of deadlines, lateness statistics and histogram every
+ * DEADLINE_REPORT_INTERVAL seconds, then resets the statistics.
+ *
+ * Reported as a warning if any deadlines were serviced late or skipped.
+ *
+ * @param[in,out] dt Timer state
+ * @param[in] args Pointer to log_thread_args_t
+ * @param[in] prefix Source type to include in log messages
+ */
+void deadline_report(deadline_timer *dt, log_thread_args_t *args, const char *prefix) {
+	const time_t now = time(NULL);
+	if ((now - dt->lastReport) < DEADLINE_REPORT_INTERVAL || dt->ticks == 0) { return; }
+
+	char hist[200] = {0};
+	int hl = 0;
+	for (int i = 0; i < DEADLINE_HIST_BINS && hl < (int)sizeof(hist); i++) {
+		hl += snprintf(&(hist[hl]), sizeof(hist) - hl, " %s:%" PRIu64, deadline_labels[i],
+		               dt->hist[i]);
+	}
+
+	const double meanLate = 1E-3 * dt->sumLate / dt->ticks;
+	if (dt->late || dt->skipped) {
+		log_warning(args->pstate,
+		            "[%s:%s] %" PRIu64 " deadlines, %" PRIu64 " late, %" PRIu64
+		            " skipped. Mean lateness %.1fus, max. %.1fus. Histogram:%s",
+		            prefix, args->tag, dt->ticks, dt->late, dt->skipped, meanLate,
+		            1E-3 * dt->maxLate, hist);
+	} else {
+		log_info(args->pstate, 2,
+		         "[%s:%s] %" PRIu64 " deadlines. Mean lateness %.1fus, max. %.1fus. Histogram:%s",
+		         prefix, args->tag, dt->ticks, meanLate, 1E-3 * dt->maxLate, hist);
+	}
+
+	*dt = (deadline_timer){.origin = dt->origin,
+	                       .current = dt->current,
+	                       .next = dt->next,
+	                       .period = dt->period,
+	                       .lastReport = now};
+}
+
 /*!
  * Ensure a name is allocated to the timer.
  *
@@ -50,10 +197,9 @@ void *timer_setup(void *ptargs) {
  * Generate timestamp messages at the specified interval using CLOCK_MONOTONIC,
  * and epoch messages whenever the value of time() changes (i.e once a second).
  *
- * The loop saves the value of CLOCK_MONOTONIC at the start of each iteration
- * and uses that to calculate the target start time for the next iteration.  If
- * the execution of the loop has taken too long (i.e. the next iteration should
- * already have started), a warning is generated.
+ * Iterations are scheduled against absolute deadlines (see deadline_wait()),
+ * so the timer does not drift, and timing statistics are reported
+ * periodically.
  *
  * @param[in] ptargs Pointer to log_thread_args_t
  * @returns NULL - Exit code in ptargs->returnCode if required
@@ -65,15 +211,15 @@ void *timer_logging(void *ptargs) {
 
 	log_info(args->pstate, 1, "[Timer:%s] Logging thread started", args->tag);
 
-	const int incr_nsec = (1E9 / timerInfo->frequency);
+	deadline_timer dt = {0};
+	deadline_init(&dt, timerInfo->frequency);
 	time_t lstamp = 0;
 	while (!shutdownFlag) {
-		struct timespec now = {0};
-		clock_gettime(CLOCK_MONOTONIC, &now);
+		args->captured = capture_time();
 		// Millisecond precision timestamp, but arbitrary reference point
 		msg_t *msg = msg_new_timestamp(timerInfo->sourceNum, SLCHAN_TSTAMP,
-		                               (1000 * now.tv_sec + now.tv_nsec / 1000000));
-		if (!queue_push(args->logQ, msg)) {
+		                               args->captured / 1000000);
+		if (!source_push(args, msg)) {
 			log_error(args->pstate, "[Timer:%s] Error pushing message to queue",
 			          args->tag);
 			msg_destroy(msg);
@@ -85,7 +231,7 @@ void *timer_logging(void *ptargs) {
 		if (nstamp != lstamp) {
 			// Unix Epoch referenced timestamp
 			msg_t *epoch_msg = msg_new_timestamp(timerInfo->sourceNum, 4, nstamp);
-			if (!queue_push(args->logQ, epoch_msg)) {
+			if (!source_push(args, epoch_msg)) {
 				log_error(args->pstate,
 				          "[Timer:%s] Error pushing message to queue", args->tag);
 				msg_destroy(epoch_msg);
@@ -95,24 +241,8 @@ void *timer_logging(void *ptargs) {
 			lstamp = nstamp;
 		}
 
-		struct timespec nextIter = now;
-		nextIter.tv_nsec += incr_nsec;
-		if (nextIter.tv_nsec >= 1E9) {
-			int nsec = nextIter.tv_nsec / 1000000000;
-			nextIter.tv_nsec = nextIter.tv_nsec % 1000000000;
-			nextIter.tv_sec += nsec;
-		}
-		nextIter.tv_nsec -= (nextIter.tv_nsec % incr_nsec);
-
-		struct timespec target = {0};
-		clock_gettime(CLOCK_MONOTONIC, &now);
-		if (timespec_subtract(&target, &nextIter, &now)) {
-			// Target has passed! Update ASAP and continue
-			log_warning(args->pstate, "[Timer:%s] Deadline missed", args->tag);
-			continue;
-		} else {
-			nanosleep(&target, NULL);
-		}
+		deadline_report(&dt, args, "Timer");
+		deadline_wait(&dt);
 	}
 	pthread_exit(NULL);
 	return NULL; // Superfluous, as returning zero via pthread_exit above
@@ -150,7 +280,7 @@ void *timer_channels(void *ptargs) {
 	msg_t *m_sn = msg_new_string(timerInfo->sourceNum, SLCHAN_NAME,
 	                             strlen(timerInfo->sourceName), timerInfo->sourceName);
 
-	if (!queue_push(args->logQ, m_sn)) {
+	if (!source_push(args, m_sn)) {
 		log_error(args->pstate, "[Timer:%s] Error pushing channel name to queue",
 		          args->tag);
 		msg_destroy(m_sn);
@@ -166,7 +296,7 @@ void *timer_channels(void *ptargs) {
 
 	msg_t *m_cmap = msg_new_string_array(timerInfo->sourceNum, SLCHAN_MAP, channels);
 
-	if (!queue_push(args->logQ, m_cmap)) {
+	if (!source_push(args, m_cmap)) {
 		log_error(args->pstate, "[Timer:%s] Error pushing channel map to queue",
 		          args->tag);
 		msg_destroy(m_cmap);
@@ -234,21 +364,27 @@ bool timer_parseConfig(log_thread_args_t *lta, config_section *s) {
 
 	if ((t = config_get_key(s, "frequency"))) {
 		errno = 0;
-		tp->frequency = strtol(t->value, NULL, 0);
+		const long freq = strtol(t->value, NULL, 0);
 		if (errno) {
 			log_error(lta->pstate, "[Timer:%s] Error parsing frequency: %s", lta->tag,
 			          strerror(errno));
 			free(tp);
 			return false;
 		}
-		if (tp->frequency <= 0) {
+		if (freq <= 0 || freq > DEADLINE_LIMIT_FREQ) {
 			log_error(
 				lta->pstate,
-				"[Timer:%s] Invalid frequency requested (%d) - must be positive and non-zero",
-				lta->tag, tp->frequency);
+				"[Timer:%s] Invalid frequency requested (%ld) - must be between 1 and %d",
+				lta->tag, freq, DEADLINE_LIMIT_FREQ);
 			free(tp);
 			return false;
 		}
+		tp->frequency = freq;
+		if (tp->frequency > DEADLINE_MAX_FREQ) {
+			log_warning(lta->pstate,
+			            "[Timer:%s] Requested frequency (%d) may not be maintained reliably",
+			            lta->tag, tp->frequency);
+		}
 	}
 	t = NULL;
 
@@ -42,6 +42,60 @@
  * @{
  */
 
+//! Number of bins in deadline_timer lateness histogram
+#define DEADLINE_HIST_BINS 8
+
+//! Interval between deadline_timer statistics reports [s]
+#define DEADLINE_REPORT_INTERVAL 300
+
+//! Maximum frequency expected to be maintained reliably by deadline_timer [Hz]
+#define DEADLINE_MAX_FREQ 1000
+
+//! Maximum frequency accepted by deadline_timer (1ns period) [Hz]
+#define DEADLINE_LIMIT_FREQ 1000000000
+
+//! Periodic timer state, using absolute CLOCK_MONOTONIC deadlines
+
+/*!
+ * Deadlines are calculated from a fixed starting point and period, rather
+ * than from the time each iteration completes, so timing errors do not
+ * accumulate. See deadline_wait() for the catch-up policy.
+ *
+ * All timers share a common origin (see sample_clock_origin()), so deadlines
+ * for timers running at the same frequency coincide and can be identified by
+ * their index (see deadline_index()).
+ *
+ * Statistics are accumulated between calls to deadline_report().
+ */
+typedef struct {
+	uint64_t origin;                   //!< Shared sample clock origin [ns, CLOCK_MONOTONIC]
+	uint64_t current;                  //!< Most recent deadline reached [ns, CLOCK_MONOTONIC]
+	uint64_t next;                     //!< Next deadline [ns, CLOCK_MONOTONIC]
+	uint64_t period;                   //!< Interval between deadlines [ns]
+	uint64_t ticks;                    //!< Number of deadlines met (or late) since last report
+	uint64_t late;                     //!< Number of deadlines serviced late by more than a full period
+	uint64_t skipped;                  //!< Number of deadlines skipped entirely
+	uint64_t maxLate;                  //!< Maximum lateness since last report [ns]
+	uint64_t sumLate;                  //!< Total lateness since last report [ns]
+	uint64_t hist[DEADLINE_HIST_BINS]; //!< Lateness histogram (see deadline_wait())
+	time_t lastReport;                 //!< Time of last statistics report
+} deadline_timer;
+
+//! Shared origin for all sample clocks [ns, CLOCK_MONOTONIC]
+uint64_t sample_clock_origin(void);
+
+//! Initialise timer state, with first deadline aligned to a multiple of the period
+void deadline_init(deadline_timer *dt, const int frequency);
+
+//! Number of periods between the shared origin and the most recent deadline
+uint32_t deadline_index(const deadline_timer *dt);
+
+//! Wait for next deadline, returning number of deadlines skipped
+int deadline_wait(deadline_timer *dt);
+
+//! Log and reset timer statistics if report interval has elapsed
+void deadline_report(deadline_timer *dt, log_thread_args_t *args, const char *prefix);
+
 //! Timer specific parameters
 typedef struct {
 	uint8_t sourceNum; //!< Source ID for messages
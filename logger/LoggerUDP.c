@@ -0,0 +1,689 @@
+/*
+ *  Copyright (C) 2023 Swansea University
+ *
+ *  This file is part of the SELKIELogger suite of tools.
+ *
+ *  SELKIELogger is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation, either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  SELKIELogger is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this SELKIELogger product.
+ *  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Logger.h"
+
+#include "LoggerSignals.h"
+#include "LoggerUDP.h"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+/*!
+ * Closes the socket and releases the receive buffers, leaving the
+ * configuration intact.
+ *
+ * @param[in] udpInfo Source parameters
+ */
+static void udp_release(udp_params *udpInfo) {
+	if (udpInfo->handle >= 0) { close(udpInfo->handle); }
+	udpInfo->handle = -1;
+	if (udpInfo->bufs) {
+		for (int i = 0; i < udpInfo->batch; i++) {
+			free(udpInfo->bufs[i]);
+		}
+		free(udpInfo->bufs);
+		udpInfo->bufs = NULL;
+	}
+	free(udpInfo->ctrl);
+	udpInfo->ctrl = NULL;
+	free(udpInfo->iov);
+	udpInfo->iov = NULL;
+	free(udpInfo->msgs);
+	udpInfo->msgs = NULL;
+}
+
+/*!
+ * Opens the socket using udp_open(), then allocates the receive buffers and
+ * datagram descriptors used by udp_readable().
+ *
+ * @param[in] ptargs Pointer to log_thread_args_t
+ * @returns NULL - Exit code in ptargs->returnCode if required
+ */
+void *udp_setup(void *ptargs) {
+	log_thread_args_t *args = (log_thread_args_t *)ptargs;
+	udp_params *udpInfo = (udp_params *)args->dParams;
+
+	if (!udp_open(ptargs)) {
+		log_error(args->pstate, "[UDP:%s] Unable to open socket", args->tag);
+		args->returnCode = -1;
+		return NULL;
+	}
+
+	udpInfo->bufs = calloc(udpInfo->batch, sizeof(uint8_t *));
+	udpInfo->ctrl = calloc(udpInfo->batch, UDP_CMSG_SIZE);
+	udpInfo->iov = calloc(udpInfo->batch, sizeof(struct iovec));
+	udpInfo->msgs = calloc(udpInfo->batch, sizeof(struct mmsghdr));
+	if (!udpInfo->bufs || !udpInfo->ctrl || !udpInfo->iov || !udpInfo->msgs) {
+		log_error(args->pstate, "[UDP:%s] Unable to allocate buffers", args->tag);
+		udp_release(udpInfo);
+		args->returnCode = -1;
+		return NULL;
+	}
+
+	for (int i = 0; i < udpInfo->batch; i++) {
+		udpInfo->bufs[i] = malloc(udpInfo->maxBytes);
+		if (!udpInfo->bufs[i]) {
+			log_error(args->pstate, "[UDP:%s] Unable to allocate buffers", args->tag);
+			udp_release(udpInfo);
+			args->returnCode = -1;
+			return NULL;
+		}
+		udpInfo->iov[i].iov_base = udpInfo->bufs[i];
+		udpInfo->iov[i].iov_len = udpInfo->maxBytes;
+		udpInfo->msgs[i].msg_hdr.msg_iov = &(udpInfo->iov[i]);
+		udpInfo->msgs[i].msg_hdr.msg_iovlen = 1;
+		udpInfo->msgs[i].msg_hdr.msg_control = &(udpInfo->ctrl[i * UDP_CMSG_SIZE]);
+	}
+	udpInfo->lastReport = time(NULL);
+
+	log_info(args->pstate, 2, "[UDP:%s] Listening on port %d", args->tag, udpInfo->port);
+	args->returnCode = 0;
+	return NULL;
+}
+
+/*!
+ * Updates the source's drop counters and capture time from the control
+ * messages attached to a received datagram.
+ *
+ * Kernel timestamps are recorded against CLOCK_REALTIME, so are converted to
+ * the CLOCK_MONOTONIC base used for capture times by subtracting the age of
+ * the datagram from the time the batch was read. If no kernel timestamp is
+ * available, or the conversion gives an implausible result (e.g. after the
+ * system clock is stepped), the batch time is used.
+ *
+ * @param[in,out] udpInfo Pointer to UDP source parameters
+ * @param[in] mh Received message header
+ * @param[in] mono Batch capture time (CLOCK_MONOTONIC) [ns]
+ * @param[in] real Batch capture time (CLOCK_REALTIME) [ns]
+ * @returns Capture time for this datagram [ns]
+ */
+static uint64_t udp_datagram_info(udp_params *udpInfo, struct msghdr *mh, const uint64_t mono,
+                                  const uint64_t real) {
+	uint64_t captured = mono;
+	if (mh->msg_flags & MSG_TRUNC) { udpInfo->truncated++; }
+	if (mh->msg_flags & MSG_CTRUNC) { return captured; }
+
+	for (struct cmsghdr *cm = CMSG_FIRSTHDR(mh); cm != NULL; cm = CMSG_NXTHDR(mh, cm)) {
+		if (cm->cmsg_level != SOL_SOCKET) { continue; }
+		if (cm->cmsg_type == SO_RXQ_OVFL) {
+			uint32_t drops = 0;
+			memcpy(&drops, CMSG_DATA(cm), sizeof(drops));
+			if (drops > udpInfo->drops) { udpInfo->drops = drops; }
+		} else if (cm->cmsg_type == SCM_TIMESTAMPNS && udpInfo->kernelTimes) {
+			struct timespec ts = {0};
+			memcpy(&ts, CMSG_DATA(cm), sizeof(ts));
+			const uint64_t kt = (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+			if (kt <= real && (real - kt) < mono) { captured = mono - (real - kt); }
+		}
+	}
+	return captured;
+}
+
+/*!
+ * Reads all datagrams currently available from the socket opened by
+ * udp_setup(), up to udp_params.batch datagrams per system call, and pushes
+ * them to the queue. Each datagram is queued as a single raw data message,
+ * with no separate timestamp message. The receive time is stored as the
+ * message capture time, which is only recorded if `capturetimes` is enabled.
+ * Empty datagrams are counted but not recorded.
+ *
+ * Datagrams filling at least half of a receive buffer are handed off to the
+ * message without copying, and a new receive buffer allocated in place.
+ *
+ * Does not block, so can be called repeatedly by udp_logging() or by the
+ * reactor threads.
+ *
+ * @param[in] ptargs Pointer to log_thread_args_t
+ * @returns NULL - Exit code in ptargs->returnCode if required
+ */
+void *udp_readable(void *ptargs) {
+	log_thread_args_t *args = (log_thread_args_t *)ptargs;
+	udp_params *udpInfo = (udp_params *)args->dParams;
+
+	while (!shutdownFlag) {
+		for (int i = 0; i < udpInfo->batch; i++) {
+			udpInfo->msgs[i].msg_hdr.msg_controllen = UDP_CMSG_SIZE;
+			udpInfo->msgs[i].msg_hdr.msg_flags = 0;
+		}
+
+		errno = 0;
+		const int n = recvmmsg(udpInfo->handle, udpInfo->msgs, udpInfo->batch,
+		                       MSG_DONTWAIT, NULL);
+		if (n < 0) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) { break; }
+			log_error(args->pstate,
+			          "[UDP:%s] Unexpected error while reading from socket (%s)",
+			          args->tag, strerror(errno));
+			args->returnCode = -1;
+			return NULL;
+		}
+		if (n == 0) { break; }
+
+		struct timespec rt = {0};
+		clock_gettime(CLOCK_REALTIME, &rt);
+		const uint64_t mono = capture_time();
+		const uint64_t real = (uint64_t)rt.tv_sec * 1000000000 + rt.tv_nsec;
+
+		source_batch batch = {0};
+		for (int i = 0; i < n; i++) {
+			struct msghdr *mh = &(udpInfo->msgs[i].msg_hdr);
+			const int len = udpInfo->msgs[i].msg_len;
+			udpInfo->received++;
+			args->captured = udp_datagram_info(udpInfo, mh, mono, real);
+			if (len <= 0) { continue; }
+
+			msg_t *sm = NULL;
+			if (len >= udpInfo->maxBytes / 2) {
+				uint8_t *nb = malloc(udpInfo->maxBytes);
+				if (nb) {
+					sm = msg_new_bytes_owned(udpInfo->sourceNum, SLCHAN_RAW,
+					                         len, udpInfo->bufs[i]);
+					if (sm) {
+						udpInfo->bufs[i] = nb;
+						udpInfo->iov[i].iov_base = nb;
+					} else {
+						free(nb);
+					}
+				}
+			}
+			// Copy if buffer not handed off (small datagram or allocation failure)
+			if (sm == NULL) {
+				sm = msg_new_bytes(udpInfo->sourceNum, SLCHAN_RAW, len,
+				                   udpInfo->bufs[i]);
+			}
+			if (!source_batch_add(args, &batch, sm)) {
+				msg_destroy(sm);
+				free(sm);
+				source_batch_discard(&batch);
+				log_error(args->pstate, "[UDP:%s] Error adding datagram to batch",
+				          args->tag);
+				args->returnCode = -1;
+				return NULL;
+			}
+		}
+
+		if (!source_batch_push(args, &batch)) {
+			log_error(args->pstate, "[UDP:%s] Error pushing messages to queue",
+			          args->tag);
+			args->returnCode = -1;
+			return NULL;
+		}
+
+		if (!udp_report_drops(args)) {
+			args->returnCode = -1;
+			return NULL;
+		}
+
+		// No more data available for now
+		if (n < udpInfo->batch) { break; }
+	}
+	return NULL;
+}
+
+/*!
+ * Counts are pushed to the queue whenever they change, but warnings are only
+ * written to the log at most once per minute.
+ *
+ * @param[in] args Pointer to log_thread_args_t
+ * @returns False if messages could not be queued, true otherwise
+ */
+bool udp_report_drops(log_thread_args_t *args) {
+	udp_params *udpInfo = (udp_params *)args->dParams;
+	if (udpInfo->drops == udpInfo->reportedDrops &&
+	    udpInfo->truncated == udpInfo->reportedTrunc) {
+		return true;
+	}
+
+	if (udpInfo->drops != udpInfo->reportedDrops) {
+		msg_t *dm = msg_new_float(udpInfo->sourceNum, UDPCHAN_DROPS, udpInfo->drops);
+		if (!source_push(args, dm)) {
+			log_error(args->pstate, "[UDP:%s] Error pushing drop count to queue",
+			          args->tag);
+			msg_destroy(dm);
+			free(dm);
+			return false;
+		}
+	}
+
+	if (udpInfo->truncated != udpInfo->reportedTrunc) {
+		msg_t *tm = msg_new_float(udpInfo->sourceNum, UDPCHAN_TRUNC, udpInfo->truncated);
+		if (!source_push(args, tm)) {
+			log_error(args->pstate, "[UDP:%s] Error pushing truncation count to queue",
+			          args->tag);
+			msg_destroy(tm);
+			free(tm);
+			return false;
+		}
+	}
+
+	const time_t now = time(NULL);
+	if ((now - udpInfo->lastReport) >= 60) {
+		log_warning(args->pstate, "[UDP:%s] %u datagrams dropped, %u truncated (total)",
+		            args->tag, udpInfo->drops, udpInfo->truncated);
+		udpInfo->lastReport = now;
+	}
+	udpInfo->reportedDrops = udpInfo->drops;
+	udpInfo->reportedTrunc = udpInfo->truncated;
+	return true;
+}
+
+/*!
+ * Calls udp_readable() repeatedly until shutdown, waiting between calls for
+ * more datagrams to arrive (see source_wait()).
+ *
+ * Terminates thread in case of error.
+ *
+ * @param[in] ptargs Pointer to log_thread_args_t
+ * @returns NULL - Exit code in ptargs->returnCode if required
+ */
+void *udp_logging(void *ptargs) {
+	signalHandlersBlock();
+	log_thread_args_t *args = (log_thread_args_t *)ptargs;
+
+	log_info(args->pstate, 1, "[UDP:%s] Logging thread started", args->tag);
+
+	while (!shutdownFlag) {
+		udp_readable(ptargs);
+		if (args->returnCode != 0) { pthread_exit(&(args->returnCode)); }
+		source_wait(args, udp_handle(ptargs), 1E4);
+	}
+	pthread_exit(NULL);
+	return NULL; // Superfluous, as returning zero via pthread_exit above
+}
+
+/*!
+ * @param[in] ptargs Pointer to log_thread_args_t
+ * @returns Handle for currently opened socket
+ */
+int udp_handle(void *ptargs) {
+	log_thread_args_t *args = (log_thread_args_t *)ptargs;
+	udp_params *udpInfo = (udp_params *)args->dParams;
+	return udpInfo->handle;
+}
+
+/*!
+ * Closes socket and releases buffers.
+ *
+ * @param[in] ptargs Pointer to log_thread_args_t
+ * @returns NULL
+ */
+void *udp_shutdown(void *ptargs) {
+	log_thread_args_t *args = (log_thread_args_t *)ptargs;
+	udp_params *udpInfo = (udp_params *)args->dParams;
+
+	if (udpInfo->handle >= 0) {
+		log_info(args->pstate, 1,
+		         "[UDP:%s] %u datagrams received, %u dropped, %u truncated", args->tag,
+		         udpInfo->received, udpInfo->drops, udpInfo->truncated);
+	}
+	udp_release(udpInfo);
+	if (udpInfo->addr) {
+		free(udpInfo->addr);
+		udpInfo->addr = NULL;
+	}
+	if (udpInfo->iface) {
+		free(udpInfo->iface);
+		udpInfo->iface = NULL;
+	}
+	if (udpInfo->sourceName) {
+		free(udpInfo->sourceName);
+		udpInfo->sourceName = NULL;
+	}
+	return NULL;
+}
+
+/*!
+ * @param[in] name Host name or address to look up (NULL for any address)
+ * @param[out] out Resolved address
+ * @returns True on success, false if name could not be resolved
+ */
+static bool udp_resolve(const char *name, struct in_addr *out) {
+	if (name == NULL) {
+		out->s_addr = htonl(INADDR_ANY);
+		return true;
+	}
+	struct addrinfo hints = {.ai_family = AF_INET, .ai_socktype = SOCK_DGRAM};
+	struct addrinfo *res = NULL;
+	if (getaddrinfo(name, NULL, &hints, &res) != 0 || res == NULL) { return false; }
+	*out = ((struct sockaddr_in *)res->ai_addr)->sin_addr;
+	freeaddrinfo(res);
+	return true;
+}
+
+/*!
+ * Closes any existing socket, then opens and binds a new non-blocking socket
+ * using the details in udp_params.
+ *
+ * If the configured address is a multicast group, the socket is bound to the
+ * group address and joins the group on the configured interface. Otherwise,
+ * the socket is bound to the configured local address (or all addresses if
+ * not specified).
+ *
+ * Kernel drop counts (SO_RXQ_OVFL) are always requested, and kernel receive
+ * timestamps (SO_TIMESTAMPNS) if enabled.
+ *
+ * @param[in] ptargs Pointer to log_thread_args_t
+ * @returns True on success, false on error
+ */
+bool udp_open(void *ptargs) {
+	log_thread_args_t *args = (log_thread_args_t *)ptargs;
+	udp_params *udpInfo = (udp_params *)args->dParams;
+
+	if (udpInfo->port <= 0 || udpInfo->port > 65535) {
+		log_error(args->pstate, "[UDP:%s] Bad port number provided", args->tag);
+		return false;
+	}
+
+	if (udpInfo->handle >= 0) { close(udpInfo->handle); }
+	udpInfo->handle = -1;
+
+	struct sockaddr_in localSA = {.sin_family = AF_INET, .sin_port = htons(udpInfo->port)};
+	if (!udp_resolve(udpInfo->addr, &(localSA.sin_addr))) {
+		log_error(args->pstate, "[UDP:%s] Unable to resolve address %s", args->tag,
+		          udpInfo->addr);
+		return false;
+	}
+
+	errno = 0;
+	udpInfo->handle = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (udpInfo->handle < 0) {
+		log_error(args->pstate, "[UDP:%s] Unable to create socket: %s", args->tag,
+		          strerror(errno));
+		return false;
+	}
+
+	const bool multicast = IN_MULTICAST(ntohl(localSA.sin_addr.s_addr));
+	int enable = 1;
+	errno = 0;
+	if ((multicast && setsockopt(udpInfo->handle, SOL_SOCKET, SO_REUSEADDR, &enable,
+	                             sizeof(enable))) ||
+	    setsockopt(udpInfo->handle, SOL_SOCKET, SO_RXQ_OVFL, &enable, sizeof(enable)) ||
+	    (udpInfo->kernelTimes && setsockopt(udpInfo->handle, SOL_SOCKET, SO_TIMESTAMPNS,
+	                                        &enable, sizeof(enable)))) {
+		log_error(args->pstate, "[UDP:%s] Unable to set socket options: %s", args->tag,
+		          strerror(errno));
+		close(udpInfo->handle);
+		udpInfo->handle = -1;
+		return false;
+	}
+
+	if (udpInfo->rcvbuf > 0 && setsockopt(udpInfo->handle, SOL_SOCKET, SO_RCVBUF,
+	                                      &(udpInfo->rcvbuf), sizeof(udpInfo->rcvbuf))) {
+		// Not fatal, the system default will be used
+		log_warning(args->pstate, "[UDP:%s] Unable to set receive buffer size: %s",
+		            args->tag, strerror(errno));
+	}
+
+	errno = 0;
+	if (bind(udpInfo->handle, (struct sockaddr *)&localSA, sizeof(localSA))) {
+		log_error(args->pstate, "[UDP:%s] Unable to bind to port %d: %s", args->tag,
+		          udpInfo->port, strerror(errno));
+		close(udpInfo->handle);
+		udpInfo->handle = -1;
+		return false;
+	}
+
+	if (multicast) {
+		struct ip_mreq mreq = {.imr_multiaddr = localSA.sin_addr};
+		if (!udp_resolve(udpInfo->iface, &(mreq.imr_interface))) {
+			log_error(args->pstate, "[UDP:%s] Unable to resolve interface address %s",
+			          args->tag, udpInfo->iface);
+			close(udpInfo->handle);
+			udpInfo->handle = -1;
+			return false;
+		}
+		errno = 0;
+		if (setsockopt(udpInfo->handle, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq,
+		               sizeof(mreq))) {
+			log_error(args->pstate, "[UDP:%s] Unable to join multicast group %s: %s",
+			          args->tag, udpInfo->addr, strerror(errno));
+			close(udpInfo->handle);
+			udpInfo->handle = -1;
+			return false;
+		}
+	}
+	return true;
+}
+
+/*!
+ * @returns device_callbacks for UDP sources
+ */
+device_callbacks udp_getCallbacks() {
+	device_callbacks cb = {.startup = &udp_setup,
+	                       .logging = &udp_logging,
+	                       .shutdown = &udp_shutdown,
+	                       .channels = &udp_channels,
+	                       .readable = &udp_readable,
+	                       .handle = &udp_handle};
+	return cb;
+}
+
+/*!
+ * @returns Default parameters for UDP sources
+ */
+udp_params udp_getParams() {
+	udp_params up = {.sourceName = NULL,
+	                 .sourceNum = SLSOURCE_EXT,
+	                 .addr = NULL,
+	                 .iface = NULL,
+	                 .port = -1,
+	                 .handle = -1,
+	                 .maxBytes = 2048,
+	                 .batch = 32,
+	                 .rcvbuf = 0,
+	                 .kernelTimes = false};
+	return up;
+}
+
+/*!
+ * Populate list of channels and push to queue as a map message
+ *
+ * @param[in] ptargs Pointer to log_thread_args_t
+ * @returns NULL - Exit code in ptargs->returnCode if required
+ */
+void *udp_channels(void *ptargs) {
+	log_thread_args_t *args = (log_thread_args_t *)ptargs;
+	udp_params *udpInfo = (udp_params *)args->dParams;
+
+	msg_t *m_sn = msg_new_string(udpInfo->sourceNum, SLCHAN_NAME, strlen(udpInfo->sourceName),
+	                             udpInfo->sourceName);
+
+	if (!source_push(args, m_sn)) {
+		log_error(args->pstate, "[UDP:%s] Error pushing channel name to queue", args->tag);
+		msg_destroy(m_sn);
+		args->returnCode = -1;
+		pthread_exit(&(args->returnCode));
+	}
+
+	strarray *channels = sa_new(6);
+	sa_create_entry(channels, SLCHAN_NAME, 4, "Name");
+	sa_create_entry(channels, SLCHAN_MAP, 8, "Channels");
+	sa_create_entry(channels, SLCHAN_TSTAMP, 9, "Timestamp");
+	sa_create_entry(channels, SLCHAN_RAW, 8, "Raw Data");
+	sa_create_entry(channels, UDPCHAN_DROPS, 7, "Dropped");
+	sa_create_entry(channels, UDPCHAN_TRUNC, 9, "Truncated");
+
+	msg_t *m_cmap = msg_new_string_array(udpInfo->sourceNum, SLCHAN_MAP, channels);
+
+	if (!source_push(args, m_cmap)) {
+		log_error(args->pstate, "[UDP:%s] Error pushing channel map to queue", args->tag);
+		msg_destroy(m_cmap);
+		sa_destroy(channels);
+		free(channels);
+		args->returnCode = -1;
+		pthread_exit(&(args->returnCode));
+	}
+
+	sa_destroy(channels);
+	free(channels);
+	return NULL;
+}
+
+/*!
+ * @param[in] lta Pointer to log_thread_args_t
+ * @param[in] s Pointer to config_section to be parsed
+ * @returns True on success, false on error
+ */
+bool udp_parseConfig(log_thread_args_t *lta, config_section *s) {
+	if (lta->dParams) {
+		log_error(lta->pstate, "[UDP:%s] Refusing to reconfigure", lta->tag);
+		return false;
+	}
+
+	udp_params *udp = calloc(1, sizeof(udp_params));
+	if (!udp) {
+		log_error(lta->pstate, "[UDP:%s] Unable to allocate memory for device parameters",
+		          lta->tag);
+		return false;
+	}
+	(*udp) = udp_getParams();
+
+	config_kv *t = NULL;
+	if ((t = config_get_key(s, "address"))) { udp->addr = config_qstrdup(t->value); }
+	t = NULL;
+
+	if ((t = config_get_key(s, "interface"))) { udp->iface = config_qstrdup(t->value); }
+	t = NULL;
+
+	if ((t = config_get_key(s, "port"))) {
+		errno = 0;
+		udp->port = strtol(t->value, NULL, 0);
+		if (errno) {
+			log_error(lta->pstate, "[UDP:%s] Error parsing port number: %s", lta->tag,
+			          strerror(errno));
+			free(udp);
+			return false;
+		}
+	}
+	t = NULL;
+
+	if (udp->port <= 0 || udp->port > 65535) {
+		log_error(lta->pstate, "[UDP:%s] A valid port number must be provided", lta->tag);
+		free(udp);
+		return false;
+	}
+
+	if ((t = config_get_key(s, "name"))) {
+		udp->sourceName = config_qstrdup(t->value);
+	} else {
+		// Must set a name, so nick the tag value
+		udp->sourceName = strdup(lta->tag);
+	}
+	t = NULL;
+
+	if ((t = config_get_key(s, "sourcenum"))) {
+		errno = 0;
+		int sn = strtol(t->value, NULL, 0);
+		if (errno) {
+			log_error(lta->pstate, "[UDP:%s] Error parsing source number: %s",
+			          lta->tag, strerror(errno));
+			free(udp);
+			return false;
+		}
+		if (sn < 0) {
+			log_error(lta->pstate, "[UDP:%s] Invalid source number (%s)", lta->tag,
+			          t->value);
+			free(udp);
+			return false;
+		}
+		if (sn < 10) {
+			udp->sourceNum += sn;
+		} else {
+			udp->sourceNum = sn;
+			if (sn < SLSOURCE_EXT || sn > (SLSOURCE_EXT + 0x0F)) {
+				log_warning(
+					lta->pstate,
+					"[UDP:%s] Unexpected Source ID number (0x%02x)- this may cause analysis problems",
+					lta->tag, sn);
+			}
+		}
+	}
+	t = NULL;
+
+	if ((t = config_get_key(s, "maxbytes"))) {
+		errno = 0;
+		udp->maxBytes = strtol(t->value, NULL, 0);
+		if (errno) {
+			log_error(lta->pstate, "[UDP:%s] Error parsing maximum datagram size: %s",
+			          lta->tag, strerror(errno));
+			free(udp);
+			return false;
+		}
+		if (udp->maxBytes <= 0 || udp->maxBytes > 65535) {
+			log_error(lta->pstate,
+			          "[UDP:%s] Invalid maximum datagram size specified (%d)",
+			          lta->tag, udp->maxBytes);
+			free(udp);
+			return false;
+		}
+	}
+	t = NULL;
+
+	if ((t = config_get_key(s, "batch"))) {
+		errno = 0;
+		udp->batch = strtol(t->value, NULL, 0);
+		if (errno) {
+			log_error(lta->pstate, "[UDP:%s] Error parsing batch size: %s", lta->tag,
+			          strerror(errno));
+			free(udp);
+			return false;
+		}
+		if (udp->batch <= 0 || udp->batch > UDP_MAX_BATCH) {
+			log_error(
+				lta->pstate,
+				"[UDP:%s] Invalid batch size specified (%d is not in range 1-%d)",
+				lta->tag, udp->batch, UDP_MAX_BATCH);
+			free(udp);
+			return false;
+		}
+	}
+	t = NULL;
+
+	if ((t = config_get_key(s, "rcvbuf"))) {
+		errno = 0;
+		udp->rcvbuf = strtol(t->value, NULL, 0);
+		if (errno || udp->rcvbuf < 0) {
+			log_error(lta->pstate, "[UDP:%s] Invalid receive buffer size: %s",
+			          lta->tag, t->value);
+			free(udp);
+			return false;
+		}
+	}
+	t = NULL;
+
+	if ((t = config_get_key(s, "kerneltimes"))) {
+		int tmp = config_parse_bool(t->value);
+		if (tmp < 0) {
+			log_error(lta->pstate,
+			          "[UDP:%s] Invalid value provided for 'kerneltimes': %s",
+			          lta->tag, t->value);
+			free(udp);
+			return false;
+		}
+		udp->kernelTimes = (tmp > 0);
+	}
+	t = NULL;
+
+	lta->dParams = udp;
+	return true;
+}
@@ -0,0 +1,117 @@
+/*
+ *  Copyright (C) 2023 Swansea University
+ *
+ *  This file is part of the SELKIELogger suite of tools.
+ *
+ *  SELKIELogger is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation, either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  SELKIELogger is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this SELKIELogger product.
+ *  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SL_LOGGER_UDP_H
+#define SL_LOGGER_UDP_H
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <sys/socket.h>
+
+#include "SELKIELoggerBase.h"
+
+//! @file
+
+/*!
+ * @addtogroup loggerUDP Logger: UDP datagram support
+ * @ingroup logger
+ *
+ * Adds support for recording datagrams received on a unicast or multicast UDP
+ * port. Each datagram is recorded as a single raw data message, preserving
+ * the boundaries between them.
+ *
+ * @{
+ */
+
+//! Channel ID for dropped datagram count
+#define UDPCHAN_DROPS 4
+
+//! Channel ID for truncated datagram count
+#define UDPCHAN_TRUNC 5
+
+//! Maximum number of datagrams to receive in a single call
+#define UDP_MAX_BATCH 1024
+
+//! Control message buffer size required for each datagram
+#define UDP_CMSG_SIZE (CMSG_SPACE(sizeof(struct timespec)) + CMSG_SPACE(sizeof(uint32_t)))
+
+//! UDP source specific parameters
+typedef struct {
+	char *sourceName;         //!< User defined name for this source
+	uint8_t sourceNum;        //!< Source ID for messages
+	char *addr;               //!< Local or multicast group address (NULL for any)
+	char *iface;              //!< Local interface address for multicast groups (NULL for any)
+	int port;                 //!< Local port number
+	int handle;               //!< Handle for currently opened socket
+	int maxBytes;             //!< Maximum datagram size (larger datagrams are truncated)
+	int batch;                //!< Maximum number of datagrams to receive per call
+	int rcvbuf;               //!< Socket receive buffer size (0 for system default)
+	bool kernelTimes;         //!< Use kernel receive timestamps as capture times
+	uint8_t **bufs;           //!< Receive buffers (batch x maxBytes, allocated by udp_setup())
+	uint8_t *ctrl;            //!< Control message buffers (batch x UDP_CMSG_SIZE)
+	struct iovec *iov;        //!< Receive buffer descriptors
+	struct mmsghdr *msgs;     //!< Datagram descriptors for recvmmsg()
+	uint32_t received;        //!< Datagrams received
+	uint32_t drops;           //!< Datagrams dropped by the kernel (from SO_RXQ_OVFL)
+	uint32_t truncated;       //!< Datagrams truncated to fit receive buffers
+	uint32_t reportedDrops;   //!< Dropped count when last reported
+	uint32_t reportedTrunc;   //!< Truncated count when last reported
+	time_t lastReport;        //!< Time drop counts last logged
+} udp_params;
+
+//! Device thread setup
+void *udp_setup(void *ptargs);
+
+//! UDP source main logging loop
+void *udp_logging(void *ptargs);
+
+//! Read and queue all currently available datagrams
+void *udp_readable(void *ptargs);
+
+//! Return current socket handle
+int udp_handle(void *ptargs);
+
+//! UDP source shutdown
+void *udp_shutdown(void *ptargs);
+
+//! Channel map
+void *udp_channels(void *ptargs);
+
+//! Open and bind socket, joining multicast group if required
+bool udp_open(void *ptargs);
+
+//! Push updated drop counters to the queue, if changed
+bool udp_report_drops(log_thread_args_t *args);
+
+//! Fill out device callback functions for logging
+device_callbacks udp_getCallbacks(void);
+
+//! Fill out default UDP source parameters
+udp_params udp_getParams(void);
+
+//! Take a configuration section and parse parameters
+bool udp_parseConfig(log_thread_args_t *lta, config_section *s);
+
+//! @}
+#endif
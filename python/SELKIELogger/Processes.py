@@ -122,11 +122,8 @@ def extractFromFile(datfile, output, source, channel, raw=True):
     log.info(f"Writing data out to {cf}")
 
     with open(cf, "wb") as outFile:
-        for m in df.messages(source=source, channel=channel):
-            if raw:
-                outFile.write(m.Data)
-            else:
-                outFile.write(m.pack())
+        count = df.extract(outFile, source=source, channel=channel, raw=raw)
+    log.info(f"{count} messages extracted")
 
     log.info(f"Data output to {cf}")
 
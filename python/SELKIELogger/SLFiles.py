@@ -17,14 +17,20 @@
 # If not, see <http://www.gnu.org/licenses/>.
 
 import logging
+import mmap
 import msgpack
 import os
 import pandas as pd
 import numpy as np
 
-from numbers import Number
+from numbers import Integral, Number
 from .SLMessages import IDs, SLMessage, SLMessageSink
 
+try:
+    from . import _SLDecode
+except ImportError:
+    _SLDecode = None
+
 ## @file
 
 ## File wide logger instance
@@ -103,6 +109,241 @@ class VarFile:
         Console().print(t)
 
 
+class ColumnAccumulator:
+    """!
+    Accumulate field values into columns, with one row per timestep.
+
+    Numerical fields are stored in numpy float64 arrays, with missing values
+    filled with NaN. If a field receives any other type of value, its column
+    is converted to an object array with missing values filled with None.
+    Columns are only allocated once a value has been received for that field,
+    and all arrays grow as required.
+
+    Values are written to the current (open) row until endRow() is called.
+    """
+
+    def __init__(self, columns, initialSize=1024):
+        """!
+        @param columns Ordered list of field names
+        @param initialSize Number of rows to allocate initially
+        """
+        ## Ordered list of field names
+        self._columns = list(columns)
+        ## Number of rows currently allocated
+        self._size = max(int(initialSize), 1)
+        ## Number of completed rows
+        self._rows = 0
+        ## Row index (timestamp) values
+        self._index = np.zeros(self._size, dtype=np.int64)
+        ## Column arrays, keyed by field name
+        self._data = {}
+        ## Boolean arrays indicating which cells have been set, keyed by field name
+        self._set = {}
+        ## Flag per field indicating that only integer values have been received
+        self._ints = {}
+
+    def __len__(self):
+        """! @returns Number of completed rows"""
+        return self._rows
+
+    @staticmethod
+    def _fill(dtype):
+        """! @returns Missing value marker for columns of type dtype"""
+        return None if dtype == object else np.nan
+
+    def _grow(self):
+        """! Double the number of rows allocated for each column"""
+        extra = self._size
+        self._size += extra
+        self._index = np.concatenate([self._index, np.zeros(extra, dtype=np.int64)])
+        for k, v in self._data.items():
+            self._data[k] = np.concatenate(
+                [v, np.full(extra, self._fill(v.dtype), dtype=v.dtype)]
+            )
+            self._set[k] = np.concatenate([self._set[k], np.zeros(extra, dtype=bool)])
+
+    def _promote(self, name):
+        """! Convert numerical column to an object column, retaining values"""
+        old = self._data[name]
+        new = np.full(self._size, None, dtype=object)
+        mask = self._set[name]
+        new[mask] = old[mask]
+        self._data[name] = new
+
+    def set(self, name, value):
+        """!
+        Set field value for the current row, replacing any existing value.
+        @param name Field name
+        @param value New value. None will clear any existing value.
+        """
+        row = self._rows
+        col = self._data.get(name)
+        if value is None:
+            if col is not None:
+                col[row] = self._fill(col.dtype)
+                self._set[name][row] = False
+            return
+
+        numeric = isinstance(value, Number) and not isinstance(value, (bool, complex))
+        if col is None:
+            dtype = np.float64 if numeric else object
+            col = np.full(self._size, self._fill(dtype), dtype=dtype)
+            self._data[name] = col
+            self._set[name] = np.zeros(self._size, dtype=bool)
+        elif not numeric and col.dtype != object:
+            self._promote(name)
+            col = self._data[name]
+
+        col[row] = value
+        self._set[name][row] = True
+        self._ints[name] = self._ints.get(name, True) and isinstance(value, Integral)
+
+    def endRow(self, index):
+        """!
+        Complete the current row and start a new one.
+        @param index Index (timestamp) value for the completed row
+        """
+        self._index[self._rows] = index
+        self._rows += 1
+        if self._rows >= self._size:
+            self._grow()
+
+    def discardRow(self):
+        """! Remove any values from the current (incomplete) row"""
+        row = self._rows
+        for k, v in self._data.items():
+            v[row] = self._fill(v.dtype)
+            self._set[k][row] = False
+
+    def clear(self):
+        """! Remove all rows, retaining allocated arrays for reuse"""
+        for k, v in self._data.items():
+            v[: self._rows + 1] = self._fill(v.dtype)
+            self._set[k][: self._rows + 1] = False
+        self._ints.clear()
+        self._rows = 0
+
+    def setRows(self, index):
+        """!
+        Replace any existing contents with a set of completed rows, which can
+        then be populated using setColumn().
+        @param index Index (timestamp) values for each row
+        """
+        self.clear()
+        rows = len(index)
+        while self._size <= rows:
+            self._grow()
+        self._index[:rows] = index
+        self._rows = rows
+
+    def setColumn(self, name, rows, values, integral=False):
+        """!
+        Set values for a single field in completed rows.
+
+        Numerical arrays are stored directly. Other values are handled as in
+        set(), except that None values are treated as missing.
+        @param name Field name
+        @param rows Array of row numbers
+        @param values Numerical array, or list of values, for each row
+        @param integral True if all numerical values were received as integers
+        """
+        if isinstance(values, np.ndarray) and values.dtype.kind in "fiu":
+            col = np.full(self._size, np.nan, dtype=np.float64)
+            col[rows] = values
+            mask = np.zeros(self._size, dtype=bool)
+            mask[rows] = True
+            self._data[name] = col
+            self._set[name] = mask
+            self._ints[name] = bool(integral)
+            return
+
+        values = list(values)
+        present = [v is not None for v in values]
+        numeric = all(
+            isinstance(v, Number) and not isinstance(v, (bool, complex))
+            for v, p in zip(values, present)
+            if p
+        )
+        dtype = np.float64 if numeric else object
+        col = np.full(self._size, self._fill(dtype), dtype=dtype)
+        mask = np.zeros(self._size, dtype=bool)
+        for r, v, p in zip(rows, values, present):
+            if p:
+                col[r] = v
+                mask[r] = True
+        self._data[name] = col
+        self._set[name] = mask
+        self._ints[name] = numeric and all(
+            isinstance(v, Integral) for v, p in zip(values, present) if p
+        )
+
+    def column(self, name):
+        """!
+        Get completed rows for a single field.
+
+        Numerical columns that only contain integers and have no missing values
+        are returned with an integer type. Object columns are returned as lists
+        so that pandas can infer a suitable type, and fields with no values in
+        the completed rows are returned as None.
+        @param name Field name
+        @returns Array, list or None
+        """
+        col = self._data.get(name)
+        rows = self._rows
+        if col is None or not self._set[name][:rows].any():
+            return None
+        if col.dtype == object:
+            return col[:rows].tolist()
+        if self._ints.get(name) and self._set[name][:rows].all():
+            return col[:rows].astype(np.int64)
+        return col[:rows].copy()
+
+    def index(self):
+        """! @returns Array of index values for completed rows"""
+        return self._index[: self._rows].copy()
+
+    def records(self):
+        """!
+        Get completed rows as a list of (index, record) tuples.
+        Missing values are represented as None in each record.
+        @returns List of tuples
+        """
+        out = [(int(ix), {}) for ix in self._index[: self._rows]]
+        for name in self._columns:
+            col = self._data.get(name)
+            for r in range(self._rows):
+                if col is not None and self._set[name][r]:
+                    v = col[r]
+                    if col.dtype != object:
+                        v = int(v) if self._ints.get(name) else float(v)
+                    out[r][1][name] = v
+                else:
+                    out[r][1][name] = None
+        return out
+
+    def frame(self):
+        """!
+        Build DataFrame from completed rows, with columns in the order
+        specified when this instance was created. If there are no completed
+        rows, an empty DataFrame with no columns is returned.
+        @returns pandas.DataFrame
+        """
+        rows = self._rows
+        if rows == 0:
+            # Equivalent to a frame built from an empty list of records
+            return pd.DataFrame(index=[])
+
+        data = {}
+        for name in self._columns:
+            col = self.column(name)
+            if col is None:
+                col = np.full(rows, None, dtype=object)
+            data[name] = pd.Series(col, copy=False)
+        ndf = pd.DataFrame(data, columns=self._columns)
+        ndf.index = self.index()
+        return ndf
+
+
 class DatFile:
     """!
     Represent a SELKIELogger data file and associated common operations.
@@ -126,6 +367,8 @@ class DatFile:
             self._pcs = int(pcs, 0)
         ## Source/Channel Map
         self._sm = None
+        ## Native decoder field mappings (see prepConverters())
+        self._native = None
         ## File data records (once parsed)
         self._records = None
 
@@ -164,6 +407,19 @@ class DatFile:
         except:
             return np.nan
 
+    @staticmethod
+    def tryIndex(value, index):
+        """!
+        Return a single entry from a packed numerical array.
+        @param value Input array
+        @param index Index of entry to be returned
+        @returns Floating point value or np.nan if entry not present
+        """
+        try:
+            return float(value[index])
+        except (IndexError, TypeError, ValueError):
+            return np.nan
+
     def prepConverters(self, force=False, includeTS=False):
         """!
         Generate and cache functions to convert each channel into defined
@@ -182,6 +438,9 @@ class DatFile:
         ```
         Where input is an input SLMessage
 
+        Where a field can be generated directly from the values returned by
+        the native decoder, this is also recorded (see processColumns()).
+
         @param force Regenerate fields rather than using cached values
         @param includeTS Retain timestamp field as data column as well as index
         @returns Collection of conversion functions and field names
@@ -195,6 +454,9 @@ class DatFile:
         simpleSources += [x for x in range(IDs.SLSOURCE_ADC, IDs.SLSOURCE_ADC + 0x10)]
         simpleSources += [x for x in range(IDs.SLSOURCE_EXT, IDs.SLSOURCE_EXT + 0x07)]
 
+        # For each field: None (whole value), an array index, or False if the
+        # conversion function must be used
+        native = {}
         fields = {}
         for src in self._sm:
             fields[src] = {}
@@ -204,10 +466,12 @@ class DatFile:
                         [f"Timestamp:0x{self._pcs:02x}"],
                         [lambda x: x.Data],
                     ]
+                    native[(src, 0x02)] = [None]
                 cid = 0
                 for chan in list(self._sm[src]):
                     if cid > IDs.SLCHAN_TSTAMP and chan != "":
                         fields[src][cid] = [[f"{chan}:0x{src:02x}"], [lambda x: x.Data]]
+                        native[(src, cid)] = [None]
                     cid += 1
             elif src in range(IDs.SLSOURCE_GPS, IDs.SLSOURCE_GPS + 0x10):
                 cid = 0
@@ -217,6 +481,7 @@ class DatFile:
                             [f"Timestamp:0x{src:02x}"],
                             [lambda x: x.Data],
                         ]
+                        native[(src, cid)] = [None]
                         cid += 1
                     elif cid in [IDs.SLCHAN_NAME, IDs.SLCHAN_MAP, IDs.SLCHAN_RAW]:
                         # Don't include in frame outputs
@@ -240,6 +505,7 @@ class DatFile:
                                 lambda x: x.Data[5],
                             ],
                         ]
+                        native[(src, cid)] = [0, 1, 2, 4, 5]
                         cid += 1
                     elif cid == 5:
                         # Velocity
@@ -261,6 +527,7 @@ class DatFile:
                                 lambda x: x.Data[6],
                             ],
                         ]
+                        native[(src, cid)] = [0, 1, 2, 5, 4, 6]
                         cid += 1
                     elif cid == 6:
                         # Date/Time
@@ -276,12 +543,14 @@ class DatFile:
                                 lambda x: f"{x.Data[7]:09.0f}",
                             ],
                         ]
+                        native[(src, cid)] = [False, False, False]
                         cid += 1
                     elif self._sm[src][cid] == "":
                         cid += 1
                         continue
                     else:
                         fields[src][cid] = [[f"{chan}:0x{src:02x}"], [lambda x: x.Data]]
+                        native[(src, cid)] = [None]
                         cid += 1
             elif src in range(IDs.SLSOURCE_MQTT, IDs.SLSOURCE_MQTT + 0x07):
                 cid = 0
@@ -323,16 +592,41 @@ class DatFile:
                             [f"Timestamp:0x{src:02x}"],
                             [lambda x: x.Data],
                         ]
+                        native[(src, cid)] = [None]
+                        cid += 1
+                    elif chan.startswith(IDs.SLCHAN_PACKED_PREFIX):
+                        # Packed channel: one value per comma separated name
+                        names = chan[len(IDs.SLCHAN_PACKED_PREFIX) :].split(",")
+                        fields[src][cid] = [
+                            [f"{n}:0x{src:02x}" for n in names],
+                            [
+                                lambda x, i=i: self.tryIndex(x.Data, i)
+                                for i in range(len(names))
+                            ],
+                        ]
+                        native[(src, cid)] = list(range(len(names)))
                         cid += 1
                     else:
                         fields[src][cid] = [[f"{chan}:0x{src:02x}"], [lambda x: x.Data]]
+                        native[(src, cid)] = [None]
                         cid += 1
+            elif src == IDs.SLSOURCE_CAPT:
+                # Capture times use the described source ID as the channel
+                # number, so only include sources present in this file
+                for cid in self._sm:
+                    if cid < IDs.SLSOURCE_TIMER or cid >= IDs.SLCHAN_LOG_INFO:
+                        continue
+                    if cid == IDs.SLSOURCE_CAPT:
+                        continue
+                    fields[src][cid] = [[f"Capture:0x{cid:02x}"], [lambda x: x.Data]]
+                    native[(src, cid)] = [None]
             else:
                 if src >= 0x02:
                     log.info(
                         f"No conversion routine known for source 0x{src:02x} ({self._sm[src]})"
                     )
         self._fields = fields
+        self._native = native
         self._columnList = []
         for _, channels in self._fields.items():
             for _, c in channels.items():
@@ -403,60 +697,307 @@ class DatFile:
 
         datFile.close()
 
-    def processMessages(self, includeTS=False, force=False, chunkSize=100000):
+    def processColumns(
+        self, includeTS=False, force=False, chunkSize=100000, native=None
+    ):
         """!
-        Process messages and return. Will yield data in chunks.
+        Process messages into columns, yielding data in chunks.
+
+        Messages are grouped by the primary clock source timestamp that follows
+        them, and each group forms a single row. Where multiple values for a
+        single field are received, the last value received will be stored.
+
+        The same ColumnAccumulator instance is yielded for each chunk and is
+        cleared once processing resumes, so each chunk must be used (e.g. by
+        calling ColumnAccumulator.frame()) before requesting the next.
+
+        The native decoder is used if available, unless the file contains
+        values that it can't represent (see nativeColumns()), in which case
+        the file is processed in Python instead.
         @param includeTS Passed to prepConverters()
         @param force Passed to prepConverters()
         @param chunkSize Yield records after this many timestamps
-        @returns List of tuples containing timestamp and dictionary of records
+        @param native Force (True) or prevent (False) use of the native decoder
+        @returns ColumnAccumulator instance containing the current chunk
         """
-        if self._records:
-            log.error("Some records already cached - discarding")
-            del self._records
-
         fields = self.prepConverters(includeTS=includeTS, force=force)
         log.debug(fields)
         log.debug(f"Primary clock source: 0x{self._pcs:02x} [{self._sm[self._pcs]}]")
 
-        self._records = []
-        stack = []
+        if native is None:
+            native = _SLDecode is not None
+        elif native and _SLDecode is None:
+            raise RuntimeError("Native decoder not available")
+
+        if native:
+            chunks = self.nativeColumns(chunkSize)
+            if chunks is not None:
+                yield from chunks
+                return
+            log.info(
+                "Unable to use native decoder for this file - using Python decoder"
+            )
+
+        acc = ColumnAccumulator(self._columnList, initialSize=min(chunkSize, 1024))
         currentTime = 0
         nextTime = 0
-        count = 0
+        pending = 0
         for msg in self.messages():
-
-            count += 1
-
             if msg.SourceID == self._pcs and msg.ChannelID == IDs.SLCHAN_TSTAMP:
                 nextTime = msg.Data
-            ##          log.debug(f"New timestep: {nextTime} (from {currentTime}, delta {nextTime - currentTime})")
-            ##         // If we accumulate too many messages (bad clock choice?), force a record to be output
-            ##         if (currMsg >= (ctsLimit - 1) && (timestep == nextstep)) {
-            ##             log_warning(&state, "Too many messages processed during %d. Forcing output.", timestep);
-            ##             nextstep++;
-            ##         }
+
             if nextTime != currentTime:
-                tsdf = self.buildRecord(stack)
-                stack.clear()
                 currentTime = nextTime
-                self._records.extend([(currentTime, tsdf)])
-                numTS = len(self._records)
-                if (numTS % chunkSize) == 0:
-                    yield self._records
-                    self._records.clear()
-                    tsdf.clear()
+                acc.endRow(currentTime)
+                pending = 0
+                if len(acc) >= chunkSize:
+                    yield acc
+                    acc.clear()
                 continue
 
-            stack.extend([msg])
+            pending += 1
+            try:
+                names, funcs = fields[msg.SourceID][msg.ChannelID]
+            except KeyError:
+                continue
+            dat = [f(msg) for f in funcs]
+            for name, value in zip(names, dat):
+                acc.set(name, value)
 
-        ## Out of messages, so yield remaining processes timesteps
-        yield self._records
+        acc.discardRow()
+        ## Out of messages, so yield remaining processed timesteps
+        yield acc
 
         # Out of messages and no more timestamps available
-        log.debug(
-            f"Out of data - {len(stack)} messages abandoned beyond last timestanp"
-        )
+        log.debug(f"Out of data - {pending} messages abandoned beyond last timestamp")
+
+    def nativeColumns(self, chunkSize=100000):
+        """!
+        Process file into columns using the native decoder, producing the same
+        output as processColumns().
+
+        Fields are filled directly from the decoded arrays where possible, and
+        the conversion functions from prepConverters() are applied to each
+        value otherwise.
+
+        The native decoder can't be used if any fields require the original
+        message (e.g. MQTT values, which may be strings), if any value was not
+        numerical, or if the primary clock timestamps are not strictly
+        increasing. The primary clock timestamp can't be included as a field.
+        @param chunkSize Number of rows in each chunk
+        @returns Iterator over ColumnAccumulator instances, or None if the
+        native decoder can't be used for this file
+        """
+        if _SLDecode is None or self._fields is None:
+            return None
+
+        clock = (self._pcs, IDs.SLCHAN_TSTAMP)
+        keys = [(s, c) for s in self._fields for c in self._fields[s]]
+        if clock in keys or any(k not in self._native for k in keys):
+            return None
+
+        count, raw = _SLDecode.decode(os.fsencode(self._fn), keys + [clock], self._pcs)
+        log.debug(f"{count} messages read from {self._fn}")
+
+        # Each clock value is tagged with the following timestamp, so the
+        # final timestamp only appears as a tag
+        ts, vals, _, _, other = raw[clock]
+        ts = np.frombuffer(ts, dtype=np.uint32).astype(np.int64)
+        index = np.frombuffer(vals, dtype=np.float64).astype(np.int64)
+        if len(ts):
+            index = np.append(index, ts[-1])
+        if other or (len(index) and (index[0] == 0 or np.any(np.diff(index) <= 0))):
+            return None
+
+        class Value:
+            """! Minimal stand in for SLMessage, for use with conversion functions"""
+
+            __slots__ = ["Data"]
+
+            def __init__(self, data):
+                self.Data = data
+
+        columns = {}
+        for k in keys:
+            ts, vals, width, ints, other = raw[k]
+            if other:
+                return None
+            rows = np.searchsorted(index, np.frombuffer(ts, dtype=np.uint32))
+            vals = np.frombuffer(vals, dtype=np.float64).reshape(-1, width)
+
+            # Last value received in each row wins
+            last = np.append(rows[1:] != rows[:-1], True) if len(rows) else []
+            rows = rows[last]
+            vals = vals[last]
+
+            names, funcs = self._fields[k[0]][k[1]]
+            for name, spec, func in zip(names, self._native[k], funcs):
+                if spec is None and width == 1:
+                    columns[name] = (rows, vals[:, 0], ints == len(last))
+                elif spec is not None and spec is not False:
+                    if spec < width:
+                        columns[name] = (rows, vals[:, spec], False)
+                    else:
+                        columns[name] = (rows, np.full(len(rows), np.nan), False)
+                else:
+                    data = vals[:, 0] if width == 1 else vals.tolist()
+                    columns[name] = (rows, [func(Value(x)) for x in data], False)
+
+        def chunks():
+            # An empty chunk is produced at the end if the final chunk is
+            # full, matching processColumns()
+            for start in range(0, len(index) + 1, chunkSize):
+                stop = min(start + chunkSize, len(index))
+                acc = ColumnAccumulator(self._columnList, initialSize=stop - start + 1)
+                acc.setRows(index[start:stop])
+                for name, (rows, values, integral) in columns.items():
+                    a, b = np.searchsorted(rows, [start, stop])
+                    if a == b:
+                        continue
+                    acc.setColumn(name, rows[a:b] - start, values[a:b], integral)
+                yield acc
+
+        return chunks()
+
+    def processMessages(self, includeTS=False, force=False, chunkSize=100000):
+        """!
+        Process messages and return. Will yield data in chunks.
+
+        Wrapper around processColumns(), converting each chunk into records.
+        @param includeTS Passed to prepConverters()
+        @param force Passed to prepConverters()
+        @param chunkSize Yield records after this many timestamps
+        @returns List of tuples containing timestamp and dictionary of records
+        """
+        if self._records:
+            log.error("Some records already cached - discarding")
+            del self._records
+
+        for acc in self.processColumns(includeTS, force, chunkSize):
+            self._records = acc.records()
+            yield self._records
+
+    def channelArrays(self, channels, native=None):
+        """!
+        Extract values for a set of channels as numpy arrays.
+
+        Each value is associated with the next timestamp from the primary clock
+        source, matching the grouping used by processMessages(). Values
+        received after the final timestamp are discarded.
+
+        Numerical arrays are returned as 2D arrays, with the width set by the
+        first message received on that channel and shorter rows padded with
+        NaN. Non-numerical values are returned as NaN.
+
+        The native decoder is used if available, and releases the GIL while
+        reading the file so that several files can be processed in parallel.
+        @param channels List of (source, channel) tuples
+        @param native Force (True) or prevent (False) use of the native decoder
+        @returns Dictionary mapping (source, channel) to (timestamps, values) arrays
+        """
+        channels = [(int(s), int(c)) for s, c in channels]
+        if native is None:
+            native = _SLDecode is not None
+        elif native and _SLDecode is None:
+            raise RuntimeError("Native decoder not available")
+
+        if native:
+            count, raw = _SLDecode.decode(os.fsencode(self._fn), channels, self._pcs)
+            log.debug(f"{count} messages read from {self._fn}")
+            out = {}
+            for k, (ts, vals, width, _, _) in raw.items():
+                ts = np.frombuffer(ts, dtype=np.uint32)
+                vals = np.frombuffer(vals, dtype=np.float64)
+                if width > 1:
+                    vals = vals.reshape(-1, width)
+                out[k] = (ts, vals)
+            return out
+
+        def toRow(data, width):
+            row = [np.nan] * width
+            if isinstance(data, (list, tuple)):
+                vals = data[:width]
+            else:
+                vals = [data]
+            for ix, v in enumerate(vals):
+                if isinstance(v, Number) and not isinstance(v, bool):
+                    row[ix] = float(v)
+            return row
+
+        ts = {k: [] for k in channels}
+        vals = {k: [] for k in channels}
+        widths = {}
+        pending = {k: 0 for k in channels}
+        for msg in self.messages():
+            if msg.SourceID == self._pcs and msg.ChannelID == IDs.SLCHAN_TSTAMP:
+                for k in channels:
+                    ts[k].extend([msg.Data] * (len(vals[k]) - pending[k]))
+                    pending[k] = len(vals[k])
+
+            k = (msg.SourceID, msg.ChannelID)
+            if k in vals:
+                if k not in widths:
+                    if isinstance(msg.Data, (list, tuple)):
+                        widths[k] = max(len(msg.Data), 1)
+                    else:
+                        widths[k] = 1
+                vals[k].append(toRow(msg.Data, widths[k]))
+
+        out = {}
+        for k in channels:
+            width = widths.get(k, 1)
+            v = np.array(vals[k][: pending[k]], dtype=np.float64).reshape(-1, width)
+            if width == 1:
+                v = v.reshape(-1)
+            out[k] = (np.array(ts[k], dtype=np.uint32), v)
+        return out
+
+    def extract(self, output, source=None, channel=None, raw=True, native=None):
+        """!
+        Write messages matching a specific source and/or channel ID to a file.
+
+        If `raw` is set, the contents of each binary or string message are
+        written out directly. Otherwise, each message is written out in the
+        data file format.
+
+        The native decoder is used if available, and releases the GIL while
+        processing the file.
+        @param output Open (binary) file object
+        @param source Optional: Source ID to match
+        @param channel Optional: Channel ID to match
+        @param raw Write message contents only
+        @param native Force (True) or prevent (False) use of the native decoder
+        @returns Number of messages written
+        """
+        if native is None:
+            native = _SLDecode is not None
+        elif native and _SLDecode is None:
+            raise RuntimeError("Native decoder not available")
+
+        if native:
+            output.flush()
+            count, size = _SLDecode.extract(
+                os.fsencode(self._fn),
+                output.fileno(),
+                int(source) if source else -1,
+                int(channel) if channel else -1,
+                raw,
+            )
+            log.debug(f"{count} messages ({size} bytes) extracted from {self._fn}")
+            return count
+
+        count = 0
+        for m in self.messages(source=source, channel=channel):
+            if not raw:
+                output.write(m.pack())
+            elif isinstance(m.Data, bytes):
+                output.write(m.Data)
+            elif isinstance(m.Data, str):
+                output.write(m.Data.encode("utf-8"))
+            else:
+                continue
+            count += 1
+        return count
 
     def yieldDataFrame(self, dropna=False, resample=None, convertEpoch=False):
         """!
@@ -471,8 +1012,8 @@ class DatFile:
         lastDT = None
         DTCol = f"DT:0x{self._pcs:02x}"
         EpochCol = f"Epoch:0x{self._pcs:02x}"
-        for chunk in self.processMessages():
-            ndf = pd.DataFrame(data=[x[1] for x in chunk], index=[x[0] for x in chunk])
+        for chunk in self.processColumns():
+            ndf = chunk.frame()
             count += len(ndf)
             if resample:
                 ndf.index = pd.to_timedelta(ndf.index.values, unit="ms")
@@ -688,3 +1229,161 @@ class StateFile:
             self.parse()
         delta = self._mtime - self._ts / 1000
         return pd.to_datetime(timestamp / 1000 + delta, unit="s")
+
+
+class StateTable(StateFile):
+    """!
+    Represent a shared logger state table (see statetable.h), providing the
+    same interface as StateFile.
+
+    The table is mapped read-only each time it is parsed, and each entry is
+    checked against its sequence number to ensure a consistent copy is used.
+    """
+
+    ## Identifies a state table file (see STATE_MAGIC)
+    MAGIC = b"SLSTATE\0"
+    ## Supported state table version
+    VERSION = 1
+    ## Size of header [bytes]
+    HEADER_SIZE = 4096
+    ## Header fields (see state_header)
+    HEADER = np.dtype(
+        [
+            ("magic", "S8"),
+            ("version", "=u4"),
+            ("entrySize", "=u4"),
+            ("sources", "=u4"),
+            ("channels", "=u4"),
+            ("seq", "=u4"),
+            ("lastTimestamp", "=u4"),
+            ("updated", "=i8"),
+            ("pid", "=u4"),
+            ("reserved", "=u4"),
+            ("varFile", "S4048"),
+        ]
+    )
+    ## Entry fields (see state_entry)
+    ENTRY = np.dtype(
+        [
+            ("seq", "=u4"),
+            ("count", "=u4"),
+            ("lastTimestamp", "=u4"),
+            ("dtype", "u1"),
+            ("reserved", "V3"),
+            ("length", "=u4"),
+            ("data", "V108"),
+        ]
+    )
+    ## Maximum attempts to get a consistent copy of each entry
+    RETRIES = 1000
+
+    def _read(self, mm, dtype, offset, count=1):
+        """!
+        Copy structures from the table, retrying any entries modified during the copy
+        @param mm Mapped table
+        @param dtype Structure type (HEADER or ENTRY)
+        @param offset Offset of first structure in table
+        @param count Number of structures
+        @returns Numpy structured array
+        """
+        out = np.frombuffer(mm, dtype=dtype, count=count, offset=offset).copy()
+        live = np.frombuffer(mm, dtype=dtype, count=count, offset=offset)["seq"]
+        for ix in np.flatnonzero((out["seq"] != live) | (out["seq"] & 1)):
+            for _ in range(self.RETRIES):
+                s1 = int(live[ix])
+                if s1 & 1:
+                    continue
+                out[ix] = np.frombuffer(
+                    mm, dtype=dtype, count=1, offset=offset + ix * dtype.itemsize
+                )[0]
+                if int(live[ix]) == s1:
+                    break
+            else:
+                raise RuntimeError(f"Unable to read consistent state table entry {ix}")
+        return out
+
+    @staticmethod
+    def _value(entry):
+        """!
+        Convert entry data to a value matching the state file representation
+        @param entry State table entry
+        @returns Value as string, formatted as per msg_data_to_string()
+        """
+        data = entry["data"].tobytes()
+        dtype = int(entry["dtype"])
+        if dtype == 1:
+            return f"{np.frombuffer(data, dtype='=f4', count=1)[0]:.6f}"
+        elif dtype == 2:
+            return f"{np.frombuffer(data, dtype='=u4', count=1)[0]:09d}"
+        elif dtype == 3:
+            return f"[Binary data, {entry['length']} bytes]"
+        elif dtype in (4, 5):
+            return data.split(b"\0", 1)[0].decode("utf-8", errors="replace")
+        elif dtype == 6:
+            n = min(int(entry["length"]), len(data) // 4)
+            return "/".join(
+                f"{x:.4f}" for x in np.frombuffer(data, dtype="=f4", count=n)
+            )
+        return "[Message type unknown]"
+
+    def parse(self):
+        """!
+        Read current table contents
+        @returns Channel statistics (also stored in _stats)
+        """
+        with open(self._fn, "rb") as sf:
+            with mmap.mmap(sf.fileno(), 0, access=mmap.ACCESS_READ) as mm:
+                hdr = self._read(mm, self.HEADER, 0)[0]
+                if (
+                    hdr["magic"] != self.MAGIC.rstrip(b"\0")
+                    or hdr["version"] != self.VERSION
+                    or hdr["entrySize"] != self.ENTRY.itemsize
+                ):
+                    raise ValueError(f"{self._fn} is not a supported state table")
+                entries = self._read(
+                    mm,
+                    self.ENTRY,
+                    self.HEADER_SIZE,
+                    int(hdr["sources"]) * int(hdr["channels"]),
+                )
+
+        self._ts = int(hdr["lastTimestamp"])
+        self._mtime = int(hdr["updated"]) / 1000
+        self._vf = VarFile(hdr["varFile"].decode("utf-8")).getSourceMap()
+
+        active = np.flatnonzero(entries["count"])
+        self._stats = pd.DataFrame(
+            {
+                "Source": active // int(hdr["channels"]),
+                "Channel": active % int(hdr["channels"]),
+                "Count": entries["count"][active].astype(int),
+                "Time": entries["lastTimestamp"][active].astype(int),
+                "Value": [self._value(e) for e in entries[active]],
+            }
+        ).set_index(["Source", "Channel"])
+        # Match type conversion applied when reading state files
+        try:
+            self._stats["Value"] = pd.to_numeric(self._stats["Value"])
+        except ValueError:
+            pass
+        self._stats["SecondsAgo"] = (self._stats["Time"] - self._ts) / 1000
+        self._stats["DateTime"] = (
+            self._stats["Time"]
+            .apply(self.to_clocktime)
+            .apply(lambda x: x.strftime("%Y-%m-%d %H:%M:%S"))
+        )
+        return self._stats
+
+
+def openStateFile(filename):
+    """!
+    Open a logger state file or state table, selecting the appropriate class
+    based on the file contents.
+
+    @param filename Path to state file or table
+    @returns StateTable or StateFile instance
+    """
+    with open(filename, "rb") as f:
+        if f.read(len(StateTable.MAGIC)) == StateTable.MAGIC:
+            return StateTable(filename)
+    return StateFile(filename)
@@ -32,6 +32,8 @@ class IDs:
     SLSOURCE_CONV = 0x01
     ## Local/Software timers
     SLSOURCE_TIMER = 0x02
+    ## Message capture times (generated by the logging software)
+    SLSOURCE_CAPT = 0x03
     ## Test data source ID (1/3)
     SLSOURCE_TEST1 = 0x05
     ## Test data source ID (2/3)
@@ -69,6 +71,8 @@ class IDs:
     SLCHAN_LOG_WARN = 0x7E
     ## Error messages
     SLCHAN_LOG_ERR = 0x7F
+    ## Prefix for names of channels containing packed numerical arrays
+    SLCHAN_PACKED_PREFIX = "Packed:"
 
 
 ## @brief Python representation of a logged message
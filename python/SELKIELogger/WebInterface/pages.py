@@ -155,10 +155,10 @@ def download_file(fileName, fileFormat="raw"):
 
 @pages.route("/state/")
 def show_state():
-    from ..SLFiles import StateFile
+    from ..SLFiles import openStateFile
 
     try:
-        sf = StateFile(
+        sf = openStateFile(
             os.path.join(
                 current_app.config["DATA_PATH"], current_app.config["STATE_NAME"]
             )
@@ -189,10 +189,10 @@ def show_map():
     g.ext_url = get_url()
     g.name = current_app.config["DEVICE_NAME"]
 
-    from ..SLFiles import StateFile
+    from ..SLFiles import openStateFile
 
     try:
-        sf = StateFile(
+        sf = openStateFile(
             os.path.join(
                 current_app.config["DATA_PATH"], current_app.config["STATE_NAME"]
             )
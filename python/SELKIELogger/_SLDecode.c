@@ -0,0 +1,459 @@
+/*
+ *  Copyright (C) 2023 Swansea University
+ *
+ *  This file is part of the SELKIELogger suite of tools.
+ *
+ *  SELKIELogger is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation, either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  SELKIELogger is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this SELKIELogger product.
+ *  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "SELKIELoggerBase.h"
+#include "SELKIELoggerMP.h"
+
+/*!
+ * @file
+ * @brief Native data file decoder for the SELKIELogger Python package
+ *
+ * Reads a data file using the MP library functions and extracts values for a
+ * set of requested channels into contiguous buffers, along with the primary
+ * clock timestamp associated with each value. The Python wrapper in SLFiles.py
+ * converts these buffers into numpy arrays without further copying.
+ *
+ * Messages from a single source and/or channel can also be written directly
+ * to another file, for use by SLExtract.
+ *
+ * The file is decoded without holding the Python global interpreter lock, so
+ * multiple files can be decoded concurrently from separate Python threads.
+ */
+
+//! Initial number of entries allocated for each channel
+#define SLD_INITIAL_SIZE 1024
+
+//! Accumulated values for a single requested channel
+typedef struct {
+	uint8_t source;  //!< Source ID
+	uint8_t channel; //!< Channel ID
+	int width;       //!< Number of values per message (set from first message)
+	size_t count;    //!< Number of messages stored
+	size_t cap;      //!< Number of messages allocated
+	size_t pending;  //!< Index of first message awaiting a timestamp
+	size_t ints;     //!< Number of stored messages that were timestamps (integers)
+	size_t other;    //!< Number of stored messages that were not numerical
+	size_t pInts;    //!< Timestamp messages awaiting a timestamp
+	size_t pOther;   //!< Non-numerical messages awaiting a timestamp
+	uint32_t *ts;    //!< Timestamps
+	double *vals;    //!< Values (count * width entries)
+} sld_channel;
+
+//! Result of decoding a file
+typedef struct {
+	int nChannels;         //!< Number of requested channels
+	sld_channel *channels; //!< Channel data
+	int err;               //!< errno value if file could not be read, or -1 for allocation failure
+	size_t messages;       //!< Total number of messages read
+} sld_result;
+
+/*!
+ * @param[in,out] c Channel to extend
+ * @param[in] width Number of values in this message
+ * @returns False on allocation failure
+ */
+static bool sld_grow(sld_channel *c, const int width) {
+	if (c->width == 0) { c->width = width > 0 ? width : 1; }
+	if (c->count < c->cap) { return true; }
+
+	const size_t nc = c->cap ? c->cap * 2 : SLD_INITIAL_SIZE;
+	uint32_t *nt = realloc(c->ts, nc * sizeof(uint32_t));
+	if (!nt) { return false; }
+	c->ts = nt;
+	double *nv = realloc(c->vals, nc * c->width * sizeof(double));
+	if (!nv) { return false; }
+	c->vals = nv;
+	c->cap = nc;
+	return true;
+}
+
+/*!
+ * Values are associated with the next timestamp received from the primary
+ * clock source, matching the grouping used by DatFile.processMessages().
+ * Values received after the final timestamp are discarded.
+ *
+ * Numerical values are stored directly, while numerical arrays are stored in
+ * rows of a fixed width (set by the first message received on that channel)
+ * and padded with NAN if required. Other message types are stored as NAN, and
+ * counted so that callers can detect channels that can't be represented.
+ *
+ * @param[in] fileName Data file to read
+ * @param[in] pcs Primary clock source ID
+ * @param[in,out] res Result structure, with channels already populated
+ */
+static void sld_decode(const char *fileName, const uint8_t pcs, sld_result *res) {
+	int idx[128][128];
+	memset(idx, 0xFF, sizeof(idx));
+	for (int i = 0; i < res->nChannels; i++) {
+		idx[res->channels[i].source][res->channels[i].channel] = i;
+	}
+
+	errno = 0;
+	int handle = open(fileName, O_RDONLY);
+	if (handle < 0) {
+		res->err = errno;
+		return;
+	}
+
+	uint8_t buf[MP_SERIAL_BUFF] = {0};
+	int index = 0;
+	int hw = 0;
+	while (true) {
+		msg_t m = {0};
+		if (!mp_readMessage_buf(handle, &m, buf, &index, &hw)) {
+			// End of file (including any truncated final message) or read
+			// error. Invalid messages are skipped, as in the Python decoder
+			if (m.dtype == MSG_ERROR && (m.data.value == 0xFD || m.data.value == 0xAA)) {
+				break;
+			}
+			continue;
+		}
+		res->messages++;
+
+		if (m.source == pcs && m.type == SLCHAN_TSTAMP && m.dtype == MSG_TIMESTAMP) {
+			for (int i = 0; i < res->nChannels; i++) {
+				sld_channel *c = &(res->channels[i]);
+				for (size_t j = c->pending; j < c->count; j++) {
+					c->ts[j] = m.data.timestamp;
+				}
+				c->pending = c->count;
+				c->ints += c->pInts;
+				c->other += c->pOther;
+				c->pInts = 0;
+				c->pOther = 0;
+			}
+		}
+
+		const int ci = idx[m.source][m.type];
+		if (ci >= 0) {
+			sld_channel *c = &(res->channels[ci]);
+			const int width = (m.dtype == MSG_NUMARRAY) ? (int)m.length : 1;
+			if (!sld_grow(c, width)) {
+				msg_destroy(&m);
+				res->err = -1;
+				break;
+			}
+			double *row = &(c->vals[c->count * c->width]);
+			for (int j = 0; j < c->width; j++) {
+				row[j] = NAN;
+			}
+			switch (m.dtype) {
+				case MSG_FLOAT:
+					row[0] = m.data.value;
+					break;
+				case MSG_TIMESTAMP:
+					row[0] = m.data.timestamp;
+					c->pInts++;
+					break;
+				case MSG_NUMARRAY:
+					for (int j = 0; j < c->width && j < (int)m.length; j++) {
+						row[j] = m.data.farray[j];
+					}
+					break;
+				default:
+					c->pOther++;
+					break;
+			}
+			c->count++;
+		}
+		msg_destroy(&m);
+	}
+	close(handle);
+
+	// Discard values without an associated timestamp
+	for (int i = 0; i < res->nChannels; i++) {
+		res->channels[i].count = res->channels[i].pending;
+	}
+}
+
+/*!
+ * Python: decode(filename, channels, pcs) -> (messages, {(source, channel): (ts, values, width,
+ * ints, other)})
+ *
+ * `channels` is a sequence of (source, channel) pairs. Timestamps are returned
+ * as bytes containing native uint32 values, and values as bytes containing
+ * native doubles. `ints` and `other` are the number of values that were
+ * received as timestamps and as non-numerical messages respectively.
+ *
+ * @param[in] self Module
+ * @param[in] args Python arguments
+ * @returns Tuple of message count and dictionary, or NULL on error
+ */
+static PyObject *sld_py_decode(PyObject *self, PyObject *args) {
+	(void)self;
+	PyObject *fnObj = NULL;
+	PyObject *chanList = NULL;
+	int pcs = SLSOURCE_TIMER;
+	if (!PyArg_ParseTuple(args, "O&O|i", PyUnicode_FSConverter, &fnObj, &chanList, &pcs)) {
+		return NULL;
+	}
+
+	PyObject *seq = PySequence_Fast(chanList, "channels must be a sequence of (source, channel) pairs");
+	if (!seq) {
+		Py_DECREF(fnObj);
+		return NULL;
+	}
+
+	sld_result res = {0};
+	res.nChannels = PySequence_Fast_GET_SIZE(seq);
+	res.channels = calloc(res.nChannels > 0 ? res.nChannels : 1, sizeof(sld_channel));
+	if (!res.channels) {
+		Py_DECREF(seq);
+		Py_DECREF(fnObj);
+		return PyErr_NoMemory();
+	}
+
+	for (int i = 0; i < res.nChannels; i++) {
+		int s = 0;
+		int c = 0;
+		PyObject *item = PySequence_Fast_GET_ITEM(seq, i);
+		if (!PyArg_ParseTuple(item, "ii", &s, &c) || s < 0 || s > 127 || c < 0 || c > 127) {
+			if (!PyErr_Occurred()) {
+				PyErr_SetString(PyExc_ValueError, "Source and channel IDs must be in range 0-127");
+			}
+			free(res.channels);
+			Py_DECREF(seq);
+			Py_DECREF(fnObj);
+			return NULL;
+		}
+		res.channels[i].source = s;
+		res.channels[i].channel = c;
+	}
+	Py_DECREF(seq);
+
+	const char *fileName = PyBytes_AS_STRING(fnObj);
+	Py_BEGIN_ALLOW_THREADS
+	sld_decode(fileName, pcs, &res);
+	Py_END_ALLOW_THREADS
+
+	PyObject *out = NULL;
+	if (res.err > 0) {
+		errno = res.err;
+		PyErr_SetFromErrnoWithFilenameObject(PyExc_OSError, fnObj);
+	} else if (res.err < 0) {
+		PyErr_NoMemory();
+	} else {
+		PyObject *dict = PyDict_New();
+		for (int i = 0; dict && i < res.nChannels; i++) {
+			sld_channel *c = &(res.channels[i]);
+			// Channels with no data have no buffers allocated
+			const char *ts = c->ts ? (const char *)c->ts : "";
+			const char *vals = c->vals ? (const char *)c->vals : "";
+			const Py_ssize_t tsLen = c->count * sizeof(uint32_t);
+			const Py_ssize_t valLen = c->count * c->width * sizeof(double);
+			PyObject *v = Py_BuildValue("(y#y#inn)", ts, tsLen, vals, valLen,
+			                            c->width ? c->width : 1, (Py_ssize_t)c->ints,
+			                            (Py_ssize_t)c->other);
+			PyObject *k = Py_BuildValue("(ii)", c->source, c->channel);
+			if (!v || !k || PyDict_SetItem(dict, k, v) < 0) { Py_CLEAR(dict); }
+			Py_XDECREF(k);
+			Py_XDECREF(v);
+		}
+		if (dict) {
+			out = Py_BuildValue("(nN)", (Py_ssize_t)res.messages, dict);
+		}
+	}
+
+	for (int i = 0; i < res.nChannels; i++) {
+		free(res.channels[i].ts);
+		free(res.channels[i].vals);
+	}
+	free(res.channels);
+	Py_DECREF(fnObj);
+	return out;
+}
+
+//! Result of extracting messages from a file
+typedef struct {
+	int err;         //!< errno value if file could not be read or output written
+	bool writeError; //!< True if err relates to the output file
+	size_t messages; //!< Number of messages extracted
+	size_t bytes;    //!< Number of bytes written
+} sld_extract_result;
+
+/*!
+ * @param[in] handle Output file descriptor
+ * @param[in] data Data to write
+ * @param[in] len Length of data
+ * @returns False on write error
+ */
+static bool sld_write(const int handle, const void *data, const size_t len) {
+	const uint8_t *p = data;
+	size_t done = 0;
+	while (done < len) {
+		const ssize_t ret = write(handle, p + done, len - done);
+		if (ret < 0) {
+			if (errno == EINTR) { continue; }
+			return false;
+		}
+		done += ret;
+	}
+	return true;
+}
+
+/*!
+ * Messages are matched against `source` and `channel`, where a negative
+ * value matches any source or channel.
+ *
+ * If `raw` is set, only the contents of binary and string messages are
+ * written. Otherwise each matching message is packed into the data file
+ * format.
+ *
+ * @param[in] fileName Data file to read
+ * @param[in] outHandle Output file descriptor
+ * @param[in] source Source ID to match
+ * @param[in] channel Channel ID to match
+ * @param[in] raw Extract message contents only
+ * @param[out] res Result structure
+ */
+static void sld_extract(const char *fileName, const int outHandle, const int source,
+                        const int channel, const bool raw, sld_extract_result *res) {
+	errno = 0;
+	int handle = open(fileName, O_RDONLY);
+	if (handle < 0) {
+		res->err = errno;
+		return;
+	}
+
+	uint8_t buf[MP_SERIAL_BUFF] = {0};
+	int index = 0;
+	int hw = 0;
+	while (true) {
+		msg_t m = {0};
+		if (!mp_readMessage_buf(handle, &m, buf, &index, &hw)) {
+			if (m.dtype == MSG_ERROR && (m.data.value == 0xFD || m.data.value == 0xAA)) {
+				break;
+			}
+			continue;
+		}
+
+		if ((source >= 0 && m.source != source) || (channel >= 0 && m.type != channel)) {
+			msg_destroy(&m);
+			continue;
+		}
+
+		const void *data = NULL;
+		size_t len = 0;
+		msgpack_sbuffer sbuf = {0};
+		if (!raw) {
+			if (mp_packMessage(&sbuf, &m)) {
+				data = sbuf.data;
+				len = sbuf.size;
+			}
+		} else if (m.dtype == MSG_BYTES) {
+			data = m.data.bytes;
+			len = m.length;
+		} else if (m.dtype == MSG_STRING) {
+			data = m.data.string.data;
+			len = m.data.string.length;
+		}
+
+		errno = 0;
+		const bool ok = (data == NULL) || sld_write(outHandle, data, len);
+		if (sbuf.data) { msgpack_sbuffer_destroy(&sbuf); }
+		msg_destroy(&m);
+		if (!ok) {
+			res->err = errno ? errno : EIO;
+			res->writeError = true;
+			break;
+		}
+		if (data) {
+			res->messages++;
+			res->bytes += len;
+		}
+	}
+	close(handle);
+}
+
+/*!
+ * Python: extract(filename, fd, source, channel, raw) -> (messages, bytes)
+ *
+ * Matching message data is written directly to the file descriptor `fd`,
+ * and the number of messages and bytes written are returned.
+ *
+ * @param[in] self Module
+ * @param[in] args Python arguments
+ * @returns Tuple of message and byte counts, or NULL on error
+ */
+static PyObject *sld_py_extract(PyObject *self, PyObject *args) {
+	(void)self;
+	PyObject *fnObj = NULL;
+	int outHandle = -1;
+	int source = -1;
+	int channel = -1;
+	int raw = 1;
+	if (!PyArg_ParseTuple(args, "O&iii|p", PyUnicode_FSConverter, &fnObj, &outHandle, &source,
+	                      &channel, &raw)) {
+		return NULL;
+	}
+
+	sld_extract_result res = {0};
+	const char *fileName = PyBytes_AS_STRING(fnObj);
+	Py_BEGIN_ALLOW_THREADS
+	sld_extract(fileName, outHandle, source, channel, raw, &res);
+	Py_END_ALLOW_THREADS
+
+	PyObject *out = NULL;
+	if (res.err > 0) {
+		errno = res.err;
+		if (res.writeError) {
+			PyErr_SetFromErrno(PyExc_OSError);
+		} else {
+			PyErr_SetFromErrnoWithFilenameObject(PyExc_OSError, fnObj);
+		}
+	} else {
+		out = Py_BuildValue("(nn)", (Py_ssize_t)res.messages, (Py_ssize_t)res.bytes);
+	}
+	Py_DECREF(fnObj);
+	return out;
+}
+
+//! Module method table
+static PyMethodDef sld_methods[] = {
+	{"decode", sld_py_decode, METH_VARARGS,
+	 "decode(filename, channels, pcs) -> (messages, {(source, channel): (timestamps, values, "
+	 "width, ints, other)})"},
+	{"extract", sld_py_extract, METH_VARARGS,
+	 "extract(filename, fd, source, channel, raw) -> (messages, bytes)"},
+	{NULL, NULL, 0, NULL}};
+
+//! Module definition
+static struct PyModuleDef sld_module = {.m_base = PyModuleDef_HEAD_INIT,
+                                       .m_name = "_SLDecode",
+                                       .m_doc = "Native SELKIELogger data file decoder",
+                                       .m_size = -1,
+                                       .m_methods = sld_methods};
+
+/*!
+ * @returns New module instance
+ */
+PyMODINIT_FUNC PyInit__SLDecode(void) { return PyModule_Create(&sld_module); }
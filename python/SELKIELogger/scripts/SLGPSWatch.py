@@ -29,7 +29,7 @@ from time import monotonic, sleep
 
 from SELKIELogger.scripts import log
 from SELKIELogger.Specs import ChannelSpec, LocatorSpec
-from SELKIELogger.SLFiles import StateFile
+from SELKIELogger.SLFiles import openStateFile
 from SELKIELogger.PushoverClient import PushoverClient
 
 
@@ -44,7 +44,7 @@ def process_arguments():
         description="Read a SELKIE Logger state file and check GPS position",
         epilog="Created as part of the SELKIE project",
     )
-    options.add_argument("file", metavar="STATEFILE", help="State file name")
+    options.add_argument("file", metavar="STATEFILE", help="State file or table name")
 
     options.add_argument(
         "-v", "--verbose", action="count", default=0, help="Increase output verbosity"
@@ -120,7 +120,7 @@ def SLGPSWatch():
     lastFlagged = None
     lastFlaggedTime = monotonic()
     while True:
-        sf = StateFile(args.file)
+        sf = openStateFile(args.file)
         ds = sf.parse()
 
         states = []
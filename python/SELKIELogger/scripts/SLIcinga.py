@@ -20,7 +20,7 @@ from time import time
 from sys import exit
 
 from SELKIELogger.Specs import ChannelSpec
-from SELKIELogger.SLFiles import StateFile
+from SELKIELogger.SLFiles import openStateFile
 
 
 def process_arguments():
@@ -30,7 +30,7 @@ def process_arguments():
         description="Read a SELKIE Logger state file and output Icinga compatible status",
         epilog="Created as part of the SELKIE project",
     )
-    options.add_argument("file", metavar="STATEFILE", help="State file name")
+    options.add_argument("file", metavar="STATEFILE", help="State file or table name")
     options.add_argument(
         "-s",
         "--source",
@@ -59,7 +59,7 @@ def process_arguments():
 
 def SLIcinga():
     args = process_arguments()
-    sf = StateFile(args.file)
+    sf = openStateFile(args.file)
     stats = sf.parse()
 
     exitStatus = 0
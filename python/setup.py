@@ -1,5 +1,5 @@
-from setuptools import setup, find_packages
-from os import path
+from setuptools import setup, find_packages, Extension
+from os import environ, path
 
 import sys
 
@@ -9,6 +9,28 @@ import setup_common as sc
 
 here = path.abspath(path.dirname(__file__))
 
+# The native decoder is optional, and is only built if the SELKIELogger
+# libraries and headers can be found. Use SELKIELOGGER_INCLUDE and
+# SELKIELOGGER_LIBDIR to specify non-standard locations (colon separated).
+slIncludes = [
+    path.join(here, "..", "library"),
+    path.join(here, "..", "library", "base"),
+    path.join(here, "..", "library", "MP"),
+    path.join(sys.prefix, "include", "SELKIELogger"),
+    "/usr/local/include/SELKIELogger",
+]
+slIncludes = environ.get("SELKIELOGGER_INCLUDE", "").split(":") + slIncludes
+slLibDirs = environ.get("SELKIELOGGER_LIBDIR", "").split(":")
+
+nativeDecoder = Extension(
+    "SELKIELogger._SLDecode",
+    sources=["SELKIELogger/_SLDecode.c"],
+    include_dirs=[x for x in slIncludes if x and path.isdir(x)],
+    library_dirs=[x for x in slLibDirs if x],
+    libraries=["SELKIELoggerMP", "SELKIELoggerBase", "msgpackc"],
+    optional=True,
+)
+
 setup(
     name=sc.project,
     version=sc.getVersionString(),
@@ -28,6 +50,7 @@ setup(
         "Programming Language :: Python :: 3.10",
     ],
     packages=find_packages(),  # Required
+    ext_modules=[nativeDecoder],
     python_requires=">=3.6, <4",
     install_requires=["msgpack", "pandas", "scipy"],
     extras_require={
@@ -0,0 +1,118 @@
+/*
+ *  Copyright (C) 2023 Swansea University
+ *
+ *  This file is part of the SELKIELogger suite of tools.
+ *
+ *  SELKIELogger is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation, either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  SELKIELogger is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this SELKIELogger product.
+ *  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "DWStats.h"
+
+/*! @file
+ *
+ * @brief Test wave statistics estimated from displacement data
+ *
+ * @test Generate displacements for a regular wave of known height, period and
+ * direction, then check that dw_wave_statistics() recovers these values.
+ *
+ * @ingroup testing
+ */
+
+bool check(const char *name, const double val, const double target, const double tol);
+
+/*!
+ * Test dw_wave_statistics() for CTest
+ *
+ * @returns 1 on error, otherwise 0
+ */
+int main(void) {
+	const double amp = 1.0;    // Wave amplitude [m]
+	const double period = 10;  // Wave period [s]
+	const double from = 45;    // Direction waves are coming from [degrees]
+	const size_t samples = 2304; // 30 minutes at 1.28Hz
+
+	dw_disp_ring ring = {0};
+	if (!dw_ring_init(&ring, samples)) {
+		// LCOV_EXCL_START
+		fprintf(stderr, "Unable to allocate displacement buffer\n");
+		return 1;
+		// LCOV_EXCL_STOP
+	}
+
+	// Horizontal displacement is in the direction of travel at the wave crest
+	const double to = (from + 180) * M_PI / 180.0;
+	const double w = 2 * M_PI / period;
+	for (size_t i = 0; i < samples + 100; i++) {
+		const double t = i / DW_HXV_RATE;
+		const double h = amp * sin(w * t);
+		dw_ring_add(&ring, h * cos(to), -h * sin(to), amp * cos(w * t));
+	}
+
+	// Include a short dropout, which should be tolerated
+	for (size_t i = 500; i < 510; i++) {
+		ring.vert[i] = NAN;
+	}
+
+	bool res = true;
+	dw_wave_stats ws = {0};
+	if (!dw_wave_statistics(&ring, 256, DW_HXV_RATE, 16, &ws)) {
+		// LCOV_EXCL_START
+		fprintf(stderr, "Unable to calculate wave statistics\n");
+		dw_ring_destroy(&ring);
+		return 1;
+		// LCOV_EXCL_STOP
+	}
+
+	fprintf(stdout, "%d segments used\n", ws.segments);
+	res &= check("Hs", ws.Hs, 4 * amp / sqrt(2), 0.05);
+	res &= check("Tp", ws.Tp, period, 0.1);
+	res &= check("Tz", ws.Tz, period, 0.2);
+	res &= check("Dm", ws.Dm, from, 1);
+	res &= check("Dp", ws.Dp, from, 1);
+
+	// Not enough data for a single segment
+	if (dw_wave_statistics(&ring, 4096, DW_HXV_RATE, 16, &ws)) {
+		// LCOV_EXCL_START
+		fprintf(stderr, "Statistics calculated with insufficient data\n");
+		res = false;
+		// LCOV_EXCL_STOP
+	}
+
+	dw_ring_destroy(&ring);
+	return (res ? 0 : 1);
+}
+
+/*!
+ * @param[in] name Statistic name, for output
+ * @param[in] val Calculated value
+ * @param[in] target Expected value
+ * @param[in] tol Permitted absolute difference
+ * @returns True if value within tolerance, false otherwise
+ */
+bool check(const char *name, const double val, const double target, const double tol) {
+	if (fabs(val - target) <= tol) {
+		fprintf(stdout, "%s: %.3f (expected %.3f)\n", name, val, target);
+		return true;
+	}
+	// LCOV_EXCL_START
+	fprintf(stdout, "%s: %.3f outside tolerance (expected %.3f +/- %.3f)\n", name, val, target,
+	        tol);
+	return false;
+	// LCOV_EXCL_STOP
+}
@@ -176,6 +176,36 @@ int main(int argc, char *argv[]) {
 					log_info(&state, 1, "%02x: Temperature: %.2f", m->id,
 					         d.temperature);
 				}
+
+				// Single pass decode must match individual field extraction
+				lpms_data ref = {.present = d.present};
+				lpms_imu_set_timestamp(m, &ref);
+				lpms_imu_set_accel_raw(m, &ref);
+				lpms_imu_set_accel_cal(m, &ref);
+				lpms_imu_set_gyro_raw(m, &ref);
+				lpms_imu_set_gyro_cal(m, &ref);
+				lpms_imu_set_gyro_aligned(m, &ref);
+				lpms_imu_set_mag_raw(m, &ref);
+				lpms_imu_set_mag_cal(m, &ref);
+				lpms_imu_set_omega(m, &ref);
+				lpms_imu_set_quaternion(m, &ref);
+				lpms_imu_set_euler_angles(m, &ref);
+				lpms_imu_set_accel_linear(m, &ref);
+				lpms_imu_set_pressure(m, &ref);
+				lpms_imu_set_altitude(m, &ref);
+				lpms_imu_set_temperature(m, &ref);
+
+				lpms_imu_layout l = {0};
+				lpms_data dd = {0};
+				if (!lpms_imu_layout_init(&l, d.present) ||
+				    !lpms_imu_decode(m, &l, &dd) ||
+				    memcmp(&dd, &ref, sizeof(lpms_data)) != 0) {
+					//LCOV_EXCL_START
+					log_error(&state, "%02x: Decoded IMU data mismatch",
+					          m->id);
+					return -1;
+					//LCOV_EXCL_STOP
+				}
 			} else {
 				//LCOV_EXCL_START
 				log_info(&state, 2, "%02x: Command %02x, %u bytes, checksum %s",
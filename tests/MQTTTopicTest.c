@@ -0,0 +1,207 @@
+/*
+ *  Copyright (C) 2023 Swansea University
+ *
+ *  This file is part of the SELKIELogger suite of tools.
+ *
+ *  SELKIELogger is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation, either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  SELKIELogger is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this SELKIELogger product.
+ *  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SELKIELoggerMQTT.h"
+
+/*! @file
+ *
+ * @brief Check MQTT topic matching and channel assignment
+ *
+ * @test Checks wildcard topic matching against the rules in the MQTT
+ * specification, then feeds messages through mqtt_enqueue_messages() and
+ * checks that each is queued with the expected channel number, including
+ * channels assigned to topics matching wildcard subscriptions.
+ *
+ * @ingroup testing
+ */
+
+//! Topic filter matching test case
+typedef struct {
+	const char *filter; //!< Subscription topic
+	const char *topic;  //!< Received topic
+	bool match;         //!< Expected result
+} mtt_match;
+
+//! Message routing test case
+typedef struct {
+	const char *topic; //!< Received topic
+	int type;          //!< Expected channel, or -1 if message should not be queued
+	const char *name;  //!< Expected channel name
+} mtt_route;
+
+bool check_route(mqtt_queue_map *qm, const mtt_route *r);
+
+/*!
+ * Check topic matching and message routing
+ *
+ * @returns 0 on success, 1 on failure
+ */
+int main(void) {
+	bool res = true;
+
+	const mtt_match matches[] = {
+		{"a/b/c", "a/b/c", true},
+		{"a/b/c", "A/B/C", true},
+		{"a/b/c", "a/b", false},
+		{"a/b", "a/b/c", false},
+		{"a/+/c", "a/b/c", true},
+		{"a/+/c", "a//c", true},
+		{"a/+/c", "a/b/d", false},
+		{"a/+", "a/b/c", false},
+		{"+/+", "/b", true},
+		{"a/#", "a", true},
+		{"a/#", "a/b/c", true},
+		{"a/#", "ab", false},
+		{"#", "a/b/c", true},
+		{"#", "$SYS/x", false},
+		{"+/x", "$SYS/x", false},
+		{"$SYS/#", "$SYS/x", true},
+		{"N/+/battery/+/Dc/0/V", "N/x/battery/256/Dc/0/V", true},
+		{"a/+/+/#", "a/b", false},
+		{"a/b/#", "a/b/", true},
+	};
+	for (size_t m = 0; m < sizeof(matches) / sizeof(matches[0]); m++) {
+		const mtt_match *t = &(matches[m]);
+		if (mqtt_topic_match(t->filter, t->topic) != t->match) {
+			// LCOV_EXCL_START
+			fprintf(stderr, "Filter '%s', topic '%s': Expected %s\n", t->filter,
+			        t->topic, t->match ? "match" : "no match");
+			res = false;
+			// LCOV_EXCL_STOP
+		}
+	}
+
+	mqtt_queue_map qm = {0};
+	if (!mqtt_init_queue_map(&qm)) {
+		// LCOV_EXCL_START
+		fprintf(stderr, "Unable to initialise queue map\n");
+		return 1;
+		// LCOV_EXCL_STOP
+	}
+	qm.sourceNum = 0x68;
+	res &= mqtt_add_topic(&qm, "N/1/system/0/Dc/Battery/Voltage", "Voltage", 4, 1, false);
+	res &= mqtt_add_topic(&qm, "N/1/pvinverter/+/Ac/Power", "PV", 5, 3, false);
+	res &= mqtt_add_topic(&qm, "N/1/tank/#", "Tank", 8, 2, true);
+	// Duplicate topics and multiple channels without wildcards are rejected
+	res &= !mqtt_add_topic(&qm, "n/1/system/0/dc/battery/voltage", "Duplicate", 10, 1, false);
+	res &= !mqtt_add_topic(&qm, "N/1/system/0/Dc/Battery/Current", "Current", 10, 2, false);
+	if (!res || qm.numtopics != 3) {
+		// LCOV_EXCL_START
+		fprintf(stderr, "Unexpected result adding topics\n");
+		res = false;
+		// LCOV_EXCL_STOP
+	}
+
+	// Before any messages are received, wildcard channels are named by offset
+	char *cn = mqtt_channel_name(&qm, 6);
+	res &= (cn && strcmp(cn, "PV:1") == 0);
+	free(cn);
+
+	const mtt_route routes[] = {
+		{"N/1/system/0/Dc/Battery/Voltage", 4, "Voltage"},
+		{"N/1/pvinverter/20/Ac/Power", 5, "PV:N/1/pvinverter/20/Ac/Power"},
+		{"N/1/pvinverter/21/Ac/Power", 6, "PV:N/1/pvinverter/21/Ac/Power"},
+		{"n/1/PVINVERTER/20/ac/power", 5, "PV:N/1/pvinverter/20/Ac/Power"},
+		{"N/1/pvinverter/22/Ac/Power", 7, "PV:N/1/pvinverter/22/Ac/Power"},
+		{"N/1/pvinverter/23/Ac/Power", -1, NULL}, // No channels left
+		{"N/1/tank/0/Level", 8, "Tank:N/1/tank/0/Level"},
+		{"N/1/tank", 9, "Tank:N/1/tank"},
+		{"N/1/tank/1/Level", -1, NULL},
+		{"N/1/system/0/Dc/Battery/Current", -1, NULL},
+		{"N/1/pvinverter/21/Ac/Power", 6, "PV:N/1/pvinverter/21/Ac/Power"},
+	};
+	for (size_t r = 0; r < sizeof(routes) / sizeof(routes[0]); r++) {
+		res &= check_route(&qm, &(routes[r]));
+	}
+	if (!atomic_load(&qm.remapped)) {
+		// LCOV_EXCL_START
+		fprintf(stderr, "Channel assignments not flagged\n");
+		res = false;
+		// LCOV_EXCL_STOP
+	}
+
+	// Unmatched topics are queued as raw strings when dumpall is set
+	qm.dumpall = true;
+	const mtt_route dump = {"N/1/system/0/Dc/Battery/Current", SLCHAN_RAW, NULL};
+	res &= check_route(&qm, &dump);
+
+	// Enough unmatched topics to force the lookup table to be resized
+	qm.dumpall = false;
+	for (int t = 0; t < 500; t++) {
+		char topic[40] = {0};
+		snprintf(topic, sizeof(topic), "N/1/unmatched/%d", t);
+		const mtt_route u = {topic, -1, NULL};
+		res &= check_route(&qm, &u);
+	}
+	res &= check_route(&qm, &(routes[0]));
+	res &= check_route(&qm, &(routes[2]));
+	if (qm.tableSize <= MQTT_TOPIC_BUCKETS) {
+		// LCOV_EXCL_START
+		fprintf(stderr, "Lookup table not resized (%zu buckets)\n", qm.tableSize);
+		res = false;
+		// LCOV_EXCL_STOP
+	}
+
+	mqtt_destroy_queue_map(&qm);
+
+	if (res) { fprintf(stdout, "All tests succeeded\n"); }
+	return (res ? 0 : 1);
+}
+
+/*!
+ * Passes a message for r->topic to mqtt_enqueue_messages() and checks the
+ * channel number of any message queued as a result.
+ *
+ * @param[in] qm Queue map
+ * @param[in] r Test case
+ * @returns True if result matches test case
+ */
+bool check_route(mqtt_queue_map *qm, const mtt_route *r) {
+	char payload[] = "12.5";
+	struct mosquitto_message in = {
+		.topic = (char *)r->topic, .payload = payload, .payloadlen = strlen(payload)};
+	mqtt_enqueue_messages(NULL, qm, &in);
+
+	msg_t *m = queue_pop(&qm->q);
+	const int type = m ? m->type : -1;
+	bool res = (type == r->type) && (queue_count(&qm->q) == 0);
+	if (m) {
+		msg_destroy(m);
+		free(m);
+	}
+	if (r->name) {
+		char *cn = mqtt_channel_name(qm, type);
+		res &= (cn && strcmp(cn, r->name) == 0);
+		free(cn);
+	}
+	if (!res) {
+		// LCOV_EXCL_START
+		fprintf(stderr, "Topic '%s': Queued on channel %d, expected %d (%s)\n", r->topic,
+		        type, r->type, r->name ? r->name : "-");
+		// LCOV_EXCL_STOP
+	}
+	return res;
+}
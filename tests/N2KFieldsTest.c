@@ -0,0 +1,261 @@
+/*
+ *  Copyright (C) 2023 Swansea University
+ *
+ *  This file is part of the SELKIELogger suite of tools.
+ *
+ *  SELKIELogger is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation, either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  SELKIELogger is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this SELKIELogger product.
+ *  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SELKIELoggerN2K.h"
+
+/*! @file
+ *
+ * @brief Compare table driven N2K decoding with PGN specific functions
+ *
+ * @test Generates pseudo-random payloads for a selection of PGNs and checks
+ * that n2k_decode_message() returns the same values as the equivalent
+ * n2k_XXXXXX_values() function. Batch decoding with n2k_decode_batch() and
+ * unaligned bit field extraction are also checked.
+ *
+ * @ingroup testing
+ */
+
+//! Number of random payloads to test for each PGN
+#define N2KFT_ROUNDS 1000
+
+bool compare(const uint32_t pgn, const int field, const double a, const double b);
+bool check_pgn(n2k_act_message *n, uint8_t *data);
+void fill_random(uint8_t *data, const size_t len);
+double unavailable(const uint8_t *data, const uint16_t byte, const uint8_t bits, const double v);
+
+/*!
+ * Check table driven decoding against existing decoders
+ *
+ * @returns 0 on success, 1 on failure
+ */
+int main(void) {
+	uint8_t data[64] = {0};
+	n2k_act_message n = {.data = data};
+	const uint32_t pgns[] = {127250, 127251, 127257, 128267, 129025,
+	                         129026, 129029, 129033, 130306, 130311};
+	bool res = true;
+
+	srand(1234);
+	for (size_t p = 0; p < sizeof(pgns) / sizeof(pgns[0]); p++) {
+		n.PGN = pgns[p];
+		for (int r = 0; r < N2KFT_ROUNDS; r++) {
+			res &= check_pgn(&n, data);
+		}
+	}
+
+	// Unaligned bit fields
+	const uint8_t bits[] = {0xA5, 0x5A, 0xFF, 0x00, 0x12, 0x34, 0x56, 0x78, 0x9A};
+	res &= (n2k_get_bits(bits, 4, 8) == 0xAA);
+	res &= (n2k_get_bits(bits, 12, 4) == 0x05);
+	res &= (n2k_get_bits(bits, 8, 16) == 0xFF5A);
+	res &= (n2k_get_bits(bits, 4, 64) == 0xA7856341200FF5AAULL);
+	if (!res) {
+		// LCOV_EXCL_START
+		fprintf(stderr, "Bit field extraction failed\n");
+		// LCOV_EXCL_STOP
+	}
+
+	// Batch decoding, including a message with the wrong PGN
+	const n2k_pgn_desc *pd = n2k_pgn_find(129025);
+	if (!pd) {
+		// LCOV_EXCL_START
+		fprintf(stderr, "Unable to find description for PGN 129025\n");
+		return 1;
+		// LCOV_EXCL_STOP
+	}
+	uint8_t bd[3][8] = {{0}};
+	n2k_act_message bm[3] = {{0}};
+	double lat[3] = {0};
+	double lon[3] = {0};
+	double *cols[2] = {lat, lon};
+	for (int i = 0; i < 3; i++) {
+		fill_random(bd[i], 8);
+		bm[i].PGN = (i == 1) ? 129026 : 129025;
+		bm[i].datalen = 8;
+		bm[i].data = bd[i];
+	}
+	if (n2k_decode_batch(pd, bm, 3, cols) != 2) {
+		// LCOV_EXCL_START
+		fprintf(stderr, "Unexpected number of messages decoded in batch\n");
+		res = false;
+		// LCOV_EXCL_STOP
+	}
+	for (int i = 0; i < 3; i++) {
+		double elat = NAN;
+		double elon = NAN;
+		if (i != 1) { n2k_129025_values(&(bm[i]), &elat, &elon); }
+		res &= compare(129025, 0, lat[i], elat);
+		res &= compare(129025, 1, lon[i], elon);
+	}
+
+	if (res) { fprintf(stdout, "All tests succeeded\n"); }
+	return (res ? 0 : 1);
+}
+
+/*!
+ * Values are considered equal if both are NAN, or if they differ by less
+ * than one part in 10^9.
+ *
+ * @param[in] pgn PGN (for error reporting)
+ * @param[in] field Field index (for error reporting)
+ * @param[in] a Table decoded value
+ * @param[in] b Reference value
+ * @returns True if values match
+ */
+bool compare(const uint32_t pgn, const int field, const double a, const double b) {
+	if (isnan(a) && isnan(b)) { return true; }
+	if (fabs(a - b) <= 1E-9 * fmax(1.0, fabs(b))) { return true; }
+	// LCOV_EXCL_START
+	fprintf(stderr, "PGN %u, field %d: Decoded %.10lf, expected %.10lf\n", pgn, field, a, b);
+	return false;
+	// LCOV_EXCL_STOP
+}
+
+/*!
+ * @param[out] data Array to fill
+ * @param[in] len Number of bytes to fill
+ */
+void fill_random(uint8_t *data, const size_t len) {
+	for (size_t i = 0; i < len; i++) {
+		// Bias towards the reserved values so they get tested regularly
+		int r = rand() % 40;
+		data[i] = (r == 0) ? 0xFF : ((r == 1) ? 0x7F : (r == 2) ? 0x80 : (rand() & 0xFF));
+	}
+}
+
+/*!
+ * Some of the PGN specific functions return integer fields without checking
+ * for reserved values, so apply the same "not available" check as the table
+ * decoder to get a comparable reference value.
+ *
+ * @param[in] data Message data
+ * @param[in] byte Field offset in bytes
+ * @param[in] bits Field width in bits
+ * @param[in] v Value returned by PGN specific function
+ * @returns NAN if the raw (unsigned) field is at its maximum value, otherwise v
+ */
+double unavailable(const uint8_t *data, const uint16_t byte, const uint8_t bits, const double v) {
+	const uint64_t umax = (bits < 64) ? ((1ULL << bits) - 1) : UINT64_MAX;
+	if (n2k_get_bits(data, byte * 8, bits) == umax) { return NAN; }
+	return v;
+}
+
+/*!
+ * Fills message with random data and compares output from table decoder
+ * with the matching PGN specific function
+ *
+ * @param[in] n Message to use, with PGN already set
+ * @param[in] data Data array pointed to by n
+ * @returns True if all fields match
+ */
+bool check_pgn(n2k_act_message *n, uint8_t *data) {
+	const n2k_pgn_desc *pd = n2k_pgn_find(n->PGN);
+	if (!pd) {
+		// LCOV_EXCL_START
+		fprintf(stderr, "Unable to find description for PGN %u\n", n->PGN);
+		return false;
+		// LCOV_EXCL_STOP
+	}
+	n->datalen = pd->minLength;
+	fill_random(data, n->datalen);
+
+	double v[N2K_MAX_FIELDS] = {0};
+	if (n2k_decode_message(pd, n, v) < 0) {
+		// LCOV_EXCL_START
+		fprintf(stderr, "Failed to decode PGN %u\n", n->PGN);
+		return false;
+		// LCOV_EXCL_STOP
+	}
+
+	double e[N2K_MAX_FIELDS] = {0};
+	uint8_t seq = 0;
+	uint8_t u1 = 0;
+	uint8_t u2 = 0;
+	uint8_t u3 = 0;
+	uint16_t d16 = 0;
+	int16_t s16 = 0;
+	switch (n->PGN) {
+		case 127250:
+			n2k_127250_values(n, &seq, &e[0], &e[1], &e[2], &u1);
+			e[3] = u1;
+			break;
+		case 127251:
+			n2k_127251_values(n, &seq, &e[0]);
+			break;
+		case 127257:
+			n2k_127257_values(n, &seq, &e[0], &e[1], &e[2]);
+			break;
+		case 128267:
+			n2k_128267_values(n, &seq, &e[0], &e[1], &e[2]);
+			break;
+		case 129025:
+			n2k_129025_values(n, &e[0], &e[1]);
+			break;
+		case 129026:
+			n2k_129026_values(n, &seq, &u1, &e[1], &e[2]);
+			e[0] = u1;
+			break;
+		case 129029:
+			n2k_129029_values(n, &seq, &d16, &e[1], &e[2], &e[3], &e[4], &u1, &u2,
+			                  NULL, &u3, &e[8], &e[9], &e[10], NULL, NULL, NULL, NULL);
+			e[0] = unavailable(data, 1, 16, d16);
+			e[1] = unavailable(data, 3, 32, e[1]);
+			e[5] = u1;
+			e[6] = u2;
+			e[7] = unavailable(data, 33, 8, u3);
+			break;
+		case 129033: {
+			n2k_129033_values(n, &d16, &e[1], &s16);
+			e[0] = unavailable(data, 0, 16, d16);
+			e[1] = unavailable(data, 2, 32, e[1]);
+			// Out of range offsets are replaced with zero by n2k_129033_values()
+			const int16_t raw = (int16_t)n2k_get_bits(data, 48, 16);
+			if (raw == INT16_MAX || raw == INT16_MIN) {
+				e[2] = NAN;
+			} else if (raw >= 1440 || raw <= -1440) {
+				e[2] = raw;
+			} else {
+				e[2] = s16;
+			}
+			break;
+		}
+		case 130306:
+			n2k_130306_values(n, &seq, &u1, &e[0], &e[1]);
+			e[2] = u1;
+			break;
+		case 130311:
+			n2k_130311_values(n, &seq, &u1, &u2, &e[2], &e[3], &e[4]);
+			e[0] = u1;
+			e[1] = u2;
+			break;
+	}
+
+	bool res = true;
+	for (int f = 0; f < pd->nFields; f++) {
+		res &= compare(n->PGN, f, v[f], e[f]);
+	}
+	return res;
+}
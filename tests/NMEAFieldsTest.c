@@ -0,0 +1,263 @@
+/*
+ *  Copyright (C) 2023 Swansea University
+ *
+ *  This file is part of the SELKIELogger suite of tools.
+ *
+ *  SELKIELogger is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation, either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  SELKIELogger is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this SELKIELogger product.
+ *  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <ctype.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "SELKIELoggerNMEA.h"
+
+/*! @file
+ *
+ * @brief Check table driven NMEA sentence decoding
+ *
+ * @test Sample sentences (with checksums calculated here) are read back using
+ * nmea_readMessage_buf() and decoded with nmea_decode_message(), and the
+ * results compared with known values. Checksum conversion with
+ * nmea_hex_decode() is checked for every possible pair of characters.
+ *
+ * @ingroup testing
+ */
+
+//! Sample sentence and expected decoded values
+typedef struct {
+	const char *body;   //!< Sentence, without start byte or checksum
+	int result;         //!< Expected return value from nmea_decode_message()
+	double values[8];   //!< Expected values
+} nft_sample;
+
+bool compare(const char *id, const int field, const double a, const double b);
+bool check_hex(void);
+bool check_numbers(void);
+bool write_sentence(const int handle, const char *body);
+
+/*!
+ * Check table driven decoding against known values
+ *
+ * @returns 0 on success, 1 on failure
+ */
+int main(void) {
+	const double kn = 1852.0 / 3600.0;
+	const nft_sample samples[] = {
+		{"GPGGA,123519.50,4807.038,N,01131.000,W,1,08,0.9,545.4,M,46.9,M,,",
+		 8,
+		 {45319.5, 48 + 7.038 / 60, -(11 + 31.0 / 60), 1, 8, 0.9, 545.4, 46.9}},
+		{"GPRMC,225446,A,4916.45,S,12311.12,E,000.5,054.7,191194,020.3,E",
+		 8,
+		 {82486, 1, -(49 + 16.45 / 60), 123 + 11.12 / 60, 0.5 * kn, 54.7, 9088, 20.3}},
+		{"GPRMC,225446,V,,,,,,,191194,004.2,W", 4, {82486, 0, NAN, NAN, NAN, NAN, 9088, -4.2}},
+		{"IIVTG,054.7,T,034.4,M,005.5,N,010.2,K", 3, {54.7, 34.4, 5.5 * kn}},
+		{"IIHDT,274.07,T", 1, {274.07}},
+		{"IIHDT,27a.07,T", 0, {NAN}},
+		{"WIMWV,045.0,R,36.0,K,A", 4, {45.0, 0, 10.0, 1}},
+		{"WIMWV,315.5,T,12.5,X,V", 3, {315.5, 1, NAN, 0}},
+		{"YXMTW,-1.5,C", 1, {-1.5}},
+		{"IIXDR,C,,C,ENV_WATER_T,C,16.24,C,ENV_OUTAIR_T,P,101800,P,ENV_ATMOS_P",
+		 2,
+		 {NAN, 16.24, 101800, NAN}},
+		{"IIZDA,235959.99,31,12,2023,00,00", 4, {86399.99, 31, 12, 2023}},
+		{"SDDPT,12.3,-0.5", 2, {12.3, -0.5, NAN}},
+		{"GPGGA,123519,4807.038,N", -1, {0}},
+		{"PABCGGA,123519,4807.038,N,01131.000,W,1,08,0.9,545.4,M,46.9,M,,", -1, {0}},
+	};
+	const int nSamples = sizeof(samples) / sizeof(samples[0]);
+	bool res = true;
+
+	res &= check_hex();
+	res &= check_numbers();
+
+	int pipefd[2] = {0};
+	if (pipe(pipefd) != 0) {
+		// LCOV_EXCL_START
+		perror("pipe");
+		return 1;
+		// LCOV_EXCL_STOP
+	}
+	for (int i = 0; i < nSamples; i++) {
+		if (!write_sentence(pipefd[1], samples[i].body)) {
+			// LCOV_EXCL_START
+			fprintf(stderr, "Unable to write sample %d\n", i);
+			return 1;
+			// LCOV_EXCL_STOP
+		}
+	}
+	close(pipefd[1]);
+
+	uint8_t buf[NMEA_SERIAL_BUFF] = {0};
+	int index = 0;
+	int hw = 0;
+	int count = 0;
+	while (count < nSamples) {
+		nmea_msg_t m = {0};
+		if (!nmea_readMessage_buf(pipefd[0], &m, buf, &index, &hw)) {
+			if (m.raw[0] == 0xFD || m.raw[0] == 0xAA) { break; }
+			continue;
+		}
+		const nft_sample *s = &(samples[count++]);
+
+		// Check regenerated message (including checksum) matches input
+		char *flat = NULL;
+		const size_t fl = nmea_flat_array(&m, &flat);
+		if (fl != strlen(s->body) + 4 || strncmp(&(flat[1]), s->body, fl - 4) != 0 ||
+		    !nmea_check_checksum(&m)) {
+			// LCOV_EXCL_START
+			fprintf(stderr, "Regenerated message does not match: %.*s\n", (int)fl, flat);
+			res = false;
+			// LCOV_EXCL_STOP
+		}
+		free(flat);
+
+		// Proprietary messages have a longer talker ID, so message ID offset varies
+		const char *id = &(s->body[(s->body[0] == 'P') ? 4 : 2]);
+		const nmea_sentence_desc *sd = nmea_sentence_find(id);
+		if (!sd) {
+			// Sentence not in table, so just check it was expected to fail
+			if (s->result != -1) {
+				// LCOV_EXCL_START
+				fprintf(stderr, "Unable to find description for %.3s\n", id);
+				res = false;
+				// LCOV_EXCL_STOP
+			}
+			continue;
+		}
+
+		nmea_tokens tok = {0};
+		nmea_tokenise(&m, &tok);
+		double v[NMEA_MAX_DECODE] = {0};
+		const int r = nmea_decode_message(sd, &m, &tok, v);
+		if (r != s->result) {
+			// LCOV_EXCL_START
+			fprintf(stderr, "%s: Decoded %d values, expected %d\n", s->body, r, s->result);
+			res = false;
+			continue;
+			// LCOV_EXCL_STOP
+		}
+		for (int f = 0; r >= 0 && f < sd->nFields; f++) {
+			res &= compare(sd->message, f, v[f], s->values[f]);
+		}
+	}
+	close(pipefd[0]);
+
+	if (count != nSamples) {
+		// LCOV_EXCL_START
+		fprintf(stderr, "Read %d messages, expected %d\n", count, nSamples);
+		res = false;
+		// LCOV_EXCL_STOP
+	}
+
+	if (res) { fprintf(stdout, "All tests succeeded\n"); }
+	return (res ? 0 : 1);
+}
+
+/*!
+ * Values are considered equal if both are NAN, or if they differ by less
+ * than one part in 10^9.
+ *
+ * @param[in] id Message ID (for error reporting)
+ * @param[in] field Field index (for error reporting)
+ * @param[in] a Table decoded value
+ * @param[in] b Reference value
+ * @returns True if values match
+ */
+bool compare(const char *id, const int field, const double a, const double b) {
+	if (isnan(a) && isnan(b)) { return true; }
+	if (fabs(a - b) <= 1E-9 * fmax(1.0, fabs(b))) { return true; }
+	// LCOV_EXCL_START
+	fprintf(stderr, "%s, field %d: Decoded %.10lf, expected %.10lf\n", id, field, a, b);
+	return false;
+	// LCOV_EXCL_STOP
+}
+
+/*!
+ * Compare nmea_hex_decode() with strtol() for every pair of characters
+ *
+ * @returns True if all pairs are handled correctly
+ */
+bool check_hex(void) {
+	for (int hi = 0; hi < 256; hi++) {
+		for (int lo = 0; lo < 256; lo++) {
+			const char s[3] = {hi, lo, 0};
+			char *end = NULL;
+			const long ref = strtol(s, &end, 16);
+			// strtol also accepts whitespace, signs and prefixes
+			const bool valid = (end == &(s[2])) && isxdigit(hi) && isxdigit(lo);
+
+			uint8_t out = 0;
+			const bool r = nmea_hex_decode(hi, lo, &out);
+			if (r != valid || (valid && out != ref)) {
+				// LCOV_EXCL_START
+				fprintf(stderr, "Hex decode failed for 0x%02x 0x%02x\n", hi, lo);
+				return false;
+				// LCOV_EXCL_STOP
+			}
+		}
+	}
+	return true;
+}
+
+/*!
+ * Check number parsing and tokenisation with edge cases not covered by the
+ * sample sentences
+ *
+ * @returns True if all values match
+ */
+bool check_numbers(void) {
+	const char *raw = "-0012.50,,+,1.2.3,123456789012345678901.5,0.0000000000000000001,7";
+	const double expected[] = {-12.5, NAN, NAN, NAN, 123456789012345678901.5, 0, 7};
+	nmea_msg_t m = {.talker = "II", .message = "XXX", .rawlen = strlen(raw)};
+	memcpy(m.raw, raw, m.rawlen);
+
+	nmea_tokens tok = {0};
+	const int n = nmea_tokenise(&m, &tok);
+	if (n != 7 || tok.start[2] != 10 || tok.length[1] != 0 || tok.length[6] != 1) {
+		// LCOV_EXCL_START
+		fprintf(stderr, "Unexpected tokenisation (%d fields)\n", n);
+		return false;
+		// LCOV_EXCL_STOP
+	}
+
+	bool res = true;
+	for (int f = 0; f < n; f++) {
+		res &= compare("XXX", f, nmea_field_number(&m, &tok, f), expected[f]);
+	}
+	res &= isnan(nmea_field_number(&m, &tok, n));
+	return res;
+}
+
+/*!
+ * @param[in] handle File descriptor to write sentence to
+ * @param[in] body Sentence content, without start byte and checksum
+ * @returns True if sentence written successfully
+ */
+bool write_sentence(const int handle, const char *body) {
+	uint8_t cs = 0;
+	for (const char *c = body; *c; c++) {
+		cs ^= *c;
+	}
+	char out[100] = {0};
+	const int len = snprintf(out, sizeof(out), "$%s*%02X\r\n", body, cs);
+	if (len <= 0 || len >= (int)sizeof(out)) { return false; }
+	return (write(handle, out, len) == len);
+}
@@ -172,6 +172,54 @@ int main(void) {
 		// LCOV_EXCL_STOP
 	}
 
+	fprintf(stdout, "Push chain of messages...\n");
+	queueitem *chain = NULL;
+	for (int i = 3; i > 0; i--) {
+		queueitem *qi = calloc(1, sizeof(queueitem));
+		qi->item = msg_new_float(1, 5, i);
+		qi->next = chain;
+		chain = qi;
+	}
+	if (!queue_push_qi(&QT, chain)) {
+		// LCOV_EXCL_START
+		fprintf(stderr, "Unable to push chain to queue\n");
+		return -1;
+		// LCOV_EXCL_STOP
+	}
+
+	// Removing the first item of the chain must leave the tail intact
+	out = queue_pop(&QT);
+	msg_destroy(out);
+	free(out);
+	if (!queue_push(&QT, msg_new_float(1, 5, 4.0))) {
+		// LCOV_EXCL_START
+		fprintf(stderr, "Unable to push item to queue\n");
+		perror("queue_push");
+		return -1;
+		// LCOV_EXCL_STOP
+	}
+
+	count = queue_count(&QT);
+	if (count != 3) {
+		// LCOV_EXCL_START
+		fprintf(stderr, "Incorrect item count after chain (expected 3, got %d)\n", count);
+		return -1;
+		// LCOV_EXCL_STOP
+	}
+
+	for (int i = 2; i <= 4; i++) {
+		msg_t *item = queue_pop(&QT);
+		if (item == NULL || item->data.value != i) {
+			// LCOV_EXCL_START
+			fprintf(stderr, "Chained messages out of order? (Expected value %d)\n", i);
+			queue_destroy(&QT);
+			return -1;
+			// LCOV_EXCL_STOP
+		}
+		msg_destroy(item);
+		free(item);
+	}
+
 	if (!queue_push(&QT, msg_new_string(1, 5, 20, "Test Message - 1234"))) {
 		// LCOV_EXCL_START
 		fprintf(stderr, "Unable to push string message to queue");
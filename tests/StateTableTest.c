@@ -0,0 +1,204 @@
+/*
+ *  Copyright (C) 2023 Swansea University
+ *
+ *  This file is part of the SELKIELogger suite of tools.
+ *
+ *  SELKIELogger is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation, either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  SELKIELogger is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this SELKIELogger product.
+ *  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "SELKIELoggerBase.h"
+
+/*! @file StateTableTest.c
+ *
+ * @brief Shared state table testing
+ *
+ * @test Creates a state table and records a variety of messages, then opens
+ * the same table read-only and checks that the counts, timestamps and values
+ * recorded match the messages written.
+ *
+ * @ingroup testing
+ */
+
+//! Table file created (and removed) by this test
+#define TEST_TABLE "StateTableTest.table"
+
+/*!
+ * Record a message, then check the entry visible to a reader
+ *
+ * @param[in] wt Writable table
+ * @param[in] rt Read-only table
+ * @param[in] msg Message to record (destroyed by this function)
+ * @param[in] ts Timestamp to record with message
+ * @param[in] count Expected message count after update
+ * @param[in] expected Expected string representation, or NULL if this should
+ *                     match msg_data_to_string()
+ * @returns True if entry matches expectations
+ */
+bool check_entry(state_table *wt, state_table *rt, msg_t *msg, uint32_t ts, uint32_t count,
+                 const char *expected);
+
+/*!
+ * Create, update, read and remove state table
+ *
+ * @returns 0 (Pass), -1 (Fail)
+ */
+int main(void) {
+	state_table wt = {0};
+	state_table rt = {0};
+
+	if (!state_table_create(&wt, TEST_TABLE)) {
+		// LCOV_EXCL_START
+		perror("state_table_create");
+		return -1;
+		// LCOV_EXCL_STOP
+	}
+
+	if (!state_table_open(&rt, TEST_TABLE)) {
+		// LCOV_EXCL_START
+		perror("state_table_open");
+		state_table_close(&wt);
+		unlink(TEST_TABLE);
+		return -1;
+		// LCOV_EXCL_STOP
+	}
+
+	state_table_set_varfile(&wt, "test.var");
+	state_table_set_timestamp(&wt, 1234);
+
+	state_header hdr = {0};
+	if (!state_table_read_header(&rt, &hdr) || hdr.lastTimestamp != 1234 ||
+	    strcmp(hdr.varFile, "test.var") != 0 || hdr.pid != (uint32_t)getpid()) {
+		// LCOV_EXCL_START
+		fprintf(stderr, "Incorrect state table header\n");
+		state_table_close(&rt);
+		state_table_close(&wt);
+		unlink(TEST_TABLE);
+		return -1;
+		// LCOV_EXCL_STOP
+	}
+	fprintf(stdout, "Header OK\n");
+
+	const float shortArray[] = {1.5, 2.5, 3.5};
+	float longArray[40] = {0};
+	for (int i = 0; i < 40; i++) {
+		longArray[i] = i;
+	}
+	char longString[200] = {0};
+	memset(longString, 'x', sizeof(longString) - 1);
+	const uint8_t bytes[] = {0x01, 0x02, 0x03, 0x04};
+
+	bool ok = true;
+	ok &= check_entry(&wt, &rt, msg_new_float(0x10, 0x04, 13.0), 10, 1, NULL);
+	ok &= check_entry(&wt, &rt, msg_new_float(0x10, 0x04, -2.5), 11, 2, NULL);
+	ok &= check_entry(&wt, &rt, msg_new_timestamp(0x02, 0x02, 1235), 12, 1, NULL);
+	ok &= check_entry(&wt, &rt, msg_new_string(0x10, 0x00, 4, "Test"), 13, 1, NULL);
+	ok &= check_entry(&wt, &rt, msg_new_float_array(0x11, 0x05, 3, shortArray), 14, 1, NULL);
+	ok &= check_entry(&wt, &rt, msg_new_bytes(0x12, 0x06, 4, bytes), 15, 1, NULL);
+	fprintf(stdout, "Short messages %s\n", ok ? "OK" : "Failed");
+
+	// Long values are truncated, so compare against expected prefix
+	char *expected = NULL;
+	{
+		msg_t *tmp = msg_new_float_array(0x11, 0x06, STATE_VALUE_SIZE / sizeof(float),
+		                                 longArray);
+		expected = msg_data_to_string(tmp);
+		msg_destroy(tmp);
+		free(tmp);
+	}
+	ok &= check_entry(&wt, &rt, msg_new_float_array(0x11, 0x06, 40, longArray), 16, 1,
+	                  expected);
+	free(expected);
+
+	longString[STATE_VALUE_SIZE - 1] = '\0';
+	expected = strdup(longString);
+	longString[STATE_VALUE_SIZE - 1] = 'x';
+	ok &= check_entry(&wt, &rt, msg_new_string(0x12, 0x07, strlen(longString), longString), 17,
+	                  1, expected);
+	free(expected);
+	fprintf(stdout, "Long messages %s\n", ok ? "OK" : "Failed");
+
+	state_entry e = {0};
+	if (!state_table_read(&rt, 0x12, 0x07, &e) || e.length != sizeof(longString) - 1) {
+		// LCOV_EXCL_START
+		fprintf(stderr, "Original string length not recorded\n");
+		ok = false;
+		// LCOV_EXCL_STOP
+	}
+
+	if (!state_table_read(&rt, 0x7F, 0x7F, &e) || e.count != 0) {
+		// LCOV_EXCL_START
+		fprintf(stderr, "Unused entry not empty\n");
+		ok = false;
+		// LCOV_EXCL_STOP
+	}
+
+	// Read-only tables must not be modified
+	msg_t *ro = msg_new_float(0x7F, 0x7F, 1.0);
+	state_table_update(&rt, ro, 1);
+	msg_destroy(ro);
+	free(ro);
+	if (!state_table_read(&rt, 0x7F, 0x7F, &e) || e.count != 0) {
+		// LCOV_EXCL_START
+		fprintf(stderr, "Read-only table modified\n");
+		ok = false;
+		// LCOV_EXCL_STOP
+	}
+
+	state_table_close(&rt);
+	state_table_close(&wt);
+	unlink(TEST_TABLE);
+
+	if (!ok) { return -1; }
+	fprintf(stdout, "State table tests passed\n");
+	return 0;
+}
+
+bool check_entry(state_table *wt, state_table *rt, msg_t *msg, uint32_t ts, uint32_t count,
+                 const char *expected) {
+	state_table_update(wt, msg, ts);
+
+	state_entry e = {0};
+	if (!state_table_read(rt, msg->source, msg->type, &e)) {
+		// LCOV_EXCL_START
+		fprintf(stderr, "Unable to read entry 0x%02x:0x%02x\n", msg->source, msg->type);
+		msg_destroy(msg);
+		free(msg);
+		return false;
+		// LCOV_EXCL_STOP
+	}
+
+	char *exp = expected ? strdup(expected) : msg_data_to_string(msg);
+	char *val = state_entry_to_string(&e);
+	bool ok = (e.count == count) && (e.lastTimestamp == ts) && (e.dtype == msg->dtype) &&
+	          exp && val && (strcmp(exp, val) == 0);
+	if (!ok) {
+		// LCOV_EXCL_START
+		fprintf(stderr,
+		        "Entry 0x%02x:0x%02x mismatch: count %u (expected %u), timestamp %u "
+		        "(expected %u), value '%s' (expected '%s')\n",
+		        msg->source, msg->type, e.count, count, e.lastTimestamp, ts, val, exp);
+		// LCOV_EXCL_STOP
+	}
+	free(exp);
+	free(val);
+	msg_destroy(msg);
+	free(msg);
+	return ok;
+}
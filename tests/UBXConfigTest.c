@@ -0,0 +1,123 @@
+/*
+ *  Copyright (C) 2023 Swansea University
+ *
+ *  This file is part of the SELKIELogger suite of tools.
+ *
+ *  SELKIELogger is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation, either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  SELKIELogger is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this SELKIELogger product.
+ *  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "SELKIELoggerGPS.h"
+
+/*! @file UBXConfigTest.c
+ *
+ * @brief Test UBX configuration sequences
+ *
+ * @test Run a short configuration sequence against simulated responses,
+ * checking that commands are re-sent after a rejection, timeout or failed
+ * verification, and that the sequence completes or fails as expected.
+ *
+ * @ingroup testing
+ */
+
+bool check(const char *label, const bool result);
+int sent(const int handle);
+
+/*!
+ * Test ubx_config_* functions for CTest
+ *
+ * @returns 1 on error, otherwise 0
+ */
+int main(void) {
+	int p[2] = {0};
+	if (pipe(p) || fcntl(p[0], F_SETFL, O_NONBLOCK)) {
+		// LCOV_EXCL_START
+		perror("pipe");
+		return 1;
+		// LCOV_EXCL_STOP
+	}
+
+	const uint8_t navRate[] = {0xF4, 0x01, 0x01, 0x00};
+	const uint8_t badRate[] = {0xE8, 0x03, 0x01, 0x00};
+	const uint8_t ackRate[] = {0x06, 0x08};
+	const uint8_t ackOther[] = {0x06, 0x01};
+	const ubx_frame ack = {0xB5, UBXACK, 0x01, 2, NULL, ackRate};
+	const ubx_frame ackWrong = {0xB5, UBXACK, 0x01, 2, NULL, ackOther};
+	const ubx_frame nak = {0xB5, UBXACK, 0x00, 2, NULL, ackRate};
+	const ubx_frame rateGood = {0xB5, 0x06, 0x08, 6, NULL, navRate};
+	const ubx_frame rateBad = {0xB5, 0x06, 0x08, 6, NULL, badRate};
+
+	ubx_message cmd = ubx_buildSetNavigationRate(500, 1);
+	ubx_message poll = ubx_buildPollMessage(0x06, 0x08);
+
+	bool res = true;
+	ubx_config c = {0};
+	ubx_config_init(&c, 1);
+	res &= check("Empty sequence complete", c.state == UBXCFG_DONE);
+	res &= check("Add command", ubx_config_add_command(&c, &cmd, 100, 0));
+	res &= check("Add poll", ubx_config_add_poll(&c, &poll, navRate, 4, 100));
+
+	res &= check("Command sent", ubx_config_run(&c, p[1], 0) == UBXCFG_WAITING);
+	res &= check("Command written", sent(p[0]) == 14);
+	res &= check("Unrelated ACK ignored", !ubx_config_frame(&c, &ackWrong, 5));
+	res &= check("NAK recognised", ubx_config_frame(&c, &nak, 5) && c.naks == 1);
+	res &= check("Command re-sent", ubx_config_run(&c, p[1], 5) == UBXCFG_WAITING);
+	res &= check("Command re-written", sent(p[0]) == 14);
+	res &= check("ACK recognised", ubx_config_frame(&c, &ack, 10) && c.current == 1);
+
+	res &= check("Poll sent", ubx_config_run(&c, p[1], 10) == UBXCFG_WAITING);
+	res &= check("Poll written", sent(p[0]) == 8);
+	res &= check("Poll rejected", ubx_config_frame(&c, &rateBad, 20) && c.naks == 2);
+	res &= check("Poll re-sent", ubx_config_run(&c, p[1], 20) == UBXCFG_WAITING);
+	res &= check("Still waiting", ubx_config_run(&c, p[1], 119) == UBXCFG_WAITING);
+	res &= check("Timeout fails sequence", ubx_config_run(&c, p[1], 120) == UBXCFG_FAILED);
+	res &= check("Timeout counted", c.timeouts == 1);
+	sent(p[0]);
+
+	ubx_config_init(&c, 0);
+	ubx_config_add_poll(&c, &poll, navRate, 4, 100);
+	ubx_config_run(&c, p[1], 0);
+	res &= check("Poll verified", ubx_config_frame(&c, &rateGood, 1) && c.state == UBXCFG_DONE);
+	res &= check("No further messages", ubx_config_run(&c, p[1], 500) == UBXCFG_DONE);
+	res &= check("Nothing else written", sent(p[0]) == 8);
+
+	close(p[0]);
+	close(p[1]);
+	return (res ? 0 : 1);
+}
+
+/*!
+ * @param[in] label Test description
+ * @param[in] result Test result
+ * @returns result
+ */
+bool check(const char *label, const bool result) {
+	fprintf(stdout, "[%s] %s\n", result ? "Pass" : "Fail", label);
+	return result;
+}
+
+/*!
+ * @param[in] handle Read end of pipe used in place of serial port
+ * @returns Number of bytes waiting to be read, after discarding them
+ */
+int sent(const int handle) {
+	uint8_t buf[512] = {0};
+	int n = read(handle, buf, sizeof(buf));
+	return n > 0 ? n : 0;
+}
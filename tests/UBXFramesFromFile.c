@@ -0,0 +1,106 @@
+/*
+ *  Copyright (C) 2023 Swansea University
+ *
+ *  This file is part of the SELKIELogger suite of tools.
+ *
+ *  SELKIELogger is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation, either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  SELKIELogger is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this SELKIELogger product.
+ *  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "SELKIELoggerGPS.h"
+
+/*! @file UBXFramesFromFile.c
+ *
+ * @brief Test reading u-Blox GPS messages in place from a file
+ *
+ * @test Read supplied u-Blox GPS messages with ubx_readFrame_buf() and check
+ * that each message referenced in the buffer is complete and valid.
+ *
+ * @ingroup testing
+ */
+
+/*!
+ * Read data from file until end of file is reached, outputting total number of
+ * entries read.
+ *
+ * Exact outputs dependent on supplied test data
+ *
+ * @param[in] argc Argument count
+ * @param[in] argv Arguments
+ * @returns 0 (Pass), -1 (Fail), -2 (Failed to run / Error)
+ */
+int main(int argc, char *argv[]) {
+	//LCOV_EXCL_START
+	if (argc < 2) {
+		fprintf(stderr, "Usage: %s <file>\n", argv[0]);
+		return -2;
+	}
+
+	errno = 0;
+	FILE *testFile = fopen(argv[1], "r");
+	if ((testFile == NULL) || errno) {
+		fprintf(stderr, "Unable to open test file %s\n", argv[1]);
+		perror("open");
+		return -2;
+	}
+	//LCOV_EXCL_STOP
+
+	uint8_t buf[UBX_SERIAL_BUFF] = {0};
+	int index = 0;
+	int hw = 0;
+	int count = 0;
+	int exit = 0;
+	while (exit == 0) {
+		ubx_frame tmp = {0};
+		if (ubx_readFrame_buf(fileno(testFile), &tmp, buf, &index, &hw)) {
+			const size_t len = UBX_FRAME_SIZE(tmp.length);
+			if (tmp.frame < buf || (tmp.frame + len) > (buf + hw) ||
+			    !ubx_check_frame(tmp.frame, len)) {
+				//LCOV_EXCL_START
+				fprintf(stderr, "Invalid frame returned\n");
+				fclose(testFile);
+				return -1;
+				//LCOV_EXCL_STOP
+			}
+			count++;
+		} else {
+			switch (tmp.sync1) {
+				//LCOV_EXCL_START
+				case 0xAA:
+					fclose(testFile);
+					return -2;
+					break;
+				case 0xEE:
+					fclose(testFile);
+					return -1;
+					break;
+				//LCOV_EXCL_STOP
+				case 0xFD:
+					exit = 1;
+					break;
+				case 0xFF:
+				default:
+					break;
+			}
+		}
+	}
+	fprintf(stdout, "%d messages read\n", count);
+	fclose(testFile);
+	return 0;
+}
@@ -134,11 +134,15 @@ int main(int argc, char *argv[]) {
 	mqtt_queue_map qm = {0};
 	mqtt_init_queue_map(&qm);
 	for (int t = 0; t < remaining; t++) {
-		qm.numtopics++;
-		qm.tc[t].type = 4 + t;
-		qm.tc[t].topic = strdup(argv[optind + t]);
-		qm.tc[t].name = strdup(argv[optind + t]);
-		qm.tc[t].text = true;
+		const char *topic = argv[optind + t];
+		const int type = 4 + t;
+		if (type >= SLCHAN_LOG_INFO || !mqtt_add_topic(&qm, topic, topic, type, 1, true)) {
+			log_error(&state, "Unable to add topic %s", topic);
+			mqtt_destroy_queue_map(&qm);
+			free(host);
+			free(sysid);
+			return EXIT_FAILURE;
+		}
 	}
 
 	qm.dumpall = dumpAll;
@@ -187,8 +191,10 @@ int main(int argc, char *argv[]) {
 			usleep(5000);
 			continue;
 		}
-		log_info(&state, 1, "[0x%02x] %s - %s", in->type,
-		         in->type >= 4 ? qm.tc[in->type - 4].name : "RAW", in->data.string.data);
+		char *cn = mqtt_channel_name(&qm, in->type);
+		log_info(&state, 1, "[0x%02x] %s - %s", in->type, cn ? cn : "RAW",
+		         in->data.string.data);
+		free(cn);
 		msg_destroy(in);
 		free(in);
 	}
@@ -18,6 +18,9 @@
  *  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -36,23 +39,91 @@
  * @ingroup Executables
  */
 
-//! Largest possible PGN value
-#define PGN_MAX 16777216
+/*!
+ * @defgroup n2kclassify N2KClassify internal functions
+ * @ingroup Executables
+ * @{
+ */
 
 //! Allocated read buffer size
-#define BUFSIZE 1024
+#define BUFSIZE 65536
 
-/*!
- * Count of messages seen by PGN number
- *
- * Could be smarter, but it's a relatively small amount of memory in the grand
- * scheme of things.
- */
-int msgCount[PGN_MAX];
+//! Initial number of slots in statistics table (must be a power of 2)
+#define N2KC_TABLE_INIT 256
+
+//! Maximum number of worker threads
+#define N2KC_MAX_THREADS 64
+
+//! Statistics for a single source address and PGN combination
+typedef struct {
+	bool used;            //!< Slot in use
+	uint8_t src;          //!< Source address
+	uint32_t PGN;         //!< PGN
+	uint64_t count;       //!< Number of valid messages
+	uint64_t bytes;       //!< Total payload bytes in valid messages
+	uint64_t csumErrors;  //!< Number of messages with invalid checksums
+	uint64_t intervals;   //!< Number of intervals measured
+	double sumInterval;   //!< Sum of measured intervals (ms)
+	uint32_t minInterval; //!< Shortest interval between messages (ms)
+	uint32_t maxInterval; //!< Longest interval between messages (ms)
+	uint32_t lastTS;      //!< Timestamp of previous valid message
+} n2kc_stats;
+
+//! Hash table of n2kc_stats entries, keyed by source address and PGN
+typedef struct {
+	size_t size;       //!< Number of slots allocated
+	size_t used;       //!< Number of slots in use
+	n2kc_stats *slots; //!< Table entries
+} n2kc_table;
+
+//! Per file processing state and results
+typedef struct {
+	const char *fileName; //!< Input file name
+	bool debug;           //!< Enable verbose parser output
+	bool ok;              //!< File processed successfully
+	uint64_t messages;    //!< Total valid messages
+	uint64_t csumErrors;  //!< Total checksum failures
+	uint64_t bytesRead;   //!< Total bytes read from file
+	n2kc_table stats;     //!< Statistics by source and PGN
+} n2kc_file;
+
+//! Shared work queue for worker threads
+typedef struct {
+	pthread_mutex_t lock; //!< Protects next
+	int next;             //!< Index of next file to be processed
+	int count;            //!< Number of entries in files
+	n2kc_file *files;     //!< Files to be processed
+} n2kc_queue;
+
+//! Find (or create) entry in statistics table
+n2kc_stats *n2kc_lookup(n2kc_table *t, const uint8_t src, const uint32_t pgn);
+
+//! Update statistics for a single message
+bool n2kc_record(n2kc_table *t, const n2k_act_message *msg, const bool valid);
+
+//! Read and classify all messages in a single file
+void n2kc_process(n2kc_file *f);
+
+//! Worker thread: Process files from queue until none remain
+void *n2kc_worker(void *ptargs);
+
+//! qsort() comparison function, ordering by source then PGN
+int n2kc_sort(const void *a, const void *b);
+
+//! Print file statistics as text
+void n2kc_print_text(FILE *out, n2kc_file *f);
+
+//! Print file statistics as a JSON object
+void n2kc_print_json(FILE *out, n2kc_file *f);
+
+//! @}
 
 /*!
- * Reads messages from file, and prints the number seen for each PGN number.
- * Zero counts are suppressed.
+ * Reads messages from each file, and prints statistics for each combination
+ * of source address and PGN seen.
+ *
+ * Files are processed in parallel, but results are always printed in the
+ * order the files were specified.
  *
  * @param[in] argc Argument count
  * @param[in] argv Arguments
@@ -62,22 +133,46 @@ int main(int argc, char *argv[]) {
 	program_state state = {0};
 	state.verbose = 1;
 
-	char *usage = "Usage: %1$s datfile\n"
+	char *usage = "Usage: %1$s [-v] [-q] [-j threads] [-J] file [file ...]\n"
+		      "\t-v\tIncrease verbosity\n"
+		      "\t-q\tDecrease verbosity\n"
+		      "\t-j\tNumber of files to process in parallel\n"
+		      "\t-J\tWrite output in JSON format\n"
 		      "\nVersion: " GIT_VERSION_STRING "\n";
 
+	int nThreads = sysconf(_SC_NPROCESSORS_ONLN);
+	bool json = false;
+
 	opterr = 0; // Handle errors ourselves
 	int go = 0;
 	bool doUsage = false;
-	while ((go = getopt(argc, argv, "")) != -1) {
+	while ((go = getopt(argc, argv, "vqj:J")) != -1) {
 		switch (go) {
+			case 'v':
+				state.verbose++;
+				break;
+			case 'q':
+				state.verbose--;
+				break;
+			case 'j':
+				errno = 0;
+				nThreads = strtol(optarg, NULL, 0);
+				if (errno || nThreads < 1 || nThreads > N2KC_MAX_THREADS) {
+					log_error(&state, "Invalid number of threads (%s)", optarg);
+					doUsage = true;
+				}
+				break;
+			case 'J':
+				json = true;
+				break;
 			case '?':
 				log_error(&state, "Unknown option `-%c'", optopt);
 				doUsage = true;
 		}
 	}
 
-	// Should be 1 spare arguments: The file to convert
-	if (argc - optind != 1) {
+	// Should be at least 1 spare argument: The file(s) to process
+	if (argc - optind < 1) {
 		log_error(&state, "Invalid arguments");
 		doUsage = true;
 	}
@@ -87,68 +182,317 @@ int main(int argc, char *argv[]) {
 		return -1;
 	}
 
-	FILE *nf = fopen(argv[optind], "r");
+	if (nThreads < 1) { nThreads = 1; }
+	if (nThreads > N2KC_MAX_THREADS) { nThreads = N2KC_MAX_THREADS; }
 
-	if (nf == NULL) {
-		log_error(&state, "Unable to open input file \"%s\"", argv[optind]);
+	n2kc_queue q = {.lock = PTHREAD_MUTEX_INITIALIZER, .next = 0, .count = argc - optind};
+	q.files = calloc(q.count, sizeof(n2kc_file));
+	if (!q.files) {
+		log_error(&state, "Unable to allocate memory");
 		return -1;
 	}
+	for (int i = 0; i < q.count; i++) {
+		q.files[i].fileName = argv[optind + i];
+		q.files[i].debug = (state.verbose > 2);
+	}
+	if (nThreads > q.count) { nThreads = q.count; }
 
 	state.started = true;
-	bool processing = true;
+	pthread_t threads[N2KC_MAX_THREADS] = {0};
+	int started = 0;
+	for (int t = 0; t < nThreads; t++) {
+		if (pthread_create(&threads[t], NULL, &n2kc_worker, &q) != 0) {
+			log_warning(&state, "Unable to start worker thread");
+			break;
+		}
+		started++;
+	}
+	if (started == 0) {
+		// Fall back to processing in this thread
+		n2kc_worker(&q);
+	}
+	for (int t = 0; t < started; t++) {
+		pthread_join(threads[t], NULL);
+	}
 
-	uint8_t buf[BUFSIZE] = {0};
-	size_t hw = 0;
-	int count = 0;
-	while (processing || hw > 18) {
-		if (processing && (hw < BUFSIZE)) {
-			ssize_t ret = fread(&(buf[hw]), sizeof(uint8_t), BUFSIZE - hw, nf);
-			if (ret < 0) {
-				log_error(&state, "Unable to read data from input");
-				processing = false;
-			} else {
-				hw += ret;
+	int rc = 0;
+	if (json) { fprintf(stdout, "[\n"); }
+	for (int i = 0; i < q.count; i++) {
+		n2kc_file *f = &(q.files[i]);
+		if (!f->ok) {
+			log_error(&state, "Unable to read input file \"%s\"", f->fileName);
+			rc = -1;
+		} else {
+			// Information messages are written to stdout, so suppress
+			// them if generating JSON output
+			if (!json) {
+				log_info(&state, 1,
+				         "%s: %" PRIu64 " messages successfully read from file",
+				         f->fileName, f->messages);
+			}
+			if (f->csumErrors) {
+				log_warning(&state, "%s: %" PRIu64 " messages with invalid checksums",
+				            f->fileName, f->csumErrors);
 			}
 		}
-		if (feof(nf)) {
-			log_info(&state, 2, "End of file reached");
-			processing = false;
+		if (json) {
+			n2kc_print_json(stdout, f);
+			fprintf(stdout, "%s\n", (i < q.count - 1) ? "," : "");
+		} else if (f->ok) {
+			n2kc_print_text(stdout, f);
+		}
+		free(f->stats.slots);
+	}
+	if (json) { fprintf(stdout, "]\n"); }
+	free(q.files);
+	return rc;
+}
+
+/*!
+ * Uses open addressing with linear probing. The table is doubled in size when
+ * more than half full.
+ *
+ * @param[in,out] t Statistics table
+ * @param[in] src Source address
+ * @param[in] pgn PGN
+ * @returns Pointer to table entry, or NULL on allocation failure
+ */
+n2kc_stats *n2kc_lookup(n2kc_table *t, const uint8_t src, const uint32_t pgn) {
+	if (t->slots == NULL || (t->used + 1) * 2 > t->size) {
+		// (Re)allocate and rehash existing entries
+		size_t ns = t->size ? t->size * 2 : N2KC_TABLE_INIT;
+		n2kc_stats *nt = calloc(ns, sizeof(n2kc_stats));
+		if (!nt) { return NULL; }
+		for (size_t i = 0; i < t->size; i++) {
+			if (!t->slots[i].used) { continue; }
+			const uint32_t k = ((uint32_t)t->slots[i].src << 24) | t->slots[i].PGN;
+			size_t h = (k * 2654435761U) & (ns - 1);
+			while (nt[h].used) {
+				h = (h + 1) & (ns - 1);
+			}
+			nt[h] = t->slots[i];
+		}
+		free(t->slots);
+		t->slots = nt;
+		t->size = ns;
+	}
+
+	const uint32_t key = ((uint32_t)src << 24) | (pgn & 0xFFFFFF);
+	size_t h = (key * 2654435761U) & (t->size - 1);
+	while (t->slots[h].used) {
+		if (t->slots[h].src == src && t->slots[h].PGN == pgn) { return &(t->slots[h]); }
+		h = (h + 1) & (t->size - 1);
+	}
+	n2kc_stats *s = &(t->slots[h]);
+	s->used = true;
+	s->src = src;
+	s->PGN = pgn;
+	s->minInterval = UINT32_MAX;
+	t->used++;
+	return s;
+}
+
+/*!
+ * Messages with invalid checksums are only counted, and are not used for
+ * interval calculations.
+ *
+ * Intervals are calculated from the timestamps provided by the N2K gateway.
+ * If the timestamp decreases (e.g. following a gateway restart), the interval
+ * is not recorded.
+ *
+ * @param[in,out] t Statistics table
+ * @param[in] msg Message to record
+ * @param[in] valid Message checksum was valid
+ * @returns False on allocation failure
+ */
+bool n2kc_record(n2kc_table *t, const n2k_act_message *msg, const bool valid) {
+	n2kc_stats *s = n2kc_lookup(t, msg->src, msg->PGN);
+	if (!s) { return false; }
+
+	if (!valid) {
+		s->csumErrors++;
+		return true;
+	}
+
+	if (s->count > 0 && msg->timestamp >= s->lastTS) {
+		const uint32_t dt = msg->timestamp - s->lastTS;
+		s->intervals++;
+		s->sumInterval += dt;
+		if (dt < s->minInterval) { s->minInterval = dt; }
+		if (dt > s->maxInterval) { s->maxInterval = dt; }
+	}
+	s->lastTS = msg->timestamp;
+	s->count++;
+	s->bytes += msg->datalen;
+	return true;
+}
+
+/*!
+ * Data is read into a large buffer and parsed in place with n2k_act_parse(),
+ * so no memory is allocated per message. The read position advances through
+ * the buffer, and unprocessed data is only moved back to the start of the
+ * buffer when more space is required.
+ *
+ * @param[in,out] f File information and results
+ */
+void n2kc_process(n2kc_file *f) {
+	f->ok = false;
+	FILE *nf = fopen(f->fileName, "rb");
+	if (nf == NULL) { return; }
+
+	uint8_t *buf = malloc(BUFSIZE);
+	if (!buf) {
+		fclose(nf);
+		return;
+	}
+
+	uint8_t data[256] = {0};
+	size_t start = 0;
+	size_t hw = 0;
+	bool eof = false;
+	bool needData = true;
+	bool ok = true;
+	while (ok) {
+		if (!eof && (needData || (hw - start) < (BUFSIZE / 4))) {
+			if (start > 0) {
+				memmove(buf, &(buf[start]), hw - start);
+				hw -= start;
+				start = 0;
+			}
+			size_t ret = fread(&(buf[hw]), sizeof(uint8_t), BUFSIZE - hw, nf);
+			hw += ret;
+			f->bytesRead += ret;
+			if (ret == 0) { eof = true; }
+			needData = false;
 		}
-		n2k_act_message *nm = NULL;
+
+		const size_t avail = hw - start;
+		if (eof && avail < 18) { break; }
+
+		n2k_act_message nm = {0};
 		size_t end = 0;
-		bool r = n2k_act_from_bytes(buf, hw, &nm, &end, (state.verbose > 2));
+		bool r = n2k_act_parse(&(buf[start]), avail, &nm, data, &end, f->debug);
 		if (r) {
-			msgCount[nm->PGN]++;
-			count++;
-		} else {
-			if (!processing && end == 0) {
-				// If we're not making progress and we're at the end of file then
-				// this must be a bad message Force the process to move onwards
-				end = 1;
+			ok = n2kc_record(&(f->stats), &nm, true);
+			f->messages++;
+		} else if (nm.data) {
+			// Complete message, but checksum failed
+			ok = n2kc_record(&(f->stats), &nm, false);
+			f->csumErrors++;
+		} else if (end == 0) {
+			if (!eof && avail < BUFSIZE) {
+				// Need more data to make progress
+				needData = true;
+				continue;
 			}
+			// Buffer full or at end of file but no message found, so
+			// skip forward
+			end = 1;
 		}
+		start += end;
+		if (start > hw) { start = hw; }
+	}
+	free(buf);
+	f->ok = ok && !ferror(nf);
+	fclose(nf);
+}
 
-		if (nm) {
-			if (nm->data) { free(nm->data); }
-			free(nm);
-			nm = NULL;
-		}
+/*!
+ * @param[in] ptargs Pointer to n2kc_queue
+ * @returns NULL
+ */
+void *n2kc_worker(void *ptargs) {
+	n2kc_queue *q = (n2kc_queue *)ptargs;
+	while (true) {
+		pthread_mutex_lock(&(q->lock));
+		int ix = q->next++;
+		pthread_mutex_unlock(&(q->lock));
+		if (ix >= q->count) { break; }
+		n2kc_process(&(q->files[ix]));
+	}
+	return NULL;
+}
+
+/*!
+ * Unused entries are sorted to the end of the table.
+ *
+ * @param[in] a Pointer to n2kc_stats
+ * @param[in] b Pointer to n2kc_stats
+ * @returns Negative, zero, or positive value if a is less than, equal to, or greater than b
+ */
+int n2kc_sort(const void *a, const void *b) {
+	const n2kc_stats *sa = a;
+	const n2kc_stats *sb = b;
+	if (sa->used != sb->used) { return sa->used ? -1 : 1; }
+	if (sa->src != sb->src) { return (sa->src < sb->src) ? -1 : 1; }
+	if (sa->PGN != sb->PGN) { return (sa->PGN < sb->PGN) ? -1 : 1; }
+	return 0;
+}
+
+/*!
+ * Sorts the statistics table in place, so the table cannot be used for
+ * further lookups after calling this function.
+ *
+ * Intervals are reported in milliseconds.
+ *
+ * @param[in] out Output file
+ * @param[in,out] f File information and results
+ */
+void n2kc_print_text(FILE *out, n2kc_file *f) {
+	n2kc_table *t = &(f->stats);
+	if (t->slots) { qsort(t->slots, t->size, sizeof(n2kc_stats), &n2kc_sort); }
 
-		if ((hw - end) > 0) {
-			memmove(buf, &(buf[end]), hw - end);
-			hw -= end;
+	fprintf(out, "\n%s\n", f->fileName);
+	fprintf(out, "Src\t   PGN\t   Count\t   Bytes\tCSErrors\tMean (ms)\tMin (ms)\tMax (ms)\n");
+	for (size_t i = 0; i < t->used; i++) {
+		const n2kc_stats *s = &(t->slots[i]);
+		fprintf(out, "%3u\t%6u\t%8" PRIu64 "\t%8" PRIu64 "\t%8" PRIu64, s->src, s->PGN, s->count, s->bytes,
+		        s->csumErrors);
+		if (s->intervals > 0) {
+			fprintf(out, "\t%9.1f\t%8u\t%8u\n", s->sumInterval / s->intervals,
+			        s->minInterval, s->maxInterval);
 		} else {
-			hw = 0;
-			end = 0;
+			fprintf(out, "\t%9s\t%8s\t%8s\n", "-", "-", "-");
 		}
+	}
+}
 
-		memset(&(buf[hw]), 0, BUFSIZE - hw);
+/*!
+ * Writes a single JSON object describing a file, without a trailing newline.
+ * Sorts the statistics table in place, as per n2kc_print_text().
+ *
+ * Interval values are omitted (null) where fewer than two valid messages were
+ * received.
+ *
+ * @param[in] out Output file
+ * @param[in,out] f File information and results
+ */
+void n2kc_print_json(FILE *out, n2kc_file *f) {
+	n2kc_table *t = &(f->stats);
+	if (t->slots) { qsort(t->slots, t->size, sizeof(n2kc_stats), &n2kc_sort); }
+
+	fprintf(out, "{\"file\": \"");
+	for (const char *c = f->fileName; *c; c++) {
+		if (*c == '"' || *c == '\\') { fputc('\\', out); }
+		fputc(*c, out);
 	}
-	log_info(&state, 0, "%d messages successfully read from file", count);
-	fprintf(stdout, "\nPGN   \tCount\n");
-	for (int i = 0; i < PGN_MAX; i++) {
-		if (msgCount[i] > 0) { fprintf(stdout, "%6d\t%6d\n", i, msgCount[i]); }
+	fprintf(out,
+	        "\", \"ok\": %s, \"bytes\": %" PRIu64 ", \"messages\": %" PRIu64
+	        ", \"checksumErrors\": %" PRIu64 ", ",
+	        f->ok ? "true" : "false", f->bytesRead, f->messages, f->csumErrors);
+	fprintf(out, "\"stats\": [");
+	for (size_t i = 0; i < t->used; i++) {
+		const n2kc_stats *s = &(t->slots[i]);
+		fprintf(out,
+		        "%s\n\t{\"src\": %u, \"pgn\": %u, \"count\": %" PRIu64 ", \"bytes\": %" PRIu64
+		        ", \"checksumErrors\": %" PRIu64 ", ",
+		        (i > 0) ? "," : "", s->src, s->PGN, s->count, s->bytes, s->csumErrors);
+		if (s->intervals > 0) {
+			fprintf(out, "\"meanInterval\": %.3f, \"minInterval\": %u, \"maxInterval\": %u}",
+			        s->sumInterval / s->intervals, s->minInterval, s->maxInterval);
+		} else {
+			fprintf(out, "\"meanInterval\": null, \"minInterval\": null, \"maxInterval\": null}");
+		}
 	}
-	fclose(nf);
-	return 0;
+	fprintf(out, "]}");
 }
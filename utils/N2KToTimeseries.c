@@ -0,0 +1,710 @@
+/*
+ *  Copyright (C) 2023 Swansea University
+ *
+ *  This file is part of the SELKIELogger suite of tools.
+ *
+ *  SELKIELogger is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation, either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  SELKIELogger is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this SELKIELogger product.
+ *  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <errno.h>
+#include <libgen.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include "SELKIELoggerBase.h"
+#include "SELKIELoggerMP.h"
+#include "SELKIELoggerN2K.h"
+
+#include "version.h"
+
+/*!
+ * @file
+ * @brief Convert N2K messages to a time series
+ * @ingroup Executables
+ */
+
+/*!
+ * @defgroup n2kts N2KToTimeseries internal functions
+ * @ingroup Executables
+ * @{
+ */
+
+//! Allocated read buffer size
+#define BUFSIZE 4096
+
+//! Number of messages to read before decoding and writing out a block of data
+#define N2KTS_BATCH 262144
+
+//! Maximum number of worker threads
+#define N2KTS_MAX_THREADS 64
+
+//! Output file formats
+typedef enum {
+	N2KTS_CSV, //!< Comma separated values, optionally compressed
+	N2KTS_NPY, //!< NumPy structured array
+} n2kts_format;
+
+//! Selected PGN and position of first field in output columns
+typedef struct {
+	const n2k_pgn_desc *desc; //!< PGN description
+	int colBase;              //!< Output column for first field
+} n2kts_pgn;
+
+//! Input file state
+typedef struct {
+	FILE *file;           //!< Input file handle
+	bool dat;             //!< Input is a logger data file, rather than raw N2K data
+	uint8_t source;       //!< Source number to extract raw N2K data from (dat mode only)
+	bool eof;             //!< No more data available from file
+	uint8_t buf[BUFSIZE]; //!< Unprocessed data
+	size_t hw;            //!< Amount of data in buf
+} n2kts_input;
+
+/*!
+ * Work allocated to each thread.
+ *
+ * Each thread decodes a contiguous range of messages, covering complete
+ * output rows, and formats them into an in-memory output buffer. Output
+ * buffers are written to file in order once all threads have completed.
+ */
+typedef struct {
+	const n2kts_pgn *pgns;       //!< Selected PGNs
+	int nPGNs;                   //!< Number of entries in pgns
+	int nCols;                   //!< Total number of data columns
+	n2kts_format format;         //!< Output format
+	const n2k_act_message *msgs; //!< Messages to decode
+	const size_t *rows;          //!< Output row number for each message
+	size_t first;                //!< First message to decode
+	size_t last;                 //!< One past final message to decode
+	char *out;                   //!< Output buffer (allocated by thread)
+	size_t outLen;               //!< Length of data in out
+	size_t nRows;                //!< Number of rows in out
+	bool ok;                     //!< Set to true on success
+} n2kts_job;
+
+//! Read next N2K message from input
+bool n2kts_read(n2kts_input *in, n2k_act_message *out);
+
+//! Refill input buffer from file
+void n2kts_fill(n2kts_input *in);
+
+//! Decode and format a block of messages (pthread function signature)
+void *n2kts_worker(void *ptargs);
+
+//! Generate and write output header
+bool n2kts_header(FILE *out, gzFile gzout, n2kts_format format, const n2kts_pgn *pgns,
+                  int nPGNs, size_t rows);
+
+//! @}
+
+/*!
+ * Reads messages containing N2K data from an Actisense gateway or from the
+ * raw data channel of an N2K source in a logger data file. Selected PGNs are
+ * decoded and messages with identical timestamps are combined into a single
+ * output row.
+ *
+ * Messages are read in batches, and decoding and formatting of each batch is
+ * split between multiple threads.
+ *
+ * @param[in] argc Argument count
+ * @param[in] argv Arguments
+ * @returns -1 on error, otherwise 0
+ */
+int main(int argc, char *argv[]) {
+	program_state state = {0};
+	state.verbose = 1;
+
+	char *outFileName = NULL;
+	bool doGZ = false;
+	bool clobberOutput = false;
+	n2kts_format format = N2KTS_CSV;
+	n2kts_input in = {.source = SLSOURCE_N2K};
+	int nThreads = sysconf(_SC_NPROCESSORS_ONLN);
+	n2kts_pgn pgns[64] = {0};
+	int nPGNs = 0;
+
+	char *usage =
+		"Usage: %1$s [-v] [-q] [-f] [-d] [-S source] [-p PGN] [-z|-n] [-j threads] [-o outfile] file\n"
+		"\t-v\tIncrease verbosity\n"
+		"\t-q\tDecrease verbosity\n"
+		"\t-f\tOverwrite existing output files\n"
+		"\t-d\tInput is a logger data file (.dat)\n"
+		"\t-S\tExtract raw N2K data from specified source (with -d, default 0x38)\n"
+		"\t-p\tDecode specified PGN (may be repeated, default all supported PGNs)\n"
+		"\t-z\tWrite gzipped CSV output\n"
+		"\t-n\tWrite NumPy structured array (.npy) output\n"
+		"\t-j\tNumber of worker threads\n"
+		"\t-o\tWrite output to named file\n"
+		"\nVersion: " GIT_VERSION_STRING "\n"
+		"Output file name will be generated based on input file name and format, unless set by -o option\n";
+
+	opterr = 0; // Handle errors ourselves
+	int go = 0;
+	bool doUsage = false;
+	while ((go = getopt(argc, argv, "vqfdS:p:znj:o:")) != -1) {
+		switch (go) {
+			case 'v':
+				state.verbose++;
+				break;
+			case 'q':
+				state.verbose--;
+				break;
+			case 'f':
+				clobberOutput = true;
+				break;
+			case 'd':
+				in.dat = true;
+				break;
+			case 'S': {
+				errno = 0;
+				int tmp = strtol(optarg, NULL, 0);
+				if (errno || tmp < 0 || tmp > 0x7F) {
+					log_error(&state, "Invalid source number (%s)", optarg);
+					doUsage = true;
+				}
+				in.source = tmp;
+			} break;
+			case 'p': {
+				errno = 0;
+				long tmp = strtol(optarg, NULL, 10);
+				const n2k_pgn_desc *pd = n2k_pgn_find(tmp);
+				if (errno || !pd) {
+					log_error(&state, "No decoder available for PGN %s", optarg);
+					doUsage = true;
+					break;
+				}
+				if (nPGNs >= 64) {
+					log_error(&state, "Too many PGNs requested");
+					doUsage = true;
+					break;
+				}
+				pgns[nPGNs++].desc = pd;
+			} break;
+			case 'z':
+				doGZ = true;
+				format = N2KTS_CSV;
+				break;
+			case 'n':
+				doGZ = false;
+				format = N2KTS_NPY;
+				break;
+			case 'j':
+				errno = 0;
+				nThreads = strtol(optarg, NULL, 0);
+				if (errno || nThreads < 1 || nThreads > N2KTS_MAX_THREADS) {
+					log_error(&state, "Invalid number of threads (%s)", optarg);
+					doUsage = true;
+				}
+				break;
+			case 'o':
+				if (outFileName) {
+					log_error(&state,
+					          "Only a single output file name can be provided");
+					doUsage = true;
+				} else {
+					outFileName = strdup(optarg);
+				}
+				break;
+			case '?':
+				log_error(&state, "Unknown option `-%c'", optopt);
+				doUsage = true;
+		}
+	}
+
+	// Should be 1 spare arguments: The file to convert
+	if (argc - optind != 1) {
+		log_error(&state, "Invalid arguments");
+		doUsage = true;
+	}
+
+	if (doUsage) {
+		fprintf(stderr, usage, argv[0]);
+		free(outFileName);
+		return -1;
+	}
+
+	if (nThreads < 1) { nThreads = 1; }
+	if (nThreads > N2KTS_MAX_THREADS) { nThreads = N2KTS_MAX_THREADS; }
+
+	if (nPGNs == 0) {
+		for (const n2k_pgn_desc *pd = n2k_pgn_table; pd->PGN && nPGNs < 64; pd++) {
+			pgns[nPGNs++].desc = pd;
+		}
+	}
+
+	int nCols = 0;
+	for (int p = 0; p < nPGNs; p++) {
+		pgns[p].colBase = nCols;
+		nCols += pgns[p].desc->nFields;
+	}
+
+	in.file = fopen(argv[optind], "rb");
+	if (in.file == NULL) {
+		log_error(&state, "Unable to open input file \"%s\"", argv[optind]);
+		free(outFileName);
+		return -1;
+	}
+
+	if (outFileName == NULL) {
+		// Work out output file name
+		// Split into base and dirnames so that we're don't accidentally split the
+		// path on a .
+		char *inF1 = strdup(argv[optind]);
+		char *inF2 = strdup(argv[optind]);
+		char *dn = dirname(inF1);
+		char *bn = basename(inF2);
+
+		// Find last . in file name, if any
+		char *ep = strrchr(bn, '.');
+
+		// If no ., use full basename length, else use length to .
+		int bnl = 0;
+		if (ep == NULL) {
+			bnl = strlen(bn);
+		} else {
+			bnl = ep - bn;
+		}
+		const char *ext = (format == N2KTS_NPY) ? "npy" : (doGZ ? "csv.gz" : "csv");
+		if (asprintf(&outFileName, "%s/%.*s.%s", dn, bnl, bn, ext) <= 0) {
+			outFileName = NULL;
+		}
+		free(inF1);
+		free(inF2);
+		if (outFileName == NULL) {
+			log_error(&state, "Unable to generate output file name");
+			fclose(in.file);
+			return -1;
+		}
+	}
+
+	errno = 0;
+	FILE *outFile = NULL;
+	gzFile gzOut = NULL;
+	if (format == N2KTS_NPY) {
+		outFile = fopen(outFileName, clobberOutput ? "wb" : "wbx");
+	} else {
+		// Use zlib functions, but in transparent mode if not compressing
+		char fmode[5] = {'w', 'b', 0, 0};
+		int fm = 2;
+		if (!clobberOutput) { fmode[fm++] = 'x'; }
+		fmode[fm] = doGZ ? '7' : 'T';
+		gzOut = gzopen(outFileName, fmode);
+	}
+	if (outFile == NULL && gzOut == NULL) {
+		log_error(&state, "Unable to open output file \"%s\": %s", outFileName,
+		          strerror(errno));
+		fclose(in.file);
+		free(outFileName);
+		return -1;
+	}
+	log_info(&state, 1, "Writing %d columns from %d PGNs to %s using %d threads", nCols, nPGNs,
+	         outFileName, nThreads);
+	free(outFileName);
+	outFileName = NULL;
+
+	if (!n2kts_header(outFile, gzOut, format, pgns, nPGNs, 0)) {
+		log_error(&state, "Unable to write output header");
+		fclose(in.file);
+		if (outFile) { fclose(outFile); }
+		if (gzOut) { gzclose(gzOut); }
+		return -1;
+	}
+
+	state.started = true;
+
+	n2k_act_message *msgs = calloc(N2KTS_BATCH, sizeof(n2k_act_message));
+	size_t *rows = calloc(N2KTS_BATCH, sizeof(size_t));
+	if (!msgs || !rows) {
+		log_error(&state, "Unable to allocate memory for message buffers");
+		free(msgs);
+		free(rows);
+		fclose(in.file);
+		if (outFile) { fclose(outFile); }
+		if (gzOut) { gzclose(gzOut); }
+		return -1;
+	}
+
+	size_t count = 0;
+	size_t totalMessages = 0;
+	size_t totalRows = 0;
+	bool more = true;
+	bool ok = true;
+	while (ok && (more || count > 0)) {
+		// Fill batch with messages containing a selected PGN
+		while (more && count < N2KTS_BATCH) {
+			if (!n2kts_read(&in, &msgs[count])) {
+				more = false;
+				break;
+			}
+			bool want = false;
+			for (int p = 0; p < nPGNs; p++) {
+				if (msgs[count].PGN == pgns[p].desc->PGN) {
+					want = true;
+					break;
+				}
+			}
+			if (want) {
+				count++;
+			} else {
+				free(msgs[count].data);
+				msgs[count].data = NULL;
+			}
+		}
+
+		if (count == 0) { break; }
+
+		// Messages sharing the final timestamp are held back until the next
+		// batch, so that output rows are not split between batches.
+		size_t use = count;
+		if (more) {
+			while (use > 1 && msgs[use - 1].timestamp == msgs[count - 1].timestamp) {
+				use--;
+			}
+			if (msgs[use - 1].timestamp == msgs[count - 1].timestamp) { use = count; }
+		}
+
+		rows[0] = 0;
+		for (size_t m = 1; m < use; m++) {
+			rows[m] = rows[m - 1] + (msgs[m].timestamp != msgs[m - 1].timestamp);
+		}
+
+		// Split work between threads, only breaking between rows
+		n2kts_job jobs[N2KTS_MAX_THREADS] = {0};
+		pthread_t threads[N2KTS_MAX_THREADS] = {0};
+		int nJobs = 0;
+		size_t start = 0;
+		for (int t = 0; t < nThreads && start < use; t++) {
+			size_t end = (t == nThreads - 1) ? use : start + (use / nThreads) + 1;
+			if (end > use) { end = use; }
+			while (end < use && rows[end] == rows[end - 1]) {
+				end++;
+			}
+			jobs[nJobs] = (n2kts_job){.pgns = pgns,
+			                          .nPGNs = nPGNs,
+			                          .nCols = nCols,
+			                          .format = format,
+			                          .msgs = msgs,
+			                          .rows = rows,
+			                          .first = start,
+			                          .last = end};
+			if (pthread_create(&threads[nJobs], NULL, &n2kts_worker, &jobs[nJobs]) != 0) {
+				log_error(&state, "Unable to start worker thread");
+				ok = false;
+				break;
+			}
+			nJobs++;
+			start = end;
+		}
+
+		for (int t = 0; t < nJobs; t++) {
+			pthread_join(threads[t], NULL);
+			if (!jobs[t].ok) {
+				log_error(&state, "Error decoding messages");
+				ok = false;
+			}
+			if (ok && jobs[t].outLen > 0) {
+				size_t w = 0;
+				if (gzOut) {
+					w = gzwrite(gzOut, jobs[t].out, jobs[t].outLen);
+				} else {
+					w = fwrite(jobs[t].out, 1, jobs[t].outLen, outFile);
+				}
+				if (w != jobs[t].outLen) {
+					log_error(&state, "Unable to write output: %s", strerror(errno));
+					ok = false;
+				}
+			}
+			totalRows += jobs[t].nRows;
+			free(jobs[t].out);
+		}
+
+		for (size_t m = 0; m < use; m++) {
+			free(msgs[m].data);
+		}
+		totalMessages += use;
+		memmove(msgs, &(msgs[use]), (count - use) * sizeof(n2k_act_message));
+		count -= use;
+		log_info(&state, 2, "%zu messages processed, %zu rows written", totalMessages,
+		         totalRows);
+	}
+
+	for (size_t m = 0; m < count; m++) {
+		free(msgs[m].data);
+	}
+	free(msgs);
+	free(rows);
+	fclose(in.file);
+
+	if (ok && format == N2KTS_NPY) {
+		// Rewrite header now that the number of rows is known
+		rewind(outFile);
+		ok = n2kts_header(outFile, NULL, format, pgns, nPGNs, totalRows);
+	}
+	if (outFile) { ok &= (fclose(outFile) == 0); }
+	if (gzOut) { ok &= (gzclose(gzOut) == Z_OK); }
+
+	if (!ok) {
+		log_error(&state, "Conversion failed");
+		return -1;
+	}
+	log_info(&state, 1, "%zu messages converted to %zu rows", totalMessages, totalRows);
+	return 0;
+}
+
+/*!
+ * Reads data into the input buffer. For raw N2K input, this reads directly
+ * from the file. For logger data files, messages are read until a raw data
+ * message from the selected source is found.
+ *
+ * Sets in->eof if no further data is available.
+ *
+ * @param[in,out] in Input state
+ */
+void n2kts_fill(n2kts_input *in) {
+	if (in->eof) { return; }
+	if (!in->dat) {
+		size_t ret = fread(&(in->buf[in->hw]), sizeof(uint8_t), BUFSIZE - in->hw, in->file);
+		in->hw += ret;
+		if (ret == 0 || feof(in->file) || ferror(in->file)) { in->eof = true; }
+		return;
+	}
+
+	while (!in->eof) {
+		msg_t m = {0};
+		if (!mp_readMessage(fileno(in->file), &m)) {
+			in->eof = true;
+			return;
+		}
+		if (m.source != in->source || m.type != SLCHAN_RAW || m.dtype != MSG_BYTES) {
+			msg_destroy(&m);
+			continue;
+		}
+		if (m.length > (BUFSIZE - in->hw)) {
+			// Not enough space: Drop buffered data, which cannot form a valid
+			// message, in favour of the new message.
+			in->hw = 0;
+		}
+		if (m.length <= BUFSIZE) {
+			memcpy(&(in->buf[in->hw]), m.data.bytes, m.length);
+			in->hw += m.length;
+		}
+		msg_destroy(&m);
+		return;
+	}
+}
+
+/*!
+ * On success, out->data is allocated and must be freed by the caller.
+ *
+ * @param[in,out] in Input state
+ * @param[out] out Decoded N2K message
+ * @returns True if a message was read, false if no more messages available
+ */
+bool n2kts_read(n2kts_input *in, n2k_act_message *out) {
+	while (true) {
+		if (!in->eof && in->hw < (BUFSIZE / 2)) { n2kts_fill(in); }
+		if (in->hw == 0 && in->eof) { return false; }
+
+		n2k_act_message *nm = NULL;
+		size_t end = 0;
+		bool r = n2k_act_from_bytes(in->buf, in->hw, &nm, &end, false);
+		if (!r) {
+			if (nm) {
+				free(nm->data);
+				free(nm);
+				nm = NULL;
+			}
+			if (end == 0) {
+				if (!in->eof && in->hw < BUFSIZE) {
+					// Need more data before we can make progress
+					n2kts_fill(in);
+					continue;
+				}
+				if (in->eof && in->hw < 18) {
+					// Too short to contain a message
+					in->hw = 0;
+					return false;
+				}
+				// Buffer full or at end of file but no message
+				// found, so skip forward
+				end = 1;
+			}
+		}
+
+		if (end > in->hw) { end = in->hw; }
+		memmove(in->buf, &(in->buf[end]), in->hw - end);
+		in->hw -= end;
+
+		if (r) {
+			(*out) = (*nm);
+			free(nm);
+			return true;
+		}
+	}
+}
+
+/*!
+ * Decodes the messages allocated to this job into a temporary array of rows,
+ * then formats the rows into an output buffer.
+ *
+ * @param[in,out] ptargs Pointer to n2kts_job
+ * @returns NULL
+ */
+void *n2kts_worker(void *ptargs) {
+	n2kts_job *job = (n2kts_job *)ptargs;
+	job->ok = false;
+	if (job->last <= job->first) {
+		job->ok = true;
+		return NULL;
+	}
+
+	const size_t rowBase = job->rows[job->first];
+	job->nRows = job->rows[job->last - 1] - rowBase + 1;
+	const size_t stride = job->nCols;
+
+	double *vals = malloc(job->nRows * stride * sizeof(double));
+	uint32_t *ts = calloc(job->nRows, sizeof(uint32_t));
+	if (!vals || !ts) {
+		free(vals);
+		free(ts);
+		return NULL;
+	}
+	for (size_t i = 0; i < job->nRows * stride; i++) {
+		vals[i] = NAN;
+	}
+
+	for (size_t m = job->first; m < job->last; m++) {
+		const n2k_act_message *n = &(job->msgs[m]);
+		const size_t r = job->rows[m] - rowBase;
+		ts[r] = n->timestamp;
+		for (int p = 0; p < job->nPGNs; p++) {
+			if (n->PGN != job->pgns[p].desc->PGN) { continue; }
+			double v[N2K_MAX_FIELDS] = {0};
+			if (n2k_decode_message(job->pgns[p].desc, n, v) >= 0) {
+				memcpy(&(vals[r * stride + job->pgns[p].colBase]), v,
+				       job->pgns[p].desc->nFields * sizeof(double));
+			}
+			break;
+		}
+	}
+
+	FILE *ms = open_memstream(&(job->out), &(job->outLen));
+	if (!ms) {
+		free(vals);
+		free(ts);
+		return NULL;
+	}
+
+	bool ok = true;
+	for (size_t r = 0; r < job->nRows && ok; r++) {
+		const double *row = &(vals[r * stride]);
+		if (job->format == N2KTS_NPY) {
+			ok &= (fwrite(&(ts[r]), sizeof(uint32_t), 1, ms) == 1);
+			ok &= (fwrite(row, sizeof(double), stride, ms) == stride);
+		} else {
+			ok &= (fprintf(ms, "%u", ts[r]) > 0);
+			for (size_t c = 0; c < stride; c++) {
+				if (isnan(row[c])) {
+					ok &= (fputc(',', ms) != EOF);
+				} else {
+					ok &= (fprintf(ms, ",%.15g", row[c]) > 0);
+				}
+			}
+			ok &= (fputc('\n', ms) != EOF);
+		}
+	}
+	ok &= (fclose(ms) == 0);
+	free(vals);
+	free(ts);
+	job->ok = ok;
+	return NULL;
+}
+
+/*!
+ * For CSV output, writes a single line containing column names.
+ *
+ * For NumPy output, writes a version 1.0 .npy header describing a structured
+ * array with an unsigned 32 bit timestamp field followed by a 64 bit float
+ * field for each column. The header is padded to a fixed size so that it can
+ * be rewritten with the final row count once all data has been written.
+ *
+ * Column names are formed from the PGN and field name, matching the channel
+ * names used by the logger.
+ *
+ * @param[in] out Output file (NPY format)
+ * @param[in] gzout Output file (CSV format)
+ * @param[in] format Output format
+ * @param[in] pgns Selected PGNs
+ * @param[in] nPGNs Number of entries in pgns
+ * @param[in] rows Number of rows in file (NPY format only)
+ * @returns True on success
+ */
+bool n2kts_header(FILE *out, gzFile gzout, n2kts_format format, const n2kts_pgn *pgns,
+                  int nPGNs, size_t rows) {
+	char *hdr = NULL;
+	size_t hlen = 0;
+	FILE *ms = open_memstream(&hdr, &hlen);
+	if (!ms) { return false; }
+
+	if (format == N2KTS_NPY) {
+		fprintf(ms, "{'descr': [('Timestamp', '<u4')");
+		for (int p = 0; p < nPGNs; p++) {
+			for (int f = 0; f < pgns[p].desc->nFields; f++) {
+				fprintf(ms, ", ('%u:%s', '<f8')", pgns[p].desc->PGN,
+				        pgns[p].desc->fields[f].name);
+			}
+		}
+		fprintf(ms, "], 'fortran_order': False, 'shape': (%20zu,), }", rows);
+	} else {
+		fprintf(ms, "Timestamp");
+		for (int p = 0; p < nPGNs; p++) {
+			for (int f = 0; f < pgns[p].desc->nFields; f++) {
+				fprintf(ms, ",%u:%s", pgns[p].desc->PGN, pgns[p].desc->fields[f].name);
+			}
+		}
+		fprintf(ms, "\n");
+	}
+	fclose(ms);
+
+	bool ok = false;
+	if (format == N2KTS_NPY) {
+		// Magic (6) + version (2) + length (2) + header, padded to 64 bytes
+		// and terminated with a newline
+		const size_t total = ((10 + hlen + 1 + 63) / 64) * 64;
+		const uint16_t pl = total - 10;
+		if (total - 10 <= UINT16_MAX) {
+			const uint8_t magic[8] = {0x93, 'N', 'U', 'M', 'P', 'Y', 1, 0};
+			const uint8_t len[2] = {pl & 0xFF, (pl >> 8) & 0xFF};
+			ok = (fwrite(magic, 1, 8, out) == 8);
+			ok &= (fwrite(len, 1, 2, out) == 2);
+			ok &= (fwrite(hdr, 1, hlen, out) == hlen);
+			for (size_t i = 10 + hlen; i < total - 1; i++) {
+				ok &= (fputc(' ', out) != EOF);
+			}
+			ok &= (fputc('\n', out) != EOF);
+		}
+	} else {
+		ok = (gzwrite(gzout, hdr, hlen) == (int)hlen);
+	}
+	free(hdr);
+	return ok;
+}
@@ -0,0 +1,137 @@
+/*
+ *  Copyright (C) 2023 Swansea University
+ *
+ *  This file is part of the SELKIELogger suite of tools.
+ *
+ *  SELKIELogger is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU General Public License as published by the Free
+ *  Software Foundation, either version 3 of the License, or (at your option)
+ *  any later version.
+ *
+ *  SELKIELogger is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ *  more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this SELKIELogger product.
+ *  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "SELKIELoggerBase.h"
+
+#include "version.h"
+
+/*!
+ * @file
+ * @brief Print current values from a logger state table
+ * @ingroup Executables
+ */
+
+/*!
+ * Reads the latest values from a logger state table and prints them in the
+ * same format as the logger state file.
+ *
+ * If an interval is specified with `-i`, the table is read repeatedly until
+ * interrupted.
+ *
+ * @param[in] argc Argument count
+ * @param[in] argv Arguments
+ * @returns -1 on error, otherwise 0
+ */
+int main(int argc, char *argv[]) {
+	program_state state = {0};
+	state.verbose = 1;
+	int interval = 0;
+
+	char *usage = "Usage: %1$s [-v] [-i interval] statetable\n"
+		      "\t-i Re-read table every 'interval' seconds\n"
+		      "\nVersion: " GIT_VERSION_STRING "\n";
+
+	opterr = 0; // Handle errors ourselves
+	int go = 0;
+	bool doUsage = false;
+	while ((go = getopt(argc, argv, "vi:")) != -1) {
+		switch (go) {
+			case 'i':
+				errno = 0;
+				interval = strtol(optarg, NULL, 0);
+				if (errno || interval < 0) {
+					log_error(&state, "Invalid interval: %s", optarg);
+					doUsage = true;
+				}
+				break;
+			case 'v':
+				state.verbose++;
+				break;
+			case '?':
+				log_error(&state, "Unknown option `-%c'", optopt);
+				doUsage = true;
+		}
+	}
+
+	// Should be 1 spare arguments: The table to read
+	if (argc - optind != 1) {
+		log_error(&state, "Invalid arguments");
+		doUsage = true;
+	}
+
+	if (doUsage) {
+		fprintf(stderr, usage, argv[0]);
+		destroy_program_state(&state);
+		return -1;
+	}
+
+	state_table table = {0};
+	errno = 0;
+	if (!state_table_open(&table, argv[optind])) {
+		log_error(&state, "Unable to open state table: %s", strerror(errno));
+		destroy_program_state(&state);
+		return -1;
+	}
+
+	state.started = 1;
+	do {
+		state_header hdr = {0};
+		if (!state_table_read_header(&table, &hdr)) {
+			log_error(&state, "Unable to read state table header");
+			state_table_close(&table);
+			destroy_program_state(&state);
+			return -1;
+		}
+		fprintf(stdout, "%u\n", hdr.lastTimestamp);
+		fprintf(stdout, "%s\n", hdr.varFile);
+
+		int entries = 0;
+		for (int s = 0; s < 128; s++) {
+			for (int c = 0; c < 128; c++) {
+				state_entry e = {0};
+				if (!state_table_read(&table, s, c, &e)) {
+					log_warning(&state, "Unable to read entry 0x%02x:0x%02x",
+					            s, c);
+					continue;
+				}
+				if (e.count == 0) { continue; }
+				char *val = state_entry_to_string(&e);
+				fprintf(stdout, "0x%02x,0x%02x,%u,%u,\'%s\'\n", s, c, e.count,
+				        e.lastTimestamp, val);
+				free(val);
+				entries++;
+			}
+		}
+		log_info(&state, 2, "%d active channels (written by process %u)", entries,
+		         hdr.pid);
+		fflush(stdout);
+		if (interval > 0) { sleep(interval); }
+	} while (interval > 0);
+
+	state_table_close(&table);
+	destroy_program_state(&state);
+	return 0;
+}
@@ -85,6 +85,13 @@ char *csv_all_timestamp_headers(const uint8_t source, const uint8_t type, const
 //! Convert timestamp (SLCHAN_TSTAMP) to string
 char *csv_all_timestamp_data(const msg_t *msg);
 
+//! Generate CSV header for message capture times (SLSOURCE_CAPT)
+char *csv_capture_time_headers(const uint8_t source, const uint8_t type, const char *sourceName,
+                               const char *channelName);
+
+//! Convert capture time to string
+char *csv_capture_time_data(const msg_t *msg);
+
 //! Generate CSV header for GPS position fields
 char *csv_gps_position_headers(const uint8_t source, const uint8_t type, const char *sourceName,
                                const char *channelName);
@@ -113,16 +120,28 @@ char *csv_all_float_headers(const uint8_t source, const uint8_t type, const char
 //! Convert single value floating point data channel to CSV string
 char *csv_all_float_data(const msg_t *msg);
 
+//! Generate CSV headers for packed numerical array channels
+char *csv_all_packed_headers(const uint8_t source, const uint8_t type, const char *sourceName,
+                             const char *channelName);
+
+//! Convert packed numerical array channel to CSV string
+char *csv_all_packed_data(const msg_t *msg);
+
 /*!
  * Represents the functions required to convert a specified message type to CSV format.
  *
  * Source and type will be exact matches, not ranges.
+ *
+ * If width is non-zero, only numerical arrays with exactly that number of
+ * entries will be passed to the data function, and empty fields are generated
+ * directly rather than by the data function.
  */
 typedef struct {
 	uint8_t source;       //!< Message source
 	uint8_t type;         //!< Message type
 	csv_header_fn header; //!< CSV Header generator
 	csv_data_fn data;     //!< CSV field generator
+	int width;            //!< Number of fields for packed array channels (0 otherwise)
 } csv_msg_handler;
 //! @}
 
@@ -346,12 +365,22 @@ int main(int argc, char *argv[]) {
 	if (handlers == NULL) { log_error(&state, "Unable to allocate handler map"); }
 
 	// Set up per source timestamps (master clock handle separately);
+	// Capture times (if recorded) follow the timestamp for each source
+	const bool captureTimes = (sourceNames[SLSOURCE_CAPT] != NULL);
 	for (int i = 0; i < nSources; i++) {
+		const uint8_t src = usedSources[i];
+		if (src == SLSOURCE_CAPT) { continue; }
 		handlers[nHandlers++] =
-			(csv_msg_handler){usedSources[i], SLCHAN_TSTAMP,
-		                          &csv_all_timestamp_headers, &csv_all_timestamp_data};
+			(csv_msg_handler){src, SLCHAN_TSTAMP,
+		                          &csv_all_timestamp_headers, &csv_all_timestamp_data, 0};
+
+		if (captureTimes && src >= SLSOURCE_TIMER && src < SLCHAN_LOG_INFO) {
+			handlers[nHandlers++] =
+				(csv_msg_handler){SLSOURCE_CAPT, src, &csv_capture_time_headers,
+			                          &csv_capture_time_data, 0};
+		}
 
-		if (nHandlers >= maxHandlers) {
+		if (nHandlers >= maxHandlers - 1) {
 			handlers =
 				reallocarray(handlers, 50 + maxHandlers, sizeof(csv_msg_handler));
 			if (handlers == NULL) {
@@ -377,24 +406,44 @@ int main(int argc, char *argv[]) {
 				maxHandlers += 50;
 			}
 			// clang-format off
-			handlers[nHandlers++] = (csv_msg_handler){usedSources[i], 4, &csv_gps_position_headers, &csv_gps_position_data};
-			handlers[nHandlers++] = (csv_msg_handler){usedSources[i], 5, &csv_gps_velocity_headers, &csv_gps_velocity_data};
-			handlers[nHandlers++] = (csv_msg_handler){usedSources[i], 6, &csv_gps_datetime_headers, &csv_gps_datetime_data};
+			handlers[nHandlers++] = (csv_msg_handler){usedSources[i], 4, &csv_gps_position_headers, &csv_gps_position_data, 0};
+			handlers[nHandlers++] = (csv_msg_handler){usedSources[i], 5, &csv_gps_velocity_headers, &csv_gps_velocity_data, 0};
+			handlers[nHandlers++] = (csv_msg_handler){usedSources[i], 6, &csv_gps_datetime_headers, &csv_gps_datetime_data, 0};
 			// clang-format on
 		}
 		// Although these sources have to be communicated with differently, both
 		// output named channels with single floating point values
-		if ((usedSources[i] >= SLSOURCE_I2C && usedSources[i] < (SLSOURCE_I2C + 0x10)) ||
-		    (usedSources[i] >= SLSOURCE_MP && usedSources[i] < (SLSOURCE_MP + 0x10)) ||
-		    (usedSources[i] >= SLSOURCE_ADC && usedSources[i] < (SLSOURCE_ADC + 0x10))) {
+		const uint8_t src = usedSources[i];
+		const bool named = (src >= SLSOURCE_I2C && src < (SLSOURCE_I2C + 0x10)) ||
+		                   (src >= SLSOURCE_MP && src < (SLSOURCE_MP + 0x10)) ||
+		                   (src >= SLSOURCE_ADC && src < (SLSOURCE_ADC + 0x10));
+		// Other channels from external sources (e.g. Datawell buoys) aren't
+		// simple values, but their wave statistics channels are
+		const bool waveStats = (src >= SLSOURCE_EXT && src < SLSOURCE_MQTT);
+		if (named || waveStats) {
 			// Start at first valid data channel (3)
 			for (int c = 3; c < 128; c++) {
 				// If the channel name is empty, assume we're not using this one
 				if (channelNames[usedSources[i]][c] == NULL) { continue; }
-				// Generic handler for any single floating point channels
-				handlers[nHandlers++] = (csv_msg_handler){usedSources[i], c,
-				                                          &csv_all_float_headers,
-				                                          &csv_all_float_data};
+				const char *cn = channelNames[usedSources[i]][c];
+				if (!named && strncmp(cn, "WS-", 3) != 0) { continue; }
+				// Packed channels are marked by a prefix, followed by
+				// the name of each value separated by commas
+				const size_t pl = strlen(SLCHAN_PACKED_PREFIX);
+				if (strncmp(cn, SLCHAN_PACKED_PREFIX, pl) == 0) {
+					int width = 1;
+					for (const char *p = cn; *p; p++) {
+						if (*p == ',') { width++; }
+					}
+					handlers[nHandlers++] = (csv_msg_handler){
+						usedSources[i], c, &csv_all_packed_headers,
+						&csv_all_packed_data, width};
+				} else {
+					// Generic handler for any single floating point channels
+					handlers[nHandlers++] = (csv_msg_handler){
+						usedSources[i], c, &csv_all_float_headers,
+						&csv_all_float_data, 0};
+				}
 				if (nHandlers >= maxHandlers) {
 					handlers = reallocarray(handlers, 50 + maxHandlers,
 					                        sizeof(csv_msg_handler));
@@ -539,7 +588,7 @@ int main(int argc, char *argv[]) {
 			destroy_program_state(&state);
 			return -1;
 		}
-		if (hlen > (hsize - strlen(fieldTitle))) {
+		while ((hlen + strlen(fieldTitle) + 2) > hsize) {
 			header = realloc(header, hsize + 512);
 			hsize += 512;
 		}
@@ -602,6 +651,12 @@ int main(int argc, char *argv[]) {
 					msg_t *msg = &(currentTimestep[m]);
 					if (msg->type == handlers[i].type &&
 					    msg->source == handlers[i].source) {
+						if (handlers[i].width &&
+						    (msg->dtype != MSG_NUMARRAY ||
+						     msg->length != (size_t)handlers[i].width)) {
+							// Doesn't match channel map, so skip
+							continue;
+						}
 						char *out = handlers[i].data(msg);
 						if (out == NULL) {
 							log_error(
@@ -618,7 +673,12 @@ int main(int argc, char *argv[]) {
 						break; // First instance of each message wins
 					}
 				}
-				if (!error && !handled) {
+				if (!error && !handled && handlers[i].width) {
+					// Empty fields for packed channels
+					for (int f = 0; f < handlers[i].width; f++) {
+						gzprintf(outFile, ",");
+					}
+				} else if (!error && !handled) {
 					char *out =
 						handlers[i].data(NULL); // Generate empty fields
 					if (out == NULL) {
@@ -739,6 +799,47 @@ char *csv_all_timestamp_data(const msg_t *msg) {
 	return out;
 }
 
+/*!
+ * Capture times are recorded with the source ID of the message being
+ * described as the channel number, so the field name is based on the channel
+ * number rather than the source.
+ *
+ * Returned string must be freed by caller
+ *
+ * @param[in] source Source number (ignored)
+ * @param[in] type Channel number
+ * @param[in] sourceName Name of this source (ignored)
+ * @param[in] channelName Name of this channel (ignored)
+ * @returns Capture time field name
+ */
+char *csv_capture_time_headers(const uint8_t source, const uint8_t type, const char *sourceName,
+                               const char *channelName) {
+	(void) source;
+	(void) sourceName;
+	(void) channelName;
+
+	char *fields = NULL;
+	if (asprintf(&fields, "Capture:%02X", type) <= 0) { return NULL; }
+	return fields;
+}
+
+/*!
+ * Microsecond capture times use the full 32 bit range, so are output as
+ * unsigned values.
+ *
+ * Returned string must be freed by caller
+ *
+ * @param[in] msg Message to be interpreted as capture time
+ * @returns Message value, as string
+ */
+char *csv_capture_time_data(const msg_t *msg) {
+	char *out = NULL;
+	if (msg == NULL) { return strdup(""); }
+
+	if (asprintf(&out, "%u", msg->data.timestamp) <= 0) { return NULL; }
+	return out;
+}
+
 /*!
  * Returned string must be freed by caller
  *
@@ -894,6 +995,10 @@ char *csv_all_float_headers(const uint8_t source, const uint8_t type, const char
 /*!
  * Returns single floating point value as a string
  *
+ * Some named channels carry integer counters as timestamp messages (e.g. the
+ * I2C sweep index), so these are output as integers rather than being
+ * reinterpreted as floating point values.
+ *
  * Returned string must be freed by caller
  *
  * @param[in] msg Message containing float value
@@ -902,6 +1007,84 @@ char *csv_all_float_headers(const uint8_t source, const uint8_t type, const char
 char *csv_all_float_data(const msg_t *msg) {
 	char *out = NULL;
 	if (msg == NULL) { return strdup(""); }
+	if (msg->dtype == MSG_TIMESTAMP) {
+		if (asprintf(&out, "%u", msg->data.timestamp) <= 0) { return NULL; }
+		return out;
+	}
 	if (asprintf(&out, "%.6f", msg->data.value) <= 0) { return NULL; }
 	return out;
 }
+
+/*!
+ * Generic handler for channels containing packed numerical arrays.
+ *
+ * The channel name is SLCHAN_PACKED_PREFIX followed by a comma separated list
+ * of names for each value in the array, and each is output as a separate
+ * field.
+ *
+ * Returned string must be freed by caller
+ *
+ * @param[in] source Source number
+ * @param[in] type Channel number (ignored)
+ * @param[in] sourceName Name of this source (ignored)
+ * @param[in] channelName Prefixed, comma separated list of value names
+ * @returns String representing each value in this source/channel
+ */
+char *csv_all_packed_headers(const uint8_t source, const uint8_t type, const char *sourceName,
+                             const char *channelName) {
+	(void) type;
+	(void) sourceName;
+
+	char *names = strdup(channelName + strlen(SLCHAN_PACKED_PREFIX));
+	if (names == NULL) { return NULL; }
+
+	// strsep() retains empty names, so field count always matches the handler width
+	char *fields = NULL;
+	char *next = names;
+	char *n = NULL;
+	while ((n = strsep(&next, ","))) {
+		char *prev = fields;
+		int r = 0;
+		if (prev) {
+			r = asprintf(&fields, "%s,%s:%02X", prev, n, source);
+		} else {
+			r = asprintf(&fields, "%s:%02X", n, source);
+		}
+		free(prev);
+		if (r <= 0) {
+			free(names);
+			return NULL;
+		}
+	}
+	free(names);
+	return fields;
+}
+
+/*!
+ * Returns each value in a numerical array as a separate field.
+ *
+ * Only called with messages matching the width of the channel (see
+ * csv_msg_handler), so no empty fields are generated here.
+ *
+ * Returned string must be freed by caller
+ *
+ * @param[in] msg Message containing numerical array
+ * @returns Data from message, as a string
+ */
+char *csv_all_packed_data(const msg_t *msg) {
+	if (msg == NULL) { return strdup(""); }
+
+	char *out = NULL;
+	for (size_t i = 0; i < msg->length; i++) {
+		char *prev = out;
+		int r = 0;
+		if (prev) {
+			r = asprintf(&out, "%s,%.6f", prev, msg->data.farray[i]);
+		} else {
+			r = asprintf(&out, "%.6f", msg->data.farray[i]);
+		}
+		free(prev);
+		if (r <= 0) { return NULL; }
+	}
+	return out;
+}